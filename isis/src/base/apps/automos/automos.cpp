@@ -65,6 +65,9 @@ namespace Isis {
     m.SetLowSaturationFlag(ui.GetBoolean("LOWSATURATION"));
     m.SetNullFlag(ui.GetBoolean("NULL"));
 
+    // Place the lines of each image with all of the available threads
+    m.SetThreadedFlag(true);
+
     // Loop for each input file and place it in the output mosaic
 
     m.SetBandBinMatch(ui.GetBoolean("MATCHBANDBIN"));
@@ -1,9 +1,19 @@
 #include "cam2map.h"
 
+#include <vector>
+
+#include <QList>
+#include <QMutexLocker>
+#include <QThreadPool>
+
 #include "Camera.h"
+#include "CameraFactory.h"
 #include "CubeAttribute.h"
 #include "IException.h"
 #include "IString.h"
+#include "LineScanCamera.h"
+#include "LineScanCameraGroundMap.h"
+#include "NaifStatus.h"
 #include "ProjectionFactory.h"
 #include "PushFrameCameraDetectorMap.h"
 #include "Pvl.h"
@@ -18,6 +28,7 @@ namespace Isis {
   void bandChange(const int band);
   Cube *icube;
   Camera *incam;
+  QList<Camera *> threadCameras;
 
   void cam2map(UserInterface &ui, Pvl *log) {
     // Open the input cube
@@ -39,12 +50,16 @@ namespace Isis {
 
   void cam2map(Cube *icube, Pvl &userMap, PvlGroup &userGrp, UserInterface &ui, Pvl *log) {
     ProcessRubberSheet p;
-    cam2map(icube, userMap, userGrp, p, ui, log);
+    int threadCount = 1;
+    if (ui.GetBoolean("THREADED")) {
+      threadCount = QThreadPool::globalInstance()->maxThreadCount();
+    }
+    cam2map(icube, userMap, userGrp, p, ui, log, threadCount);
   }
 
 
   void cam2map(Cube *icube, Pvl &userMap, PvlGroup &userGrp, ProcessRubberSheet &p,
-                UserInterface &ui, Pvl *log){
+                UserInterface &ui, Pvl *log, int threadCount){
 
     // Get the camera from the input cube
     p.SetInputCube(icube);
@@ -304,53 +319,36 @@ namespace Isis {
       ocube->putGroup(alpha);
     }
 
-    // We will need a transform class
-    Transform *transform = 0;
+    // Forward driven transforms map input pixels with processPatchTransform(),
+    // reverse driven transforms map output pixels with StartProcess()
+    bool forward = false;
 
     // Okay we need to decide how to apply the rubbersheeting for the transform
     // Does the user want to define how it is done?
     if (ui.GetString("WARPALGORITHM") == "FORWARDPATCH") {
-      transform = new cam2mapForward(icube->sampleCount(),
-                                     icube->lineCount(),
-                                     incam,
-                                     samples,
-                                     lines,
-                                     outmap,
-                                     trim);
+      forward = true;
 
       int patchSize = ui.GetInteger("PATCHSIZE");
       if (patchSize <= 1) {
         patchSize = 3; // Make the patchsize reasonable
       }
       p.setPatchParameters(1, 1, patchSize, patchSize, patchSize-1, patchSize-1);
-
-      p.processPatchTransform(*transform, *interp);
     }
 
     else if (ui.GetString("WARPALGORITHM") == "REVERSEPATCH") {
-      transform = new cam2mapReverse(icube->sampleCount(),
-                                     icube->lineCount(), incam, samples,lines,
-                                     outmap, trim, occlusion);
-
       int patchSize = ui.GetInteger("PATCHSIZE");
       int minPatchSize = 4;
       if (patchSize < minPatchSize) {
         patchSize = minPatchSize;
       }
       p.SetTiling(patchSize, patchSize);
-
-      p.StartProcess(*transform, *interp);
     }
 
     // The user didn't want to override the program smarts.
     // Handle framing cameras.  Always process using the backward
     // driven system (tfile).
     else if (incam->GetCameraType() == Camera::Framing) {
-      transform = new cam2mapReverse(icube->sampleCount(),
-                                     icube->lineCount(), incam, samples,lines,
-                                     outmap, trim, occlusion);
       p.SetTiling(4, 4);
-      p.StartProcess(*transform, *interp);
     }
 
     // The user didn't want to override the program smarts.
@@ -361,11 +359,7 @@ namespace Isis {
     // to determine patch size based on 1) if the limb is in the file
     // or 2) if the DTM is much coarser than the image
     else if (incam->GetCameraType() == Camera::LineScan) {
-      transform = new cam2mapForward(icube->sampleCount(),
-                                     icube->lineCount(), incam, samples,lines,
-                                     outmap, trim);
-
-      p.processPatchTransform(*transform, *interp);
+      forward = true;
     }
 
     // The user didn't want to override the program smarts.
@@ -378,9 +372,7 @@ namespace Isis {
     // TODO: What about the THEMIS VIS Camera.  Will tall narrow (128x4) patches
     // work okay?
     else if (incam->GetCameraType() == Camera::PushFrame) {
-      transform = new cam2mapForward(icube->sampleCount(),
-                                     icube->lineCount(), incam, samples,lines,
-                                     outmap, trim);
+      forward = true;
 
       // Get the frame height
       PushFrameCameraDetectorMap *dmap = (PushFrameCameraDetectorMap *) incam->DetectorMap();
@@ -409,23 +401,84 @@ namespace Isis {
 
       p.setPatchParameters(1, startLine, 5, frameSize,
                            4, frameSize * 2);
-
-      p.processPatchTransform(*transform, *interp);
     }
 
     // The user didn't want to override the program smarts.  The other camera
     // types have not be analyized.  This includes Radar and Point.  Continue to
     // use the reverse geom option with the default tiling hints
     else {
-      transform = new cam2mapReverse(icube->sampleCount(),
-                                     icube->lineCount(), incam, samples,lines,
-                                     outmap, trim, occlusion);
-
       int tileStart, tileEnd;
       incam->GetGeometricTilingHint(tileStart, tileEnd);
       p.SetTiling(tileStart, tileEnd);
+    }
 
-      p.StartProcess(*transform, *interp);
+    // Every thread needs its own camera and output projection. Cameras can only
+    // be cloned when the SPICE is attached to the cube, otherwise run serially.
+    QList<Camera *> cameras;
+    QList<TProjection *> projections;
+    cameras.append(incam);
+    projections.append(outmap);
+    PvlGroup warnings("Warnings");
+    try {
+      while (cameras.size() < threadCount) {
+        Camera *camera = CameraFactory::Clone(*icube);
+        cameras.append(camera);
+        threadCameras.append(camera);
+        projections.append((TProjection *) ProjectionFactory::CreateFromCube(*ocube));
+      }
+    }
+    catch (IException &e) {
+      // Use the cameras that could be created
+      while (projections.size() < cameras.size()) {
+        delete cameras.takeLast();
+        threadCameras.removeLast();
+      }
+
+      QString message = "Unable to create a camera for each of the [" + toString(threadCount) +
+                        "] threads, using [" + toString(cameras.size()) + "] threads instead. " +
+                        e.toString();
+      warnings.addKeyword(PvlKeyword("Warning", message));
+    }
+
+    // Interpolate the SPICE caches without searching them
+    foreach (Camera *camera, cameras) {
+      camera->setIndexedCacheLookup(true);
+    }
+
+    // The pixels of a line scan line share the line's exposure state, and
+    // ground points are seeded with their predicted line
+    if (incam->GetCameraType() == Camera::LineScan) {
+      foreach (Camera *camera, cameras) {
+        ((LineScanCamera *) camera)->SetLineTimeTable(true);
+        ((LineScanCamera *) camera)->GroundMap()->SetLinePredictor(true);
+      }
+    }
+
+    std::vector<Transform *> transforms;
+    for (int i = 0; i < cameras.size(); i++) {
+      if (forward) {
+        transforms.push_back(new cam2mapForward(icube->sampleCount(), icube->lineCount(),
+                                                cameras[i], samples, lines, projections[i],
+                                                trim));
+      }
+      else {
+        transforms.push_back(new cam2mapReverse(icube->sampleCount(), icube->lineCount(),
+                                                cameras[i], samples, lines, projections[i],
+                                                trim, occlusion));
+      }
+    }
+
+    if (forward && transforms.size() == 1) {
+      p.processPatchTransform(*transforms[0], *interp);
+    }
+    else if (forward) {
+      p.processPatchTransform(transforms, *interp);
+    }
+    else if (transforms.size() == 1) {
+      p.StartProcess(*transforms[0], *interp);
+    }
+    else {
+      p.StartProcess(transforms, *interp);
     }
 
     // Wrap up the warping process
@@ -433,10 +486,25 @@ namespace Isis {
 
     // add mapping to print.prt
     log->addGroup(cleanMapping);
+    if (warnings.keywords() > 0) {
+      log->addGroup(warnings);
+    }
 
     // Cleanup
+    for (int i = 0; i < (int)transforms.size(); i++) {
+      delete transforms[i];
+    }
+    incam->setIndexedCacheLookup(false);
+    if (incam->GetCameraType() == Camera::LineScan) {
+      ((LineScanCamera *) incam)->SetLineTimeTable(false);
+      ((LineScanCamera *) incam)->GroundMap()->SetLinePredictor(false);
+    }
+    for (int i = 1; i < cameras.size(); i++) {
+      delete cameras[i];
+      delete projections[i];
+    }
+    threadCameras.clear();
     delete outmap;
-    delete transform;
     delete interp;
   }
 
@@ -459,12 +527,19 @@ namespace Isis {
   // Transform method mapping input line/samps to lat/lons to output line/samps
   bool cam2mapForward::Xform(double &outSample, double &outLine,
                              const double inSample, const double inLine) {
-    // See if the input image coordinate converts to a lat/lon
-    if (!p_incam->SetImage(inSample,inLine)) return false;
+    double lat, lon;
+    {
+      // The transforms of other threads evaluate their cameras concurrently
+      QMutexLocker locker(NaifStatus::mutex());
+
+      // See if the input image coordinate converts to a lat/lon
+      if (!p_incam->SetImage(inSample,inLine)) return false;
+
+      lat = p_incam->UniversalLatitude();
+      lon = p_incam->UniversalLongitude();
+    }
 
     // Does that ground coordinate work in the map projection
-    double lat = p_incam->UniversalLatitude();
-    double lon = p_incam->UniversalLongitude();
     if (!p_outmap->SetUniversalGround(lat,lon)) return false;
 
     // See if we should trim
@@ -533,6 +608,9 @@ namespace Isis {
     double lat = p_outmap->UniversalLatitude();
     double lon = p_outmap->UniversalLongitude();
 
+    // The transforms of other threads evaluate their cameras concurrently
+    QMutexLocker locker(NaifStatus::mutex());
+
     if (!p_incam->SetUniversalGround(lat, lon)) return false;
 
     // Make sure the point is inside the input image
@@ -567,5 +645,8 @@ namespace Isis {
 
   void bandChange(const int band) {
     incam->SetBand(band);
+    foreach (Camera *camera, threadCameras) {
+      camera->SetBand(band);
+    }
   }
 }
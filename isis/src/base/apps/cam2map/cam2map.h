@@ -11,7 +11,7 @@
 namespace Isis {
   extern void cam2map(UserInterface &ui, Pvl *log=nullptr);
   extern void cam2map(Cube *icube, Pvl &userMap, PvlGroup &userGrp, ProcessRubberSheet &rs,
-                      UserInterface &ui, Pvl *log);
+                      UserInterface &ui, Pvl *log, int threadCount=1);
   extern void cam2map(Cube *icube, Pvl &userMap, PvlGroup &userGrp, UserInterface &ui, Pvl *log);
 
   /**
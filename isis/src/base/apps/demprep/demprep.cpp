@@ -1,5 +1,6 @@
 #include <iomanip>
 
+#include "DemElevationPyramid.h"
 #include "Distance.h"
 #include "ProcessByLine.h"
 #include "TProjection.h"
@@ -291,6 +292,11 @@ namespace Isis{
 
     ocube->write(table);
 
+    // Store the radius bounds of each block of the DEM so that DemShape can
+    // skip over the parts of a ray that are above the terrain
+    DemElevationPyramid pyramid(*ocube);
+    ocube->write(pyramid.toTable());
+
     p.EndProcess();
     ocube->close();
     delete ocube;
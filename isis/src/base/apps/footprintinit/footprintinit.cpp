@@ -1,5 +1,7 @@
 #include "footprintinit.h"
 
+#include <QThreadPool>
+
 #include "Application.h"
 #include "IException.h"
 #include "ImagePolygon.h"
@@ -46,6 +48,7 @@ namespace Isis {
     QString sn = SerialNumber::Compose(*cube);
 
     ImagePolygon poly;
+    poly.SetThreadedFlag(ui.GetBoolean("THREADED"));
     if (ui.WasEntered("MAXEMISSION")) {
       poly.Emission(ui.GetDouble("MAXEMISSION"));
     }
@@ -140,11 +143,31 @@ namespace Isis {
     cube->deleteBlob("Polygon", sn);
     cube->write(poly);
 
+    PvlGroup results("Results");
     if (precision) {
-      PvlGroup results("Results");
       results.addKeyword(PvlKeyword("SINC", toString(sinc)));
       results.addKeyword(PvlKeyword("LINC", toString(linc)));
-      log->addGroup(results);
+    }
+    if (precision || ui.GetBoolean("THREADED")) {
+      results.addKeyword(PvlKeyword("CameraEvaluations", toString(poly.cameraEvaluations())));
+    }
+
+    PvlGroup warnings("Warnings");
+    int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+    if (ui.GetBoolean("THREADED") && poly.cameraCount() == 1 && threadCount > 1) {
+      QString message = "Unable to create a camera for each of the [" + toString(threadCount) +
+                        "] threads, the footprint was found with one thread. The SPICE "
+                        "must be attached to the cube (spiceinit ATTACH=yes) to use threads.";
+      warnings.addKeyword(PvlKeyword("Warning", message));
+    }
+
+    if (log) {
+      if (results.keywords() > 0) {
+        log->addGroup(results);
+      }
+      if (warnings.keywords() > 0) {
+        log->addGroup(warnings);
+      }
     }
 
     Process p;
@@ -95,6 +95,9 @@ namespace Isis {
     m.SetLowSaturationFlag(ui.GetBoolean("LOWSATURATION"));
     m.SetNullFlag(ui.GetBoolean("NULL"));
 
+    // Place the lines of each image with all of the available threads
+    m.SetThreadedFlag(true);
+
     // Start Process  
     if(!m.StartProcess(sInputFile)) {
       // Logs the cube if it falls outside of the given mosaic
@@ -0,0 +1,72 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "CacheTimeIndex.h"
+
+#include <algorithm>
+
+#include "IException.h"
+#include "IString.h"
+
+using namespace std;
+
+namespace Isis {
+  //! Creates an empty index
+  CacheTimeIndex::CacheTimeIndex() {
+    m_start = 0.0;
+    m_step = 1.0;
+  }
+
+
+  //! Destroys the index
+  CacheTimeIndex::~CacheTimeIndex() {
+  }
+
+
+  /**
+   * Indexes a cache.
+   *
+   * @param times The cache times, in increasing order
+   *
+   * @throws IException::Programmer "At least two cache times are needed"
+   * @throws IException::Programmer "The cache times must increase"
+   */
+  void CacheTimeIndex::build(const vector<double> &times) {
+    if (times.size() < 2) {
+      QString msg = "At least two cache times are needed to index a cache, not [" +
+                    toString((int)times.size()) + "]";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    for (size_t i = 1; i < times.size(); i++) {
+      if (!(times[i] > times[i - 1])) {
+        QString msg = "The cache times must increase to index a cache";
+        throw IException(IException::Programmer, msg, _FILEINFO_);
+      }
+    }
+
+    m_times = times;
+    int intervals = (int)times.size() - 1;
+    m_start = times.front();
+    m_step = (times.back() - times.front()) / intervals;
+
+    m_buckets.resize(intervals);
+    for (int bucket = 0; bucket < intervals; bucket++) {
+      double bucketStart = m_start + bucket * m_step;
+      int i = (int)(upper_bound(m_times.begin(), m_times.end(), bucketStart) -
+                    m_times.begin()) - 1;
+      m_buckets[bucket] = max(0, min(i, intervals - 1));
+    }
+  }
+
+
+  //! Empties the index
+  void CacheTimeIndex::clear() {
+    m_times.clear();
+    m_buckets.clear();
+  }
+}
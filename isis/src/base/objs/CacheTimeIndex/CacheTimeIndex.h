@@ -0,0 +1,70 @@
+#ifndef CacheTimeIndex_h
+#define CacheTimeIndex_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <vector>
+
+namespace Isis {
+  /**
+   * @brief Finds the interval of a sorted time cache that brackets a time
+   *
+   * The span of the cache is split into as many equal buckets as there are
+   * intervals, and each bucket remembers the first interval it overlaps.
+   * Finding a time's interval is then a division and, on average, less than
+   * one step forward instead of a binary search. SpicePosition and
+   * SpiceRotation use this to interpolate their caches in constant time.
+   *
+   * @ingroup SpiceInstrumentsAndCameras
+   */
+  class CacheTimeIndex {
+    public:
+      CacheTimeIndex();
+      ~CacheTimeIndex();
+
+      void build(const std::vector<double> &times);
+      void clear();
+
+      //! Returns true if the index hasn't been built
+      bool isEmpty() const {
+        return m_buckets.empty();
+      };
+
+      //! Returns the indexed times
+      const std::vector<double> &times() const {
+        return m_times;
+      };
+
+      /**
+       * Finds the interval that brackets a time. Times before the first cache
+       * time give the first interval and times after the last give the last,
+       * so interpolating in them extrapolates the cache.
+       *
+       * @param et The time to find
+       *
+       * @return @b int The index i of the interval from times()[i] to
+       *                times()[i + 1]
+       */
+      int interval(double et) const {
+        int last = (int)m_buckets.size() - 1;
+        double bucket = (et - m_start) / m_step;
+        int i = m_buckets[!(bucket > 0.0) ? 0 : (bucket >= last ? last : (int)bucket)];
+        while (i < last && m_times[i + 1] <= et) {
+          i++;
+        }
+        return i;
+      };
+
+    private:
+      std::vector<double> m_times; //!< The cache times, in increasing order
+      std::vector<int> m_buckets;  //!< The first interval of each bucket
+      double m_start;              //!< The first cache time
+      double m_step;               //!< The length of each bucket
+  };
+}
+
+#endif
@@ -1478,6 +1478,230 @@ namespace Isis {
   }
 
 
+  /**
+   * Sets the image to each of the sample/line pairs in turn and collects the
+   *   ground coordinates and photometric angles of every point. This is the
+   *   same as calling SetImage() for each point, but reuses the arrays in
+   *   points instead of allocating per point. For framing cameras without a
+   *   projection the detector, focal plane and distortion maps convert the
+   *   whole batch at once before each point is intersected with the target.
+   *   The camera is left set to the last point.
+   *
+   * @param samples The sample positions in the image
+   * @param lines The line positions in the image, one for each sample
+   * @param points The results, resized to the number of points
+   *
+   * @throws IException::Programmer "The sample and line arrays must be the same size"
+   */
+  void Camera::SetImages(const std::vector<double> &samples,
+                         const std::vector<double> &lines, PointBatch &points) {
+    if (samples.size() != lines.size()) {
+      QString msg = "The sample and line arrays must be the same size, got [" +
+                    toString((int)samples.size()) + "] samples and [" +
+                    toString((int)lines.size()) + "] lines";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    int count = samples.size();
+    points.resize(count);
+    if (count == 0) {
+      return;
+    }
+
+    if (!BatchMapsApply()) {
+      for (int i = 0; i < count; i++) {
+        FillPointBatch(i, SetImage(samples[i], lines[i]), points);
+      }
+      return;
+    }
+
+    m_batchX.resize(count);
+    m_batchY.resize(count);
+    for (int i = 0; i < count; i++) {
+      m_batchX[i] = p_alphaCube->AlphaSample(samples[i]);
+      m_batchY[i] = p_alphaCube->AlphaLine(lines[i]);
+      points.valid[i] = true;
+    }
+    // The last point goes through SetImage() so the camera is left set to it
+    points.valid[count - 1] = false;
+
+    p_detectorMap->SetParents(m_batchX, m_batchY, m_batchX, m_batchY, points.valid);
+    p_focalPlaneMap->SetDetectors(m_batchX, m_batchY, m_batchX, m_batchY, points.valid);
+    p_distortionMap->SetFocalPlanes(m_batchX, m_batchY, m_batchX, m_batchY, points.valid);
+    double z = p_distortionMap->UndistortedFocalPlaneZ();
+
+    ShapeModel *shape = target()->shape();
+    for (int i = 0; i < count - 1; i++) {
+      bool success = false;
+      if (points.valid[i]) {
+        p_childSample = samples[i];
+        p_childLine = lines[i];
+        p_pointComputed = true;
+        shape->clearSurfacePoint();
+        success = p_groundMap->SetFocalPlane(m_batchX[i], m_batchY[i], z);
+      }
+      FillPointBatch(i, success, points);
+    }
+
+    FillPointBatch(count - 1, SetImage(samples[count - 1], lines[count - 1]), points);
+  }
+
+
+  /**
+   * Sets the ground to each of the latitude/longitude pairs in turn and
+   *   collects the image positions and photometric angles of every point. This
+   *   is the same as calling SetUniversalGround() for each point, but reuses
+   *   the arrays in points instead of allocating per point. For framing
+   *   cameras without a projection each point is projected into the focal
+   *   plane and then the distortion, focal plane and detector maps convert
+   *   the whole batch at once. The camera is left set to the last point.
+   *
+   * @param latitudes The universal latitudes, in degrees
+   * @param longitudes The universal longitudes, in degrees, one for each
+   *                   latitude
+   * @param points The results, resized to the number of points
+   *
+   * @throws IException::Programmer "The latitude and longitude arrays must be the same size"
+   */
+  void Camera::SetUniversalGrounds(const std::vector<double> &latitudes,
+                                   const std::vector<double> &longitudes,
+                                   PointBatch &points) {
+    if (latitudes.size() != longitudes.size()) {
+      QString msg = "The latitude and longitude arrays must be the same size, got [" +
+                    toString((int)latitudes.size()) + "] latitudes and [" +
+                    toString((int)longitudes.size()) + "] longitudes";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    int count = latitudes.size();
+    points.resize(count);
+    if (count == 0) {
+      return;
+    }
+
+    if (!BatchMapsApply()) {
+      for (int i = 0; i < count; i++) {
+        FillPointBatch(i, SetUniversalGround(latitudes[i], longitudes[i]), points);
+      }
+      return;
+    }
+
+    // The ground coordinates and photometric angles don't depend on where the
+    // point falls in the image, so collect them while the camera is set to
+    // each point and convert the focal plane coordinates afterwards.
+    m_batchX.resize(count);
+    m_batchY.resize(count);
+    for (int i = 0; i < count - 1; i++) {
+      points.valid[i] = p_groundMap->SetGround(Latitude(latitudes[i], Angle::Degrees),
+                                               Longitude(longitudes[i], Angle::Degrees));
+      if (points.valid[i]) {
+        m_batchX[i] = p_groundMap->FocalPlaneX();
+        m_batchY[i] = p_groundMap->FocalPlaneY();
+        points.latitude[i] = UniversalLatitude();
+        points.longitude[i] = UniversalLongitude();
+        points.radius[i] = LocalRadius().meters();
+        points.phaseAngle[i] = PhaseAngle();
+        points.incidenceAngle[i] = IncidenceAngle();
+        points.emissionAngle[i] = EmissionAngle();
+      }
+    }
+    // The last point goes through SetUniversalGround() so the camera is left set to it
+    points.valid[count - 1] = false;
+
+    p_distortionMap->SetUndistortedFocalPlanes(m_batchX, m_batchY, m_batchX, m_batchY,
+                                               points.valid);
+    p_focalPlaneMap->SetFocalPlanes(m_batchX, m_batchY, m_batchX, m_batchY, points.valid);
+    p_detectorMap->SetDetectors(m_batchX, m_batchY, m_batchX, m_batchY, points.valid);
+
+    for (int i = 0; i < count - 1; i++) {
+      if (points.valid[i]) {
+        points.sample[i] = p_alphaCube->BetaSample(m_batchX[i]);
+        points.line[i] = p_alphaCube->BetaLine(m_batchY[i]);
+      }
+      else {
+        FillPointBatch(i, false, points);
+      }
+    }
+
+    FillPointBatch(count - 1, SetUniversalGround(latitudes[count - 1], longitudes[count - 1]),
+                   points);
+  }
+
+
+  /**
+   * Whether SetImages() and SetUniversalGrounds() can convert between the
+   *   image and the undistorted focal plane for a whole batch at once. That
+   *   is only the case for framing cameras that aren't projected, because the
+   *   other camera types change the time for each image line.
+   *
+   * @return @b bool True if the maps can convert a whole batch
+   */
+  bool Camera::BatchMapsApply() {
+    return (p_projection == NULL || p_ignoreProjection) && GetCameraType() == Framing &&
+           p_detectorMap && p_focalPlaneMap && p_distortionMap && p_groundMap;
+  }
+
+
+  /**
+   * Copies the state of the point the camera is set to into a PointBatch.
+   *
+   * @param index The index of the point in the batch
+   * @param success Whether setting the camera to the point succeeded
+   * @param points The batch to fill in
+   */
+  void Camera::FillPointBatch(int index, bool success, PointBatch &points) {
+    points.valid[index] = success;
+
+    if (!success) {
+      points.sample[index] = Null;
+      points.line[index] = Null;
+      points.latitude[index] = Null;
+      points.longitude[index] = Null;
+      points.radius[index] = Null;
+      points.phaseAngle[index] = Null;
+      points.incidenceAngle[index] = Null;
+      points.emissionAngle[index] = Null;
+      return;
+    }
+
+    points.sample[index] = Sample();
+    points.line[index] = Line();
+    points.latitude[index] = UniversalLatitude();
+    points.longitude[index] = UniversalLongitude();
+    points.radius[index] = LocalRadius().meters();
+    points.phaseAngle[index] = PhaseAngle();
+    points.incidenceAngle[index] = IncidenceAngle();
+    points.emissionAngle[index] = EmissionAngle();
+  }
+
+
+  /**
+   * @return The number of points in the batch
+   */
+  int Camera::PointBatch::size() const {
+    return valid.size();
+  }
+
+
+  /**
+   * Sets the number of points in the batch. Shrinking the batch keeps the
+   *   arrays' memory so later batches up to the old size don't allocate.
+   *
+   * @param count The number of points
+   */
+  void Camera::PointBatch::resize(int count) {
+    valid.resize(count);
+    sample.resize(count);
+    line.resize(count);
+    latitude.resize(count);
+    longitude.resize(count);
+    radius.resize(count);
+    phaseAngle.resize(count);
+    incidenceAngle.resize(count);
+    emissionAngle.resize(count);
+  }
+
+
   /**
    * This method will find the local normal at the current (sample, line) and
    * set it to the passed in array.
@@ -9,6 +9,8 @@ find files of those names at the top level of this repository. **/
 
 #include "Sensor.h"
 
+#include <vector>
+
 #include <QList>
 #include <QPointF>
 #include <QString>
@@ -232,6 +234,39 @@ namespace Isis {
 
   class Camera : public Sensor {
     public:
+      /**
+       * The results of a batch of SetImage() or SetUniversalGround() calls.
+       *   Every member has one entry per point, in the order the points were
+       *   given. The entries of points that didn't intersect the target are
+       *   Null, except for valid. The arrays are only reallocated when a batch
+       *   is larger than all previous batches, so reusing one PointBatch for
+       *   many batches doesn't allocate per point.
+       */
+      class PointBatch {
+        public:
+          //! Non-zero if the point intersected the target
+          std::vector<char> valid;
+          //! The image sample of the point
+          std::vector<double> sample;
+          //! The image line of the point
+          std::vector<double> line;
+          //! The universal latitude of the point, in degrees
+          std::vector<double> latitude;
+          //! The universal longitude (positive east, 0 to 360) of the point, in degrees
+          std::vector<double> longitude;
+          //! The local radius of the point, in meters
+          std::vector<double> radius;
+          //! The phase angle at the point, in degrees
+          std::vector<double> phaseAngle;
+          //! The incidence angle at the point, in degrees
+          std::vector<double> incidenceAngle;
+          //! The emission angle at the point, in degrees
+          std::vector<double> emissionAngle;
+
+          int size() const;
+          void resize(int count);
+      };
+
       // constructors
       Camera(Cube &cube);
 
@@ -250,6 +285,11 @@ namespace Isis {
       virtual bool SetGround(const SurfacePoint & surfacePt);
       bool SetRightAscensionDeclination(const double ra, const double dec);
 
+      void SetImages(const std::vector<double> &samples, const std::vector<double> &lines,
+                     PointBatch &points);
+      void SetUniversalGrounds(const std::vector<double> &latitudes,
+                               const std::vector<double> &longitudes, PointBatch &points);
+
       void LocalPhotometricAngles(Angle & phase, Angle & incidence,
                                   Angle & emission, bool &success);
 
@@ -505,6 +545,8 @@ namespace Isis {
       void ringRangeResolution();
       double ComputeAzimuth(const double lat, const double lon);
       bool RawFocalPlanetoImage();
+      void FillPointBatch(int index, bool success, PointBatch &points);
+      bool BatchMapsApply();
       // SetImage helper functions:
       // bool SetImageNoProjection(const double sample, const double line);
       bool SetImageMapProjection(const double sample, const double line, ShapeModel *shape);
@@ -568,6 +610,9 @@ namespace Isis {
       /** The ideal geometric tile size to end with when projecting*/
       int p_geometricTilingEndSize;
 
+      std::vector<double> m_batchX;          //!< Working x or sample coordinates for batches
+      std::vector<double> m_batchY;          //!< Working y or line coordinates for batches
+
   };
 };
 
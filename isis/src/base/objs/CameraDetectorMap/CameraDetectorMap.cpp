@@ -5,6 +5,8 @@ find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
 #include "CameraDetectorMap.h"
+
+
 #include "iTime.h"
 
 namespace Isis {
@@ -93,6 +95,78 @@ namespace Isis {
   }
 
 
+  /**
+   * Compute detector positions from many parent image coordinates
+   *
+   * This is the same as calling SetParent(sample, line) for each point whose
+   * valid entry is non-zero. Points whose valid entry is zero are skipped and
+   * the entry is set to zero for points that can't be converted. The output
+   * arrays must be the same size as the inputs and may be the same arrays as
+   * the inputs. The single point accessors, such as DetectorSample(), are not
+   * defined after this call.
+   *
+   * Subclasses whose SetParent() can convert many points faster than one at a
+   * time can override this.
+   *
+   * @param samples Sample numbers in the parent image
+   * @param lines Line numbers in the parent image
+   * @param detectorSamples The detector samples of the points
+   * @param detectorLines The detector lines of the points
+   * @param valid Non-zero for the points to convert
+   */
+  void CameraDetectorMap::SetParents(const std::vector<double> &samples,
+                                     const std::vector<double> &lines,
+                                     std::vector<double> &detectorSamples,
+                                     std::vector<double> &detectorLines,
+                                     std::vector<char> &valid) {
+    int count = samples.size();
+
+    for (int i = 0; i < count; i++) {
+      if (valid[i]) {
+        valid[i] = SetParent(samples[i], lines[i]);
+        detectorSamples[i] = DetectorSample();
+        detectorLines[i] = DetectorLine();
+      }
+    }
+  }
+
+
+  /**
+   * Compute parent positions from many detector coordinates
+   *
+   * This is the same as calling SetDetector() for each point whose valid
+   * entry is non-zero. Points whose valid entry is zero are skipped and the
+   * entry is set to zero for points that can't be converted. The output
+   * arrays must be the same size as the inputs and may be the same arrays as
+   * the inputs. The single point accessors, such as ParentSample(), are not
+   * defined after this call.
+   *
+   * Subclasses whose SetDetector() can convert many points faster than one at
+   * a time can override this.
+   *
+   * @param samples Sample numbers in the detector
+   * @param lines Line numbers in the detector
+   * @param parentSamples The parent image samples of the points
+   * @param parentLines The parent image lines of the points
+   * @param valid Non-zero for the points to convert
+   */
+  void CameraDetectorMap::SetDetectors(const std::vector<double> &samples,
+                                       const std::vector<double> &lines,
+                                       std::vector<double> &parentSamples,
+                                       std::vector<double> &parentLines,
+                                       std::vector<char> &valid) {
+    int count = samples.size();
+
+    for (int i = 0; i < count; i++) {
+      if (valid[i]) {
+        valid[i] = SetDetector(samples[i], lines[i]);
+        parentSamples[i] = ParentSample();
+        parentLines[i] = ParentLine();
+      }
+    }
+  }
+
+
   /** 
    * Compute new offsets whenenver summing or starting sample/lines change
    */
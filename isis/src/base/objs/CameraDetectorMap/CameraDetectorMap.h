@@ -7,6 +7,8 @@ find files of those names at the top level of this repository. **/
 #ifndef CameraDetectorMap_h
 #define CameraDetectorMap_h
 
+#include <vector>
+
 #include "Camera.h"
 
 namespace Isis {
@@ -59,6 +61,17 @@ namespace Isis {
       virtual bool SetDetector(const double sample, 
                                const double line);
 
+      virtual void SetParents(const std::vector<double> &samples,
+                              const std::vector<double> &lines,
+                              std::vector<double> &detectorSamples,
+                              std::vector<double> &detectorLines,
+                              std::vector<char> &valid);
+      virtual void SetDetectors(const std::vector<double> &samples,
+                                const std::vector<double> &lines,
+                                std::vector<double> &parentSamples,
+                                std::vector<double> &parentLines,
+                                std::vector<char> &valid);
+
       double AdjustedStartingSample() const;
 
       double AdjustedStartingLine() const;
@@ -7,6 +7,7 @@ find files of those names at the top level of this repository. **/
 #include "IString.h"
 #include "CameraDistortionMap.h"
 
+
 namespace Isis {
   /**
    * Camera distortion map constructor
@@ -186,6 +187,78 @@ namespace Isis {
   }
 
 
+  /**
+   * Compute many undistorted focal plane x/y
+   *
+   * This is the same as calling SetFocalPlane() for each point whose valid
+   * entry is non-zero. Points whose valid entry is zero are skipped and the
+   * entry is set to zero for points that can't be converted. The output
+   * arrays must be the same size as the inputs and may be the same arrays as
+   * the inputs. The single point accessors, such as UndistortedFocalPlaneX(),
+   * are not defined after this call.
+   *
+   * Subclasses whose SetFocalPlane() can convert many points faster than one
+   * at a time can override this.
+   *
+   * @param dxs Distorted focal plane x in millimeters
+   * @param dys Distorted focal plane y in millimeters
+   * @param uxs The undistorted focal plane x of the points in millimeters
+   * @param uys The undistorted focal plane y of the points in millimeters
+   * @param valid Non-zero for the points to convert
+   */
+  void CameraDistortionMap::SetFocalPlanes(const std::vector<double> &dxs,
+                                           const std::vector<double> &dys,
+                                           std::vector<double> &uxs,
+                                           std::vector<double> &uys,
+                                           std::vector<char> &valid) {
+    int count = dxs.size();
+
+    for (int i = 0; i < count; i++) {
+      if (valid[i]) {
+        valid[i] = SetFocalPlane(dxs[i], dys[i]);
+        uxs[i] = UndistortedFocalPlaneX();
+        uys[i] = UndistortedFocalPlaneY();
+      }
+    }
+  }
+
+
+  /**
+   * Compute many distorted focal plane x/y
+   *
+   * This is the same as calling SetUndistortedFocalPlane() for each point
+   * whose valid entry is non-zero. Points whose valid entry is zero are
+   * skipped and the entry is set to zero for points that can't be converted.
+   * The output arrays must be the same size as the inputs and may be the same
+   * arrays as the inputs. The single point accessors, such as FocalPlaneX(),
+   * are not defined after this call.
+   *
+   * Subclasses whose SetUndistortedFocalPlane() can convert many points faster
+   * than one at a time can override this.
+   *
+   * @param uxs Undistorted focal plane x in millimeters
+   * @param uys Undistorted focal plane y in millimeters
+   * @param dxs The distorted focal plane x of the points in millimeters
+   * @param dys The distorted focal plane y of the points in millimeters
+   * @param valid Non-zero for the points to convert
+   */
+  void CameraDistortionMap::SetUndistortedFocalPlanes(const std::vector<double> &uxs,
+                                                      const std::vector<double> &uys,
+                                                      std::vector<double> &dxs,
+                                                      std::vector<double> &dys,
+                                                      std::vector<char> &valid) {
+    int count = uxs.size();
+
+    for (int i = 0; i < count; i++) {
+      if (valid[i]) {
+        valid[i] = SetUndistortedFocalPlane(uxs[i], uys[i]);
+        dxs[i] = FocalPlaneX();
+        dys[i] = FocalPlaneY();
+      }
+    }
+  }
+
+
   /**
    * Retrieve the distortion coefficients used for this model.
    *
@@ -50,6 +50,17 @@ namespace Isis {
 
       virtual bool SetUndistortedFocalPlane(double ux, double uy);
 
+      virtual void SetFocalPlanes(const std::vector<double> &dxs,
+                                  const std::vector<double> &dys,
+                                  std::vector<double> &uxs,
+                                  std::vector<double> &uys,
+                                  std::vector<char> &valid);
+      virtual void SetUndistortedFocalPlanes(const std::vector<double> &uxs,
+                                             const std::vector<double> &uys,
+                                             std::vector<double> &dxs,
+                                             std::vector<double> &dys,
+                                             std::vector<char> &valid);
+
       std::vector<double> OpticalDistortionCoefficients() const;
 
       double ZDirection() const;
@@ -10,6 +10,8 @@ find files of those names at the top level of this repository. **/
 #include <QDirIterator>
 #include <QFileInfo>
 #include <QLibrary>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "CameraFactory.h"
 
@@ -31,6 +33,9 @@ namespace Isis {
   Plugin CameraFactory::m_cameraPlugin;
   bool CameraFactory::m_initialized = false;
 
+  //! Serializes creating cloned cameras, which reads the cube and NAIF keywords
+  static QMutex cloneMutex;
+
   /**
    * Creates a Camera object using Pvl Specifications
    *
@@ -114,6 +119,35 @@ namespace Isis {
   }
 
 
+  /**
+   * Creates a camera for a cube that is independent of the cube's camera() and
+   *   of every other clone, for use by one thread. The cached SPICE tables are
+   *   read again for every clone, so nothing a clone evaluates touches the NAIF
+   *   kernel pool or the state of another camera. Create the clones before
+   *   starting the threads that use them. Every camera still calls NAIF
+   *   routines, which keep their working variables and error state in
+   *   globals, so a thread must hold NaifStatus::mutex() while it evaluates
+   *   its clone.
+   *
+   * @param cube The cube to create the camera for. Its SPICE must be attached
+   *             as tables, or it must have a CSM state.
+   *
+   * @return Camera* The new camera, owned by the caller
+   *
+   * @throws IException::User "The SPICE of the cube must be attached to it"
+   */
+  Camera *CameraFactory::Clone(Cube &cube) {
+    if (!cube.label()->hasObject("NaifKeywords") && !cube.hasBlob("String", "CSMState")) {
+      QString msg = "The SPICE of the cube [" + cube.fileName() + "] must be attached to it "
+                    "(spiceinit ATTACH=yes) to create cameras for several threads";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+
+    QMutexLocker locker(&cloneMutex);
+    return Create(cube);
+  }
+
+
   /**
    * Reads the appropriate plugin file for the ISIS cameras, and scans the
    * directories specified in IsisPreferences for CSM cameras.
@@ -26,6 +26,14 @@ namespace Isis {
    * camera models to create a plugin without the need for recompiling all the
    * Isis applications that use camera models.
    *
+   * Camera models keep the state of the last point they were set to, so one
+   * camera can't be used by several threads. Clone() creates another camera
+   * for a cube that shares no state with the cube's own camera, one for each
+   * thread. Cloning requires SPICE attached to the cube as tables (or a CSM
+   * state), since evaluating cameras that read NAIF kernels isn't thread safe.
+   * The NAIF math routines the cameras call aren't thread safe either, so
+   * each thread holds NaifStatus::mutex() while it evaluates its clone.
+   *
    * @ingroup Camera
    *
    * @author 2005-05-10 Elizabeth Ribelin
@@ -52,6 +60,7 @@ namespace Isis {
   class CameraFactory {
     public:
       static Camera *Create(Cube &cube);
+      static Camera *Clone(Cube &cube);
       static int CameraVersion(Cube &cube);
       static int CameraVersion(Pvl &lab);
       static void initPlugin();
@@ -171,6 +171,76 @@ namespace Isis {
   }
 
 
+  /** Compute distorted focal plane coordinates from many detector positions
+   *
+   * This is the same as calling SetDetector() for each point whose valid
+   * entry is non-zero. Points whose valid entry is zero are skipped and the
+   * entry is set to zero for points that can't be converted. The output
+   * arrays must be the same size as the inputs and may be the same arrays as
+   * the inputs. The single point accessors, such as FocalPlaneX(), are not
+   * defined after this call.
+   *
+   * Subclasses whose SetDetector() can convert many points faster than one at
+   * a time can override this.
+   *
+   * @param samples Detector samples
+   * @param lines Detector lines
+   * @param focalPlaneXs The distorted focal plane x of the points in millimeters
+   * @param focalPlaneYs The distorted focal plane y of the points in millimeters
+   * @param valid Non-zero for the points to convert
+   */
+  void CameraFocalPlaneMap::SetDetectors(const std::vector<double> &samples,
+                                         const std::vector<double> &lines,
+                                         std::vector<double> &focalPlaneXs,
+                                         std::vector<double> &focalPlaneYs,
+                                         std::vector<char> &valid) {
+    int count = samples.size();
+
+    for (int i = 0; i < count; i++) {
+      if (valid[i]) {
+        valid[i] = SetDetector(samples[i], lines[i]);
+        focalPlaneXs[i] = FocalPlaneX();
+        focalPlaneYs[i] = FocalPlaneY();
+      }
+    }
+  }
+
+
+  /** Compute detector positions from many distorted focal plane coordinates
+   *
+   * This is the same as calling SetFocalPlane() for each point whose valid
+   * entry is non-zero. Points whose valid entry is zero are skipped and the
+   * entry is set to zero for points that can't be converted. The output
+   * arrays must be the same size as the inputs and may be the same arrays as
+   * the inputs. The single point accessors, such as DetectorSample(), are not
+   * defined after this call.
+   *
+   * Subclasses whose SetFocalPlane() can convert many points faster than one
+   * at a time can override this.
+   *
+   * @param dxs Distorted focal plane x in millimeters
+   * @param dys Distorted focal plane y in millimeters
+   * @param detectorSamples The detector samples of the points
+   * @param detectorLines The detector lines of the points
+   * @param valid Non-zero for the points to convert
+   */
+  void CameraFocalPlaneMap::SetFocalPlanes(const std::vector<double> &dxs,
+                                           const std::vector<double> &dys,
+                                           std::vector<double> &detectorSamples,
+                                           std::vector<double> &detectorLines,
+                                           std::vector<char> &valid) {
+    int count = dxs.size();
+
+    for (int i = 0; i < count; i++) {
+      if (valid[i]) {
+        valid[i] = SetFocalPlane(dxs[i], dys[i]);
+        detectorSamples[i] = DetectorSample();
+        detectorLines[i] = DetectorLine();
+      }
+    }
+  }
+
+
   /** Return the focal plane x dependency variable
    *
    * This method returns the image variable (sample or line) on
@@ -7,6 +7,8 @@ find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
 
+#include <vector>
+
 template<class T> class QVector;
 
 namespace Isis {
@@ -92,6 +94,17 @@ namespace Isis {
       virtual bool SetDetector(const double sample, const double line);
       virtual bool SetFocalPlane(const double dx, const double dy);
 
+      virtual void SetDetectors(const std::vector<double> &samples,
+                                const std::vector<double> &lines,
+                                std::vector<double> &focalPlaneXs,
+                                std::vector<double> &focalPlaneYs,
+                                std::vector<char> &valid);
+      virtual void SetFocalPlanes(const std::vector<double> &dxs,
+                                  const std::vector<double> &dys,
+                                  std::vector<double> &detectorSamples,
+                                  std::vector<double> &detectorLines,
+                                  std::vector<char> &valid);
+
       double FocalPlaneX() const;
       double FocalPlaneY() const;
       double DetectorSample() const;
@@ -21,6 +21,7 @@ find files of those names at the top level of this repository. **/
 #include "CameraFactory.h"
 #include "CubeAttribute.h"
 #include "CubeBsqHandler.h"
+#include "CubeCompressedTileHandler.h"
 #include "CubeTileHandler.h"
 #include "Endian.h"
 #include "FileName.h"
@@ -251,8 +252,14 @@ namespace Isis {
    * removed/deleted.
    */
   void Cube::close(bool removeIt) {
-    if (isOpen() && isReadWrite())
+    if (isOpen() && isReadWrite()) {
+      // Get all of the data on disk first, the IO handler may need to record
+      //   how it was stored in the labels
+      if (m_storesDnData)
+        m_ioHandler->clearCache(true);
+
       writeLabels();
+    }
 
     cleanUp(removeIt);
   }
@@ -315,8 +322,8 @@ namespace Isis {
     }
     else {
       if (isReadWrite()) {
-        writeLabels();
         m_ioHandler->clearCache(true);
+        writeLabels();
       }
 
       result->setExternalDnData(fileName());
@@ -560,14 +567,15 @@ namespace Isis {
       m_ioHandler = new CubeBsqHandler(dataFile(), m_virtualBandList, realDataFileLabel(),
                                        dataAlreadyOnDisk);
     }
+    else if (m_format == CompressedTile) {
+      m_ioHandler = new CubeCompressedTileHandler(dataFile(), m_virtualBandList,
+                                                  realDataFileLabel(), dataAlreadyOnDisk);
+    }
     else {
       m_ioHandler = new CubeTileHandler(dataFile(), m_virtualBandList, realDataFileLabel(),
                                         dataAlreadyOnDisk);
     }
 
-    if (m_storesDnData)
-      m_ioHandler->updateLabels(*m_label);
-
     // Write the labels
     writeLabels();
   }
@@ -742,6 +750,10 @@ namespace Isis {
       m_ioHandler = new CubeBsqHandler(dataFile(), m_virtualBandList,
           realDataFileLabel(), true);
     }
+    else if (m_format == CompressedTile) {
+      m_ioHandler = new CubeCompressedTileHandler(dataFile(), m_virtualBandList,
+          realDataFileLabel(), true);
+    }
     else {
       m_ioHandler = new CubeTileHandler(dataFile(), m_virtualBandList,
           realDataFileLabel(), true);
@@ -825,8 +837,35 @@ namespace Isis {
       throw IException(IException::Programmer, msg, _FILEINFO_);
     }
 
+    // Nothing can write to a read-only cube, so its IO handler lets many
+    //   threads read it at once
+    if (isReadOnly()) {
+      m_ioHandler->read(bufferToFill);
+    }
+    else {
+      QMutexLocker locker(m_mutex);
+      m_ioHandler->read(bufferToFill);
+    }
+  }
+
+
+  /**
+   * This method will start reading the area of the cube covered by the Buffer
+   * in the background, so that a later read() of the same area is faster.
+   * The buffer is not filled. This should be called with the buffers that are
+   * going to be read next, for example a copy of a BufferManager advanced a
+   * few positions ahead of the one being read.
+   *
+   * @param buffer Buffer whose area will be read soon
+   */
+  void Cube::prefetch(const Buffer &buffer) const {
+    if (!isOpen()) {
+      string msg = "Try opening a file before you read it";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
     QMutexLocker locker(m_mutex);
-    m_ioHandler->read(bufferToFill);
+    m_ioHandler->prefetch(buffer);
   }
 
 
@@ -1050,10 +1089,10 @@ namespace Isis {
 
   /**
    * Used prior to the Create method, this will specify the format of the cube,
-   * either band, sequential or tiled.
+   * either band sequential, tiled or compressed tiled.
    * If not invoked, a tiled file will be created.
    *
-   * @param format An enumeration of either Bsq or Tile.
+   * @param format An enumeration of either Bsq, Tile or CompressedTile.
    */
   void Cube::setFormat(Format format) {
     openCheck();
@@ -2100,6 +2139,9 @@ namespace Isis {
       if ((QString) core["Format"] == "BandSequential") {
         m_format = Bsq;
       }
+      else if ((QString) core["Format"] == "CompressedTile") {
+        m_format = CompressedTile;
+      }
       else {
         m_format = Tile;
       }
@@ -2399,6 +2441,12 @@ namespace Isis {
     // Set the pvl's format template
     m_label->setFormatTemplate(m_formatTemplateFile->original());
 
+    // Let the IO handler describe how the cube data is stored
+    if (m_storesDnData) {
+      QMutexLocker locker(m_mutex);
+      m_ioHandler->updateLabels(*m_label);
+    }
+
     // Write them with attached data
     if (m_attached) {
       QMutexLocker locker(m_mutex);
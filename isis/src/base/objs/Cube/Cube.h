@@ -222,7 +222,15 @@ namespace Isis {
          * The symbol '*' denotes tile boundaries.
          * The symbols '-' and '|' denote cube boundaries.
          */
-        Tile
+        Tile,
+        /**
+         * Cubes are split into tiles just like the Tile format, but each tile
+         *   is compressed on its own and tiles that are entirely NULL are not
+         *   stored at all. The cube data starts with an index of where each
+         *   tile is in the file. This makes cubes that are mostly NULL or low
+         *   entropy, like large mosaics, much smaller on disk.
+         */
+        CompressedTile
       };
 
       void fromIsd(const FileName &fileName, Pvl &label, nlohmann::json &isd, QString access);
@@ -248,6 +256,7 @@ namespace Isis {
       void read(Blob &blob,
                 const std::vector<PvlKeyword> keywords = std::vector<PvlKeyword>()) const;
       void read(Buffer &rbuf) const;
+      void prefetch(const Buffer &buffer) const;
       void write(Blob &blob, bool overwrite=true);
       void write(Buffer &wbuf);
 
@@ -121,6 +121,18 @@ namespace Isis {
   }
 
 
+  /**
+   * Get a view of the chunk inside of the memory mapped data file. Chunks are
+   *   stored contiguously, so this is just an offset into the mapping.
+   *
+   * @param chunkIndex The index of the chunk to find
+   * @return The raw chunk data, or NULL if the data file isn't memory mapped
+   */
+  const char *CubeBsqHandler::mappedChunk(int chunkIndex) const {
+    return mappedFileData(getChunkStartByte(chunkIndex));
+  }
+
+
   /**
    * This method attempts to compute a good chunk line size. Chunk band size is
    * always 1 and chunk sample size is always number of samples in the cube for this format.
@@ -155,6 +167,17 @@ namespace Isis {
    * @return The file position to start reading or writing at
    */
   BigInt CubeBsqHandler::getChunkStartByte(const RawCubeChunk &chunk) const {
-    return getDataStartByte() + getChunkIndex(chunk) * getBytesPerChunk();
+    return getChunkStartByte(getChunkIndex(chunk));
+  }
+
+
+  /**
+   * This is a helper method that goes from chunk index to file position.
+   *
+   * @param chunkIndex The index of the chunk to locate in the file.
+   * @return The file position to start reading or writing at
+   */
+  BigInt CubeBsqHandler::getChunkStartByte(int chunkIndex) const {
+    return getDataStartByte() + chunkIndex * getBytesPerChunk();
   }
 }
@@ -49,6 +49,7 @@ namespace Isis {
     protected:
       virtual void readRaw(RawCubeChunk &chunkToFill);
       virtual void writeRaw(const RawCubeChunk &chunkToWrite);
+      virtual const char *mappedChunk(int chunkIndex) const;
 
     private:
       /**
@@ -69,6 +70,7 @@ namespace Isis {
 
       int findGoodSize(int maxSize, int dimensionSize) const;
       BigInt getChunkStartByte(const RawCubeChunk &chunk) const;
+      BigInt getChunkStartByte(int chunkIndex) const;
   };
 }
 
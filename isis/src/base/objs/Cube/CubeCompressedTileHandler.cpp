@@ -0,0 +1,352 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "CubeCompressedTileHandler.h"
+
+#include <algorithm>
+
+#include <QByteArray>
+#include <QFile>
+#include <QVector>
+#include <QtEndian>
+
+#include "IException.h"
+#include "IString.h"
+#include "Pvl.h"
+#include "PvlObject.h"
+#include "PvlKeyword.h"
+#include "RawCubeChunk.h"
+
+using namespace std;
+
+namespace Isis {
+  /**
+   * Construct a compressed tile handler. New cubes get a tile index with
+   *   every tile marked as NULL; existing cubes have their tile index read in.
+   *   The data file is never sized to hold the uncompressed tiles, it only
+   *   grows as compressed tiles are written.
+   *
+   * @param dataFile The file with cube DN data in it
+   * @param virtualBandList The mapping from virtual band to physical band, see
+   *          CubeIoHandler's description.
+   * @param labels The Pvl labels for the cube
+   * @param alreadyOnDisk True if the cube is allocated on the disk, false
+   *          otherwise
+   */
+  CubeCompressedTileHandler::CubeCompressedTileHandler(QFile * dataFile,
+      const QList<int> *virtualBandList, const Pvl &labels, bool alreadyOnDisk)
+      : CubeTileHandler(dataFile, virtualBandList, labels, alreadyOnDisk, false) {
+    m_tileStartBytes = new QVector<BigInt>(getChunkCount(), 0);
+    m_tileByteCounts = new QVector<BigInt>(getChunkCount(), 0);
+
+    if (alreadyOnDisk) {
+      readTileIndex();
+    }
+    else {
+      writeTileIndex();
+    }
+
+    m_dataEndByte = max(getDataFile()->size(),
+                        getDataStartByte() + getTileIndexByteCount());
+  }
+
+
+  /**
+   * Writes all data from memory to disk. This has to happen here, while our
+   *   readRaw() and writeRaw() are still the ones that get called.
+   */
+  CubeCompressedTileHandler::~CubeCompressedTileHandler() {
+    clearCache();
+
+    delete m_tileStartBytes;
+    m_tileStartBytes = NULL;
+
+    delete m_tileByteCounts;
+    m_tileByteCounts = NULL;
+  }
+
+
+  /**
+   * Update the cube labels so that this cube indicates what tile size and
+   *   compression it used.
+   *
+   * @param labels The "Core" object in this Pvl will be updated
+   */
+  void CubeCompressedTileHandler::updateLabels(Pvl &labels) {
+    CubeTileHandler::updateLabels(labels);
+
+    PvlObject &core = labels.findObject("IsisCube").findObject("Core");
+    core.addKeyword(PvlKeyword("Format", "CompressedTile"),
+                    PvlContainer::Replace);
+    core.addKeyword(PvlKeyword("TileCompression", "Zlib"),
+                    PvlContainer::Replace);
+  }
+
+
+  /**
+   * @return The number of bytes the tile index and the tiles written so far
+   *   take up. Unlike uncompressed cubes, this grows as tiles are written.
+   */
+  BigInt CubeCompressedTileHandler::getDataSize() const {
+    return m_dataEndByte - getDataStartByte();
+  }
+
+
+  void CubeCompressedTileHandler::readRaw(RawCubeChunk &chunkToFill) {
+    int tileIndex = getChunkIndex(chunkToFill);
+    BigInt startByte = (*m_tileStartBytes)[tileIndex];
+    BigInt byteCount = (*m_tileByteCounts)[tileIndex];
+
+    // NULL tiles aren't stored
+    if (startByte == 0) {
+      RawCubeChunk *nullChunk = getNullChunk(tileIndex);
+      chunkToFill.setRawData(nullChunk->getRawData());
+      delete nullChunk;
+      return;
+    }
+
+    bool success = false;
+
+    QFile * dataFile = getDataFile();
+    if(dataFile->seek(startByte)) {
+      QByteArray tileData = dataFile->read(byteCount);
+
+      if(tileData.size() == byteCount) {
+        // Tiles that didn't compress are stored as they are
+        if (byteCount != chunkToFill.getByteCount()) {
+          tileData = qUncompress(tileData);
+        }
+
+        if (tileData.size() == chunkToFill.getByteCount()) {
+          chunkToFill.setRawData(tileData);
+          success = true;
+        }
+      }
+    }
+
+    if(!success) {
+      IString msg = "Reading the compressed tile [" + toString(tileIndex) +
+          "] from the file [" + dataFile->fileName() + "] failed with reading [" +
+          QString::number(byteCount) + "] bytes at position [" +
+          QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  void CubeCompressedTileHandler::writeRaw(const RawCubeChunk &chunkToWrite) {
+    int tileIndex = getChunkIndex(chunkToWrite);
+    const QByteArray &rawData = chunkToWrite.getRawData();
+
+    // NULL tiles aren't stored; leave the tile data empty for them
+    QByteArray tileData;
+    RawCubeChunk *nullChunk = getNullChunk(tileIndex);
+    if (rawData != nullChunk->getRawData()) {
+      // Favor speed, most of the savings come from NULL and low entropy tiles
+      tileData = qCompress(rawData, 1);
+
+      if (tileData.size() >= rawData.size()) {
+        tileData = rawData;
+      }
+    }
+    delete nullChunk;
+
+    BigInt startByte = 0;
+    QFile * dataFile = getDataFile();
+
+    if (!tileData.isEmpty()) {
+      startByte = (*m_tileStartBytes)[tileIndex];
+
+      // Rewrite the tile in place when it still fits, otherwise append it
+      if (startByte == 0 || tileData.size() > (*m_tileByteCounts)[tileIndex]) {
+        startByte = max(dataFile->size(), m_dataEndByte);
+      }
+
+      bool success = false;
+      if(dataFile->seek(startByte)) {
+        BigInt dataWritten = dataFile->write(tileData);
+
+        if(dataWritten == tileData.size()) {
+          success = true;
+        }
+      }
+
+      if(!success) {
+        IString msg = "Writing the compressed tile [" + toString(tileIndex) +
+            "] to the file [" + dataFile->fileName() + "] failed with writing [" +
+            QString::number(tileData.size()) + "] bytes at position [" +
+            QString::number(startByte) + "]";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+
+      m_dataEndByte = max(m_dataEndByte, startByte + tileData.size());
+    }
+
+    // Tiles that stay NULL don't change their index entries
+    if (startByte != (*m_tileStartBytes)[tileIndex] ||
+        tileData.size() != (*m_tileByteCounts)[tileIndex]) {
+      (*m_tileStartBytes)[tileIndex] = startByte;
+      (*m_tileByteCounts)[tileIndex] = tileData.size();
+      writeTileIndexEntry(tileIndex);
+    }
+  }
+
+
+  /**
+   * Tiles that were never written are already NULL in the tile index, so
+   *   there is nothing to do for them.
+   *
+   * @param chunkIndex The index of the tile that needs to be NULL
+   */
+  void CubeCompressedTileHandler::writeNullChunk(int chunkIndex) {
+  }
+
+
+  /**
+   * Compressed tiles can't be converted straight out of the memory mapped
+   *   file.
+   *
+   * @param chunkIndex The index of the chunk to find
+   * @return NULL
+   */
+  const char *CubeCompressedTileHandler::mappedChunk(int chunkIndex) const {
+    return NULL;
+  }
+
+
+  /**
+   * @return The number of bytes in the tile index at the start of the data
+   */
+  BigInt CubeCompressedTileHandler::getTileIndexByteCount() const {
+    return (BigInt)getChunkCount() * 2 * sizeof(qint64);
+  }
+
+
+  /**
+   * Read the tile index from the start of the cube data.
+   */
+  void CubeCompressedTileHandler::readTileIndex() {
+    BigInt startByte = getDataStartByte();
+    BigInt indexByteCount = getTileIndexByteCount();
+    bool success = false;
+
+    QFile * dataFile = getDataFile();
+    if(dataFile->seek(startByte)) {
+      QByteArray indexData = dataFile->read(indexByteCount);
+
+      if(indexData.size() == indexByteCount) {
+        const char *entry = indexData.constData();
+
+        for (int i = 0; i < m_tileStartBytes->size(); i++) {
+          (*m_tileStartBytes)[i] = qFromLittleEndian<qint64>(entry);
+          (*m_tileByteCounts)[i] =
+              qFromLittleEndian<qint64>(entry + sizeof(qint64));
+          entry += 2 * sizeof(qint64);
+        }
+
+        success = true;
+      }
+    }
+
+    // Every stored tile has to be after the index and inside of the file
+    BigInt dataStartByte = startByte + indexByteCount;
+    for (int i = 0; success && i < m_tileStartBytes->size(); i++) {
+      BigInt tileStartByte = (*m_tileStartBytes)[i];
+      BigInt tileByteCount = (*m_tileByteCounts)[i];
+
+      if (tileStartByte == 0 && tileByteCount == 0) {
+        continue;
+      }
+
+      if (tileStartByte < dataStartByte || tileByteCount <= 0 ||
+          tileStartByte + tileByteCount > dataFile->size()) {
+        IString msg = "The tile index of the file [" + dataFile->fileName() +
+            "] puts the compressed tile [" + toString(i) + "] at [" +
+            QString::number(tileByteCount) + "] bytes from position [" +
+            QString::number(tileStartByte) + "], which is not inside of the [" +
+            QString::number((BigInt)dataFile->size()) + "] byte file";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+    }
+
+    if(!success) {
+      IString msg = "Reading the tile index from the file [" +
+          dataFile->fileName() + "] failed with reading [" +
+          QString::number(indexByteCount) + "] bytes at position [" +
+          QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Write the entire tile index to the start of the cube data.
+   */
+  void CubeCompressedTileHandler::writeTileIndex() {
+    BigInt startByte = getDataStartByte();
+    QByteArray indexData(getTileIndexByteCount(), '\0');
+    char *entry = indexData.data();
+
+    for (int i = 0; i < m_tileStartBytes->size(); i++) {
+      qToLittleEndian<qint64>((*m_tileStartBytes)[i], entry);
+      qToLittleEndian<qint64>((*m_tileByteCounts)[i], entry + sizeof(qint64));
+      entry += 2 * sizeof(qint64);
+    }
+
+    bool success = false;
+
+    QFile * dataFile = getDataFile();
+    if(dataFile->seek(startByte)) {
+      BigInt dataWritten = dataFile->write(indexData);
+
+      if(dataWritten == indexData.size()) {
+        success = true;
+      }
+    }
+
+    if(!success) {
+      IString msg = "Writing the tile index to the file [" +
+          dataFile->fileName() + "] failed with writing [" +
+          QString::number(indexData.size()) + "] bytes at position [" +
+          QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Write a single tile's entry in the tile index to the disk.
+   *
+   * @param tileIndex The tile whose position in the file changed
+   */
+  void CubeCompressedTileHandler::writeTileIndexEntry(int tileIndex) {
+    BigInt startByte = getDataStartByte() + (BigInt)tileIndex * 2 * sizeof(qint64);
+    QByteArray entryData(2 * sizeof(qint64), '\0');
+    qToLittleEndian<qint64>((*m_tileStartBytes)[tileIndex], entryData.data());
+    qToLittleEndian<qint64>((*m_tileByteCounts)[tileIndex],
+                            entryData.data() + sizeof(qint64));
+
+    bool success = false;
+
+    QFile * dataFile = getDataFile();
+    if(dataFile->seek(startByte)) {
+      BigInt dataWritten = dataFile->write(entryData);
+
+      if(dataWritten == entryData.size()) {
+        success = true;
+      }
+    }
+
+    if(!success) {
+      IString msg = "Writing the tile index entry for tile [" +
+          toString(tileIndex) + "] to the file [" + dataFile->fileName() +
+          "] failed with writing [" + QString::number(entryData.size()) +
+          "] bytes at position [" + QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#ifndef CubeCompressedTileHandler_h
+#define CubeCompressedTileHandler_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "CubeTileHandler.h"
+
+template <typename T> class QVector;
+
+namespace Isis {
+
+  /**
+   * @brief IO Handler for Isis Cubes using the compressed tile format.
+   *
+   * Cubes are split into tiles exactly like the tile format, but each tile is
+   *   compressed (zlib) on its own before it goes to the disk. Since the tiles
+   *   no longer have a fixed size, the cube data starts with a tile index. The
+   *   index has one entry per tile, in tile order, and each entry is a little
+   *   endian 64-bit start byte followed by a little endian 64-bit byte count.
+   *   The tiles follow the index in the order they were written.
+   *
+   * A tile that is entirely NULL is never stored; its index entry is all
+   *   zeros and reading it does not touch the disk. A tile that doesn't get
+   *   smaller when compressed is stored uncompressed, which is recognizable
+   *   because its byte count is the uncompressed tile size.
+   *
+   * A tile that is rewritten is stored in its old place if it still fits,
+   *   otherwise it is appended to the end of the file. The space it used to
+   *   take up is not reclaimed.
+   *
+   * @ingroup LowLevelCubeIO
+   */
+  class CubeCompressedTileHandler : public CubeTileHandler {
+    public:
+      CubeCompressedTileHandler(QFile * dataFile,
+          const QList<int> *virtualBandList, const Pvl &label,
+          bool alreadyOnDisk);
+      ~CubeCompressedTileHandler();
+
+      void updateLabels(Pvl &label);
+      BigInt getDataSize() const;
+
+    protected:
+      virtual void readRaw(RawCubeChunk &chunkToFill);
+      virtual void writeRaw(const RawCubeChunk &chunkToWrite);
+      virtual void writeNullChunk(int chunkIndex);
+      virtual const char *mappedChunk(int chunkIndex) const;
+
+    private:
+      /**
+       * Disallow copying of this object.
+       *
+       * @param other The object to copy.
+       */
+      CubeCompressedTileHandler(const CubeCompressedTileHandler &other);
+
+      /**
+       * Disallow assignments of this object
+       *
+       * @param other The CubeCompressedTileHandler on the right-hand side of
+       *              the assignment that we are copying into *this.
+       * @return A reference to *this.
+       */
+      CubeCompressedTileHandler &operator=(
+          const CubeCompressedTileHandler &other);
+
+      BigInt getTileIndexByteCount() const;
+      void readTileIndex();
+      void writeTileIndex();
+      void writeTileIndexEntry(int tileIndex);
+
+    private:
+      //! The file position of each tile, 0 if the tile is all NULL
+      QVector<BigInt> *m_tileStartBytes;
+
+      //! The number of bytes each tile takes up in the file
+      QVector<BigInt> *m_tileByteCounts;
+
+      //! The file position just past the last tile written
+      BigInt m_dataEndByte;
+  };
+}
+
+#endif
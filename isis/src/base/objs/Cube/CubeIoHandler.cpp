@@ -10,17 +10,22 @@ find files of those names at the top level of this repository. **/
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iomanip>
 
 #include <QDebug>
 #include <QFile>
 #include <QList>
 #include <QListIterator>
+#include <QMap>
 #include <QMapIterator>
 #include <QMutex>
 #include <QPair>
+#include <QReadWriteLock>
 #include <QRect>
+#include <QSet>
 #include <QTime>
+#include <QtEndian>
 
 #include "Area3D.h"
 #include "Brick.h"
@@ -44,6 +49,23 @@ find files of those names at the top level of this repository. **/
 using namespace std;
 
 namespace Isis {
+  /**
+   * One part of the chunk cache. During concurrent reads the mutex must be
+   *   held while using any of the other members.
+   */
+  class CubeIoHandler::ChunkCacheShard {
+    public:
+      //! Protects this shard during concurrent reads
+      QMutex mutex;
+      //! The cached chunks in this shard, keyed by chunk index
+      QMap<int, RawCubeChunk *> chunks;
+      //! Chunks that were read by prefetch() and have not been used yet
+      QSet<int> prefetchedChunks;
+      //! Chunks used by concurrent reads since the last minimizeCache()
+      QSet<int> recentlyUsedChunks;
+  };
+
+
   /**
    * Creates a new CubeIoHandler using a RegionalCachingAlgorithm. The chunk
    *   sizes must be set by a child in its constructor.
@@ -65,13 +87,17 @@ namespace Isis {
     m_byteSwapper = NULL;
     m_cachingAlgorithms = NULL;
     m_dataIsOnDiskMap = NULL;
-    m_rawData = NULL;
+    m_chunkCache = NULL;
+    m_chunkCacheLock = NULL;
     m_virtualBands = NULL;
     m_nullChunkData = NULL;
     m_lastProcessByLineChunks = NULL;
     m_writeCache = NULL;
     m_ioThreadPool = NULL;
     m_writeThreadMutex = NULL;
+    m_mappedFile = NULL;
+    m_mappedFileSize = 0;
+    m_prefetchThreadPool = NULL;
 
     try {
       if (!dataFile) {
@@ -91,9 +117,23 @@ namespace Isis {
         m_ioThreadPool->setMaxThreadCount(1);
       }
 
+      m_useMemoryMappedRead = false;
+      if (performancePrefs.hasKeyword("CubeReadMemoryMap")) {
+        IString memoryMapPerfOpt = performancePrefs["CubeReadMemoryMap"][0];
+        m_useMemoryMappedRead = (memoryMapPerfOpt.DownCase() == "readonly");
+      }
+
       m_consecutiveOverflowCount = 0;
       m_lastOperationWasWrite = false;
-      m_rawData = new QMap<int, RawCubeChunk *>;
+
+      // Enough shards that threads working on neighboring chunks rarely need
+      //   the same lock
+      m_chunkCache = new QList<ChunkCacheShard *>;
+      for (int i = 0; i < 16; i++) {
+        m_chunkCache->append(new ChunkCacheShard);
+      }
+      m_chunkCacheLock = new QReadWriteLock;
+
       m_writeCache = new QPair< QMutex *, QList<Buffer *> >;
       m_writeCache->first = new QMutex;
       m_writeThreadMutex = new QMutex;
@@ -103,6 +143,8 @@ namespace Isis {
       m_cachingAlgorithms->append(new RegionalCachingAlgorithm);
 
       m_dataFile = dataFile;
+      m_concurrentReads = alreadyOnDisk &&
+                          !(m_dataFile->openMode() & QIODevice::WriteOnly);
 
       const PvlObject &core = label.findObject("IsisCube").findObject("Core");
       const PvlGroup &pixelGroup = core.findGroup("Pixels");
@@ -155,7 +197,7 @@ namespace Isis {
    *   because we can no longer do IO by the time this destructor is called.
    */
   CubeIoHandler::~CubeIoHandler() {
-    ASSERT( m_rawData ? m_rawData->size() == 0 : 1 );
+    ASSERT( m_chunkCache ? cachedChunkCount() == 0 : 1 );
 
     if (m_ioThreadPool)
       m_ioThreadPool->waitForDone();
@@ -163,6 +205,17 @@ namespace Isis {
     delete m_ioThreadPool;
     m_ioThreadPool = NULL;
 
+    if (m_prefetchThreadPool)
+      m_prefetchThreadPool->waitForDone();
+
+    delete m_prefetchThreadPool;
+    m_prefetchThreadPool = NULL;
+
+    if (m_mappedFile) {
+      m_dataFile->unmap(m_mappedFile);
+      m_mappedFile = NULL;
+    }
+
     delete m_dataIsOnDiskMap;
     m_dataIsOnDiskMap = NULL;
 
@@ -175,20 +228,26 @@ namespace Isis {
       m_cachingAlgorithms = NULL;
     }
 
-    if (m_rawData) {
-      QMapIterator<int, RawCubeChunk *> it(*m_rawData);
-      while (it.hasNext()) {
-        // Unwritten data here means it cannot be written :(
-        ASSERT(0);
-        it.next();
+    if (m_chunkCache) {
+      foreach (ChunkCacheShard *shard, *m_chunkCache) {
+        QMapIterator<int, RawCubeChunk *> it(shard->chunks);
+        while (it.hasNext()) {
+          // Unwritten data here means it cannot be written :(
+          ASSERT(0);
+          it.next();
 
-        if(it.value())
-          delete it.value();
+          if(it.value())
+            delete it.value();
+        }
+        delete shard;
       }
-      delete m_rawData;
-      m_rawData = NULL;
+      delete m_chunkCache;
+      m_chunkCache = NULL;
     }
 
+    delete m_chunkCacheLock;
+    m_chunkCacheLock = NULL;
+
     if (m_writeCache) {
       delete m_writeCache->first;
       m_writeCache->first = NULL;
@@ -228,10 +287,6 @@ namespace Isis {
    * @param bufferToFill The buffer to populate with cube data.
    */
   void CubeIoHandler::read(Buffer &bufferToFill) const {
-    // We need to record the current chunk count size so we can use
-    // it to evaluate if the cache should be minimized
-    int lastChunkCount = m_rawData->size();
-
     if (m_lastOperationWasWrite) {
       // Do the remaining writes
       flushWriteCache(true);
@@ -246,8 +301,25 @@ namespace Isis {
       }
     }
 
+    // MEMORY MAPPED CUBE READ - this never touches the chunk cache
+    if (m_mappedFile && readMapped(bufferToFill)) {
+      return;
+    }
+
+    // CONCURRENT CUBE READ - nothing can write to this cube, so threads only
+    //   wait on each other when they need the same part of the cache
+    if (m_concurrentReads) {
+      concurrentRead(bufferToFill);
+      return;
+    }
+
     QMutexLocker lock(m_writeThreadMutex);
 
+    // We need to record the current chunk count size so we can use
+    // it to evaluate if the cache should be minimized. This has to happen
+    // after locking because prefetch() may be filling the cache.
+    int lastChunkCount = cachedChunkCount();
+
     // NON-THREADED CUBE READ
     QList<RawCubeChunk *> cubeChunks;
     QList<int > chunkBands;
@@ -315,12 +387,22 @@ namespace Isis {
       chunkBands = chunkInfo.second;
     }
 
+    bool usedPrefetchedChunk = false;
     for (int i = 0; i < cubeChunks.size(); i++) {
       writeIntoDouble(*cubeChunks[i], bufferToFill, chunkBands[i]);
+
+      int chunkIndex = getChunkIndex(*cubeChunks[i]);
+      ChunkCacheShard &shard = chunkCacheShard(chunkIndex);
+      QMutexLocker shardLock(&shard.mutex);
+      if (!shard.prefetchedChunks.isEmpty() &&
+          shard.prefetchedChunks.remove(chunkIndex)) {
+        usedPrefetchedChunk = true;
+      }
     }
 
-    // Minimize the cache if it changed in size
-    if (lastChunkCount != m_rawData->size()) {
+    // Minimize the cache if it changed in size. Prefetched chunks were added
+    //   to the cache before this read, so they count as a change too.
+    if (lastChunkCount != cachedChunkCount() || usedPrefetchedChunk) {
       minimizeCache(cubeChunks, bufferToFill);
     }
   }
@@ -336,6 +418,10 @@ namespace Isis {
    * @param bufferToWrite The buffer to get cube data from.
    */
   void CubeIoHandler::write(const Buffer &bufferToWrite) {
+    // Outstanding prefetches must not race with the write cache
+    if (m_prefetchThreadPool)
+      m_prefetchThreadPool->waitForDone();
+
     m_lastOperationWasWrite = true;
 
     if (m_ioThreadPool) {
@@ -356,6 +442,32 @@ namespace Isis {
   }
 
 
+  /**
+   * Start reading the cube data for the given buffer's area into the cache in
+   *   the background. This does not fill the buffer; a later read() of the
+   *   same area will find the data already cached. This is purely an
+   *   optimization hint and is ignored when it can't help (cubes that are
+   *   being written to, cubes that are memory mapped, etc.).
+   *
+   * @param bufferToPrefetch The buffer whose area will be read soon
+   */
+  void CubeIoHandler::prefetch(const Buffer &bufferToPrefetch) const {
+    if (m_mappedFile || m_dataIsOnDiskMap || m_lastOperationWasWrite) {
+      return;
+    }
+
+    if (!m_prefetchThreadPool) {
+      m_prefetchThreadPool = new QThreadPool;
+      m_prefetchThreadPool->setMaxThreadCount(1);
+    }
+
+    m_prefetchThreadPool->start(new ChunkPrefetcher(this,
+        bufferToPrefetch.Sample(), bufferToPrefetch.SampleDimension(),
+        bufferToPrefetch.Line(), bufferToPrefetch.LineDimension(),
+        bufferToPrefetch.Band(), bufferToPrefetch.BandDimension()));
+  }
+
+
   /**
    * This will add the given caching algorithm to the list of attempted caching
    *   algorithms. The algorithms are tried in the opposite order that they
@@ -382,10 +494,20 @@ namespace Isis {
    */
   void CubeIoHandler::clearCache(bool blockForWriteCache) const {
     if (blockForWriteCache) {
+      // Nothing may be read into the cache while we're clearing it
+      if (m_prefetchThreadPool)
+        m_prefetchThreadPool->waitForDone();
+
       // Start the rest of the writes
       flushWriteCache(true);
     }
 
+    // Concurrent readers must be done with the cache before it's cleared. When
+    //   not blocking, we're being called from minimizeCache() which already
+    //   holds this.
+    QWriteLocker cacheLock(
+        (blockForWriteCache && m_concurrentReads) ? m_chunkCacheLock : NULL);
+
     // If this map is allocated, then this is a brand new cube and we need to
     //   make sure it's filled with data or NULLs.
     if(m_dataIsOnDiskMap) {
@@ -394,21 +516,26 @@ namespace Isis {
 
     // This should be allocated. This is a list of the cached cube data.
     //   Write it all to disk.
-    if (m_rawData) {
-      QMapIterator<int, RawCubeChunk *> it(*m_rawData);
-      while (it.hasNext()) {
-        it.next();
+    if (m_chunkCache) {
+      foreach (ChunkCacheShard *shard, *m_chunkCache) {
+        QMutexLocker shardLock(&shard->mutex);
+        QMapIterator<int, RawCubeChunk *> it(shard->chunks);
+        while (it.hasNext()) {
+          it.next();
+
+          if(it.value()) {
+            if(it.value()->isDirty()) {
+              (const_cast<CubeIoHandler *>(this))->writeRaw(*it.value());
+            }
 
-        if(it.value()) {
-          if(it.value()->isDirty()) {
-            (const_cast<CubeIoHandler *>(this))->writeRaw(*it.value());
+            delete it.value();
           }
-
-          delete it.value();
         }
-      }
 
-      m_rawData->clear();
+        shard->chunks.clear();
+        shard->prefetchedChunks.clear();
+        shard->recentlyUsedChunks.clear();
+      }
     }
 
     if(m_lastProcessByLineChunks) {
@@ -520,7 +647,7 @@ namespace Isis {
    * Given a chunk, what's its index in the file. Chunks are ordered from
    *   left to right, then top to bottom, then front to back (BSQ). The
    *   first chunk is at the top left of band 1 and is index 0, for example. In
-   *   other words, this is going from the value of m_rawData to the key.
+   *   other words, this is going from a cached chunk to its key in the cache.
    *
    * Chunks which sit outside of the cube entirely must not be passed into this
    *   method; the results will be wrong.
@@ -617,9 +744,13 @@ namespace Isis {
    * @param numSamples The chunk size in the sample dimension
    * @param numLines The chunk size in the line dimension
    * @param numBands The chunk size in the band dimension
+   * @param fixedSizeData False if the size of the data on disk doesn't follow
+   *          from the chunk sizes, like with compressed chunks. The data file
+   *          is then neither sized nor checked nor memory mapped here; the
+   *          child is responsible for that.
    */
   void CubeIoHandler::setChunkSizes(
-      int numSamples, int numLines, int numBands) {
+      int numSamples, int numLines, int numBands, bool fixedSizeData) {
     bool success = false;
     IString msg;
 
@@ -647,6 +778,10 @@ namespace Isis {
       m_linesInChunk = numLines;
       m_bandsInChunk = numBands;
 
+      if(!fixedSizeData) {
+        return;
+      }
+
       if(m_dataIsOnDiskMap) {
         m_dataFile->resize(getDataStartByte() + getDataSize());
       }
@@ -658,6 +793,9 @@ namespace Isis {
             "offset to the cube data is [" + IString(getDataStartByte()) +
             " bytes]";
       }
+      else if(m_useMemoryMappedRead) {
+        mapDataFile();
+      }
     }
     else {
       throw IException(IException::Programmer, msg, _FILEINFO_);
@@ -665,6 +803,28 @@ namespace Isis {
   }
 
 
+  /**
+   * Get a pointer into the memory mapped data file. This is intended for
+   *   children to implement mappedChunk() with.
+   *
+   * @param startByte The 0-based byte offset into the data file of the first
+   *                  byte of a chunk
+   * @return A read-only pointer to the byte at startByte, or NULL if the data
+   *         file isn't mapped or a chunk starting at startByte would not be
+   *         entirely inside of the mapped region.
+   */
+  const char *CubeIoHandler::mappedFileData(BigInt startByte) const {
+    const char *result = NULL;
+
+    if (m_mappedFile && startByte >= 0 &&
+        startByte + getBytesPerChunk() <= m_mappedFileSize) {
+      result = (const char *)m_mappedFile + startByte;
+    }
+
+    return result;
+  }
+
+
   /**
    * This blocks (doesn't return) until the number of active runnables in the
    *   thread pool goes to 0. This uses the m_writeThreadMutex, because the
@@ -737,7 +897,34 @@ namespace Isis {
   QPair< QList<RawCubeChunk *>, QList<int> > CubeIoHandler::findCubeChunks(int startSample,
       int numSamples, int startLine, int numLines, int startBand,
       int numBands) const {
+    QPair< QList<int>, QList<int> > chunkIndices = findCubeChunkIndices(
+        startSample, numSamples, startLine, numLines, startBand, numBands);
+
     QList<RawCubeChunk *> results;
+    foreach (int chunkIndex, chunkIndices.first) {
+      results.append(getChunk(chunkIndex, true));
+    }
+
+    return QPair< QList<RawCubeChunk *>, QList<int> >(results, chunkIndices.second);
+  }
+
+
+  /**
+   * Get the indices of the cube chunks that correspond to the given cube area.
+   *   This does not allocate, read or cache any chunks.
+   *
+   * @param startSample The starting sample of the cube data
+   * @param numSamples The number of samples of cube data
+   * @param startLine The starting line of the cube data
+   * @param numLines The number of lines of cube data
+   * @param startBand The starting band of the cube data
+   * @param numBands The number of bands of cube data
+   * @return The chunk indices and the (virtual) band each chunk was found for
+   */
+  QPair< QList<int>, QList<int> > CubeIoHandler::findCubeChunkIndices(int startSample,
+      int numSamples, int startLine, int numLines, int startBand,
+      int numBands) const {
+    QList<int> results;
     QList<int> resultBands;
 /************************************************************************CHANGED THIS!!!!!!!!******/
     int lastBand = startBand + numBands - 1;
@@ -846,9 +1033,7 @@ namespace Isis {
               (chunkZPos * getChunkCountInSampleDimension() *
                           getChunkCountInLineDimension());
 
-          RawCubeChunk * newChunk = getChunk(chunkIndex, true);
-
-          results.append(newChunk);
+          results.append(chunkIndex);
           resultBands.append(band);
 
           chunkRect.moveLeft(chunkRect.right() + 1);
@@ -858,7 +1043,7 @@ namespace Isis {
       }
     }
 
-    return QPair< QList<RawCubeChunk *>, QList<int> >(results, resultBands);
+    return QPair< QList<int>, QList<int> >(results, resultBands);
   }
 
 
@@ -883,6 +1068,37 @@ namespace Isis {
       const RawCubeChunk &cube1, const Buffer &cube2,
       int &startX, int &startY, int &startZ,
       int &endX, int &endY, int &endZ) const {
+    findIntersection(cube1.getStartSample(), cube1.getStartLine(),
+                     cube1.getStartBand(), cube1.sampleCount(),
+                     cube1.lineCount(), cube1.bandCount(), cube2,
+                     startX, startY, startZ, endX, endY, endZ);
+  }
+
+
+  /**
+   * Find the intersection between the buffer area and a chunk given by its
+   *   placement. This is the same as the RawCubeChunk version, but does not
+   *   require a chunk to be allocated.
+   *
+   * @param chunkStartSample The first sample of the chunk (inclusive)
+   * @param chunkStartLine The first line of the chunk (inclusive)
+   * @param chunkStartBand The first band of the chunk (inclusive)
+   * @param chunkSampleCount The number of samples in the chunk
+   * @param chunkLineCount The number of lines in the chunk
+   * @param chunkBandCount The number of bands in the chunk
+   * @param cube2 The buffer (in virtual band space) to intersect
+   * @param startX (output) The leftmost sample position (inclusive)
+   * @param startY (output) The topmost line position (inclusive)
+   * @param startZ (output) The frontmost band position (inclusive)
+   * @param endX (output) The rightmost sample position (inclusive)
+   * @param endY (output) The bottommost line position (inclusive)
+   * @param endZ (output) The backmost band position (inclusive)
+   */
+  void CubeIoHandler::findIntersection(int chunkStartSample,
+      int chunkStartLine, int chunkStartBand, int chunkSampleCount,
+      int chunkLineCount, int chunkBandCount, const Buffer &cube2,
+      int &startX, int &startY, int &startZ,
+      int &endX, int &endY, int &endZ) const {
     // So we have 2 3D "cubes" (not Cube cubes but 3d areas) we need to
     //   intersect in order to figure out what chunk data goes into the output
     //   buffer.
@@ -924,14 +1140,14 @@ namespace Isis {
       }
     }
 
-    startX = max(cube1.getStartSample(), cube2.Sample());
-    startY = max(cube1.getStartLine(), cube2.Line());
-    startZ = max(cube1.getStartBand(), startPhysicalBand);
-    endX = min(cube1.getStartSample() + cube1.sampleCount() - 1,
+    startX = max(chunkStartSample, cube2.Sample());
+    startY = max(chunkStartLine, cube2.Line());
+    startZ = max(chunkStartBand, startPhysicalBand);
+    endX = min(chunkStartSample + chunkSampleCount - 1,
                cube2.Sample() + cube2.SampleDimension() - 1);
-    endY = min(cube1.getStartLine() + cube1.lineCount() - 1,
+    endY = min(chunkStartLine + chunkLineCount - 1,
                cube2.Line() + cube2.LineDimension() - 1);
-    endZ = min(cube1.getStartBand() + cube1.bandCount() - 1,
+    endZ = min(chunkStartBand + chunkBandCount - 1,
                endPhysicalBand);
   }
 
@@ -1022,10 +1238,16 @@ namespace Isis {
    * @param chunkToFree The chunk we're removing from memory
    */
   void CubeIoHandler::freeChunk(RawCubeChunk *chunkToFree) const {
-    if(chunkToFree && m_rawData) {
+    if(chunkToFree && m_chunkCache) {
       int chunkIndex = getChunkIndex(*chunkToFree);
 
-      m_rawData->erase(m_rawData->find(chunkIndex));
+      ChunkCacheShard &shard = chunkCacheShard(chunkIndex);
+      {
+        QMutexLocker shardLock(&shard.mutex);
+        shard.chunks.remove(chunkIndex);
+        shard.prefetchedChunks.remove(chunkIndex);
+        shard.recentlyUsedChunks.remove(chunkIndex);
+      }
 
       if(chunkToFree->isDirty())
         (const_cast<CubeIoHandler *>(this))->writeRaw(*chunkToFree);
@@ -1053,39 +1275,124 @@ namespace Isis {
                                         bool allocateIfNecessary) const {
     RawCubeChunk *chunk = NULL;
 
-    if(m_rawData) {
-      chunk = m_rawData->value(chunkIndex);
-    }
+    if(m_chunkCache) {
+      ChunkCacheShard &shard = chunkCacheShard(chunkIndex);
+      QMutexLocker shardLock(&shard.mutex);
+      chunk = shard.chunks.value(chunkIndex);
 
-    if(allocateIfNecessary && !chunk) {
-      if(m_dataIsOnDiskMap && !(*m_dataIsOnDiskMap)[chunkIndex]) {
-        chunk = getNullChunk(chunkIndex);
-        (*m_dataIsOnDiskMap)[chunkIndex] = true;
+      if(allocateIfNecessary && !chunk) {
+        chunk = readChunk(chunkIndex);
+        shard.chunks[chunkIndex] = chunk;
       }
-      else {
-        int startSample;
-        int startLine;
-        int startBand;
-        int endSample;
-        int endLine;
-        int endBand;
-        getChunkPlacement(chunkIndex, startSample, startLine, startBand,
-                          endSample, endLine, endBand);
-        chunk = new RawCubeChunk(startSample, startLine, startBand,
-                                    endSample, endLine, endBand,
-                                    getBytesPerChunk());
+    }
+
+    return chunk;
+  }
 
+
+  /**
+   * Create the chunk at the given chunk index and fill it with the data from
+   *   the disk, or with NULLs if that part of the cube was never written. The
+   *   chunk is not put into the cache.
+   *
+   * Ownership of the return value is given to the caller.
+   *
+   * @param chunkIndex The position of the chunk in the cube
+   * @return The chunk at chunkIndex, populated with cube data
+   */
+  RawCubeChunk *CubeIoHandler::readChunk(int chunkIndex) const {
+    RawCubeChunk *chunk = NULL;
+
+    if(m_dataIsOnDiskMap && !(*m_dataIsOnDiskMap)[chunkIndex]) {
+      chunk = getNullChunk(chunkIndex);
+      (*m_dataIsOnDiskMap)[chunkIndex] = true;
+    }
+    else {
+      int startSample;
+      int startLine;
+      int startBand;
+      int endSample;
+      int endLine;
+      int endBand;
+      getChunkPlacement(chunkIndex, startSample, startLine, startBand,
+                        endSample, endLine, endBand);
+      chunk = new RawCubeChunk(startSample, startLine, startBand,
+                                  endSample, endLine, endBand,
+                                  getBytesPerChunk());
+
+      try {
         (const_cast<CubeIoHandler *>(this))->readRaw(*chunk);
-        chunk->setDirty(false);
       }
-
-      (*m_rawData)[chunkIndex] = chunk;
+      catch (IException &) {
+        delete chunk;
+        throw;
+      }
+      chunk->setDirty(false);
     }
 
     return chunk;
   }
 
 
+  /**
+   * @param chunkIndex The position of a chunk in the cube
+   * @return The part of the chunk cache that the chunk belongs in
+   */
+  CubeIoHandler::ChunkCacheShard &CubeIoHandler::chunkCacheShard(
+      int chunkIndex) const {
+    return *(*m_chunkCache)[chunkIndex % m_chunkCache->size()];
+  }
+
+
+  /**
+   * @return Every chunk in the cache, in chunk index order
+   */
+  QList<RawCubeChunk *> CubeIoHandler::cachedChunks() const {
+    QMap<int, RawCubeChunk *> allChunks;
+
+    foreach (ChunkCacheShard *shard, *m_chunkCache) {
+      QMutexLocker shardLock(&shard->mutex);
+      QMapIterator<int, RawCubeChunk *> it(shard->chunks);
+      while (it.hasNext()) {
+        it.next();
+        allChunks.insert(it.key(), it.value());
+      }
+    }
+
+    return allChunks.values();
+  }
+
+
+  /**
+   * @return The number of chunks in the cache
+   */
+  int CubeIoHandler::cachedChunkCount() const {
+    int count = 0;
+
+    foreach (ChunkCacheShard *shard, *m_chunkCache) {
+      QMutexLocker shardLock(&shard->mutex);
+      count += shard->chunks.size();
+    }
+
+    return count;
+  }
+
+
+  /**
+   * @return The number of chunks read by prefetch() that haven't been used
+   */
+  int CubeIoHandler::prefetchedChunkCount() const {
+    int count = 0;
+
+    foreach (ChunkCacheShard *shard, *m_chunkCache) {
+      QMutexLocker shardLock(&shard->mutex);
+      count += shard->prefetchedChunks.size();
+    }
+
+    return count;
+  }
+
+
   /**
    * @return The number of chunks that are required to encapsulate all of the
    *   cube data
@@ -1184,6 +1491,27 @@ namespace Isis {
   }
 
 
+  /**
+   * Memory map the cube data for reading. This only happens for cubes that are
+   *   already on disk and were opened read-only; memory mapping a cube that
+   *   can be written to would bypass the chunk cache and write cache. If the
+   *   mapping fails (for example, the address space is too small) then reads
+   *   silently continue to use the chunk cache.
+   */
+  void CubeIoHandler::mapDataFile() {
+    if (!m_mappedFile && !m_dataIsOnDiskMap &&
+        !(m_dataFile->openMode() & QIODevice::WriteOnly)) {
+      BigInt mapSize = getDataStartByte() + getDataSize();
+
+      // Never map past the end of the file
+      if (mapSize <= m_dataFile->size()) {
+        m_mappedFile = m_dataFile->map(0, mapSize);
+      }
+      m_mappedFileSize = m_mappedFile ? mapSize : 0;
+    }
+  }
+
+
   /**
    * Apply the caching algorithms and get rid of excess cube data in memory.
    *   This is intended to be called after every IO operation.
@@ -1195,10 +1523,30 @@ namespace Isis {
    */
   void CubeIoHandler::minimizeCache(const QList<RawCubeChunk *> &justUsed,
                                     const Buffer &justRequested) const {
+    // Prefetched chunks haven't been read yet and other threads may still be
+    //   working with the chunks they recently read, so treat them as in use
+    QList<RawCubeChunk *> inUse(justUsed);
+    foreach (ChunkCacheShard *shard, *m_chunkCache) {
+      QMutexLocker shardLock(&shard->mutex);
+      QSet<int> chunkIndices = shard->prefetchedChunks;
+      chunkIndices.unite(shard->recentlyUsedChunks);
+      shard->recentlyUsedChunks.clear();
+
+      foreach (int chunkIndex, chunkIndices) {
+        RawCubeChunk *chunk = shard->chunks.value(chunkIndex);
+
+        if (chunk && !inUse.contains(chunk)) {
+          inUse.append(chunk);
+        }
+      }
+    }
+
     // Since we have a lock on the cache, no newly created threads can utilize
     //   or access any cache data until we're done.
-    if (m_rawData->size() * getBytesPerChunk() > 1 * 1024 * 1024 ||
+    if (cachedChunkCount() * getBytesPerChunk() > 1 * 1024 * 1024 ||
        m_cachingAlgorithms->size() > 1) {
+
+
       bool algorithmAccepted = false;
 
       int algorithmIndex = 0;
@@ -1207,7 +1555,7 @@ namespace Isis {
         CubeCachingAlgorithm *algorithm = (*m_cachingAlgorithms)[algorithmIndex];
 
         CubeCachingAlgorithm::CacheResult result =
-            algorithm->recommendChunksToFree(m_rawData->values(), justUsed,
+            algorithm->recommendChunksToFree(cachedChunks(), inUse,
                                              justRequested);
 
         algorithmAccepted = result.algorithmUnderstoodData();
@@ -1225,7 +1573,7 @@ namespace Isis {
       }
 
       // Fall back - no algorithms liked us :(
-      if(!algorithmAccepted && m_rawData->size() > 100) {
+      if(!algorithmAccepted && cachedChunkCount() > 100) {
         // This (minimizeCache()) is typically executed in the Runnable thread.
         // We don't want to wait for ourselves.
         clearCache(false);
@@ -1234,6 +1582,175 @@ namespace Isis {
   }
 
 
+  /**
+   * Read the chunks for the given area into the cache and remember them as
+   *   prefetched so that they are not freed until they are read. If the cube
+   *   can be written to, the caller must hold the m_writeThreadMutex;
+   *   otherwise the cache is locked just like concurrentRead() does. To bound
+   *   memory use, the prefetch is skipped if it would grow the unread
+   *   prefetched data past 64MB, unless nothing is prefetched yet.
+   *
+   * @param startSample The starting sample of the cube data
+   * @param numSamples The number of samples of cube data
+   * @param startLine The starting line of the cube data
+   * @param numLines The number of lines of cube data
+   * @param startBand The starting band of the cube data
+   * @param numBands The number of bands of cube data
+   */
+  void CubeIoHandler::prefetchChunks(int startSample, int numSamples,
+                                     int startLine, int numLines,
+                                     int startBand, int numBands) const {
+    QList<int> chunkIndices = findCubeChunkIndices(startSample, numSamples,
+        startLine, numLines, startBand, numBands).first;
+
+    QReadLocker cacheLock(m_concurrentReads ? m_chunkCacheLock : NULL);
+
+    QList<int> chunksToRead;
+    foreach (int chunkIndex, chunkIndices) {
+      if (!getChunk(chunkIndex, false) && !chunksToRead.contains(chunkIndex)) {
+        chunksToRead.append(chunkIndex);
+      }
+    }
+
+    int prefetchedCount = prefetchedChunkCount();
+    BigInt maxPrefetchBytes = 64 * 1024 * 1024;
+    BigInt prefetchBytes = (BigInt)(prefetchedCount + chunksToRead.size()) *
+                           getBytesPerChunk();
+
+    if (chunksToRead.size() &&
+        (prefetchedCount == 0 || prefetchBytes <= maxPrefetchBytes)) {
+      foreach (int chunkIndex, chunksToRead) {
+        ChunkCacheShard &shard = chunkCacheShard(chunkIndex);
+        QMutexLocker shardLock(&shard.mutex);
+
+        // A concurrent read may have needed this chunk first
+        if (!shard.chunks.contains(chunkIndex)) {
+          QMutexLocker fileLock(m_concurrentReads ? m_writeThreadMutex : NULL);
+          shard.chunks.insert(chunkIndex, readChunk(chunkIndex));
+          shard.prefetchedChunks.insert(chunkIndex);
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Read cube data from the cache into the buffer without waiting on other
+   *   reads. This is only safe when nothing can write to the cube. The cache
+   *   is held for reading and each chunk is used while holding its shard's
+   *   lock, so it can't be freed out from under us. Chunks that aren't cached
+   *   are read from the disk while holding the m_writeThreadMutex. If this
+   *   changed the cache, the cache is then minimized while holding it for
+   *   writing.
+   *
+   * @param bufferToFill The buffer to populate with cube data.
+   */
+  void CubeIoHandler::concurrentRead(Buffer &bufferToFill) const {
+    QPair< QList<int>, QList<int> > chunkInfo = findCubeChunkIndices(
+        bufferToFill.Sample(), bufferToFill.SampleDimension(),
+        bufferToFill.Line(), bufferToFill.LineDimension(),
+        bufferToFill.Band(), bufferToFill.BandDimension());
+
+    // We can't guarantee our cube chunks will encompass the buffer
+    //   if the buffer goes beyond the cube bounds.
+    for (int i = 0; i < bufferToFill.size(); i++) {
+      bufferToFill[i] = Null;
+    }
+
+    bool cacheChanged = false;
+    {
+      QReadLocker cacheLock(m_chunkCacheLock);
+
+      for (int i = 0; i < chunkInfo.first.size(); i++) {
+        int chunkIndex = chunkInfo.first[i];
+        ChunkCacheShard &shard = chunkCacheShard(chunkIndex);
+        QMutexLocker shardLock(&shard.mutex);
+
+        RawCubeChunk *chunk = shard.chunks.value(chunkIndex);
+        if (!chunk) {
+          QMutexLocker fileLock(m_writeThreadMutex);
+          chunk = readChunk(chunkIndex);
+          shard.chunks.insert(chunkIndex, chunk);
+          cacheChanged = true;
+        }
+
+        writeIntoDouble(*chunk, bufferToFill, chunkInfo.second[i]);
+
+        // Prefetched chunks were added to the cache before this read, so they
+        //   count as a change too.
+        if (shard.prefetchedChunks.remove(chunkIndex)) {
+          cacheChanged = true;
+        }
+        shard.recentlyUsedChunks.insert(chunkIndex);
+      }
+    }
+
+    if (cacheChanged) {
+      QWriteLocker cacheLock(m_chunkCacheLock);
+
+      // Other threads may have freed our chunks since we let go of the cache
+      QList<RawCubeChunk *> justUsed;
+      foreach (int chunkIndex, chunkInfo.first) {
+        RawCubeChunk *chunk = getChunk(chunkIndex, false);
+
+        if (chunk && !justUsed.contains(chunk)) {
+          justUsed.append(chunk);
+        }
+      }
+
+      minimizeCache(justUsed, bufferToFill);
+    }
+  }
+
+
+  /**
+   * Read cube data straight out of the memory mapped data file into the
+   *   buffer. No chunks are allocated, cached or copied; the raw data is
+   *   converted in place by writeIntoDouble().
+   *
+   * @param bufferToFill The buffer to populate with cube data.
+   * @return False if the child can't provide a mapped view for every chunk
+   *         required, in which case the buffer is left untouched and the
+   *         caller must fall back to the cached read.
+   */
+  bool CubeIoHandler::readMapped(Buffer &bufferToFill) const {
+    QPair< QList<int>, QList<int> > chunkInfo = findCubeChunkIndices(
+        bufferToFill.Sample(), bufferToFill.SampleDimension(),
+        bufferToFill.Line(), bufferToFill.LineDimension(),
+        bufferToFill.Band(), bufferToFill.BandDimension());
+
+    QList<const char *> chunkViews;
+    foreach (int chunkIndex, chunkInfo.first) {
+      const char *chunkView = mappedChunk(chunkIndex);
+
+      if (!chunkView) {
+        return false;
+      }
+
+      chunkViews.append(chunkView);
+    }
+
+    // We can't guarantee our cube chunks will encompass the buffer
+    //   if the buffer goes beyond the cube bounds.
+    for (int i = 0; i < bufferToFill.size(); i++) {
+      bufferToFill[i] = Null;
+    }
+
+    for (int i = 0; i < chunkViews.size(); i++) {
+      int startSample, startLine, startBand, endSample, endLine, endBand;
+      getChunkPlacement(chunkInfo.first[i], startSample, startLine, startBand,
+                        endSample, endLine, endBand);
+
+      writeIntoDouble(chunkViews[i], startSample, startLine, startBand,
+                      endSample - startSample + 1, endLine - startLine + 1,
+                      endBand - startBand + 1, bufferToFill,
+                      chunkInfo.second[i]);
+    }
+
+    return true;
+  }
+
+
   /**
    * This method takes the given buffer and synchronously puts it into the
    *   Cube's cache. This includes reading missing cache areas and freeing
@@ -1359,12 +1876,34 @@ namespace Isis {
    */
   void CubeIoHandler::writeIntoDouble(const RawCubeChunk &chunk,
                                       Buffer &output, int index) const {
-    // The code in this method is highly optimized. Even the order of the if
-    //   statements will have a significant impact on performance if changed.
-    //   Also, there is a lot of duplicate code in both writeIntoDouble(...) and
-    //   writeIntoRaw(...). This is needed for performance gain. Any function
-    //   or method calls from within the x loop cause significant performance
-    //   decreases.
+    writeIntoDouble(chunk.getRawData().data(), chunk.getStartSample(),
+                    chunk.getStartLine(), chunk.getStartBand(),
+                    chunk.sampleCount(), chunk.lineCount(), chunk.bandCount(),
+                    output, index);
+  }
+
+
+  /**
+   * Write the intersecting area of the raw chunk data into the buffer. The
+   *   chunk data can live anywhere, including inside of the memory mapped data
+   *   file.
+   *
+   * @param chunkBuf The raw (unswapped) chunk data
+   * @param chunkStartSample The first sample of the chunk (inclusive)
+   * @param chunkStartLine The first line of the chunk (inclusive)
+   * @param chunkStartBand The first band of the chunk (inclusive)
+   * @param chunkSampleCount The number of samples in the chunk
+   * @param chunkLineCount The number of lines in the chunk
+   * @param chunkBandCount The number of bands in the chunk
+   * @param output The data destination
+   * @param index int
+   */
+  void CubeIoHandler::writeIntoDouble(const char *chunkBuf,
+      int chunkStartSample, int chunkStartLine, int chunkStartBand,
+      int chunkSampleCount, int chunkLineCount, int chunkBandCount,
+      Buffer &output, int index) const {
+    // Each line of the intersection is contiguous in both the chunk and the
+    //   buffer, so whole lines are converted at once by convertToDouble(...).
     int startX = 0;
     int startY = 0;
     int startZ = 0;
@@ -1373,25 +1912,21 @@ namespace Isis {
     int endY = 0;
     int endZ = 0;
 
-    findIntersection(chunk, output, startX, startY, startZ, endX, endY, endZ);
+    findIntersection(chunkStartSample, chunkStartLine, chunkStartBand,
+                     chunkSampleCount, chunkLineCount, chunkBandCount, output,
+                     startX, startY, startZ, endX, endY, endZ);
 
     int bufferBand = output.Band();
     int bufferBands = output.BandDimension();
-    int chunkStartSample = chunk.getStartSample();
-    int chunkStartLine = chunk.getStartLine();
-    int chunkStartBand = chunk.getStartBand();
-    int chunkLineSize = chunk.sampleCount();
-    int chunkBandSize = chunkLineSize * chunk.lineCount();
-    //double *buffersDoubleBuf = output.p_buf;
+    int chunkLineSize = chunkSampleCount;
+    int chunkBandSize = chunkLineSize * chunkLineCount;
+    int pixelSize = SizeOf(m_pixelType);
     double *buffersDoubleBuf = output.DoubleBuffer();
-    const char *chunkBuf = chunk.getRawData().data();
     char *buffersRawBuf = (char *)output.RawBuffer();
 
     for(int z = startZ; z <= endZ; z++) {
       const int &bandIntoChunk = z - chunkStartBand;
-      int virtualBand = z;
-
-      virtualBand = index;
+      int virtualBand = index;
 
       if(virtualBand != 0 && virtualBand >= bufferBand &&
          virtualBand <= bufferBand + bufferBands - 1) {
@@ -1400,150 +1935,13 @@ namespace Isis {
           const int &lineIntoChunk = y - chunkStartLine;
           int bufferIndex = output.Index(startX, y, virtualBand);
 
-          for(int x = startX; x <= endX; x++) {
-            const int &sampleIntoChunk = x - chunkStartSample;
-
-            const int &chunkIndex = sampleIntoChunk +
-                (chunkLineSize * lineIntoChunk) +
-                (chunkBandSize * bandIntoChunk);
-
-            double &bufferVal = buffersDoubleBuf[bufferIndex];
-
-            if(m_pixelType == Real) {
-              float raw = ((float *)chunkBuf)[chunkIndex];
-              if(m_byteSwapper)
-                raw = m_byteSwapper->Float(&raw);
-
-              if(raw >= VALID_MIN4) {
-                bufferVal = (double) raw;
-              }
-              else {
-                if(raw == NULL4)
-                  bufferVal = NULL8;
-                else if(raw == LOW_INSTR_SAT4)
-                  bufferVal = LOW_INSTR_SAT8;
-                else if(raw == LOW_REPR_SAT4)
-                  bufferVal = LOW_REPR_SAT8;
-                else if(raw == HIGH_INSTR_SAT4)
-                  bufferVal = HIGH_INSTR_SAT8;
-                else if(raw == HIGH_REPR_SAT4)
-                  bufferVal = HIGH_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-
-              ((float *)buffersRawBuf)[bufferIndex] = raw;
-            }
-
-            else if(m_pixelType == SignedWord) {
-              short raw = ((short *)chunkBuf)[chunkIndex];
-              if(m_byteSwapper)
-                raw = m_byteSwapper->ShortInt(&raw);
-
-              if(raw >= VALID_MIN2) {
-                bufferVal = (double) raw * m_multiplier + m_base;
-              }
-              else {
-                if(raw == NULL2)
-                  bufferVal = NULL8;
-                else if(raw == LOW_INSTR_SAT2)
-                  bufferVal = LOW_INSTR_SAT8;
-                else if(raw == LOW_REPR_SAT2)
-                  bufferVal = LOW_REPR_SAT8;
-                else if(raw == HIGH_INSTR_SAT2)
-                  bufferVal = HIGH_INSTR_SAT8;
-                else if(raw == HIGH_REPR_SAT2)
-                  bufferVal = HIGH_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-
-              ((short *)buffersRawBuf)[bufferIndex] = raw;
-            }
-
-
-            else if(m_pixelType == UnsignedWord) {
-              unsigned short raw = ((unsigned short *)chunkBuf)[chunkIndex];
-              if(m_byteSwapper)
-                raw = m_byteSwapper->UnsignedShortInt(&raw);
-
-              if(raw >= VALID_MINU2) {
-                bufferVal = (double) raw * m_multiplier + m_base;
-              }
-              else if (raw > VALID_MAXU2) {
-                if(raw == HIGH_INSTR_SATU2)
-                  bufferVal = HIGH_INSTR_SAT8;
-                else if(raw == HIGH_REPR_SATU2)
-                  bufferVal = HIGH_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-              else {
-                if(raw == NULLU2)
-                  bufferVal = NULL8;
-                else if(raw == LOW_INSTR_SATU2)
-                  bufferVal = LOW_INSTR_SAT8;
-                else if(raw == LOW_REPR_SATU2)
-                  bufferVal = LOW_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-
-              ((unsigned short *)buffersRawBuf)[bufferIndex] = raw;
-            }
-
-            else if(m_pixelType == UnsignedInteger) {
-
-              unsigned int raw = ((unsigned int *)chunkBuf)[chunkIndex];
-              if(m_byteSwapper)
-                raw = m_byteSwapper->Uint32_t(&raw);
-
-              if(raw >= VALID_MINUI4) {
-                bufferVal = (double) raw * m_multiplier + m_base;
-              }
-              else if (raw > VALID_MAXUI4) {
-                if(raw == HIGH_INSTR_SATUI4)
-                  bufferVal = HIGH_INSTR_SAT8;
-                else if(raw == HIGH_REPR_SATUI4)
-                  bufferVal = HIGH_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-              else {
-                if(raw == NULLUI4)
-                  bufferVal = NULL8;
-                else if(raw == LOW_INSTR_SATUI4)
-                  bufferVal = LOW_INSTR_SAT8;
-                else if(raw == LOW_REPR_SATUI4)
-                  bufferVal = LOW_REPR_SAT8;
-                else
-                  bufferVal = LOW_REPR_SAT8;
-              }
-
-              ((unsigned int *)buffersRawBuf)[bufferIndex] = raw;
-
-
+          int chunkIndex = (startX - chunkStartSample) +
+              (chunkLineSize * lineIntoChunk) +
+              (chunkBandSize * bandIntoChunk);
 
-            }
-
-            else if(m_pixelType == UnsignedByte) {
-              unsigned char raw = ((unsigned char *)chunkBuf)[chunkIndex];
-
-              if(raw == NULL1) {
-                bufferVal = NULL8;
-              }
-              else if(raw == HIGH_REPR_SAT1) {
-                bufferVal = HIGH_REPR_SAT8;
-              }
-              else {
-                bufferVal = (double) raw * m_multiplier + m_base;
-              }
-
-              ((unsigned char *)buffersRawBuf)[bufferIndex] = raw;
-            }
-
-            bufferIndex ++;
-          }
+          convertToDouble(chunkBuf + (BigInt)chunkIndex * pixelSize,
+                          buffersRawBuf + (BigInt)bufferIndex * pixelSize,
+                          buffersDoubleBuf + bufferIndex, endX - startX + 1);
         }
       }
     }
@@ -1559,12 +1957,8 @@ namespace Isis {
    */
   void CubeIoHandler::writeIntoRaw(const Buffer &buffer, RawCubeChunk &output, int index)
       const {
-    // The code in this method is highly optimized. Even the order of the if
-    //   statements will have a significant impact on performance if changed.
-    //   Also, there is a lot of duplicate code in both writeIntoDouble(...) and
-    //   writeIntoRaw(...). This is needed for performance gain. Any function
-    //   or method calls from within the x loop cause significant performance
-    //   decreases.
+    // Each line of the intersection is contiguous in both the chunk and the
+    //   buffer, so whole lines are converted at once by convertToRaw(...).
     int startX = 0;
     int startY = 0;
     int startZ = 0;
@@ -1583,6 +1977,7 @@ namespace Isis {
     int outputStartBand = output.getStartBand();
     int lineSize = output.sampleCount();
     int bandSize = lineSize * output.lineCount();
+    int pixelSize = SizeOf(m_pixelType);
     double *buffersDoubleBuf = buffer.DoubleBuffer();
     char *chunkBuf = output.getRawData().data();
 
@@ -1602,234 +1997,346 @@ namespace Isis {
           const int &lineIntoChunk = y - outputStartLine;
           int bufferIndex = buffer.Index(startX, y, virtualBand);
 
-          for(int x = startX; x <= endX; x++) {
-            const int &sampleIntoChunk = x - outputStartSample;
-
-            const int &chunkIndex = sampleIntoChunk +
-                (lineSize * lineIntoChunk) + (bandSize * bandIntoChunk);
-
-            double bufferVal = buffersDoubleBuf[bufferIndex];
-
-            if(m_pixelType == Real) {
-              float raw = 0;
-
-              if(bufferVal >= VALID_MIN8) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-
-                if(filePixelValueDbl < (double) VALID_MIN4) {
-                  raw = LOW_REPR_SAT4;
-                }
-                else if(filePixelValueDbl > (double) VALID_MAX4) {
-                  raw = HIGH_REPR_SAT4;
-                }
-                else {
-                  raw = (float) filePixelValueDbl;
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULL4;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SAT4;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SAT4;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SAT4;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SAT4;
-                else
-                  raw = LOW_REPR_SAT4;
-              }
-              ((float *)chunkBuf)[chunkIndex] =
-                  m_byteSwapper ? m_byteSwapper->Float(&raw) : raw;
-            }
+          int chunkIndex = (startX - outputStartSample) +
+              (lineSize * lineIntoChunk) + (bandSize * bandIntoChunk);
 
-            else if(m_pixelType == SignedWord) {
-              short raw;
-
-              if(bufferVal >= VALID_MIN8) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-                if(filePixelValueDbl < VALID_MIN2 - 0.5) {
-                  raw = LOW_REPR_SAT2;
-                }
-                if(filePixelValueDbl > VALID_MAX2 + 0.5) {
-                  raw = HIGH_REPR_SAT2;
-                }
-                else {
-                  int filePixelValue = (int)round(filePixelValueDbl);
-
-                  if(filePixelValue < VALID_MIN2) {
-                    raw = LOW_REPR_SAT2;
-                  }
-                  else if(filePixelValue > VALID_MAX2) {
-                    raw = HIGH_REPR_SAT2;
-                  }
-                  else {
-                    raw = filePixelValue;
-                  }
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULL2;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SAT2;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SAT2;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SAT2;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SAT2;
-                else
-                  raw = LOW_REPR_SAT2;
-              }
-
-              ((short *)chunkBuf)[chunkIndex] =
-                  m_byteSwapper ? m_byteSwapper->ShortInt(&raw) : raw;
-            }
+          convertToRaw(buffersDoubleBuf + bufferIndex,
+                       chunkBuf + (BigInt)chunkIndex * pixelSize,
+                       endX - startX + 1);
+        }
+      }
+    }
+  }
 
-            else if(m_pixelType == UnsignedInteger) {
-
-              unsigned int raw;
-
-              if(bufferVal >= VALID_MINUI4) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-                if(filePixelValueDbl < VALID_MINUI4 - 0.5) {
-                  raw = LOW_REPR_SATUI4;
-                }
-                if(filePixelValueDbl > VALID_MAXUI4) {
-                  raw = HIGH_REPR_SATUI4;
-                }
-                else {
-                  unsigned int filePixelValue = (unsigned int)round(filePixelValueDbl);
-
-                  if(filePixelValue < VALID_MINUI4) {
-                    raw = LOW_REPR_SATUI4;
-                  }
-                  else if(filePixelValue > VALID_MAXUI4) {
-                    raw = HIGH_REPR_SATUI4;
-                  }
-                  else {
-                    raw = filePixelValue;
-                  }
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULLUI4;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SATUI4;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SATUI4;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SATUI4;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SATUI4;
-                else
-                  raw = LOW_REPR_SATUI4;
-              }
-
-              ((unsigned int *)chunkBuf)[chunkIndex] =
-                  m_byteSwapper ? m_byteSwapper->Uint32_t(&raw) : raw;
 
-            }
+  /**
+   * Convert a run of raw pixels from the cube into DNs.
+   *
+   * This is the inner loop of reading a cube, so it is written to be fast
+   *   instead of short. The pixel type is checked once per run instead of
+   *   once per pixel, the byte swap happens on the whole run, and valid
+   *   pixels are scaled in a loop without branches that the compiler can
+   *   vectorize. Special pixels are rare, so they are found and replaced in a
+   *   second pass.
+   *
+   * @param chunkPixels The raw (unswapped) pixels in the chunk
+   * @param rawPixels The buffer's raw buffer; this gets the swapped pixels
+   * @param doublePixels The buffer's double buffer; this gets the DNs
+   * @param count The number of pixels to convert
+   */
+  void CubeIoHandler::convertToDouble(const char *chunkPixels, char *rawPixels,
+                                      double *doublePixels, int count) const {
+    memcpy(rawPixels, chunkPixels, (size_t)count * SizeOf(m_pixelType));
 
+    if(m_byteSwapper) {
+      swapPixels(rawPixels, count);
+    }
 
-            else if(m_pixelType == UnsignedWord) {
-              unsigned short raw;
-
-              if(bufferVal >= VALID_MIN8) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-                if(filePixelValueDbl < VALID_MINU2 - 0.5) {
-                  raw = LOW_REPR_SATU2;
-                }
-                if(filePixelValueDbl > VALID_MAXU2 + 0.5) {
-                  raw = HIGH_REPR_SATU2;
-                }
-                else {
-                  int filePixelValue = (int)round(filePixelValueDbl);
-
-                  if(filePixelValue < VALID_MINU2) {
-                    raw = LOW_REPR_SATU2;
-                  }
-                  else if(filePixelValue > VALID_MAXU2) {
-                    raw = HIGH_REPR_SATU2;
-                  }
-                  else {
-                    raw = filePixelValue;
-                  }
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULLU2;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SATU2;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SATU2;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SATU2;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SATU2;
-                else
-                  raw = LOW_REPR_SATU2;
-              }
-
-              ((unsigned short *)chunkBuf)[chunkIndex] =
-                  m_byteSwapper ? m_byteSwapper->UnsignedShortInt(&raw) : raw;
-            }
-            else if(m_pixelType == UnsignedByte) {
-              unsigned char raw;
-
-              if(bufferVal >= VALID_MIN8) {
-                double filePixelValueDbl = (bufferVal - m_base) /
-                    m_multiplier;
-                if(filePixelValueDbl < VALID_MIN1 - 0.5) {
-                  raw = LOW_REPR_SAT1;
-                }
-                else if(filePixelValueDbl > VALID_MAX1 + 0.5) {
-                  raw = HIGH_REPR_SAT1;
-                }
-                else {
-                  int filePixelValue = (int)(filePixelValueDbl + 0.5);
-                  if(filePixelValue < VALID_MIN1) {
-                    raw = LOW_REPR_SAT1;
-                  }
-                  else if(filePixelValue > VALID_MAX1) {
-                    raw = HIGH_REPR_SAT1;
-                  }
-                  else {
-                    raw = (unsigned char)(filePixelValue);
-                  }
-                }
-              }
-              else {
-                if(bufferVal == NULL8)
-                  raw = NULL1;
-                else if(bufferVal == LOW_INSTR_SAT8)
-                  raw = LOW_INSTR_SAT1;
-                else if(bufferVal == LOW_REPR_SAT8)
-                  raw = LOW_REPR_SAT1;
-                else if(bufferVal == HIGH_INSTR_SAT8)
-                  raw = HIGH_INSTR_SAT1;
-                else if(bufferVal == HIGH_REPR_SAT8)
-                  raw = HIGH_REPR_SAT1;
-                else
-                  raw = LOW_REPR_SAT1;
-              }
-
-              ((unsigned char *)chunkBuf)[chunkIndex] = raw;
-            }
+    if(m_pixelType == Real) {
+      const float *raw = (const float *)rawPixels;
 
-            bufferIndex ++;
-          }
+      for(int i = 0; i < count; i++) {
+        doublePixels[i] = (double) raw[i];
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(!(raw[i] >= VALID_MIN4)) {
+          if(raw[i] == NULL4)
+            doublePixels[i] = NULL8;
+          else if(raw[i] == LOW_INSTR_SAT4)
+            doublePixels[i] = LOW_INSTR_SAT8;
+          else if(raw[i] == LOW_REPR_SAT4)
+            doublePixels[i] = LOW_REPR_SAT8;
+          else if(raw[i] == HIGH_INSTR_SAT4)
+            doublePixels[i] = HIGH_INSTR_SAT8;
+          else if(raw[i] == HIGH_REPR_SAT4)
+            doublePixels[i] = HIGH_REPR_SAT8;
+          else
+            doublePixels[i] = LOW_REPR_SAT8;
+        }
+      }
+    }
+
+    else if(m_pixelType == SignedWord) {
+      const short *raw = (const short *)rawPixels;
+
+      for(int i = 0; i < count; i++) {
+        doublePixels[i] = (double) raw[i] * m_multiplier + m_base;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(raw[i] < VALID_MIN2) {
+          if(raw[i] == NULL2)
+            doublePixels[i] = NULL8;
+          else if(raw[i] == LOW_INSTR_SAT2)
+            doublePixels[i] = LOW_INSTR_SAT8;
+          else if(raw[i] == LOW_REPR_SAT2)
+            doublePixels[i] = LOW_REPR_SAT8;
+          else if(raw[i] == HIGH_INSTR_SAT2)
+            doublePixels[i] = HIGH_INSTR_SAT8;
+          else if(raw[i] == HIGH_REPR_SAT2)
+            doublePixels[i] = HIGH_REPR_SAT8;
+          else
+            doublePixels[i] = LOW_REPR_SAT8;
         }
       }
     }
+
+    else if(m_pixelType == UnsignedWord) {
+      const unsigned short *raw = (const unsigned short *)rawPixels;
+
+      for(int i = 0; i < count; i++) {
+        doublePixels[i] = (double) raw[i] * m_multiplier + m_base;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(raw[i] < VALID_MINU2) {
+          if(raw[i] == NULLU2)
+            doublePixels[i] = NULL8;
+          else if(raw[i] == LOW_INSTR_SATU2)
+            doublePixels[i] = LOW_INSTR_SAT8;
+          else
+            doublePixels[i] = LOW_REPR_SAT8;
+        }
+        else if(raw[i] > VALID_MAXU2) {
+          if(raw[i] == HIGH_INSTR_SATU2)
+            doublePixels[i] = HIGH_INSTR_SAT8;
+          else
+            doublePixels[i] = HIGH_REPR_SAT8;
+        }
+      }
+    }
+
+    else if(m_pixelType == UnsignedInteger) {
+      const unsigned int *raw = (const unsigned int *)rawPixels;
+
+      for(int i = 0; i < count; i++) {
+        doublePixels[i] = (double) raw[i] * m_multiplier + m_base;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(raw[i] < VALID_MINUI4) {
+          if(raw[i] == NULLUI4)
+            doublePixels[i] = NULL8;
+          else if(raw[i] == LOW_INSTR_SATUI4)
+            doublePixels[i] = LOW_INSTR_SAT8;
+          else
+            doublePixels[i] = LOW_REPR_SAT8;
+        }
+        else if(raw[i] > VALID_MAXUI4) {
+          if(raw[i] == HIGH_INSTR_SATUI4)
+            doublePixels[i] = HIGH_INSTR_SAT8;
+          else
+            doublePixels[i] = HIGH_REPR_SAT8;
+        }
+      }
+    }
+
+    else if(m_pixelType == UnsignedByte) {
+      const unsigned char *raw = (const unsigned char *)rawPixels;
+
+      for(int i = 0; i < count; i++) {
+        doublePixels[i] = (double) raw[i] * m_multiplier + m_base;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(raw[i] == NULL1)
+          doublePixels[i] = NULL8;
+        else if(raw[i] == HIGH_REPR_SAT1)
+          doublePixels[i] = HIGH_REPR_SAT8;
+      }
+    }
+  }
+
+
+  /**
+   * Convert a run of DNs into raw pixels for the cube.
+   *
+   * This is the inner loop of writing a cube, see convertToDouble(...). Every
+   *   DN is first converted as if it were valid, with the out of range checks
+   *   written as selects so that the loop can be vectorized, then the special
+   *   pixels are found and replaced in a second pass.
+   *
+   * @param doublePixels The DNs to convert
+   * @param chunkPixels The raw pixels in the chunk; these are swapped to the
+   *                    cube's byte order
+   * @param count The number of pixels to convert
+   */
+  void CubeIoHandler::convertToRaw(const double *doublePixels,
+                                   char *chunkPixels, int count) const {
+    if(m_pixelType == Real) {
+      float *raw = (float *)chunkPixels;
+
+      for(int i = 0; i < count; i++) {
+        double filePixelValueDbl = (doublePixels[i] - m_base) / m_multiplier;
+        raw[i] = (filePixelValueDbl < (double) VALID_MIN4) ? LOW_REPR_SAT4 :
+                 (filePixelValueDbl > (double) VALID_MAX4) ? HIGH_REPR_SAT4 :
+                 (float) filePixelValueDbl;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(!(doublePixels[i] >= VALID_MIN8)) {
+          if(doublePixels[i] == NULL8)
+            raw[i] = NULL4;
+          else if(doublePixels[i] == LOW_INSTR_SAT8)
+            raw[i] = LOW_INSTR_SAT4;
+          else if(doublePixels[i] == LOW_REPR_SAT8)
+            raw[i] = LOW_REPR_SAT4;
+          else if(doublePixels[i] == HIGH_INSTR_SAT8)
+            raw[i] = HIGH_INSTR_SAT4;
+          else if(doublePixels[i] == HIGH_REPR_SAT8)
+            raw[i] = HIGH_REPR_SAT4;
+          else
+            raw[i] = LOW_REPR_SAT4;
+        }
+      }
+    }
+
+    else if(m_pixelType == SignedWord) {
+      short *raw = (short *)chunkPixels;
+
+      for(int i = 0; i < count; i++) {
+        double filePixelValue =
+            round((doublePixels[i] - m_base) / m_multiplier);
+        raw[i] = !(filePixelValue >= VALID_MIN2) ? LOW_REPR_SAT2 :
+                 (filePixelValue > VALID_MAX2) ? HIGH_REPR_SAT2 :
+                 (short) filePixelValue;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(!(doublePixels[i] >= VALID_MIN8)) {
+          if(doublePixels[i] == NULL8)
+            raw[i] = NULL2;
+          else if(doublePixels[i] == LOW_INSTR_SAT8)
+            raw[i] = LOW_INSTR_SAT2;
+          else if(doublePixels[i] == LOW_REPR_SAT8)
+            raw[i] = LOW_REPR_SAT2;
+          else if(doublePixels[i] == HIGH_INSTR_SAT8)
+            raw[i] = HIGH_INSTR_SAT2;
+          else if(doublePixels[i] == HIGH_REPR_SAT8)
+            raw[i] = HIGH_REPR_SAT2;
+          else
+            raw[i] = LOW_REPR_SAT2;
+        }
+      }
+    }
+
+    else if(m_pixelType == UnsignedInteger) {
+      unsigned int *raw = (unsigned int *)chunkPixels;
+
+      for(int i = 0; i < count; i++) {
+        double filePixelValueDbl = (doublePixels[i] - m_base) / m_multiplier;
+        double filePixelValue = round(filePixelValueDbl);
+        raw[i] = !(filePixelValue >= VALID_MINUI4) ? LOW_REPR_SATUI4 :
+                 (filePixelValueDbl > VALID_MAXUI4) ? HIGH_REPR_SATUI4 :
+                 (unsigned int) filePixelValue;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(!(doublePixels[i] >= VALID_MINUI4)) {
+          if(doublePixels[i] == NULL8)
+            raw[i] = NULLUI4;
+          else if(doublePixels[i] == LOW_INSTR_SAT8)
+            raw[i] = LOW_INSTR_SATUI4;
+          else if(doublePixels[i] == LOW_REPR_SAT8)
+            raw[i] = LOW_REPR_SATUI4;
+          else if(doublePixels[i] == HIGH_INSTR_SAT8)
+            raw[i] = HIGH_INSTR_SATUI4;
+          else if(doublePixels[i] == HIGH_REPR_SAT8)
+            raw[i] = HIGH_REPR_SATUI4;
+          else
+            raw[i] = LOW_REPR_SATUI4;
+        }
+      }
+    }
+
+    else if(m_pixelType == UnsignedWord) {
+      unsigned short *raw = (unsigned short *)chunkPixels;
+
+      for(int i = 0; i < count; i++) {
+        double filePixelValue =
+            round((doublePixels[i] - m_base) / m_multiplier);
+        raw[i] = !(filePixelValue >= VALID_MINU2) ? LOW_REPR_SATU2 :
+                 (filePixelValue > VALID_MAXU2) ? HIGH_REPR_SATU2 :
+                 (unsigned short) filePixelValue;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(!(doublePixels[i] >= VALID_MIN8)) {
+          if(doublePixels[i] == NULL8)
+            raw[i] = NULLU2;
+          else if(doublePixels[i] == LOW_INSTR_SAT8)
+            raw[i] = LOW_INSTR_SATU2;
+          else if(doublePixels[i] == LOW_REPR_SAT8)
+            raw[i] = LOW_REPR_SATU2;
+          else if(doublePixels[i] == HIGH_INSTR_SAT8)
+            raw[i] = HIGH_INSTR_SATU2;
+          else if(doublePixels[i] == HIGH_REPR_SAT8)
+            raw[i] = HIGH_REPR_SATU2;
+          else
+            raw[i] = LOW_REPR_SATU2;
+        }
+      }
+    }
+
+    else if(m_pixelType == UnsignedByte) {
+      unsigned char *raw = (unsigned char *)chunkPixels;
+
+      for(int i = 0; i < count; i++) {
+        double filePixelValue =
+            floor((doublePixels[i] - m_base) / m_multiplier + 0.5);
+        raw[i] = !(filePixelValue >= VALID_MIN1) ? LOW_REPR_SAT1 :
+                 (filePixelValue > VALID_MAX1) ? HIGH_REPR_SAT1 :
+                 (unsigned char) filePixelValue;
+      }
+
+      for(int i = 0; i < count; i++) {
+        if(!(doublePixels[i] >= VALID_MIN8)) {
+          if(doublePixels[i] == NULL8)
+            raw[i] = NULL1;
+          else if(doublePixels[i] == LOW_INSTR_SAT8)
+            raw[i] = LOW_INSTR_SAT1;
+          else if(doublePixels[i] == LOW_REPR_SAT8)
+            raw[i] = LOW_REPR_SAT1;
+          else if(doublePixels[i] == HIGH_INSTR_SAT8)
+            raw[i] = HIGH_INSTR_SAT1;
+          else if(doublePixels[i] == HIGH_REPR_SAT8)
+            raw[i] = HIGH_REPR_SAT1;
+          else
+            raw[i] = LOW_REPR_SAT1;
+        }
+      }
+    }
+
+    if(m_byteSwapper) {
+      swapPixels(chunkPixels, count);
+    }
+  }
+
+
+  /**
+   * Reverse the byte order of a run of pixels in place.
+   *
+   * @param pixels The pixels to swap
+   * @param count The number of pixels to swap
+   */
+  void CubeIoHandler::swapPixels(char *pixels, int count) const {
+    int pixelSize = SizeOf(m_pixelType);
+
+    if(pixelSize == 2) {
+      quint16 *swapped = (quint16 *)pixels;
+
+      for(int i = 0; i < count; i++) {
+        swapped[i] = qbswap(swapped[i]);
+      }
+    }
+    else if(pixelSize == 4) {
+      quint32 *swapped = (quint32 *)pixels;
+
+      for(int i = 0; i < count; i++) {
+        swapped[i] = qbswap(swapped[i]);
+      }
+    }
   }
 
 
@@ -1846,17 +2353,29 @@ namespace Isis {
     int numChunks = getChunkCount();
     for(int i = 0; i < numChunks; i++) {
       if(!(*m_dataIsOnDiskMap)[i]) {
-        RawCubeChunk *nullChunk = getNullChunk(i);
-        (const_cast<CubeIoHandler *>(this))->writeRaw(*nullChunk);
+        (const_cast<CubeIoHandler *>(this))->writeNullChunk(i);
         (*m_dataIsOnDiskMap)[i] = true;
-
-        delete nullChunk;
-        nullChunk = NULL;
       }
     }
   }
 
 
+  /**
+   * Put a chunk that was never written into a brand new cube on disk as all
+   *   NULL. Children that can represent NULL chunks without writing them out
+   *   should override this.
+   *
+   * @param chunkIndex The index of the chunk that needs to be NULL on disk
+   */
+  void CubeIoHandler::writeNullChunk(int chunkIndex) {
+    RawCubeChunk *nullChunk = getNullChunk(chunkIndex);
+    writeRaw(*nullChunk);
+
+    delete nullChunk;
+    nullChunk = NULL;
+  }
+
+
   /**
    * Create a BufferToChunkWriter which is designed to asynchronously move
    *   the given buffers into the cube cache. This will lock the
@@ -1954,4 +2473,57 @@ namespace Isis {
     m_buffersToWrite->clear();
     m_ioHandler->m_dataFile->flush();
   }
+
+
+  /**
+   * Create a ChunkPrefetcher which is designed to asynchronously read the
+   *   chunks for the given area into the cube cache.
+   *
+   * @param ioHandler This is the cube IO handler whose cache will be filled.
+   * @param startSample The starting sample of the area
+   * @param numSamples The number of samples in the area
+   * @param startLine The starting line of the area
+   * @param numLines The number of lines in the area
+   * @param startBand The starting (virtual) band of the area
+   * @param numBands The number of bands in the area
+   */
+  CubeIoHandler::ChunkPrefetcher::ChunkPrefetcher(
+      const CubeIoHandler * ioHandler, int startSample, int numSamples,
+      int startLine, int numLines, int startBand, int numBands) {
+    m_ioHandler = ioHandler;
+    m_startSample = startSample;
+    m_numSamples = numSamples;
+    m_startLine = startLine;
+    m_numLines = numLines;
+    m_startBand = startBand;
+    m_numBands = numBands;
+  }
+
+
+  /**
+   * Destructor
+   */
+  CubeIoHandler::ChunkPrefetcher::~ChunkPrefetcher() {
+    m_ioHandler = NULL;
+  }
+
+
+  /**
+   * This is the asynchronous computation. Read the area's chunks into the
+   *   cube cache. Cubes that can be written to are locked for the whole
+   *   prefetch, just like a read() of the area. Failures are ignored here;
+   *   the read() of the area will report them.
+   */
+  void CubeIoHandler::ChunkPrefetcher::run() {
+    QMutexLocker lock(m_ioHandler->m_concurrentReads ?
+                      NULL : m_ioHandler->m_writeThreadMutex);
+
+    try {
+      m_ioHandler->prefetchChunks(m_startSample, m_numSamples,
+                                  m_startLine, m_numLines,
+                                  m_startBand, m_numBands);
+    }
+    catch (IException &) {
+    }
+  }
 }
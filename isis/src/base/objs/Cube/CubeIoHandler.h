@@ -17,6 +17,7 @@ find files of those names at the top level of this repository. **/
 
 class QFile;
 class QMutex;
+class QReadWriteLock;
 class QTime;
 template <typename A> class QList;
 template <typename A, typename B> class QMap;
@@ -43,6 +44,24 @@ namespace Isis {
    *   guarantees that unwritten cube data ends up read and written as NULLs.
    *   The default caching algorithm is a RegionalCachingAlgorithm.
    *
+   * If the CubeReadMemoryMap performance preference is set to ReadOnly, cubes
+   *   opened read-only have their data file memory mapped. Reads then convert
+   *   straight from the mapped file into the Buffer (see mappedChunk()) and
+   *   bypass the chunk cache entirely.
+   *
+   * Callers that know which areas they will read next (for example, a process
+   *   walking a BufferManager through the cube) can call prefetch() to have
+   *   the required chunks read into the cache on a background IO thread.
+   *   Prefetched chunks are kept in the cache until they are read.
+   *
+   * The chunk cache is split into several shards by chunk index, each with its
+   *   own lock. Cubes that are opened read-only can never be written to, so
+   *   their reads do not need to be serialized: many threads may call read()
+   *   at the same time and only wait on each other when they need chunks from
+   *   the same shard or need to go to the disk. Freeing chunks from the cache
+   *   still happens one thread at a time. Cubes that can be written to read
+   *   and write one buffer at a time, as they always have.
+   *
    * @author 2011-??-?? Jai Rideout and Steven Lambright
    *
    * @internal
@@ -114,10 +133,11 @@ namespace Isis {
 
       void read(Buffer &bufferToFill) const;
       void write(const Buffer &bufferToWrite);
+      void prefetch(const Buffer &bufferToPrefetch) const;
 
       void addCachingAlgorithm(CubeCachingAlgorithm *algorithm);
       void clearCache(bool blockForWriteCache = true) const;
-      BigInt getDataSize() const;
+      virtual BigInt getDataSize() const;
       void setVirtualBands(const QList<int> *virtualBandList);
       /**
        * Function to update the labels with a Pvl object
@@ -132,19 +152,37 @@ namespace Isis {
       int bandCount() const;
       int getBandCountInChunk() const;
       BigInt getBytesPerChunk() const;
+      int getChunkCount() const;
       int getChunkCountInBandDimension() const;
       int getChunkCountInLineDimension() const;
       int getChunkCountInSampleDimension() const;
       int getChunkIndex(const RawCubeChunk &)  const;
       BigInt getDataStartByte() const;
       QFile * getDataFile();
+      RawCubeChunk *getNullChunk(int chunkIndex) const;
       int lineCount() const;
       int getLineCountInChunk() const;
       PixelType pixelType() const;
       int sampleCount() const;
       int getSampleCountInChunk() const;
 
-      void setChunkSizes(int numSamples, int numLines, int numBands);
+      void setChunkSizes(int numSamples, int numLines, int numBands,
+                         bool fixedSizeData = true);
+
+      const char *mappedFileData(BigInt startByte) const;
+
+      /**
+       * Children that lay their chunks out contiguously on disk should return
+       *   a pointer to the chunk's bytes inside of the memory mapped data file
+       *   (see mappedFileData()). The default implementation returns NULL,
+       *   which means the chunk can only be accessed through readRaw().
+       *
+       * @param chunkIndex The index of the chunk to locate in the mapped file
+       * @return A read-only view of the raw (unswapped) chunk data or NULL
+       */
+      virtual const char *mappedChunk(int chunkIndex) const {
+        return NULL;
+      }
 
       /**
        * This needs to populate the chunkToFill with unswapped raw bytes from
@@ -165,6 +203,8 @@ namespace Isis {
        */
       virtual void writeRaw(const RawCubeChunk &chunkToWrite) = 0;
 
+      virtual void writeNullChunk(int chunkIndex);
+
     private:
       /**
        * This class is designed to handle write() asynchronously.
@@ -213,6 +253,58 @@ namespace Isis {
       };
 
 
+      /**
+       * This class is designed to handle prefetch() asynchronously.
+       *
+       * This reads the chunks for an area of the cube into the cache in the
+       *   background so that a later read() of the same area does not have to
+       *   wait on the disk. It locks the ioHandler's cache the same way that a
+       *   read() of the area would.
+       */
+      class ChunkPrefetcher : public QRunnable {
+        public:
+          ChunkPrefetcher(const CubeIoHandler *ioHandler,
+                          int startSample, int numSamples,
+                          int startLine, int numLines,
+                          int startBand, int numBands);
+          ~ChunkPrefetcher();
+
+          void run();
+
+        private:
+          /**
+           * This is disabled.
+           * @param other Nothing.
+           */
+          ChunkPrefetcher(const ChunkPrefetcher & other);
+          /**
+           * This is disabled.
+           * @param rhs Nothing.
+           * @return Nothing.
+           */
+          ChunkPrefetcher & operator=(const ChunkPrefetcher & rhs);
+
+        private:
+          //! The IO Handler instance to read the chunks into
+          const CubeIoHandler * m_ioHandler;
+          //! The first sample of the area to prefetch
+          int m_startSample;
+          //! The number of samples in the area to prefetch
+          int m_numSamples;
+          //! The first line of the area to prefetch
+          int m_startLine;
+          //! The number of lines in the area to prefetch
+          int m_numLines;
+          //! The first (virtual) band of the area to prefetch
+          int m_startBand;
+          //! The number of bands in the area to prefetch
+          int m_numBands;
+      };
+
+
+      class ChunkCacheShard;
+
+
       /**
        * Disallow copying of this object.
        *
@@ -237,33 +329,72 @@ namespace Isis {
                                                                 int startLine, int numLines,
                                                                 int startBand, int numBands) const;
 
+      QPair< QList<int>, QList<int> > findCubeChunkIndices(int startSample, int numSamples,
+                                                           int startLine, int numLines,
+                                                           int startBand, int numBands) const;
+
       void findIntersection(const RawCubeChunk &cube1,
           const Buffer &cube2, int &startX, int &startY, int &startZ,
           int &endX, int &endY, int &endZ) const;
 
+      void findIntersection(int chunkStartSample, int chunkStartLine,
+          int chunkStartBand, int chunkSampleCount, int chunkLineCount,
+          int chunkBandCount, const Buffer &cube2,
+          int &startX, int &startY, int &startZ,
+          int &endX, int &endY, int &endZ) const;
+
       void flushWriteCache(bool force = false) const;
 
       void freeChunk(RawCubeChunk *chunkToFree) const;
 
       RawCubeChunk *getChunk(int chunkIndex, bool allocateIfNecessary) const;
 
-      int getChunkCount() const;
-
       void getChunkPlacement(int chunkIndex,
         int &startSample, int &startLine, int &startBand,
         int &endSample, int &endLine, int &endBand) const;
 
-      RawCubeChunk *getNullChunk(int chunkIndex) const;
+      void mapDataFile();
+
+      bool readMapped(Buffer &bufferToFill) const;
+
+      void concurrentRead(Buffer &bufferToFill) const;
+
+      RawCubeChunk *readChunk(int chunkIndex) const;
+
+      ChunkCacheShard &chunkCacheShard(int chunkIndex) const;
+
+      QList<RawCubeChunk *> cachedChunks() const;
+
+      int cachedChunkCount() const;
+
+      int prefetchedChunkCount() const;
 
       void minimizeCache(const QList<RawCubeChunk *> &justUsed,
                          const Buffer &justRequested) const;
 
+      void prefetchChunks(int startSample, int numSamples,
+                          int startLine, int numLines,
+                          int startBand, int numBands) const;
+
       void synchronousWrite(const Buffer &bufferToWrite);
 
       void writeIntoDouble(const RawCubeChunk &chunk, Buffer &output, int startIndex) const;
 
+      void writeIntoDouble(const char *chunkBuf, int chunkStartSample,
+                           int chunkStartLine, int chunkStartBand,
+                           int chunkSampleCount, int chunkLineCount,
+                           int chunkBandCount, Buffer &output, int index) const;
+
       void writeIntoRaw(const Buffer &buffer, RawCubeChunk &output, int index) const;
 
+      void convertToDouble(const char *chunkPixels, char *rawPixels,
+                           double *doublePixels, int count) const;
+
+      void convertToRaw(const double *doublePixels, char *chunkPixels,
+                        int count) const;
+
+      void swapPixels(char *pixels, int count) const;
+
       void writeNullDataToDisk() const;
 
     private:
@@ -304,8 +435,24 @@ namespace Isis {
       //! The caching algorithms to use, in order of priority.
       QList<CubeCachingAlgorithm *> * m_cachingAlgorithms;
 
-      //! The map from chunk index to chunk for cached data.
-      mutable QMap<int, RawCubeChunk *> * m_rawData;
+      /**
+       * The cached cube data. A chunk is always stored in the shard at
+       *   (chunk index % number of shards).
+       */
+      QList<ChunkCacheShard *> * m_chunkCache;
+
+      /**
+       * Concurrent reads hold this for reading while they use the chunk cache.
+       *   Freeing chunks or clearing the cache requires holding it for writing.
+       *   This is only used when m_concurrentReads is true.
+       */
+      QReadWriteLock *m_chunkCacheLock;
+
+      /**
+       * True if the cube can't be written to, meaning many threads can read()
+       *   simultaneously.
+       */
+      bool m_concurrentReads;
 
       //! The map from chunk index to on-disk status, all true if not allocated.
       mutable QMap<int, bool> * m_dataIsOnDiskMap;
@@ -352,7 +499,10 @@ namespace Isis {
        */
       bool m_useOptimizedCubeWrite;
 
-      //! This enables us to block while the write thread is working
+      /**
+       * This enables us to block while the write thread is working. Concurrent
+       *   reads also hold this while they read chunks from the data file.
+       */
       QMutex *m_writeThreadMutex;
 
       //! Ideal write cache flush size
@@ -360,6 +510,24 @@ namespace Isis {
 
       //! How many times the write cache has overflown in a row
       mutable int m_consecutiveOverflowCount;
+
+      /**
+       * This is true if the Isis preference for memory mapped cube reads is
+       *   enabled. Only cubes opened read-only are ever mapped.
+       */
+      bool m_useMemoryMappedRead;
+
+      //! The memory mapped data file, NULL if the data file isn't mapped.
+      uchar *m_mappedFile;
+
+      //! The number of bytes of the data file that are mapped into m_mappedFile.
+      BigInt m_mappedFileSize;
+
+      /**
+       * This contains the thread for doing prefetch() reads. It is only
+       *   allocated once prefetch() is first called.
+       */
+      mutable QThreadPool *m_prefetchThreadPool;
   };
 }
 
@@ -7,9 +7,16 @@ find files of those names at the top level of this repository. **/
 
 #include "CubeTileHandler.h"
 
+#include <algorithm>
+
+#include <QBitArray>
 #include <QFile>
+#include <QMutexLocker>
+#include <QPair>
 
 #include "IException.h"
+#include "IString.h"
+#include "Preference.h"
 #include "Pvl.h"
 #include "PvlObject.h"
 #include "PvlKeyword.h"
@@ -31,12 +38,33 @@ namespace Isis {
    */
   CubeTileHandler::CubeTileHandler(QFile * dataFile,
       const QList<int> *virtualBandList, const Pvl &labels, bool alreadyOnDisk)
+      : CubeTileHandler(dataFile, virtualBandList, labels, alreadyOnDisk, true) {
+  }
+
+
+  /**
+   * Construct a tile handler for children whose tiles don't all take up the
+   *   same number of bytes on disk. Those children size and check the data
+   *   file themselves.
+   *
+   * @param dataFile The file with cube DN data in it
+   * @param virtualBandList The mapping from virtual band to physical band, see
+   *          CubeIoHandler's description.
+   * @param labels The Pvl labels for the cube
+   * @param alreadyOnDisk True if the cube is allocated on the disk, false
+   *          otherwise
+   * @param fixedSizeTiles False if the data file must not be sized to hold
+   *          every tile uncompressed
+   */
+  CubeTileHandler::CubeTileHandler(QFile * dataFile,
+      const QList<int> *virtualBandList, const Pvl &labels, bool alreadyOnDisk,
+      bool fixedSizeTiles)
       : CubeIoHandler(dataFile, virtualBandList, labels, alreadyOnDisk) {
 
     const PvlObject &core = labels.findObject("IsisCube").findObject("Core");
 
     if(core.hasKeyword("Format")) {
-      setChunkSizes(core["TileSamples"], core["TileLines"], 1);
+      setChunkSizes(core["TileSamples"], core["TileLines"], 1, fixedSizeTiles);
     }
     else {
       // up to 1MB chunks
@@ -45,7 +73,45 @@ namespace Isis {
       int lineChunkSize =
           findGoodSize(512 * 4 / SizeOf(pixelType()), lineCount());
 
-      setChunkSizes(sampleChunkSize, lineChunkSize, 1);
+      setChunkSizes(sampleChunkSize, lineChunkSize, 1, fixedSizeTiles);
+    }
+
+    m_nullTiles = new QBitArray(getChunkCount());
+
+    RawCubeChunk *nullChunk = getNullChunk(0);
+    m_nullTileData = new QByteArray(nullChunk->getRawData());
+    delete nullChunk;
+
+    if (alreadyOnDisk && core.hasKeyword("NullTileRanges")) {
+      const PvlKeyword &nullTileRanges = core["NullTileRanges"];
+
+      for (int i = 0; i < nullTileRanges.size(); i += 2) {
+        int startTile = -1;
+        int tileCount = -1;
+
+        if (i + 1 < nullTileRanges.size()) {
+          startTile = toInt(nullTileRanges[i]);
+          tileCount = toInt(nullTileRanges[i + 1]);
+        }
+
+        if (startTile < 0 || tileCount < 0 ||
+            startTile + tileCount > m_nullTiles->size()) {
+          QString msg = "The NullTileRanges keyword in the labels of [" +
+              dataFile->fileName() + "] is not valid for a cube with [" +
+              toString(m_nullTiles->size()) + "] tiles";
+          throw IException(IException::Io, msg, _FILEINFO_);
+        }
+
+        m_nullTiles->fill(true, startTile, startTile + tileCount);
+      }
+    }
+
+    m_skipNullTiles = false;
+    PvlGroup &performancePrefs =
+        Preference::Preferences().findGroup("Performance");
+    if (performancePrefs.hasKeyword("CubeSkipNullTiles")) {
+      IString skipNullTilesPerfOpt = performancePrefs["CubeSkipNullTiles"][0];
+      m_skipNullTiles = (skipNullTilesPerfOpt.DownCase() == "always");
     }
   }
 
@@ -55,11 +121,22 @@ namespace Isis {
    */
   CubeTileHandler::~CubeTileHandler() {
     clearCache();
+
+    delete m_nullTiles;
+    m_nullTiles = NULL;
+
+    delete m_nullTileData;
+    m_nullTileData = NULL;
   }
 
 
   /**
-   * Update the cube labels so that this cube indicates what tile size it used.
+   * Update the cube labels so that this cube indicates what tile size it used
+   *   and which tiles were not written because they are NULL.
+   *
+   * The label space is limited, so only the largest runs of NULL tiles are
+   *   kept out of the file. The tiles in the rest of the runs are written to
+   *   the disk as NULL.
    *
    * @param labels The "Core" object in this Pvl will be updated
    */
@@ -71,10 +148,71 @@ namespace Isis {
                     PvlContainer::Replace);
     core.addKeyword(PvlKeyword("TileLines", toString(getLineCountInChunk())),
                     PvlContainer::Replace);
+
+    QMutexLocker locker(dataFileMutex());
+
+    // Each run of NULL tiles is a (start tile, tile count) pair
+    QList< QPair<int, int> > nullTileRanges;
+    int tileIndex = 0;
+    while (tileIndex < m_nullTiles->size()) {
+      if (m_nullTiles->testBit(tileIndex)) {
+        int startTile = tileIndex;
+
+        while (tileIndex < m_nullTiles->size() &&
+               m_nullTiles->testBit(tileIndex)) {
+          tileIndex++;
+        }
+
+        nullTileRanges.append(qMakePair(startTile, tileIndex - startTile));
+      }
+      else {
+        tileIndex++;
+      }
+    }
+
+    const int maxNullTileRanges = 512;
+    if (nullTileRanges.size() > maxNullTileRanges) {
+      std::stable_sort(nullTileRanges.begin(), nullTileRanges.end(),
+          [](const QPair<int, int> &lhs, const QPair<int, int> &rhs) {
+            return lhs.second > rhs.second;
+          });
+
+      while (nullTileRanges.size() > maxNullTileRanges) {
+        QPair<int, int> range = nullTileRanges.takeLast();
+
+        for (int i = range.first; i < range.first + range.second; i++) {
+          writeTile(i, *m_nullTileData);
+        }
+      }
+
+      std::sort(nullTileRanges.begin(), nullTileRanges.end());
+    }
+
+    if (nullTileRanges.isEmpty()) {
+      if (core.hasKeyword("NullTileRanges")) {
+        core.deleteKeyword("NullTileRanges");
+      }
+    }
+    else {
+      PvlKeyword nullTileRangesKeyword("NullTileRanges");
+
+      for (int i = 0; i < nullTileRanges.size(); i++) {
+        nullTileRangesKeyword.addValue(toString(nullTileRanges[i].first));
+        nullTileRangesKeyword.addValue(toString(nullTileRanges[i].second));
+      }
+
+      core.addKeyword(nullTileRangesKeyword, PvlContainer::Replace);
+    }
   }
 
 
   void CubeTileHandler::readRaw(RawCubeChunk &chunkToFill) {
+    // NULL tiles that weren't written don't need to come from the disk
+    if (m_nullTiles->testBit(getChunkIndex(chunkToFill))) {
+      chunkToFill.setRawData(*m_nullTileData);
+      return;
+    }
+
     BigInt startByte = getTileStartByte(chunkToFill);
 
     bool success = false;
@@ -100,25 +238,47 @@ namespace Isis {
 
 
   void CubeTileHandler::writeRaw(const RawCubeChunk &chunkToWrite) {
-    BigInt startByte = getTileStartByte(chunkToWrite);
-    bool success = false;
+    int tileIndex = getChunkIndex(chunkToWrite);
 
-    QFile * dataFile = getDataFile();
-    if(dataFile->seek(startByte)) {
-      BigInt dataWritten = dataFile->write(chunkToWrite.getRawData());
+    if (m_skipNullTiles && chunkToWrite.getRawData() == *m_nullTileData) {
+      skipNullTile(tileIndex);
+    }
+    else {
+      writeTile(tileIndex, chunkToWrite.getRawData());
+    }
+  }
 
-      if(dataWritten == chunkToWrite.getByteCount()) {
-        success = true;
-      }
+
+  /**
+   * Brand new cubes call this for every tile that was never written. The
+   *   tile is only written to the disk if NULL tiles aren't being skipped.
+   *
+   * @param chunkIndex The index of the tile that needs to be NULL
+   */
+  void CubeTileHandler::writeNullChunk(int chunkIndex) {
+    if (m_skipNullTiles) {
+      skipNullTile(chunkIndex);
     }
+    else {
+      writeTile(chunkIndex, *m_nullTileData);
+    }
+  }
 
-    if(!success) {
-      IString msg = "Writing to the file [" + dataFile->fileName() + "] "
-          "failed with writing [" +
-          QString::number(chunkToWrite.getByteCount()) +
-          "] bytes at position [" + QString::number(startByte) + "]";
-      throw IException(IException::Io, msg, _FILEINFO_);
+
+  /**
+   * Get a view of the chunk inside of the memory mapped data file. Chunks are
+   *   stored contiguously, so this is just an offset into the mapping.
+   *
+   * @param chunkIndex The index of the chunk to find
+   * @return The raw chunk data, or NULL if the data file isn't memory mapped
+   */
+  const char *CubeTileHandler::mappedChunk(int chunkIndex) const {
+    // NULL tiles that weren't written only exist in memory
+    if (m_nullTiles->testBit(chunkIndex)) {
+      return NULL;
     }
+
+    return mappedFileData(getTileStartByte(chunkIndex));
   }
 
 
@@ -161,6 +321,71 @@ namespace Isis {
    * @returns The position to start reading or writing at
    */
   BigInt CubeTileHandler::getTileStartByte(const RawCubeChunk &chunk) const {
-    return getDataStartByte() + getChunkIndex(chunk) * getBytesPerChunk();
+    return getTileStartByte(getChunkIndex(chunk));
+  }
+
+
+  /**
+   * This is a helper method that goes from chunk index to file position.
+   *
+   * @param chunkIndex The index of the chunk to locate in the file.
+   * @return The file position to start reading or writing at
+   */
+  BigInt CubeTileHandler::getTileStartByte(int chunkIndex) const {
+    return getDataStartByte() + chunkIndex * getBytesPerChunk();
+  }
+
+
+  /**
+   * Mark a tile as NULL instead of writing it to the disk. The file is kept
+   *   as large as it would be if the last tile had been written so that
+   *   anything stored after the cube data, like blobs, doesn't move.
+   *
+   * @param tileIndex The index of the NULL tile
+   */
+  void CubeTileHandler::skipNullTile(int tileIndex) {
+    m_nullTiles->setBit(tileIndex);
+
+    if (tileIndex == getChunkCount() - 1) {
+      QFile * dataFile = getDataFile();
+      BigInt dataEndByte = getTileStartByte(tileIndex + 1);
+
+      if (dataFile->size() < dataEndByte && !dataFile->resize(dataEndByte)) {
+        IString msg = "Resizing the file [" + dataFile->fileName() + "] to [" +
+            QString::number(dataEndByte) + "] bytes failed";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+    }
+  }
+
+
+  /**
+   * Write a tile's raw data to its place on the disk.
+   *
+   * @param tileIndex The index of the tile to write
+   * @param tileData The unswapped raw bytes of the tile
+   */
+  void CubeTileHandler::writeTile(int tileIndex, const QByteArray &tileData) {
+    BigInt startByte = getTileStartByte(tileIndex);
+    bool success = false;
+
+    QFile * dataFile = getDataFile();
+    if(dataFile->seek(startByte)) {
+      BigInt dataWritten = dataFile->write(tileData);
+
+      if(dataWritten == tileData.size()) {
+        success = true;
+      }
+    }
+
+    if(!success) {
+      IString msg = "Writing to the file [" + dataFile->fileName() + "] "
+          "failed with writing [" +
+          QString::number(tileData.size()) +
+          "] bytes at position [" + QString::number(startByte) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    m_nullTiles->clearBit(tileIndex);
   }
 }
@@ -9,6 +9,9 @@ find files of those names at the top level of this repository. **/
 
 #include "CubeIoHandler.h"
 
+class QBitArray;
+class QByteArray;
+
 namespace Isis {
 
   /**
@@ -17,6 +20,14 @@ namespace Isis {
    * This class is used to open, create, read, and write data from Isis cube
    * files.
    *
+   * When the CubeSkipNullTiles performance preference is Always, tiles that
+   *   are entirely NULL are not written to the disk. Which tiles were skipped
+   *   is kept in the NullTileRanges keyword of the Core object as pairs of
+   *   0-based starting tile index and tile count, and reading those tiles
+   *   gives back NULLs without touching the disk. The file is still as large
+   *   as it would be with every tile written, so skipped tiles become holes in
+   *   file systems that support sparse files.
+   *
    * @ingroup LowLevelCubeIO
    *
    * @author 2003-02-14 Jeff Anderson
@@ -41,8 +52,13 @@ namespace Isis {
       void updateLabels(Pvl &label);
 
     protected:
+      CubeTileHandler(QFile * dataFile, const QList<int> *virtualBandList,
+          const Pvl &label, bool alreadyOnDisk, bool fixedSizeTiles);
+
       virtual void readRaw(RawCubeChunk &chunkToFill);
       virtual void writeRaw(const RawCubeChunk &chunkToWrite);
+      virtual void writeNullChunk(int chunkIndex);
+      virtual const char *mappedChunk(int chunkIndex) const;
 
     private:
       /**
@@ -63,6 +79,19 @@ namespace Isis {
 
       int findGoodSize(int maxSize, int dimensionSize) const;
       BigInt getTileStartByte(const RawCubeChunk &chunk) const;
+      BigInt getTileStartByte(int chunkIndex) const;
+      void skipNullTile(int tileIndex);
+      void writeTile(int tileIndex, const QByteArray &tileData);
+
+    private:
+      //! The tiles that are NULL and weren't written to the disk
+      QBitArray *m_nullTiles;
+
+      //! The raw data of a NULL tile
+      QByteArray *m_nullTileData;
+
+      //! True if NULL tiles should not be written to the disk
+      bool m_skipNullTiles;
   };
 }
 
@@ -0,0 +1,374 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "DemElevationPyramid.h"
+
+#include <algorithm>
+#include <cfloat>
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "Constants.h"
+#include "Cube.h"
+#include "IException.h"
+#include "IString.h"
+#include "LineManager.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+#include "SpecialPixel.h"
+#include "Table.h"
+#include "TableField.h"
+#include "TableRecord.h"
+
+using namespace std;
+
+namespace Isis {
+  //! Serializes acquire and release
+  static QMutex pyramidsMutex;
+  //! The shared pyramid of each DEM cube
+  static QHash<Cube *, DemElevationPyramid *> pyramids;
+
+
+  /**
+   * Computes the pyramid of a DEM from its first band, with a block size that
+   * suits the size of the DEM.
+   *
+   * @param demCube The DEM, with radii in meters
+   */
+  DemElevationPyramid::DemElevationPyramid(Cube &demCube) {
+    compute(demCube, defaultBlockSize(demCube.sampleCount(), demCube.lineCount()));
+  }
+
+
+  /**
+   * Computes the pyramid of a DEM from its first band.
+   *
+   * @param demCube The DEM, with radii in meters
+   * @param blockSize The number of DEM pixels across each first level block
+   */
+  DemElevationPyramid::DemElevationPyramid(Cube &demCube, int blockSize) {
+    compute(demCube, blockSize);
+  }
+
+
+  /**
+   * Reads a pyramid from the table that toTable created.
+   *
+   * @param table The ShapeModelPyramid table
+   */
+  DemElevationPyramid::DemElevationPyramid(Table &table) {
+    m_demCube = NULL;
+    m_references = 0;
+
+    PvlObject &label = table.Label();
+    if (!label.hasKeyword("Samples") || !label.hasKeyword("Lines") ||
+        !label.hasKeyword("BlockSize")) {
+      QString msg = "The table [" + table.Name() + "] is not an elevation pyramid";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    int blockSize = toInt(label["BlockSize"][0]);
+    if (blockSize < 1) {
+      QString msg = "The elevation pyramid table [" + table.Name() +
+                    "] has an invalid block size [" + toString(blockSize) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    init(toInt(label["Samples"][0]), toInt(label["Lines"][0]), blockSize);
+
+    if (table.Records() != m_minimum.size()) {
+      QString msg = "The elevation pyramid table [" + table.Name() + "] has [" +
+                    toString(table.Records()) + "] records instead of [" +
+                    toString(m_minimum.size()) + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    for (int i = 0; i < table.Records(); i++) {
+      double minRadius = table[i]["MinimumRadius"];
+      double maxRadius = table[i]["MaximumRadius"];
+      if (!IsSpecial(minRadius) && !IsSpecial(maxRadius)) {
+        m_minimum[i] = minRadius;
+        m_maximum[i] = maxRadius;
+      }
+    }
+  }
+
+
+  //! Destroys the pyramid
+  DemElevationPyramid::~DemElevationPyramid() {
+  }
+
+
+  /**
+   * Returns the shared pyramid of a DEM, reading it from the DEM's
+   * ShapeModelPyramid table on first use. Every call that returns a pyramid
+   * must be paired with a call to release.
+   *
+   * @param demCube The DEM
+   *
+   * @return @b DemElevationPyramid* The DEM's pyramid, or NULL if the DEM
+   *                                 does not have one
+   */
+  DemElevationPyramid *DemElevationPyramid::acquire(Cube *demCube) {
+    QMutexLocker locker(&pyramidsMutex);
+    DemElevationPyramid *pyramid = pyramids.value(demCube, NULL);
+    if (!pyramid) {
+      if (!demCube->hasTable(tableName())) {
+        return NULL;
+      }
+
+      Table table(tableName(), demCube->fileName(), *demCube->label());
+      pyramid = new DemElevationPyramid(table);
+      pyramid->m_demCube = demCube;
+      pyramids.insert(demCube, pyramid);
+    }
+    pyramid->m_references++;
+    return pyramid;
+  }
+
+
+  /**
+   * Gives up a pyramid from acquire. The pyramid is deleted when its last
+   * user releases it.
+   *
+   * @param pyramid The pyramid to release. NULL is ignored.
+   */
+  void DemElevationPyramid::release(DemElevationPyramid *pyramid) {
+    if (!pyramid) {
+      return;
+    }
+
+    QMutexLocker locker(&pyramidsMutex);
+    pyramid->m_references--;
+    if (pyramid->m_references <= 0) {
+      pyramids.remove(pyramid->m_demCube);
+      delete pyramid;
+    }
+  }
+
+
+  /**
+   * @return @b QString The name of the table that holds the pyramid in a DEM
+   */
+  QString DemElevationPyramid::tableName() {
+    return "ShapeModelPyramid";
+  }
+
+
+  /**
+   * Chooses a block size for a DEM. Small DEMs use 16 pixel blocks, and the
+   * block size doubles until the first level has at most 2^18 blocks, so the
+   * table of a global DEM stays a few megabytes.
+   *
+   * @param samples The number of samples in the DEM
+   * @param lines The number of lines in the DEM
+   *
+   * @return @b int The number of DEM pixels across each first level block
+   */
+  int DemElevationPyramid::defaultBlockSize(int samples, int lines) {
+    const BigInt maxBlocks = 1 << 18;
+
+    int blockSize = 16;
+    while ((BigInt)((samples + blockSize - 1) / blockSize) *
+           ((lines + blockSize - 1) / blockSize) > maxBlocks) {
+      blockSize *= 2;
+    }
+    return blockSize;
+  }
+
+
+  /**
+   * Writes the pyramid to a table, one record per block starting with the
+   * first level. Blocks without any valid DEM pixels are NULL.
+   *
+   * @return @b Table The ShapeModelPyramid table
+   */
+  Table DemElevationPyramid::toTable() const {
+    TableField minRadius("MinimumRadius", TableField::Double);
+    TableField maxRadius("MaximumRadius", TableField::Double);
+
+    TableRecord record;
+    record += minRadius;
+    record += maxRadius;
+
+    Table table(tableName(), record);
+    table.Label() += PvlKeyword("Samples", toString(m_samples));
+    table.Label() += PvlKeyword("Lines", toString(m_lines));
+    table.Label() += PvlKeyword("BlockSize", toString(m_blockSize));
+
+    for (int i = 0; i < m_minimum.size(); i++) {
+      bool valid = m_minimum[i] <= m_maximum[i];
+      record[0] = valid ? m_minimum[i] : Null;
+      record[1] = valid ? m_maximum[i] : Null;
+      table += record;
+    }
+
+    return table;
+  }
+
+
+  /**
+   * @return @b int The number of levels in the pyramid
+   */
+  int DemElevationPyramid::levels() const {
+    return m_levelOffsets.size();
+  }
+
+
+  /**
+   * @return @b int The number of DEM pixels across each first level block
+   */
+  int DemElevationPyramid::blockSize() const {
+    return m_blockSize;
+  }
+
+
+  /**
+   * Bounds the radii over an area of the DEM. The bounds come from the
+   * finest level where the area touches at most 2x2 blocks, so they can be
+   * wider than the actual range but never narrower.
+   *
+   * @param startSample The first DEM sample of the area
+   * @param startLine The first DEM line of the area
+   * @param endSample The last DEM sample of the area
+   * @param endLine The last DEM line of the area
+   * @param minRadius Set to at most the smallest radius in the area, in km
+   * @param maxRadius Set to at least the largest radius in the area, in km
+   *
+   * @return @b bool False if the area is off the DEM or has no valid pixels
+   */
+  bool DemElevationPyramid::range(int startSample, int startLine, int endSample, int endLine,
+                                  double &minRadius, double &maxRadius) const {
+    startSample = max(startSample, 1) - 1;
+    startLine = max(startLine, 1) - 1;
+    endSample = min(endSample, m_samples) - 1;
+    endLine = min(endLine, m_lines) - 1;
+    if (startSample > endSample || startLine > endLine) {
+      return false;
+    }
+
+    int level = 0;
+    int size = m_blockSize;
+    while (level + 1 < levels() &&
+           (endSample / size - startSample / size > 1 || endLine / size - startLine / size > 1)) {
+      level++;
+      size *= 2;
+    }
+
+    minRadius = DBL_MAX;
+    maxRadius = -DBL_MAX;
+    for (int blockLine = startLine / size; blockLine <= endLine / size; blockLine++) {
+      for (int blockSample = startSample / size; blockSample <= endSample / size; blockSample++) {
+        int block = blockIndex(level, blockSample, blockLine);
+        minRadius = min(minRadius, m_minimum[block]);
+        maxRadius = max(maxRadius, m_maximum[block]);
+      }
+    }
+
+    return minRadius <= maxRadius;
+  }
+
+
+  /**
+   * Computes the pyramid of a DEM from its first band.
+   *
+   * @param demCube The DEM, with radii in meters
+   * @param blockSize The number of DEM pixels across each first level block
+   */
+  void DemElevationPyramid::compute(Cube &demCube, int blockSize) {
+    m_demCube = NULL;
+    m_references = 0;
+
+    if (blockSize < 1) {
+      QString msg = "The elevation pyramid block size [" + toString(blockSize) +
+                    "] must be positive";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    init(demCube.sampleCount(), demCube.lineCount(), blockSize);
+
+    LineManager line(demCube);
+    for (int lineNum = 1; lineNum <= m_lines; lineNum++) {
+      line.SetLine(lineNum, 1);
+      demCube.read(line);
+
+      int blockLine = (lineNum - 1) / m_blockSize;
+      for (int i = 0; i < line.size(); i++) {
+        if (IsSpecial(line[i])) continue;
+
+        double radius = line[i] / 1000.0;
+        int block = blockIndex(0, i / m_blockSize, blockLine);
+        m_minimum[block] = min(m_minimum[block], radius);
+        m_maximum[block] = max(m_maximum[block], radius);
+      }
+    }
+
+    buildLevels();
+  }
+
+
+  /**
+   * Sizes the levels and marks every block as having no valid pixels.
+   *
+   * @param samples The number of samples in the DEM
+   * @param lines The number of lines in the DEM
+   * @param blockSize The number of DEM pixels across each first level block
+   */
+  void DemElevationPyramid::init(int samples, int lines, int blockSize) {
+    m_samples = samples;
+    m_lines = lines;
+    m_blockSize = blockSize;
+
+    int blocks = 0;
+    int levelSamples = (samples + blockSize - 1) / blockSize;
+    int levelLines = (lines + blockSize - 1) / blockSize;
+    while (true) {
+      m_levelSamples.append(levelSamples);
+      m_levelLines.append(levelLines);
+      m_levelOffsets.append(blocks);
+      blocks += levelSamples * levelLines;
+
+      if (levelSamples == 1 && levelLines == 1) break;
+      levelSamples = (levelSamples + 1) / 2;
+      levelLines = (levelLines + 1) / 2;
+    }
+
+    m_minimum.fill(DBL_MAX, blocks);
+    m_maximum.fill(-DBL_MAX, blocks);
+  }
+
+
+  /**
+   * Fills in every level above the first from the level below it.
+   */
+  void DemElevationPyramid::buildLevels() {
+    for (int level = 1; level < levels(); level++) {
+      for (int line = 0; line < m_levelLines[level - 1]; line++) {
+        for (int sample = 0; sample < m_levelSamples[level - 1]; sample++) {
+          int child = blockIndex(level - 1, sample, line);
+          int parent = blockIndex(level, sample / 2, line / 2);
+          m_minimum[parent] = min(m_minimum[parent], m_minimum[child]);
+          m_maximum[parent] = max(m_maximum[parent], m_maximum[child]);
+        }
+      }
+    }
+  }
+
+
+  /**
+   * @param level The pyramid level
+   * @param blockSample The zero based block column in the level
+   * @param blockLine The zero based block row in the level
+   *
+   * @return @b int The index of the block in the minimum and maximum vectors
+   */
+  int DemElevationPyramid::blockIndex(int level, int blockSample, int blockLine) const {
+    return m_levelOffsets[level] + blockLine * m_levelSamples[level] + blockSample;
+  }
+}
@@ -0,0 +1,76 @@
+#ifndef DemElevationPyramid_h
+#define DemElevationPyramid_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+namespace Isis {
+  class Cube;
+  class Table;
+
+  /**
+   * @brief Minimum and maximum radii over blocks of a DEM at several scales
+   *
+   * The first level of the pyramid holds the minimum and maximum radius of
+   * each square block of DEM pixels. Each level above it merges 2x2 blocks of
+   * the level below, up to a single block that covers the whole DEM. This
+   * bounds the surface under any area of the DEM with a few lookups, which
+   * lets a ray tracer skip the parts of a ray that are above the terrain.
+   *
+   * demprep stores the pyramid in the DEM as the ShapeModelPyramid table, and
+   * DemShape uses it when it is there. Radii are in kilometers, like the
+   * ShapeModelStatistics table. The pyramid read from a DEM is shared by every
+   * shape model that uses the DEM, through acquire and release. It does not
+   * change once it is read, so it may be used from several threads at once.
+   *
+   * @ingroup Camera
+   */
+  class DemElevationPyramid {
+    public:
+      DemElevationPyramid(Cube &demCube);
+      DemElevationPyramid(Cube &demCube, int blockSize);
+      DemElevationPyramid(Table &table);
+      ~DemElevationPyramid();
+
+      static DemElevationPyramid *acquire(Cube *demCube);
+      static void release(DemElevationPyramid *pyramid);
+
+      static QString tableName();
+      static int defaultBlockSize(int samples, int lines);
+      Table toTable() const;
+
+      int levels() const;
+      int blockSize() const;
+
+      bool range(int startSample, int startLine, int endSample, int endLine,
+                 double &minRadius, double &maxRadius) const;
+
+    private:
+      Q_DISABLE_COPY(DemElevationPyramid)
+
+      void compute(Cube &demCube, int blockSize);
+      void init(int samples, int lines, int blockSize);
+      void buildLevels();
+      int blockIndex(int level, int blockSample, int blockLine) const;
+
+      int m_samples;                  //!< Number of samples in the DEM
+      int m_lines;                    //!< Number of lines in the DEM
+      int m_blockSize;                //!< DEM pixels across a first level block
+      QVector<int> m_levelSamples;    //!< Blocks across each level
+      QVector<int> m_levelLines;      //!< Blocks down each level
+      QVector<int> m_levelOffsets;    //!< Index of each level's first block
+      QVector<double> m_minimum;      //!< Minimum radius of each block in km
+      QVector<double> m_maximum;      //!< Maximum radius of each block in km
+      Cube *m_demCube;                //!< The DEM a shared pyramid was read from
+      int m_references;               //!< Number of users from acquire
+  };
+}
+
+#endif
@@ -25,6 +25,8 @@ find files of those names at the top level of this repository. **/
 
 #include "Cube.h"
 #include "CubeManager.h"
+#include "DemElevationPyramid.h"
+#include "DemTileCache.h"
 #include "Distance.h"
 #include "EllipsoidShape.h"
 //#include "Geometry3D.h"
@@ -36,6 +38,7 @@ find files of those names at the top level of this repository. **/
 #include "NaifStatus.h"
 #include "Portal.h"
 #include "Projection.h"
+#include "ProjectionFactory.h"
 #include "Pvl.h"
 #include "Spice.h"
 #include "SurfacePoint.h"
@@ -57,6 +60,8 @@ namespace Isis {
     m_demCube = NULL;
     m_interp = NULL;
     m_portal = NULL;
+    m_demCache = NULL;
+    m_demPyramid = NULL;
   }
 
 
@@ -74,6 +79,8 @@ namespace Isis {
     m_demCube = NULL;
     m_interp = NULL;
     m_portal = NULL;
+    m_demCache = NULL;
+    m_demPyramid = NULL;
 
     PvlGroup &kernels = pvl.findGroup("Kernels", Pvl::Traverse);
 
@@ -94,22 +101,41 @@ namespace Isis {
     //   from iteration 1 of setlookdirection (first algorithm) at iteration
     //   4 and the next setimage has to re-read the data.
     m_demCube->addCachingAlgorithm(new UniqueIOCachingAlgorithm(5));
-    m_demProj = m_demCube->projection();
+    // The DEM cube is shared through the CubeManager, but every shape needs its
+    //   own projection so that cameras used by different threads don't share state
+    m_demProj = ProjectionFactory::CreateFromCube(*m_demCube);
     m_interp = new Interpolator(Interpolator::BiLinearType);
     m_portal = new Portal(m_interp->Samples(), m_interp->Lines(),
                             m_demCube->pixelType(),
                             m_interp->HotSample(), m_interp->HotLine());
 
+    // Elevations come from the shared in-memory tiles unless DEM caching is off
+    m_demCache = DemTileCache::acquire(m_demCube);
+
     // Read in the Scale of the DEM file in pixels/degree
     const PvlGroup &mapgrp = m_demCube->label()->findGroup("Mapping", Pvl::Traverse);
 
     // Save map scale in pixels per degree
     m_pixPerDegree = (double) mapgrp["Scale"];
+
+    // Equatorial cylindrical DEMs prepared by demprep carry an elevation
+    // pyramid that bounds the ray traversal. Like the tiles, it is read once
+    // and shared by every shape on the DEM.
+    if (m_demProj->IsEquatorialCylindrical()) {
+      m_demPyramid = DemElevationPyramid::acquire(m_demCube);
+    }
   }
 
 
   //! Destroys the DemShape
   DemShape::~DemShape() {
+    DemElevationPyramid::release(m_demPyramid);
+    m_demPyramid = NULL;
+
+    DemTileCache::release(m_demCache);
+    m_demCache = NULL;
+
+    delete m_demProj;
     m_demProj = NULL;
 
     // We do not have ownership of p_demCube
@@ -135,6 +161,9 @@ namespace Isis {
    * Mercury). This implies that info at the limb will not always be computed.
    * In the future we may want to do a better job handling this special case.
    *
+   * DEMs with an elevation pyramid don't have this problem, see
+   * intersectPyramid.
+   *
    * @param observerPos
    * @param lookDirection
    *
@@ -142,6 +171,10 @@ namespace Isis {
    */
   bool DemShape::intersectSurface(vector<double> observerPos,
                                   vector<double> lookDirection) {
+    if (m_demPyramid) {
+      return intersectPyramid(observerPos, lookDirection);
+    }
+
     // try to intersect the target body ellipsoid as a first approximation
     // for the iterative DEM intersection method
     // (this method is in the ShapeModel base class)
@@ -253,6 +286,234 @@ namespace Isis {
   }
 
 
+  /**
+   * Find the first intersection of a ray with the DEM using its elevation
+   * pyramid. The part of the ray between the spheres of the DEM's largest
+   * and smallest radii is split in half over and over. Pieces that the
+   * pyramid shows are above all of the terrain under them are skipped, in
+   * order along the ray, until a piece about a DEM pixel long is left. The
+   * first such piece where the ray goes from above to below the surface holds
+   * the intersection, which is then refined with the regula falsi method.
+   *
+   * Unlike the iteration in intersectSurface, this doesn't need to intersect
+   * the ellipsoid first, and it finds the intersection closest to the observer
+   * even on rough terrain or at grazing angles.
+   *
+   * @param observerPos The body-fixed position of the observer in kilometers
+   * @param lookDirection The body-fixed look direction
+   *
+   * @return @b bool Indicates whether the intersection was found.
+   */
+  bool DemShape::intersectPyramid(const vector<double> &observerPos,
+                                  const vector<double> &lookDirection) {
+    setHasIntersection(false);
+
+    SpiceDouble origin[3] = {observerPos[0], observerPos[1], observerPos[2]};
+    SpiceDouble look[3] = {lookDirection[0], lookDirection[1], lookDirection[2]};
+    vhat_c(look, look);
+
+    double minRadius, maxRadius;
+    if (!m_demPyramid->range(1, 1, m_demCube->sampleCount(), m_demCube->lineCount(),
+                             minRadius, maxRadius)) {
+      return false;
+    }
+
+    // The surface is between the spheres of the smallest and largest radii
+    double b = vdot_c(origin, look);
+    double c = vdot_c(origin, origin);
+    double disc = b * b - (c - maxRadius * maxRadius);
+    if (disc < 0.0) {
+      return false;
+    }
+
+    double tStart = max(0.0, -b - sqrt(disc));
+    double tEnd = -b + sqrt(disc);
+    double minDisc = b * b - (c - minRadius * minRadius);
+    if (minDisc >= 0.0 && -b - sqrt(minDisc) >= 0.0) {
+      tEnd = min(tEnd, -b - sqrt(minDisc));
+    }
+
+    // Stop splitting at about a DEM pixel, and refine to 1/100 of a pixel.
+    // There is no intersection yet, so the size comes from the DEM's scale.
+    double leafLength = maxRadius * DEG2RAD / m_pixPerDegree;
+    double tol = leafLength / 100.0;
+
+    // Pieces of the ray still to check, the nearest at the back
+    QVector< QPair<double, double> > pieces;
+    pieces.append(qMakePair(tStart, tEnd));
+
+    SpiceDouble point[3];
+    while (!pieces.isEmpty()) {
+      double ta = pieces.last().first;
+      double tb = pieces.last().second;
+      pieces.removeLast();
+
+      // The lowest point of the ray on this piece
+      double tLow = max(ta, min(tb, -b));
+      vlcom_c(1.0, origin, tLow, look, point);
+      double rayMin = vnorm_c(point);
+
+      double tMid = (ta + tb) / 2.0;
+      vlcom_c(1.0, origin, tMid, look, point);
+      double surfaceMin, surfaceMax;
+      if (!pyramidRange(point, (tb - ta) / 2.0, surfaceMin, surfaceMax) ||
+          rayMin > surfaceMax) {
+        continue;
+      }
+
+      if (tb - ta > leafLength) {
+        pieces.append(qMakePair(tMid, tb));
+        pieces.append(qMakePair(ta, tMid));
+        continue;
+      }
+
+      // Look for the ray crossing the surface on this piece
+      double fa, fb;
+      if (!heightAboveSurface(origin, look, ta, fa) ||
+          !heightAboveSurface(origin, look, tb, fb) ||
+          fa < 0.0 || fb > 0.0) {
+        continue;
+      }
+
+      // Illinois variant of regula falsi
+      static const int maxit = 100;
+      double t = tb;
+      int side = 0;
+      for (int it = 0; it < maxit && tb - ta > tol && fa - fb > 0.0; it++) {
+        t = (ta * fb - tb * fa) / (fb - fa);
+        double f;
+        if (!heightAboveSurface(origin, look, t, f)) {
+          return false;
+        }
+        if (fabs(f) < tol) {
+          break;
+        }
+
+        if (f > 0.0) {
+          ta = t;
+          fa = f;
+          if (side == 1) fb /= 2.0;
+          side = 1;
+        }
+        else {
+          tb = t;
+          fb = f;
+          if (side == -1) fa /= 2.0;
+          side = -1;
+        }
+      }
+
+      vlcom_c(1.0, origin, t, look, point);
+      surfaceIntersection()->FromNaifArray(point);
+      setHasIntersection(true);
+      return true;
+    }
+
+    return false;
+  }
+
+
+  /**
+   * Bounds the DEM radii under a piece of a ray from the elevation pyramid.
+   * Every point of the piece is within halfLength of its middle, so its ground
+   * track is inside a latitude/longitude box around the middle.
+   *
+   * @param middle The body-fixed middle of the piece in kilometers
+   * @param halfLength Half the length of the piece in kilometers
+   * @param minRadius Set to at most the smallest radius under the piece, in km
+   * @param maxRadius Set to at least the largest radius under the piece, in km
+   *
+   * @return @b bool False if there is no valid DEM under the piece
+   */
+  bool DemShape::pyramidRange(const double middle[3], double halfLength,
+                              double &minRadius, double &maxRadius) {
+    int samples = m_demCube->sampleCount();
+    int lines = m_demCube->lineCount();
+
+    double dist = vnorm_c(middle);
+    if (halfLength >= dist) {
+      return m_demPyramid->range(1, 1, samples, lines, minRadius, maxRadius);
+    }
+
+    double lat = asin(middle[2] / dist) * RAD2DEG;
+    double lon = atan2(middle[1], middle[0]) * RAD2DEG;
+    if (lon < 0) {
+      lon += 360;
+    }
+
+    double pad = asin(halfLength / dist);
+    double latLo = max(-90.0, lat - pad * RAD2DEG);
+    double latHi = min(90.0, lat + pad * RAD2DEG);
+
+    // The DEM is equatorial cylindrical, so lines only depend on latitude
+    // and samples only on longitude
+    int startLine = 1, endLine = lines;
+    if (m_demProj->SetUniversalGround(latHi, lon)) {
+      double y1 = m_demProj->WorldY();
+      if (m_demProj->SetUniversalGround(latLo, lon)) {
+        double y2 = m_demProj->WorldY();
+        startLine = (int)floor(min(y1, y2)) - 1;
+        endLine = (int)ceil(max(y1, y2)) + 1;
+      }
+    }
+
+    int startSample = 1, endSample = samples;
+    double cosLat = cos(max(fabs(latLo), fabs(latHi)) * DEG2RAD);
+    if (sin(pad) < cosLat) {
+      double lonPad = asin(sin(pad) / cosLat) * RAD2DEG;
+      double x[3];
+      bool good = true;
+      for (int i = 0; i < 3 && good; i++) {
+        good = m_demProj->SetUniversalGround(lat, lon + (i - 1) * lonPad);
+        x[i] = m_demProj->WorldX();
+      }
+
+      // Pieces across the edge of the DEM's longitude domain use every sample
+      if (good && ((x[0] <= x[1] && x[1] <= x[2]) || (x[0] >= x[1] && x[1] >= x[2]))) {
+        startSample = (int)floor(min(x[0], x[2])) - 1;
+        endSample = (int)ceil(max(x[0], x[2])) + 1;
+      }
+    }
+
+    return m_demPyramid->range(startSample, startLine, endSample, endLine,
+                               minRadius, maxRadius);
+  }
+
+
+  /**
+   * Computes how far a point on a ray is above the DEM surface.
+   *
+   * @param origin The body-fixed origin of the ray in kilometers
+   * @param look The unit look direction of the ray
+   * @param t The distance along the ray in kilometers
+   * @param height Set to the distance from the body center to the point less
+   *               the DEM radius under it, in kilometers
+   *
+   * @return @b bool False if the DEM has no radius under the point
+   */
+  bool DemShape::heightAboveSurface(const double origin[3], const double look[3],
+                                    double t, double &height) {
+    SpiceDouble point[3];
+    vlcom_c(1.0, origin, t, look, point);
+
+    double dist = vnorm_c(point);
+    double latDD = asin(point[2] / dist) * RAD2DEG;
+    double lonDD = atan2(point[1], point[0]) * RAD2DEG;
+    if (lonDD < 0) {
+      lonDD += 360;
+    }
+
+    Distance radius = localRadius(Latitude(latDD, Angle::Degrees),
+                                  Longitude(lonDD, Angle::Degrees));
+    if (!radius.isValid() || Isis::IsSpecial(radius.kilometers())) {
+      return false;
+    }
+
+    height = dist - radius.kilometers();
+    return true;
+  }
+
+
   /**
    * Gets the radius from the DEM, if we have one.
    *
@@ -273,14 +534,29 @@ namespace Isis {
       // if (!m_demProj->IsGood())
       //   return Distance();
 
-      m_portal->SetPosition(m_demProj->WorldX(), m_demProj->WorldY(), 1);
+      if (m_demCache) {
+        // The bilinear interpolator needs the 2x2 window that a Portal at the
+        // same position would read
+        double values[4];
+        m_demCache->read((int)floor(m_demProj->WorldX() - m_interp->HotSample()),
+                         (int)floor(m_demProj->WorldY() - m_interp->HotLine()),
+                         m_interp->Samples(), m_interp->Lines(), values);
+
+        distance = Distance(m_interp->Interpolate(m_demProj->WorldX(),
+                                                  m_demProj->WorldY(),
+                                                  values),
+                                                  Distance::Meters);
+      }
+      else {
+        m_portal->SetPosition(m_demProj->WorldX(), m_demProj->WorldY(), 1);
 
-      m_demCube->read(*m_portal);
+        m_demCube->read(*m_portal);
 
-      distance = Distance(m_interp->Interpolate(m_demProj->WorldX(),
-                                                m_demProj->WorldY(),
-                                                m_portal->DoubleBuffer()),
-                                                Distance::Meters);
+        distance = Distance(m_interp->Interpolate(m_demProj->WorldX(),
+                                                  m_demProj->WorldY(),
+                                                  m_portal->DoubleBuffer()),
+                                                  Distance::Meters);
+      }
     }
 
     return distance;
@@ -13,6 +13,8 @@ template<class T> class QVector;
 
 namespace Isis {
   class Cube;
+  class DemElevationPyramid;
+  class DemTileCache;
   class Interpolator;
   class Portal;
   class Projection;
@@ -92,11 +94,20 @@ namespace Isis {
      Cube *demCube();         //!< Returns the cube defining the shape model.
 
     private:
+      bool intersectPyramid(const std::vector<double> &observerPos,
+                            const std::vector<double> &lookDirection);
+      bool pyramidRange(const double middle[3], double halfLength,
+                        double &minRadius, double &maxRadius);
+      bool heightAboveSurface(const double origin[3], const double look[3],
+                              double t, double &height);
+
       Cube *m_demCube;        //!< The cube containing the model
       Projection *m_demProj;  //!< The projection of the model
       double m_pixPerDegree;  //!< Scale of DEM file in pixels per degree
       Portal *m_portal;       //!< Buffer used to read from the model
       Interpolator *m_interp; //!< Use bilinear interpolation from dem
+      DemTileCache *m_demCache; //!< Shared in-memory elevations, NULL if caching is off
+      DemElevationPyramid *m_demPyramid; //!< Shared radius bounds of the model, NULL if it has none
   };
 }
 
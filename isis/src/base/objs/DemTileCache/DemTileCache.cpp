@@ -0,0 +1,249 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "DemTileCache.h"
+
+#include <algorithm>
+
+#include <QMutexLocker>
+
+#include "Brick.h"
+#include "Cube.h"
+#include "IException.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "SpecialPixel.h"
+
+using namespace std;
+
+namespace Isis {
+  //! Serializes acquire and release
+  static QMutex cachesMutex;
+  //! The shared cache of each DEM cube
+  static QHash<Cube *, DemTileCache *> caches;
+
+
+  /**
+   * Creates an empty cache for a DEM.
+   *
+   * @param demCube The DEM to cache. This must stay open for the life of the
+   *                cache.
+   * @param maxBytes The most memory the tiles may use. At least one tile is
+   *                 always kept.
+   * @param tileSize The number of samples and lines in each tile
+   */
+  DemTileCache::DemTileCache(Cube *demCube, BigInt maxBytes, int tileSize) {
+    if (tileSize < 1) {
+      QString msg = "The DEM cache tile size [" + QString::number(tileSize) +
+                    "] must be positive";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    m_demCube = demCube;
+    m_samples = demCube->sampleCount();
+    m_lines = demCube->lineCount();
+    m_tileSize = tileSize;
+    m_tilesPerLine = (m_samples + tileSize - 1) / tileSize;
+
+    // Real pixels fit in a float without losing anything, other types could be
+    // radii in meters that need a double
+    m_realPixels = demCube->pixelType() == Real;
+
+    BigInt tileBytes = (BigInt)tileSize * tileSize *
+                       (m_realPixels ? sizeof(float) : sizeof(double));
+    BigInt demTiles = (BigInt)m_tilesPerLine * ((m_lines + tileSize - 1) / tileSize);
+    m_maxTiles = (int)max((BigInt)1, min(demTiles, maxBytes / tileBytes));
+
+    m_useCount = 0;
+    m_references = 0;
+  }
+
+
+  //! Frees the tiles
+  DemTileCache::~DemTileCache() {
+    qDeleteAll(m_tiles);
+    m_tiles.clear();
+  }
+
+
+  /**
+   * Returns the shared cache for a DEM, creating it on first use. Every call
+   * must be paired with a call to release.
+   *
+   * @param demCube The DEM to cache
+   *
+   * @return @b DemTileCache* The DEM's cache, or NULL if DEM caching is
+   *                          turned off in the preferences
+   */
+  DemTileCache *DemTileCache::acquire(Cube *demCube) {
+    BigInt megabytes = 0;
+    PvlGroup &performancePrefs =
+        Preference::Preferences().findGroup("Performance");
+    if (performancePrefs.hasKeyword("DemCacheSize")) {
+      // We need a no-iException conversion here
+      megabytes = performancePrefs["DemCacheSize"][0].toLongLong();
+    }
+
+    if (megabytes <= 0) {
+      return NULL;
+    }
+
+    QMutexLocker locker(&cachesMutex);
+    DemTileCache *cache = caches.value(demCube, NULL);
+    if (!cache) {
+      cache = new DemTileCache(demCube, megabytes * 1024 * 1024);
+      caches.insert(demCube, cache);
+    }
+    cache->m_references++;
+    return cache;
+  }
+
+
+  /**
+   * Gives up a cache from acquire. The cache is deleted when its last user
+   * releases it.
+   *
+   * @param cache The cache to release. NULL is ignored.
+   */
+  void DemTileCache::release(DemTileCache *cache) {
+    if (!cache) {
+      return;
+    }
+
+    QMutexLocker locker(&cachesMutex);
+    cache->m_references--;
+    if (cache->m_references <= 0) {
+      caches.remove(cache->m_demCube);
+      delete cache;
+    }
+  }
+
+
+  /**
+   * Copies a window of the DEM's first band. Pixels outside of the DEM are
+   * NULL, like they are when reading a Portal.
+   *
+   * @param sample The first sample of the window
+   * @param line The first line of the window
+   * @param samples The number of samples in the window
+   * @param lines The number of lines in the window
+   * @param values The samples * lines pixels of the window, line by line
+   */
+  void DemTileCache::read(int sample, int line, int samples, int lines, double *values) {
+    QMutexLocker locker(&m_mutex);
+
+    for (int l = 0; l < lines; l++) {
+      int demLine = line + l - 1;
+      for (int s = 0; s < samples; s++) {
+        int demSample = sample + s - 1;
+        double &value = values[l * samples + s];
+
+        if (demSample < 0 || demSample >= m_samples || demLine < 0 || demLine >= m_lines) {
+          value = Null;
+          continue;
+        }
+
+        const Tile *demTile = tile(demSample / m_tileSize, demLine / m_tileSize);
+        int index = (demLine % m_tileSize) * m_tileSize + demSample % m_tileSize;
+        if (m_realPixels) {
+          float pixel = demTile->realPixels[index];
+          value = IsSpecial(pixel) ? TestPixel(pixel) : pixel;
+        }
+        else {
+          value = demTile->doublePixels[index];
+        }
+      }
+    }
+  }
+
+
+  /**
+   * @return @b int The number of samples and lines in each tile
+   */
+  int DemTileCache::tileSize() const {
+    return m_tileSize;
+  }
+
+
+  /**
+   * @return @b int The most tiles the cache holds at once
+   */
+  int DemTileCache::maximumTiles() const {
+    return m_maxTiles;
+  }
+
+
+  /**
+   * @return @b int The number of tiles in memory
+   */
+  int DemTileCache::tileCount() {
+    QMutexLocker locker(&m_mutex);
+    return m_tiles.size();
+  }
+
+
+  /**
+   * Finds a tile, reading it from the DEM if it isn't in memory. The caller
+   * must hold the mutex.
+   *
+   * @param tileSample The zero based tile column
+   * @param tileLine The zero based tile row
+   *
+   * @return @b const Tile* The tile
+   */
+  const DemTileCache::Tile *DemTileCache::tile(int tileSample, int tileLine) {
+    int tileIndex = tileLine * m_tilesPerLine + tileSample;
+    m_useCount++;
+
+    Tile *demTile = m_tiles.value(tileIndex, NULL);
+    if (demTile) {
+      demTile->lastUse = m_useCount;
+      return demTile;
+    }
+
+    // Reuse the least recently used tile when the cache is full
+    if (m_tiles.size() >= m_maxTiles) {
+      QHash<int, Tile *>::iterator oldest = m_tiles.begin();
+      for (QHash<int, Tile *>::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it) {
+        if (it.value()->lastUse < oldest.value()->lastUse) {
+          oldest = it;
+        }
+      }
+      demTile = oldest.value();
+      m_tiles.erase(oldest);
+    }
+    else {
+      demTile = new Tile;
+      if (m_realPixels) {
+        demTile->realPixels.resize(m_tileSize * m_tileSize);
+      }
+      else {
+        demTile->doublePixels.resize(m_tileSize * m_tileSize);
+      }
+    }
+
+    // Pixels past the edges of the DEM read as NULL
+    Brick brick(m_tileSize, m_tileSize, 1, m_demCube->pixelType());
+    brick.SetBasePosition(tileSample * m_tileSize + 1, tileLine * m_tileSize + 1, 1);
+    m_demCube->read(brick);
+
+    if (m_realPixels) {
+      float *pixels = demTile->realPixels.data();
+      for (int i = 0; i < brick.size(); i++) {
+        pixels[i] = IsSpecial(brick[i]) ? TestPixel(brick[i]) : (float)brick[i];
+      }
+    }
+    else {
+      std::copy(brick.DoubleBuffer(), brick.DoubleBuffer() + brick.size(),
+                demTile->doublePixels.data());
+    }
+
+    demTile->lastUse = m_useCount;
+    m_tiles.insert(tileIndex, demTile);
+    return demTile;
+  }
+}
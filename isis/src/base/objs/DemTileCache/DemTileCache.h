@@ -0,0 +1,81 @@
+#ifndef DemTileCache_h
+#define DemTileCache_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+#include "Constants.h"
+
+namespace Isis {
+  class Cube;
+
+  /**
+   * @brief In-memory cache of the elevations in a DEM cube
+   *
+   * Shape models look up a handful of DEM pixels for every ray intersection
+   * iteration. Reading them through a Portal costs a Cube::read, with its
+   * locking and cache bookkeeping, for every lookup. This class keeps square
+   * tiles of the DEM's first band in memory and copies pixels straight out of
+   * them. Real DEMs are stored as floats and other pixel types as doubles, so
+   * the cached elevations are exactly the ones a Portal reads. Tiles are read
+   * the first time they are needed, and the least recently used tile is
+   * dropped when the cache is full. A DEM that fits in the cache stays
+   * resident.
+   *
+   * The cache for a DEM is shared by every shape model that uses it, through
+   * acquire and release, and may be used from several threads at once. The
+   * size of each cache comes from the DemCacheSize keyword in the Performance
+   * group of the preferences.
+   *
+   * @ingroup Camera
+   */
+  class DemTileCache {
+    public:
+      DemTileCache(Cube *demCube, BigInt maxBytes, int tileSize = 256);
+      ~DemTileCache();
+
+      static DemTileCache *acquire(Cube *demCube);
+      static void release(DemTileCache *cache);
+
+      void read(int sample, int line, int samples, int lines, double *values);
+
+      int tileSize() const;
+      int maximumTiles() const;
+      int tileCount();
+
+    private:
+      Q_DISABLE_COPY(DemTileCache)
+
+      /**
+       * A tile of DEM pixels
+       */
+      struct Tile {
+        QVector<float> realPixels;    //!< The pixels of a Real DEM, line by line
+        QVector<double> doublePixels; //!< The pixels of any other DEM, line by line
+        quint64 lastUse;              //!< When the tile was last used
+      };
+
+      const Tile *tile(int tileSample, int tileLine);
+
+      Cube *m_demCube;             //!< The DEM the tiles come from
+      int m_samples;               //!< Number of samples in the DEM
+      int m_lines;                 //!< Number of lines in the DEM
+      int m_tileSize;              //!< Samples and lines in each tile
+      bool m_realPixels;           //!< Whether the tiles are stored as floats
+      int m_tilesPerLine;          //!< Number of tiles across the DEM
+      int m_maxTiles;              //!< Most tiles the cache holds
+      QHash<int, Tile *> m_tiles;  //!< The tiles in memory by tile index
+      quint64 m_useCount;          //!< Count of tile uses, for finding the oldest
+      QMutex m_mutex;              //!< Serializes access to the tiles
+      int m_references;            //!< Number of users from acquire
+  };
+}
+
+#endif
@@ -225,34 +225,12 @@ namespace Isis {
     // Sorts hits based on distance to the observer
     QVector<RayHitInformation> hits = sortHits(ray, observer);
 
-    // If desired, check occlusion
+    // If desired, check occlusion. The first intersection that is not
+    // occluded is the closest intersection to the observer.
     if ( backCheck ) {
-      for (int i = 0 ; i < hits.size() ; i++) {
-        LinearAlgebra::Vector obsToIntersection = hits[i].intersection - observer;
-        LinearAlgebra::Vector lookVector = LinearAlgebra::normalize(obsToIntersection);
-
-        // Cast a ray from the observer to the intersection and check if it is occluded
-        RTCOcclusionRay obsRay;
-        obsRay.org[0] = observerPos[0];
-        obsRay.org[1] = observerPos[1];
-        obsRay.org[2] = observerPos[2];
-        obsRay.dir[0] = lookVector[0];
-        obsRay.dir[1] = lookVector[1];
-        obsRay.dir[2] = lookVector[2];
-        obsRay.tnear = 0.0;
-        obsRay.tfar = LinearAlgebra::magnitude(obsToIntersection) - 0.0005;
-        obsRay.instID = RTC_INVALID_GEOMETRY_ID;
-        obsRay.geomID = RTC_INVALID_GEOMETRY_ID;
-        obsRay.primID = RTC_INVALID_GEOMETRY_ID;
-        obsRay.mask = 0xFFFFFFFF;
-        obsRay.ignorePrimID = hits[i].primID;
-
-        // If the intersection point is not occluded,
-        // then it is the closest intersection to the oberserver.
-        if ( !m_targetShape->isOccluded(obsRay) ) {
-          updateIntersection( hits[i] );
-          break;
-        }
+      int visible = firstVisibleHit(hits, observer, 0.0005);
+      if ( visible >= 0 ) {
+        updateIntersection( hits[visible] );
       }
      }
     else {
@@ -311,34 +289,12 @@ namespace Isis {
     // Sorts hits based on distance to the surface point
     QVector< RayHitInformation > hits = sortHits(ray, surfPoint);
 
-    // If desired, check occlusion
+    // If desired, check occlusion. The first intersection that is not
+    // occluded is the closest intersection to the surface point.
     if ( backCheck ) {
-      for (int i = 0 ; i < hits.size() ; i++) {
-        LinearAlgebra::Vector obsToIntersection = hits[i].intersection - observer;
-        LinearAlgebra::Vector lookVector = LinearAlgebra::normalize(obsToIntersection);
-
-        // Cast a ray from the observer to the intersection and check if it is occluded
-        RTCOcclusionRay obsRay;
-        obsRay.org[0] = observerPos[0];
-        obsRay.org[1] = observerPos[1];
-        obsRay.org[2] = observerPos[2];
-        obsRay.dir[0] = lookVector[0];
-        obsRay.dir[1] = lookVector[1];
-        obsRay.dir[2] = lookVector[2];
-        obsRay.tnear = 0.0;
-        obsRay.tfar = LinearAlgebra::magnitude(obsToIntersection);
-        obsRay.instID = RTC_INVALID_GEOMETRY_ID;
-        obsRay.geomID = RTC_INVALID_GEOMETRY_ID;
-        obsRay.primID = RTC_INVALID_GEOMETRY_ID;
-        obsRay.mask = 0xFFFFFFFF;
-        obsRay.ignorePrimID = hits[i].primID; 
-
-        // If the intersection point is no occluded,
-        // then it is the closest intersection to the oberserver.
-        if ( !m_targetShape->isOccluded(obsRay) ) {
-          updateIntersection( hits[i] );
-          break;
-        }
+      int visible = firstVisibleHit(hits, observer, 0.0);
+      if ( visible >= 0 ) {
+        updateIntersection( hits[visible] );
       }
      }
     else {
@@ -350,6 +306,115 @@ namespace Isis {
   }
 
 
+  /**
+   * Compute the intercept points of several look directions from a single
+   * observer, such as the pixels of a framing image or a line of a line scan
+   * image. The rays are traced together in SIMD packets. Unlike
+   * intersectSurface, this does not change the ShapeModel's surface point or
+   * normal.
+   *
+   * @param observerPos    Position of observer in body-fixed kilometers
+   * @param lookDirections Unit look directions from the observer
+   * @param points         Output intercept points, one per look direction.
+   *                       Look directions that miss the target get an invalid
+   *                       SurfacePoint.
+   *
+   * @return @b int The number of look directions that intersect the target
+   */
+  int EmbreeShapeModel::intersectSurfaces(const std::vector<double> &observerPos,
+                                          const std::vector< std::vector<double> > &lookDirections,
+                                          QVector<SurfacePoint> &points) {
+    std::vector<RTCMultiHitRay> rays;
+    rays.reserve(lookDirections.size());
+    for (size_t i = 0; i < lookDirections.size(); i++) {
+      rays.push_back(RTCMultiHitRay(observerPos, lookDirections[i]));
+    }
+
+    m_targetShape->intersectRays(rays);
+
+    LinearAlgebra::Vector observer = LinearAlgebra::vector(observerPos[0],
+                                                           observerPos[1],
+                                                           observerPos[2]);
+
+    int intersections = 0;
+    points.clear();
+    points.reserve(rays.size());
+    for (size_t i = 0; i < rays.size(); i++) {
+      SurfacePoint point;
+      if (rays[i].lastHit >= 0) {
+        // Take the hit closest to the observer
+        QVector<RayHitInformation> hits = sortHits(rays[i], observer);
+        std::vector<double> intersectArray(3);
+        std::copy( hits[0].intersection.data().begin(),
+                   hits[0].intersection.data().end(),
+                   intersectArray.begin() );
+        point.FromNaifArray( &intersectArray[0] );
+        intersections++;
+      }
+      points.append(point);
+    }
+
+    return intersections;
+  }
+
+
+  /**
+   * Find the first of a set of intersections that can be seen from the
+   * observer. The first intersection is traced alone, and only if it is
+   * occluded are the occlusion rays for the rest traced together in SIMD
+   * packets.
+   *
+   * @param hits The intersections to check, in order of preference
+   * @param observer The body-fixed position of the observer in kilometers
+   * @param tolerance How far short of each intersection the occlusion ray
+   *                  stops, in kilometers
+   *
+   * @return @b int The index of the first intersection that is not occluded,
+   *                or -1 if they are all occluded
+   */
+  int EmbreeShapeModel::firstVisibleHit(const QVector<RayHitInformation> &hits,
+                                        const LinearAlgebra::Vector &observer,
+                                        double tolerance) {
+    std::vector<RTCOcclusionRay> obsRays(hits.size());
+    for (int i = 0 ; i < hits.size() ; i++) {
+      LinearAlgebra::Vector obsToIntersection = hits[i].intersection - observer;
+      LinearAlgebra::Vector lookVector = LinearAlgebra::normalize(obsToIntersection);
+
+      // Cast a ray from the observer to the intersection
+      RTCOcclusionRay &obsRay = obsRays[i];
+      obsRay.org[0] = observer[0];
+      obsRay.org[1] = observer[1];
+      obsRay.org[2] = observer[2];
+      obsRay.dir[0] = lookVector[0];
+      obsRay.dir[1] = lookVector[1];
+      obsRay.dir[2] = lookVector[2];
+      obsRay.tnear = 0.0;
+      obsRay.tfar = LinearAlgebra::magnitude(obsToIntersection) - tolerance;
+      obsRay.ignorePrimID = hits[i].primID;
+    }
+
+    // The first intersection is usually visible, so only trace the rest when it is not
+    if (obsRays.empty()) {
+      return -1;
+    }
+    if ( !m_targetShape->isOccluded(obsRays[0]) ) {
+      return 0;
+    }
+    if (obsRays.size() == 1) {
+      return -1;
+    }
+
+    std::vector<RTCOcclusionRay> laterRays(obsRays.begin() + 1, obsRays.end());
+    std::vector<bool> occluded = m_targetShape->areOccluded(laterRays);
+    for (int i = 0 ; i < (int) occluded.size() ; i++) {
+      if ( !occluded[i] ) {
+        return i + 1;
+      }
+    }
+    return -1;
+  }
+
+
   /**
    * Update the ShapeModel given an intersection and normal.
    * 
@@ -78,11 +78,19 @@ namespace Isis {
       virtual bool isVisibleFrom(const std::vector<double> observerPos,
                                  const std::vector<double> lookDirection);
 
+      // Intersect many look directions from one observer without changing the model
+      int intersectSurfaces(const std::vector<double> &observerPos,
+                            const std::vector< std::vector<double> > &lookDirections,
+                            QVector<SurfacePoint> &points);
+
     private:
       // Disallow copying because ShapeModel is not copyable
       Q_DISABLE_COPY(EmbreeShapeModel)
 
       void updateIntersection(const RayHitInformation hitInfo);
+      int firstVisibleHit(const QVector<RayHitInformation> &hits,
+                          const LinearAlgebra::Vector &observer,
+                          double tolerance);
       RTCMultiHitRay latlonToRay(const Latitude &lat, const Longitude &lon) const;
       RTCMultiHitRay pointToRay(const  SurfacePoint &point) const;
       QVector< RayHitInformation > sortHits(RTCMultiHitRay &ray,
@@ -7,6 +7,7 @@ find files of those names at the top level of this repository. **/
 
 #include "EmbreeTargetShape.h"
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <numeric>
@@ -190,6 +191,112 @@ namespace Isis {
   }
 
 
+  /**
+   * Default constructor for RTCMultiHitRay4. Every lane starts out empty.
+   */
+  RTCMultiHitRay4::RTCMultiHitRay4() {
+    for (int lane = 0; lane < 4; lane++) {
+      setRay(lane, RTCMultiHitRay());
+    }
+  }
+
+
+  /**
+   * Copy a ray's origin, direction and segment into a lane of the packet and
+   * clear the lane's hits.
+   * 
+   * @param lane The lane of the packet, 0 through 3.
+   * @param ray The ray to trace in the lane.
+   */
+  void RTCMultiHitRay4::setRay(int lane, const RTCMultiHitRay &ray) {
+    orgx[lane] = ray.org[0];
+    orgy[lane] = ray.org[1];
+    orgz[lane] = ray.org[2];
+    dirx[lane] = ray.dir[0];
+    diry[lane] = ray.dir[1];
+    dirz[lane] = ray.dir[2];
+    tnear[lane] = ray.tnear;
+    tfar[lane] = ray.tfar;
+    time[lane] = 0.0;
+    mask[lane] = ray.mask;
+    Ngx[lane] = 0.0;
+    Ngy[lane] = 0.0;
+    Ngz[lane] = 0.0;
+    u[lane] = 0.0;
+    v[lane] = 0.0;
+    geomID[lane] = RTC_INVALID_GEOMETRY_ID;
+    primID[lane] = RTC_INVALID_GEOMETRY_ID;
+    instID[lane] = RTC_INVALID_GEOMETRY_ID;
+    lastHit[lane] = -1;
+  }
+
+
+  /**
+   * Copy the results of tracing a lane of the packet back into a ray.
+   * 
+   * @param lane The lane of the packet, 0 through 3.
+   * @param ray The ray to store the results in.
+   */
+  void RTCMultiHitRay4::getRay(int lane, RTCMultiHitRay &ray) const {
+    ray.tfar = tfar[lane];
+    ray.Ng[0] = Ngx[lane];
+    ray.Ng[1] = Ngy[lane];
+    ray.Ng[2] = Ngz[lane];
+    ray.u = u[lane];
+    ray.v = v[lane];
+    ray.geomID = geomID[lane];
+    ray.primID = primID[lane];
+    ray.instID = instID[lane];
+    ray.lastHit = lastHit[lane];
+    for (int hit = 0; hit <= lastHit[lane]; hit++) {
+      ray.hitGeomIDs[hit] = hitGeomIDs[lane][hit];
+      ray.hitPrimIDs[hit] = hitPrimIDs[lane][hit];
+      ray.hitUs[hit] = hitUs[lane][hit];
+      ray.hitVs[hit] = hitVs[lane][hit];
+    }
+  }
+
+
+  /**
+   * Default constructor for RTCOcclusionRay4. Every lane starts out empty.
+   */
+  RTCOcclusionRay4::RTCOcclusionRay4() {
+    for (int lane = 0; lane < 4; lane++) {
+      setRay(lane, RTCOcclusionRay());
+    }
+  }
+
+
+  /**
+   * Copy a ray's origin, direction, segment and ignored primitive into a lane
+   * of the packet.
+   * 
+   * @param lane The lane of the packet, 0 through 3.
+   * @param ray The ray to trace in the lane.
+   */
+  void RTCOcclusionRay4::setRay(int lane, const RTCOcclusionRay &ray) {
+    orgx[lane] = ray.org[0];
+    orgy[lane] = ray.org[1];
+    orgz[lane] = ray.org[2];
+    dirx[lane] = ray.dir[0];
+    diry[lane] = ray.dir[1];
+    dirz[lane] = ray.dir[2];
+    tnear[lane] = ray.tnear;
+    tfar[lane] = ray.tfar;
+    time[lane] = 0.0;
+    mask[lane] = ray.mask;
+    Ngx[lane] = 0.0;
+    Ngy[lane] = 0.0;
+    Ngz[lane] = 0.0;
+    u[lane] = 0.0;
+    v[lane] = 0.0;
+    geomID[lane] = RTC_INVALID_GEOMETRY_ID;
+    primID[lane] = RTC_INVALID_GEOMETRY_ID;
+    instID[lane] = RTC_INVALID_GEOMETRY_ID;
+    ignorePrimID[lane] = ray.ignorePrimID;
+  }
+
+
   /**
    * Default constructor for RayHitInformation
    */
@@ -229,7 +336,7 @@ namespace Isis {
         m_device(rtcNewDevice(NULL)),
         m_scene(rtcDeviceNewScene(m_device,
                                   RTC_SCENE_STATIC | RTC_SCENE_HIGH_QUALITY | RTC_SCENE_ROBUST,
-                                  RTC_INTERSECT1)) { }
+                                  RTC_INTERSECT1 | RTC_INTERSECT4)) { }
 
 
   /** 
@@ -245,7 +352,7 @@ namespace Isis {
         m_device(rtcNewDevice(NULL)),
         m_scene(rtcDeviceNewScene(m_device,
                                   RTC_SCENE_STATIC | RTC_SCENE_HIGH_QUALITY | RTC_SCENE_ROBUST,
-                                  RTC_INTERSECT1)) {
+                                  RTC_INTERSECT1 | RTC_INTERSECT4)) {
     initMesh(mesh);
   }
 
@@ -267,7 +374,7 @@ namespace Isis {
         m_device(rtcNewDevice(NULL)),
         m_scene(rtcDeviceNewScene(m_device,
                                   RTC_SCENE_STATIC | RTC_SCENE_HIGH_QUALITY | RTC_SCENE_ROBUST,
-                                  RTC_INTERSECT1)) {
+                                  RTC_INTERSECT1 | RTC_INTERSECT4)) {
     FileName file(dem);
     pcl::PolygonMesh::Ptr mesh;
     m_name = file.baseName();
@@ -471,6 +578,12 @@ namespace Isis {
     rtcSetOcclusionFilterFunction(m_scene, geomID,
                                     (RTCFilterFunc)&EmbreeTargetShape::occlusionFilter);
 
+    // Add the same filters for tracing packets
+    rtcSetIntersectionFilterFunction4(m_scene, geomID,
+                                      (RTCFilterFunc4)&EmbreeTargetShape::multiHitFilter4);
+    rtcSetOcclusionFilterFunction4(m_scene, geomID,
+                                   (RTCFilterFunc4)&EmbreeTargetShape::occlusionFilter4);
+
     // Done, now we can perform some ray tracing
     rtcCommit(m_scene);
   }
@@ -661,6 +774,80 @@ namespace Isis {
   }
 
 
+  /**
+   * Intersect a set of rays with the target body. The rays are traced four
+   * at a time with Embree's packet kernels, which is faster than tracing them
+   * one at a time when neighboring rays are coherent, for example the look
+   * directions of a block of detector pixels. Each ray gets the same
+   * results that intersectRay would give it.
+   * 
+   * @param rays The rays to intersect. The hits are stored in the rays.
+   * 
+   * @see embree::rtcIntersect4
+   */
+  void EmbreeTargetShape::intersectRays(std::vector<RTCMultiHitRay> &rays) {
+    if (!isValid()) {
+      return;
+    }
+
+    RTCMultiHitRay4 packet;
+    RTCORE_ALIGN(16) int valid[4];
+    for (size_t start = 0; start < rays.size(); start += 4) {
+      int count = std::min(rays.size() - start, (size_t) 4);
+      for (int lane = 0; lane < 4; lane++) {
+        if (lane < count) {
+          packet.setRay(lane, rays[start + lane]);
+        }
+        valid[lane] = (lane < count) ? -1 : 0;
+      }
+
+      rtcIntersect4(valid, m_scene, packet);
+
+      for (int lane = 0; lane < count; lane++) {
+        packet.getRay(lane, rays[start + lane]);
+      }
+    }
+  }
+
+
+  /**
+   * Check if each of a set of rays intersects the target body. The rays are
+   * traced four at a time with Embree's packet kernels.
+   * 
+   * @param rays The rays to check. Like isOccluded, the geomID of a ray is
+   *             set to 0 if it hits anything.
+   * 
+   * @return @b std::vector<bool> If each ray intersects anything.
+   * 
+   * @see embree::rtcOccluded4
+   */
+  std::vector<bool> EmbreeTargetShape::areOccluded(std::vector<RTCOcclusionRay> &rays) {
+    std::vector<bool> occluded(rays.size(), false);
+
+    RTCOcclusionRay4 packet;
+    RTCORE_ALIGN(16) int valid[4];
+    for (size_t start = 0; start < rays.size(); start += 4) {
+      int count = std::min(rays.size() - start, (size_t) 4);
+      for (int lane = 0; lane < 4; lane++) {
+        if (lane < count) {
+          packet.setRay(lane, rays[start + lane]);
+        }
+        valid[lane] = (lane < count) ? -1 : 0;
+      }
+
+      rtcOccluded4(valid, m_scene, packet);
+
+      // rtcOccluded4 sets the geomID of a lane to 0 if its ray hits anything
+      for (int lane = 0; lane < count; lane++) {
+        rays[start + lane].geomID = packet.geomID[lane];
+        occluded[start + lane] = (packet.geomID[lane] == 0);
+      }
+    }
+
+    return occluded;
+  }
+
+
   /**
    * Extract the intersection point and unit surface normal from an
    * RTCMultiHitRay that has been intersected with the target shape. This
@@ -785,4 +972,61 @@ namespace Isis {
     }
   }
 
+
+  /**
+   * Packet version of multiHitFilter. This is called by the Embree library
+   * with the lanes of a packet that found an intersection.
+   * 
+   * @param[in] valid Mask of the lanes with an intersection, -1 if valid and 0
+   *                  otherwise.
+   * @param[in] userDataPtr Data pointer from the geometry hit. Not used.
+   * @param[in,out] ray The packet being traced. Information about the
+   *                    intersections will be stored in the packet.
+   */
+  void EmbreeTargetShape::multiHitFilter4(const void* valid, void* userDataPtr,
+                                          RTCMultiHitRay4& ray) {
+    const int *validLanes = (const int *) valid;
+    for (int lane = 0; lane < 4; lane++) {
+      if (validLanes[lane] == 0) {
+        continue;
+      }
+
+      // Calculate the index to store the hit in
+      ray.lastHit[lane] ++;
+      int hit = ray.lastHit[lane];
+
+      // Store the hits
+      ray.hitGeomIDs[lane][hit] = ray.geomID[lane];
+      ray.hitPrimIDs[lane][hit] = ray.primID[lane];
+      ray.hitUs[lane][hit] = ray.u[lane];
+      ray.hitVs[lane][hit] = ray.v[lane];
+
+      // If there are less than 16 hits, continue ray tracing.
+      if (hit < 15) {
+        ray.geomID[lane] = RTC_INVALID_GEOMETRY_ID;
+      }
+    }
+  }
+
+
+  /**
+   * Packet version of occlusionFilter. This is called by the Embree library
+   * with the lanes of a packet that found an intersection.
+   * 
+   * @param[in] valid Mask of the lanes with an intersection, -1 if valid and 0
+   *                  otherwise.
+   * @param[in] userDataPtr Data pointer from the geometry hit. Not used.
+   * @param[in,out] ray The packet being traced.
+   */
+  void EmbreeTargetShape::occlusionFilter4(const void* valid, void* userDataPtr,
+                                           RTCOcclusionRay4& ray) {
+    const int *validLanes = (const int *) valid;
+    for (int lane = 0; lane < 4; lane++) {
+      // Ignore re-intersecting the occluded plate and keep tracing
+      if (validLanes[lane] != 0 && ray.primID[lane] == ray.ignorePrimID[lane]) {
+        ray.geomID[lane] = RTC_INVALID_GEOMETRY_ID;
+      }
+    }
+  }
+
 }  // namespace Isis
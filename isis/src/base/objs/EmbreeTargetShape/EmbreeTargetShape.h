@@ -7,6 +7,8 @@ find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
 
+#include <vector>
+
 #include <QString>
 
 // Embree includes
@@ -107,6 +109,39 @@ namespace Isis {
   };
 
 
+  /**
+   * A packet of four RTCMultiHitRays that Embree traces together with its
+   * SIMD packet kernels. Each lane has its own hit containers.
+   */
+  struct RTCMultiHitRay4 : RTCRay4 {
+    RTCMultiHitRay4();
+
+    void setRay(int lane, const RTCMultiHitRay &ray);
+    void getRay(int lane, RTCMultiHitRay &ray) const;
+
+    // ray extensions, indexed by lane then hit
+    unsigned hitGeomIDs[4][16]; //!< IDs of the geometries (bodies) hit
+    unsigned hitPrimIDs[4][16]; //!< IDs of the primitives (trinagles) hit
+    float    hitUs[4][16];      //!< Barycentric u coordinate of the hits
+    float    hitVs[4][16];      //!< Barycentric v coordinate of the hits
+    int      lastHit[4];        //!< Index of the last hit in each lane's hit containers
+  };
+
+
+  /**
+   * A packet of four RTCOcclusionRays that Embree traces together with its
+   * SIMD packet kernels.
+   */
+  struct RTCOcclusionRay4 : RTCRay4 {
+    RTCOcclusionRay4();
+
+    void setRay(int lane, const RTCOcclusionRay &ray);
+
+    // ray extensions
+    unsigned ignorePrimID[4]; //!< IDs of the primitives (trinagles) which should be ignored.
+  };
+
+
   /**
    * Container that holds the body fixed intersection point and unit surface
    * normal for a hit.
@@ -155,10 +190,15 @@ namespace Isis {
       void intersectRay(RTCMultiHitRay &ray);
       bool isOccluded(RTCOcclusionRay &ray);
 
+      void intersectRays(std::vector<RTCMultiHitRay> &rays);
+      std::vector<bool> areOccluded(std::vector<RTCOcclusionRay> &rays);
+
       RayHitInformation getHitInformation(RTCMultiHitRay &ray, int hitIndex);
 
       static void multiHitFilter(void* userDataPtr, RTCMultiHitRay& ray);
       static void occlusionFilter(void* userDataPtr, RTCOcclusionRay& ray);
+      static void multiHitFilter4(const void* valid, void* userDataPtr, RTCMultiHitRay4& ray);
+      static void occlusionFilter4(const void* valid, void* userDataPtr, RTCOcclusionRay4& ray);
 
     protected:
       pcl::PolygonMesh::Ptr readDSK(FileName file);
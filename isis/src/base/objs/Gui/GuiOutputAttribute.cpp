@@ -136,15 +136,19 @@ namespace Isis {
     p_tiled->setToolTip("Save image data in tiled format");
     p_bsq = new QRadioButton("&BSQ");
     p_bsq->setToolTip("Save image data in band sequential format");
+    p_compressedTiled = new QRadioButton("&Compressed Tiled");
+    p_compressedTiled->setToolTip("Save image data in compressed tiled format");
 
     buttonGroup = new QButtonGroup();
     buttonGroup->addButton(p_tiled);
     buttonGroup->addButton(p_bsq);
+    buttonGroup->addButton(p_compressedTiled);
     buttonGroup->setExclusive(true);
 
     layout = new QVBoxLayout();
     layout->addWidget(p_tiled);
     layout->addWidget(p_bsq);
+    layout->addWidget(p_compressedTiled);
 
     QGroupBox *cubeFormatBox = new QGroupBox("Cube Format");
     cubeFormatBox->setLayout(layout);
@@ -201,6 +205,7 @@ namespace Isis {
 
     if(p_tiled->isChecked()) att += "+Tile";
     if(p_bsq->isChecked()) att += "+BandSequential";
+    if(p_compressedTiled->isChecked()) att += "+CompressedTile";
 
     if(p_attached->isChecked()) att += "+Attached";
     if(p_detached->isChecked()) att += "+Detached";
@@ -233,6 +238,9 @@ namespace Isis {
     if(att.fileFormat() == Cube::Tile) {
       p_tiled->setChecked(true);
     }
+    else if(att.fileFormat() == Cube::CompressedTile) {
+      p_compressedTiled->setChecked(true);
+    }
     else {
       p_bsq->setChecked(true);
     }
@@ -7,11 +7,17 @@ find files of those names at the top level of this repository. **/
 
 #include "IsisDebug.h"
 
+#include <exception>
 #include <string>
 #include <iostream>
 #include <vector>
 
 #include <QDebug>
+#include <QFuture>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <QVector>
 
 #include <geos/geom/Geometry.h>
 #include <geos/geom/Polygon.h>
@@ -24,8 +30,10 @@ find files of those names at the top level of this repository. **/
 #include <geos/io/WKTWriter.h>
 #include <geos/operation/distance/DistanceOp.h>
 
+#include "CameraFactory.h"
 #include "ImagePolygon.h"
 #include "IString.h"
+#include "NaifStatus.h"
 #include "SpecialPixel.h"
 #include "PolygonTools.h"
 
@@ -56,6 +64,11 @@ namespace Isis {
     p_subpixelAccuracy = 50; //An accuracte and quick number
 
     p_ellipsoid = false;
+
+    m_threaded = false;
+    m_limbEllipsoid = false;
+    m_cameraCount = 0;
+    m_cameraEvaluations = 0;
   }
 
 
@@ -77,6 +90,8 @@ namespace Isis {
 
     delete m_botCoord;
     m_botCoord = NULL;
+
+    deleteThreadCameras();
   }
 
 
@@ -148,9 +163,11 @@ namespace Isis {
     p_cubeStartSamp = ss;
     p_cubeStartLine = sl;
 
+    m_limbEllipsoid = false;
     if (p_ellipsoid && IsLimb() && p_gMap->Camera()) {
       try {
         p_gMap->Camera()->IgnoreElevationModel(true);
+        m_limbEllipsoid = true;
       }
       catch(IException &) {
         std::string msg = "Cannot use an ellipsoid shape model";
@@ -204,6 +221,11 @@ namespace Isis {
 
     cam = initCube(cube, ss, sl, ns, nl, band);
 
+    if (m_threaded && cam && !p_isProjected) {
+      createThreadCameras(cube, band);
+    }
+    m_cameraCount = p_isProjected ? 0 : m_threadCameras.size() + 1;
+
     // Reduce the increment size to find a valid polygon
     bool polygonGenerated = false;
     while (!polygonGenerated) {
@@ -253,6 +275,8 @@ namespace Isis {
 
     if (p_gMap->Camera())
       p_gMap->Camera()->IgnoreElevationModel(false);
+
+    deleteThreadCameras();
   }
 
   void ImagePolygon::Create(std::vector<std::vector<double>> polyCoordinates) {
@@ -499,10 +523,39 @@ namespace Isis {
   *         polygon.
   */
   geos::geom::Coordinate ImagePolygon::FindFirstPoint() {
+    // With several threads, the positions are evaluated in batches ahead of
+    // the search, in the order the search visits them
+    int lines = p_cubeLines - p_cubeStartLine + 1;
+    int batchSize = m_threadCameras.isEmpty() ? 0 : 64 * (m_threadCameras.size() + 1);
+    QVector<char> batchValid;
+    int batchStart = 0;
+    int position = 0;
+
     // @todo: Brute force method, should be improved
     for (int sample = p_cubeStartSamp; sample <= p_cubeSamps; sample++) {
-      for (int line = p_cubeStartLine; line <= p_cubeLines; line++) {
-        if (SetImage(sample, line)) {
+      for (int line = p_cubeStartLine; line <= p_cubeLines; line++, position++) {
+        bool valid;
+        if (batchSize > 0) {
+          if (position >= batchStart + batchValid.size()) {
+            int positions = (p_cubeSamps - p_cubeStartSamp + 1) * lines;
+            batchStart = position;
+            batchValid.fill(false, std::min(batchSize, positions - position));
+            runThreaded(batchValid.size(), [this, &batchValid, batchStart, lines]
+                                           (Camera *camera, int start, int end) {
+              for (int i = start; i < end; i++) {
+                batchValid[i] = SetImage(camera,
+                                         p_cubeStartSamp + (batchStart + i) / lines,
+                                         p_cubeStartLine + (batchStart + i) % lines);
+              }
+            });
+          }
+          valid = batchValid[position - batchStart];
+        }
+        else {
+          valid = SetImage(sample, line);
+        }
+
+        if (valid) {
           // An outlier check.  Make sure that the pixel we use to start
           // constructing a polygon is not surrounded by a bunch of invalid
           // positions.
@@ -757,11 +810,30 @@ namespace Isis {
     // this vector stores crossing points, where the image crosses the
     // meridian. It stores the first coordinate of the pair in its vector
     vector<geos::geom::Coordinate> *crossingPoints = new vector<geos::geom::Coordinate>;
+    vector<geos::geom::Coordinate> groundPoints(points.size());
+    if (!m_threadCameras.isEmpty()) {
+      runThreaded(points.size(), [this, &points, &groundPoints]
+                                 (Camera *camera, int start, int end) {
+        for (int i = start; i < end; i++) {
+          QMutexLocker locker(NaifStatus::mutex());
+          SetImage(camera, points[i].x, points[i].y);
+          groundPoints[i] = geos::geom::Coordinate(camera->UniversalLongitude(),
+                                                   camera->UniversalLatitude());
+        }
+      });
+    }
+    else {
+      for (unsigned int i = 0; i < points.size(); i++) {
+        geos::geom::Coordinate *temp = &(points.at(i));
+        SetImage(temp->x, temp->y);
+        groundPoints[i] = geos::geom::Coordinate(p_gMap->UniversalLongitude(),
+                                                 p_gMap->UniversalLatitude());
+      }
+    }
+
     for (unsigned int i = 0; i < points.size(); i++) {
-      geos::geom::Coordinate *temp = &(points.at(i));
-      SetImage(temp->x, temp->y);
-      lon = p_gMap->UniversalLongitude();
-      lat = p_gMap->UniversalLatitude();
+      lon = groundPoints[i].x;
+      lat = groundPoints[i].y;
       if (abs(lon - prevLon) >= 180 && i != 0) {
         crossingPoints->push_back(geos::geom::Coordinate(prevLon, prevLat));
       }
@@ -1051,45 +1123,8 @@ namespace Isis {
    *              was not or if pixel of level 2 images is NULL.
    */
   bool ImagePolygon::SetImage(const double sample, const double line) {
-    bool found = false;
     if (!p_isProjected) {
-      found = p_gMap->SetImage(sample, line);
-      if (!found) {
-        return false;
-      }
-      else {
-        // Check for valid emission and incidence
-        try {
-          if (p_gMap->Camera() &&
-             p_gMap->Camera()->EmissionAngle() > p_emission) {
-            return false;
-          }
-          if (p_gMap->Camera() &&
-             p_gMap->Camera()->IncidenceAngle() > p_incidence) {
-            return false;
-          }
-        }
-        catch(IException &error) {
-        }
-
-        /**
-         * This check has been removed because it causes push frame cameras
-         * to fail inbetween the framelets, resulting in only the first
-         * framlet to be walked, leaving out the rest of the image.
-         *
-         * This can cause autoseed/jigsaw issues, since they require conversion
-         * from lat/lon to samp/line
-         */
-        //  Make sure we can go back to image coordinates
-        //  This is done because some camera models due to distortion, get
-        //  a lat/lon for samp/line=1:1, but entering that lat/lon does
-        //  not return samp/line =1:1. Ie.  moc WA global images
-        //double lat = p_gMap->UniversalLatitude();
-        //double lon = p_gMap->UniversalLongitude();
-        //return p_gMap->SetUniversalGround(lat,lon);
-
-        return found;
-      }
+      return SetImage(p_gMap->Camera(), sample, line);
     }
     else {
       // If projected, make sure the pixel DN is valid before worrying about
@@ -1100,12 +1135,71 @@ namespace Isis {
         return false;
       }
       else {
+        m_cameraEvaluations.fetchAndAddRelaxed(1);
         return p_gMap->SetImage(sample, line);
       }
     }
   }
 
 
+  /**
+   * Sets the sample/line values of a camera and checks the emission and
+   * incidence angles. Several threads may call this at once with their own
+   * cameras. The cameras are evaluated one at a time under
+   * NaifStatus::mutex(), because they all use NAIF.
+   *
+   * @param[in] camera   (Camera *)      The camera to set
+   *
+   * @param[in] sample   (const double)  Sample coordinate of the cube
+   *
+   * @param[in] line     (const double)  Line coordinate of the cube
+   *
+   * @return bool Returns true if the image was set successfully and the
+   *              angles are within the limits
+   */
+  bool ImagePolygon::SetImage(Camera *camera, const double sample, const double line) {
+    m_cameraEvaluations.fetchAndAddRelaxed(1);
+
+    // The threads each have a camera, but NAIF is shared by all of them
+    QMutexLocker locker(NaifStatus::mutex());
+    bool found = camera->SetImage(sample, line);
+    if (!found) {
+      return false;
+    }
+    else {
+      // Check for valid emission and incidence
+      try {
+        if (camera->EmissionAngle() > p_emission) {
+          return false;
+        }
+        if (camera->IncidenceAngle() > p_incidence) {
+          return false;
+        }
+      }
+      catch(IException &error) {
+      }
+
+      /**
+       * This check has been removed because it causes push frame cameras
+       * to fail inbetween the framelets, resulting in only the first
+       * framlet to be walked, leaving out the rest of the image.
+       *
+       * This can cause autoseed/jigsaw issues, since they require conversion
+       * from lat/lon to samp/line
+       */
+      //  Make sure we can go back to image coordinates
+      //  This is done because some camera models due to distortion, get
+      //  a lat/lon for samp/line=1:1, but entering that lat/lon does
+      //  not return samp/line =1:1. Ie.  moc WA global images
+      //double lat = p_gMap->UniversalLatitude();
+      //double lon = p_gMap->UniversalLongitude();
+      //return p_gMap->SetUniversalGround(lat,lon);
+
+      return found;
+    }
+  }
+
+
   /**
    * If the cube crosses the 0/360 boundary and does not include a pole, the
    * polygon is separated into multiple polygons, usually one on each side of the
@@ -1554,43 +1648,178 @@ namespace Isis {
   void ImagePolygon::FindSubpixel(std::vector<geos::geom::Coordinate> & points) {
     if (p_subpixelAccuracy > 0) {
 
-      // Fix the polygon with subpixel accuracy
-      geos::geom::Coordinate old = points.at(0);
-      bool didStartingPoint = false;
-      for (unsigned int pt = 1; !didStartingPoint; pt ++) {
-        if (pt >= points.size() - 1) {
-          pt = 0;
-          didStartingPoint = true;
+      // Each vertex is refined away from its neighbors as they were before
+      // refining, except the starting point which is refined last, after its
+      // next neighbor. This lets the other vertices be refined in any order.
+      vector<geos::geom::Coordinate> original = points;
+      int last = points.size() - 1;
+
+      if (!m_threadCameras.isEmpty()) {
+        runThreaded(last - 1, [this, &points, &original](Camera *camera, int start, int end) {
+          for (int pt = start + 1; pt < end + 1; pt++) {
+            points[pt] = FindSubpixel(camera, original[pt - 1], original[pt], original[pt + 1]);
+          }
+        });
+      }
+      else {
+        for (int pt = 1; pt < last; pt++) {
+          points[pt] = FindSubpixel(NULL, original[pt - 1], original[pt], original[pt + 1]);
         }
+      }
 
-        // Binary Coordinate Search
-        double maxStep = std::max(p_sampinc, p_lineinc);
-        double stepY = (old.x - points.at(pt + 1).x) / maxStep;
-        double stepX = (points.at(pt + 1).y - old.y) / maxStep;
+      points[0] = FindSubpixel(NULL, original[last - 1], original[0], points[1]);
 
-        geos::geom::Coordinate valid = points.at(pt);
-        geos::geom::Coordinate invalid(valid.x + stepX, valid.y + stepY);
+      // Fix starting point
+      points[points.size()-1] = geos::geom::Coordinate(points[0].x, points[0].y);
 
-        for (int itt = 0; itt < p_subpixelAccuracy; itt ++) {
-          geos::geom::Coordinate half((valid.x + invalid.x) / 2.0, (valid.y + invalid.y) / 2.0);
-          if (SetImage(half.x, half.y)  &&  InsideImage(half.x, half.y)) {
-            valid = half;
-          }
-          else {
-            invalid = half;
-          }
+    }
+  }
+
+
+  /**
+   * Tests if a vertex of the walk lies on the edge of the image, where the
+   * walk snaps to the first or last sample or line.
+   *
+   * @param vertex The vertex to test
+   *
+   * @return bool True if the vertex is on the edge of the image
+   */
+  bool ImagePolygon::OnImageEdge(const geos::geom::Coordinate &vertex) {
+    return (vertex.x == p_cubeStartSamp || vertex.x == p_cubeSamps ||
+            vertex.y == p_cubeStartLine || vertex.y == p_cubeLines);
+  }
+
+
+  /**
+   * Finds the subpixel position of one vertex with a binary search from the
+   * vertex outwards, perpendicular to the line between its neighbors.
+   *
+   * Only vertices on edges where the camera fails are refined with the
+   * camera. A vertex on the edge of the image that searches off the image is
+   * bounded by the image, so it is only searched against the image bounds and
+   * the camera is assumed valid out to the edge of its pixel.
+   *
+   * @param camera The camera to evaluate, or NULL to use the cube's
+   * @param previous The vertex before this one
+   * @param vertex The vertex to refine
+   * @param next The vertex after this one
+   *
+   * @return geos::geom::Coordinate The refined vertex
+   */
+  geos::geom::Coordinate ImagePolygon::FindSubpixel(Camera *camera,
+                                                    const geos::geom::Coordinate &previous,
+                                                    const geos::geom::Coordinate &vertex,
+                                                    const geos::geom::Coordinate &next) {
+    // Binary Coordinate Search
+    double maxStep = std::max(p_sampinc, p_lineinc);
+    double stepY = (previous.x - next.x) / maxStep;
+    double stepX = (next.y - previous.y) / maxStep;
+
+    geos::geom::Coordinate valid = vertex;
+    geos::geom::Coordinate invalid(valid.x + stepX, valid.y + stepY);
+    bool failingEdge = !OnImageEdge(vertex) || InsideImage(invalid.x, invalid.y);
+
+    for (int itt = 0; itt < p_subpixelAccuracy; itt ++) {
+      geos::geom::Coordinate half((valid.x + invalid.x) / 2.0, (valid.y + invalid.y) / 2.0);
+
+      // Positions off the image are never valid, so don't evaluate the camera there
+      bool halfValid = InsideImage(half.x, half.y);
+      if (halfValid && failingEdge) {
+        halfValid = camera ? SetImage(camera, half.x, half.y) : SetImage(half.x, half.y);
+      }
+
+      if (halfValid) {
+        valid = half;
+      }
+      else {
+        invalid = half;
+      }
+    }
+
+    return valid;
+  }
+
+
+  /**
+   * Creates a camera for every other thread of the global thread pool. The
+   * cameras need the SPICE attached to the cube, so if they can't be created
+   * the polygon is found with the cube's camera alone, and cameraCount()
+   * reports how many cameras were used.
+   *
+   * @param cube The cube to create cameras for
+   * @param band The band the cameras are set to
+   */
+  void ImagePolygon::createThreadCameras(Cube &cube, int band) {
+    deleteThreadCameras();
+
+    try {
+      while (m_threadCameras.size() + 1 < QThreadPool::globalInstance()->maxThreadCount()) {
+        Camera *camera = CameraFactory::Clone(cube);
+        m_threadCameras.append(camera);
+        camera->SetBand(band);
+        if (m_limbEllipsoid) {
+          camera->IgnoreElevationModel(true);
         }
+      }
+    }
+    catch (IException &) {
+      deleteThreadCameras();
+    }
+  }
 
-        old = points.at(pt);
 
-        // Set new coordinate
-        points[pt] = valid;
+  //! Deletes the cameras of the other threads
+  void ImagePolygon::deleteThreadCameras() {
+    qDeleteAll(m_threadCameras);
+    m_threadCameras.clear();
+  }
 
+
+  /**
+   * Splits a range of work into one contiguous piece for each camera and
+   * evaluates the pieces concurrently. The cube's camera's piece is evaluated
+   * by the calling thread.
+   *
+   * @param count The amount of work
+   * @param evaluate Evaluates the work from the first index up to, but not
+   *                 including, the second index with the camera. This is
+   *                 called from several threads at once.
+   */
+  void ImagePolygon::runThreaded(int count,
+                                 const std::function<void(Camera *, int, int)> &evaluate) {
+    QList<Camera *> cameras;
+    cameras.append(p_gMap->Camera());
+    cameras.append(m_threadCameras);
+
+    int workerCount = cameras.size();
+    QVector<std::exception_ptr> errors(workerCount);
+
+    auto runWorker = [&cameras, &errors, &evaluate, count, workerCount](int worker) {
+      try {
+        evaluate(cameras[worker], (BigInt)count * worker / workerCount,
+                 (BigInt)count * (worker + 1) / workerCount);
       }
+      catch (...) {
+        errors[worker] = std::current_exception();
+      }
+    };
 
-      // Fix starting point
-      points[points.size()-1] = geos::geom::Coordinate(points[0].x, points[0].y);
+    QList< QFuture<void> > workers;
+    for (int worker = 1; worker < workerCount; worker++) {
+      workers.append(QtConcurrent::run(runWorker, worker));
+    }
+    runWorker(0);
 
+    // Every worker uses this polygon's state, so all of them have to finish
+    // before an error is passed on
+    for (int worker = 0; worker < workers.size(); worker++) {
+      workers[worker].waitForFinished();
+    }
+
+    for (int worker = 0; worker < workerCount; worker++) {
+      if (errors[worker]) {
+        std::rethrow_exception(errors[worker]);
+      }
     }
   }
 
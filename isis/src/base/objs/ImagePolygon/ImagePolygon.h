@@ -7,10 +7,14 @@ find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
 
+#include <functional>
 #include <string>
 #include <sstream>
 #include <vector>
 
+#include <QAtomicInteger>
+#include <QList>
+
 #include "IException.h"
 #include "Cube.h"
 #include "Brick.h"
@@ -204,6 +208,44 @@ namespace Isis {
         p_subpixelAccuracy = div;
       }
 
+      /**
+       * Evaluate the camera with one camera per thread where the walk allows
+       * it: searching for the first point, refining the vertices to subpixel
+       * accuracy, and converting the vertices to latitude/longitude. The
+       * polygon is the same as it is without threads. Cubes without attached
+       * SPICE and projected cubes are always done serially.
+       *
+       * The cameras call NAIF routines, which are not thread safe, so they
+       * are evaluated one at a time under NaifStatus::mutex().
+       *
+       * @param threaded True to use several threads
+       */
+      void SetThreadedFlag(bool threaded) {
+        m_threaded = threaded;
+      }
+
+      /**
+       * The number of times the camera (or projection) was evaluated at an
+       * image coordinate since the polygon was constructed. This is the cost
+       * of a footprint, for tuning the sample and line increments.
+       *
+       * @return @b BigInt The number of evaluations
+       */
+      BigInt cameraEvaluations() const {
+        return m_cameraEvaluations.loadAcquire();
+      }
+
+      /**
+       * The number of cameras the last polygon was created with, one for each
+       * thread. This is fewer than the threads asked for when the cameras
+       * could not be copied, and 0 for projected cubes.
+       *
+       * @return @b int The number of cameras
+       */
+      int cameraCount() const {
+        return m_cameraCount;
+      }
+
       //!  Return a geos Multipolygon
       geos::geom::MultiPolygon *Polys() {
         return p_polygons;
@@ -235,6 +277,7 @@ namespace Isis {
       // Please do not add new polygon manipulation methods to this class.
       // Polygon manipulation should be done in the PolygonTools class.
       bool SetImage(const double sample, const double line);
+      bool SetImage(Camera *camera, const double sample, const double line);
 
       geos::geom::Coordinate FindFirstPoint();
       void WalkPoly();
@@ -257,6 +300,15 @@ namespace Isis {
                                            geos::geom::Coordinate newPoint);
 
       void FindSubpixel(std::vector<geos::geom::Coordinate> & points);
+      bool OnImageEdge(const geos::geom::Coordinate &vertex);
+      geos::geom::Coordinate FindSubpixel(Camera *camera,
+                                          const geos::geom::Coordinate &previous,
+                                          const geos::geom::Coordinate &vertex,
+                                          const geos::geom::Coordinate &next);
+
+      void createThreadCameras(Cube &cube, int band);
+      void deleteThreadCameras();
+      void runThreaded(int count, const std::function<void(Camera *, int, int)> &evaluate);
 
       void calcImageBorderCoordinates();
 
@@ -292,6 +344,12 @@ namespace Isis {
 
       int p_subpixelAccuracy; //!< The subpixel accuracy to use
 
+      bool m_threaded;        //!< Evaluates the camera with several threads
+      bool m_limbEllipsoid;   //!< True when a limb image uses the ellipsoid
+      QList<Camera *> m_threadCameras; //!< The cameras of the other threads
+      int m_cameraCount;      //!< The cameras the last polygon was created with
+      QAtomicInteger<qint64> m_cameraEvaluations; //!< Camera evaluations so far
+
   };
 };
 
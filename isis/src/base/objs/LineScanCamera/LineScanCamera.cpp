@@ -7,6 +7,9 @@ find files of those names at the top level of this repository. **/
 
 #include "LineScanCamera.h"
 
+#include "SpicePosition.h"
+#include "SpiceRotation.h"
+
 namespace Isis {
   /**
    * Constructs the LineScanCamera object
@@ -15,5 +18,24 @@ namespace Isis {
    */
   LineScanCamera::LineScanCamera(Isis::Cube &cube) : Camera(cube) {
   }
+
+
+  /**
+   * Turns the table of line exposure states on or off. When it is on, the
+   *   instrument position and rotation, the body rotation and the sun position
+   *   are kept for the exposure time of every line the camera is set to, up to
+   *   the number of lines in the image. Reloading the SPICE caches or changing
+   *   their polynomials empties the table.
+   *
+   * @param enable True to keep the states of the lines
+   */
+  void LineScanCamera::SetLineTimeTable(bool enable) {
+    int size = enable ? ParentLines() : 0;
+
+    instrumentPosition()->SetTimeTableSize(size);
+    instrumentRotation()->SetTimeTableSize(size);
+    bodyRotation()->SetTimeTableSize(size);
+    sunPosition()->SetTimeTableSize(size);
+  }
 };
 
@@ -20,6 +20,11 @@ namespace Isis {
    * This class is used to abstract out line scan camera functionality from
    * children classes.
    *
+   * Every line of a line scan image is exposed at one time, so all of the
+   * pixels of a line share the same spacecraft position and pointing.
+   * SetLineTimeTable() keeps those for each line as the line is first used,
+   * so that later points on the line don't interpolate the SPICE again.
+   *
    * @ingroup SpiceInstrumentsAndCameras
    * @author 2009-08-26 Steven Lambright
    *
@@ -37,6 +42,8 @@ namespace Isis {
     public:
       LineScanCamera(Isis::Cube &cube);
 
+      void SetLineTimeTable(bool enable);
+
       /** 
        * Returns the LineScan type of camera, as enumerated in the Camera 
        * class. 
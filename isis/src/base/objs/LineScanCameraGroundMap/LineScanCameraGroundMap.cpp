@@ -7,6 +7,8 @@ find files of those names at the top level of this repository. **/
 
 #include "LineScanCameraGroundMap.h"
 
+#include <algorithm>
+#include <cfloat>
 #include <iostream>
 #include <iomanip>
 
@@ -44,9 +46,11 @@ class LineOffsetFunctor :
   public std::unary_function<double, double > {
   public:
 
-    LineOffsetFunctor(Isis::Camera *camera, const Isis::SurfacePoint &surPt) {
+    LineOffsetFunctor(Isis::Camera *camera, const Isis::SurfacePoint &surPt,
+                      Isis::BigInt *evaluations) {
       m_camera = camera;
       m_surfacePoint = surPt;
+      m_evaluations = evaluations;
     }
 
 
@@ -68,6 +72,8 @@ class LineOffsetFunctor :
       double dx = 0.0;
       double dy = 0.0;
 
+      (*m_evaluations)++;
+
       // Verify the time is with the cache bounds
       double startTime = m_camera->cacheStartTime().Et();
       double endTime = m_camera->cacheEndTime().Et();
@@ -137,6 +143,7 @@ class LineOffsetFunctor :
   private:
     SurfacePoint m_surfacePoint;
     Camera* m_camera;
+    Isis::BigInt *m_evaluations;
 };
 
 
@@ -194,7 +201,14 @@ namespace Isis {
    *
    * @param cam pointer to camera model
    */
-  LineScanCameraGroundMap::LineScanCameraGroundMap(Camera *cam) : CameraGroundMap(cam) {}
+  LineScanCameraGroundMap::LineScanCameraGroundMap(Camera *cam) : CameraGroundMap(cam) {
+    m_linePredictor = false;
+    m_linePredictorBuilt = false;
+    m_predictorSamples = 0;
+    m_predictorLines = 0;
+    m_findFocalPlaneCalls = 0;
+    m_offsetEvaluations = 0;
+  }
 
 
   /** Destructor
@@ -245,7 +259,7 @@ namespace Isis {
    * @return conversion was successful
    */
   bool LineScanCameraGroundMap::SetGround(const SurfacePoint &surfacePoint) {
-    FindFocalPlaneStatus status = FindFocalPlane(-1, surfacePoint);
+    FindFocalPlaneStatus status = FindFocalPlane(PredictLine(surfacePoint), surfacePoint);
 
     if (status == Success) return true;
 
@@ -253,6 +267,188 @@ namespace Isis {
   }
 
 
+  /**
+   * Turns the line predictor used by SetGround(const SurfacePoint &) on or
+   * off. The predictor grid is computed the first time it is needed after it
+   * is turned on, so turn it off and on again if the camera's pointing or
+   * position changes.
+   *
+   * @param enable True to seed SetGround with a predicted line
+   */
+  void LineScanCameraGroundMap::SetLinePredictor(bool enable) {
+    m_linePredictor = enable;
+    m_linePredictorBuilt = false;
+    m_predictorPoints.clear();
+    m_predictorValid.clear();
+  }
+
+
+  /**
+   * @return The number of times FindFocalPlane was called since the counts
+   *         were last reset
+   */
+  BigInt LineScanCameraGroundMap::FindFocalPlaneCalls() const {
+    return m_findFocalPlaneCalls;
+  }
+
+
+  /**
+   * @return The number of line offset evaluations FindFocalPlane made since
+   *         the counts were last reset
+   */
+  BigInt LineScanCameraGroundMap::LineOffsetEvaluations() const {
+    return m_offsetEvaluations;
+  }
+
+
+  /**
+   * @return The average number of line offset evaluations per FindFocalPlane
+   *         call, or 0 if it hasn't been called
+   */
+  double LineScanCameraGroundMap::AverageIterations() const {
+    if (m_findFocalPlaneCalls == 0) return 0.0;
+
+    return (double)m_offsetEvaluations / (double)m_findFocalPlaneCalls;
+  }
+
+
+  /**
+   * Resets the FindFocalPlane call and line offset evaluation counts.
+   */
+  void LineScanCameraGroundMap::ResetIterationCounts() {
+    m_findFocalPlaneCalls = 0;
+    m_offsetEvaluations = 0;
+  }
+
+
+  /**
+   * Projects a coarse grid of parent image nodes to the ground. Nodes that
+   * don't intersect the target are marked invalid.
+   */
+  void LineScanCameraGroundMap::BuildLinePredictor() {
+    m_linePredictorBuilt = true;
+    m_predictorSamples = 5;
+    m_predictorLines = min(p_camera->ParentLines(), 128) + 1;
+    m_predictorPoints.assign(3 * m_predictorSamples * m_predictorLines, 0.0);
+    m_predictorValid.assign(m_predictorSamples * m_predictorLines, false);
+
+    CameraDetectorMap *detectorMap = p_camera->DetectorMap();
+    CameraFocalPlaneMap *focalMap = p_camera->FocalPlaneMap();
+    CameraDistortionMap *distortionMap = p_camera->DistortionMap();
+
+    for (int j = 0; j < m_predictorLines; j++) {
+      double line = 0.5 + p_camera->ParentLines() * j / (m_predictorLines - 1.0);
+      for (int i = 0; i < m_predictorSamples; i++) {
+        double sample = 0.5 + p_camera->ParentSamples() * i / (m_predictorSamples - 1.0);
+        int node = j * m_predictorSamples + i;
+
+        try {
+          if (!detectorMap->SetParent(sample, line)) continue;
+          if (!focalMap->SetDetector(detectorMap->DetectorSample(),
+                                     detectorMap->DetectorLine())) continue;
+          if (!distortionMap->SetFocalPlane(focalMap->FocalPlaneX(),
+                                            focalMap->FocalPlaneY())) continue;
+          if (!CameraGroundMap::SetFocalPlane(distortionMap->UndistortedFocalPlaneX(),
+                                              distortionMap->UndistortedFocalPlaneY(),
+                                              distortionMap->UndistortedFocalPlaneZ())) {
+            continue;
+          }
+
+          SurfacePoint point = p_camera->GetSurfacePoint();
+          m_predictorPoints[3 * node] = point.GetX().meters();
+          m_predictorPoints[3 * node + 1] = point.GetY().meters();
+          m_predictorPoints[3 * node + 2] = point.GetZ().meters();
+          m_predictorValid[node] = true;
+        }
+        catch (IException &e) {
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Predicts the parent line that imaged a ground point from the predictor
+   * grid. The point is located relative to its nearest node by a least
+   * squares fit to the node's line and sample neighbors.
+   *
+   * @param surfacePoint 3D point on the surface of the planet
+   *
+   * @return The predicted parent line, or -1 if the predictor is off or the
+   *         point is not near the image
+   */
+  int LineScanCameraGroundMap::PredictLine(const SurfacePoint &surfacePoint) {
+    if (!m_linePredictor) return -1;
+    if (!m_linePredictorBuilt) BuildLinePredictor();
+
+    double p[3] = {surfacePoint.GetX().meters(),
+                   surfacePoint.GetY().meters(),
+                   surfacePoint.GetZ().meters()};
+
+    // Find the nearest node
+    int nearest = -1;
+    double nearestDist = DBL_MAX;
+    for (int node = 0; node < (int)m_predictorValid.size(); node++) {
+      if (!m_predictorValid[node]) continue;
+
+      const double *q = &m_predictorPoints[3 * node];
+      double dist = (p[0] - q[0]) * (p[0] - q[0]) +
+                    (p[1] - q[1]) * (p[1] - q[1]) +
+                    (p[2] - q[2]) * (p[2] - q[2]);
+      if (dist < nearestDist) {
+        nearestDist = dist;
+        nearest = node;
+      }
+    }
+
+    if (nearest < 0) return -1;
+
+    int i = nearest % m_predictorSamples;
+    int j = nearest / m_predictorSamples;
+
+    // The steps to the neighboring nodes, towards the middle of the grid at the edges
+    int lineStep = (j + 1 < m_predictorLines) ? 1 : -1;
+    int sampleStep = (i + 1 < m_predictorSamples) ? 1 : -1;
+    int lineNode = nearest + lineStep * m_predictorSamples;
+    int sampleNode = nearest + sampleStep;
+    if (!m_predictorValid[lineNode] || !m_predictorValid[sampleNode]) {
+      return -1;
+    }
+
+    const double *q = &m_predictorPoints[3 * nearest];
+    double d[3], dl[3], ds[3];
+    for (int k = 0; k < 3; k++) {
+      d[k] = p[k] - q[k];
+      dl[k] = m_predictorPoints[3 * lineNode + k] - q[k];
+      ds[k] = m_predictorPoints[3 * sampleNode + k] - q[k];
+    }
+
+    // Solve the normal equations for d = a * dl + b * ds
+    double ll = dl[0] * dl[0] + dl[1] * dl[1] + dl[2] * dl[2];
+    double ss = ds[0] * ds[0] + ds[1] * ds[1] + ds[2] * ds[2];
+    double ls = dl[0] * ds[0] + dl[1] * ds[1] + dl[2] * ds[2];
+    double ld = dl[0] * d[0] + dl[1] * d[1] + dl[2] * d[2];
+    double sd = ds[0] * d[0] + ds[1] * d[1] + ds[2] * d[2];
+    double det = ll * ss - ls * ls;
+    if (det <= 1.0e-12 * ll * ss) return -1;
+
+    double a = (ld * ss - sd * ls) / det;
+    double b = (sd * ll - ld * ls) / det;
+
+    // Points more than a grid cell off the image are left to the full search
+    double gridLine = j + a * lineStep;
+    double gridSample = i + b * sampleStep;
+    if (gridLine < -1.0 || gridLine > m_predictorLines ||
+        gridSample < -1.0 || gridSample > m_predictorSamples) {
+      return -1;
+    }
+
+    double line = 0.5 + p_camera->ParentLines() * gridLine / (m_predictorLines - 1.0);
+    line = max(1.0, min((double)p_camera->ParentLines(), line));
+    return (int)(line + 0.5);
+  }
+
+
   double LineScanCameraGroundMap::FindSpacecraftDistance(int line,
       const SurfacePoint &surfacePoint) {
 
@@ -287,7 +483,9 @@ namespace Isis {
 
     if (lineRate == 0.0) return Failure;
 
-    LineOffsetFunctor offsetFunc(p_camera,surfacePoint);
+    m_findFocalPlaneCalls++;
+
+    LineOffsetFunctor offsetFunc(p_camera, surfacePoint, &m_offsetEvaluations);
     SensorSurfacePointDistanceFunctor distanceFunc(p_camera,surfacePoint);
 
     // METHOD #1
@@ -357,7 +555,7 @@ namespace Isis {
 
         // See if we converged on the point so set up the undistorted focal plane values and return
         if (fabs(f) < 1e-2) {
-          p_camera->Sensor::setTime(approxTime);
+          p_camera->Sensor::setTime(etGuess);
           // check to make sure the point isn't behind the planet
           if (!p_camera->Sensor::SetGround(surfacePoint, true)) {
             return Failure;
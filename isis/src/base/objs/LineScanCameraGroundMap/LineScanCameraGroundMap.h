@@ -6,7 +6,10 @@ The authors of ISIS do not claim copyright on the contents of this file.
 For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
+#include <vector>
+
 #include "CameraGroundMap.h"
+#include "Constants.h"
 
 namespace Isis {
   /** Convert between undistorted focal plane and ground coordinates
@@ -15,6 +18,15 @@ namespace Isis {
    * coordinates (x/y) in millimeters and ground coordinates lat/lon
    * for line scan cameras.
    *
+   * Without an approximate line, each ground point is found by evaluating the
+   * focal plane line offset at the start, middle and end of the image before
+   * refining the root. When many points are mapped into the same image, the
+   * line predictor can be turned on: a coarse grid of image nodes is
+   * projected to the ground once, and each ground point is seeded with the
+   * line fitted from its nearest nodes, so the secant search usually needs
+   * only a few evaluations. The number of offset evaluations per call is
+   * counted so the effect can be measured.
+   *
    * @ingroup Camera
    *
    * @see Camera
@@ -59,6 +71,12 @@ namespace Isis {
       virtual bool SetGround(const SurfacePoint &surfacePoint);
       virtual bool SetGround(const SurfacePoint &surfacePoint, const int &approxLine);
 
+      void SetLinePredictor(bool enable);
+      BigInt FindFocalPlaneCalls() const;
+      BigInt LineOffsetEvaluations() const;
+      double AverageIterations() const;
+      void ResetIterationCounts();
+
     protected:
       enum FindFocalPlaneStatus {
         Success,
@@ -69,6 +87,19 @@ namespace Isis {
       FindFocalPlaneStatus FindFocalPlane(const int &approxLine,
                                           const SurfacePoint &surfacePoint);
       double FindSpacecraftDistance(int line, const SurfacePoint &surfacePoint);
+      int PredictLine(const SurfacePoint &surfacePoint);
+
+    private:
+      void BuildLinePredictor();
+
+      bool m_linePredictor;                  //!< Seed SetGround with a predicted line
+      bool m_linePredictorBuilt;             //!< The predictor grid has been computed
+      int m_predictorSamples;                //!< Number of grid nodes across a line
+      int m_predictorLines;                  //!< Number of grid nodes down the image
+      std::vector<double> m_predictorPoints; //!< Body-fixed x/y/z of each node in meters
+      std::vector<char> m_predictorValid;    //!< Whether each node intersected the target
+      BigInt m_findFocalPlaneCalls;          //!< Calls to FindFocalPlane
+      BigInt m_offsetEvaluations;            //!< Line offset evaluations in FindFocalPlane
 
   };
 };
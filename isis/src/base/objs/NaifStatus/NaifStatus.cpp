@@ -8,6 +8,8 @@ find files of those names at the top level of this repository. **/
 
 #include <iostream>
 
+#include <QMutex>
+
 #include <SpiceUsr.h>
 
 #include "IException.h"
@@ -18,6 +20,19 @@ find files of those names at the top level of this repository. **/
 namespace Isis {
   bool NaifStatus::initialized = false;
 
+
+  /**
+   * The lock that serializes calls to the NAIF toolkit across threads. It is
+   * recursive, so code that holds it can call other code that takes it.
+   *
+   * @return QMutex* The process wide NAIF lock
+   */
+  QMutex *NaifStatus::mutex() {
+    static QMutex naifMutex(QMutex::Recursive);
+    return &naifMutex;
+  }
+
+
   /**
    * This method looks for any naif errors that might have occurred. It
    * then compares the error to a list of known naif errors and converts
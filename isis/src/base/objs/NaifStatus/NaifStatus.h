@@ -7,6 +7,8 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+class QMutex;
+
 namespace Isis {
   /**
    * @brief Class for checking for errors in the NAIF library
@@ -14,6 +16,10 @@ namespace Isis {
    * The Naif Status class looks for errors that have occurred in NAIF calls. If
    * an error has occurred, it will be converted to an iException.
    *
+   * The NAIF toolkit keeps its working variables and error state in globals,
+   * so only one thread at a time may call it. Threads that evaluate their own
+   * cameras hold mutex() while they do.
+   *
    * @author 2008-06-13 Steven Lambright
    *
    * @internal
@@ -21,6 +27,7 @@ namespace Isis {
   class NaifStatus {
     public:
       static void CheckErrors(bool resetNaif = true);
+      static QMutex *mutex();
     private:
       static bool initialized;
   };
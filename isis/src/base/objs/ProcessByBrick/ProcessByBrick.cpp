@@ -4,11 +4,22 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <climits>
+#include <deque>
 #include <functional>
 
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
 #include "ProcessByBrick.h"
 #include "Brick.h"
 #include "Cube.h"
+#include "IException.h"
+#include "IString.h"
+#include "Preference.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlObject.h"
 
 using namespace std;
 
@@ -27,6 +38,17 @@ namespace Isis {
     p_outputBrickSizeSet = false;
     p_wrapOption = false;
     p_reverse = false;
+
+    p_readAheadDepth = 0;
+    PvlGroup &performancePrefs =
+        Preference::Preferences().findGroup("Performance");
+    if (performancePrefs.hasKeyword("CubeReadAhead")) {
+      // We need a no-iException conversion here
+      int depth = performancePrefs["CubeReadAhead"][0].toInt();
+      if (depth > 0) {
+        p_readAheadDepth = depth;
+      }
+    }
   }
 
 
@@ -421,6 +443,45 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
   }
 
 
+  /**
+   * Sets how many brick positions ahead of the one currently being processed
+   * input cube data should be read in the background. Reading ahead overlaps
+   * disk latency with processing, which helps the most when cubes are on slow
+   * or networked storage. The default comes from the CubeReadAhead keyword in
+   * the Performance group of the Isis preferences.
+   *
+   * @param depth The number of positions to read ahead, 0 disables reading
+   *              ahead
+   */
+  void ProcessByBrick::SetReadAheadDepth(int depth) {
+    p_readAheadDepth = qMax(0, depth);
+  }
+
+
+  /**
+   * Returns how many brick positions ahead input cube data is read.
+   * @see SetReadAheadDepth()
+   * @return The read ahead depth, 0 if reading ahead is disabled
+   */
+  int ProcessByBrick::ReadAheadDepth() const {
+    return p_readAheadDepth;
+  }
+
+
+  /**
+   * Returns how fast each worker thread processed bricks the last time
+   * ProcessCubeInPlace(), ProcessCube() or ProcessCubes() ran threaded. This
+   * is useful for finding out how well processing scales with the number of
+   * threads.
+   *
+   * @return The number of brick positions per second processed by each worker
+   *         thread, empty if the last run wasn't threaded
+   */
+  std::vector<double> ProcessByBrick::ThreadThroughput() const {
+    return p_threadThroughput;
+  }
+
+
   /**
    * Starts the systematic processing of the input cube by moving an arbitrary
    * shaped brick through the cube. This method requires that exactly one input
@@ -445,8 +506,10 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
     p_progress->CheckStatus();
 
     for (brick->begin(); !brick->end(); (*brick)++) {
-      if (haveInput)
+      if (haveInput) {
         cube->read(*brick);  // input only
+        ReadAhead(cube, *brick, p_readAheadDepth);
+      }
 
       funct(*brick);
 
@@ -486,8 +549,10 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
     p_progress->CheckStatus();
 
     for (brick->begin(); !brick->end(); (*brick)++) {
-      if (haveInput)
+      if (haveInput) {
         cube->read(*brick);  // input only
+        ReadAhead(cube, *brick, p_readAheadDepth);
+      }
 
       funct(*brick);
 
@@ -532,6 +597,7 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
 
     for (int i = 0; i < numBricks; i++) {
       InputCubes[0]->read(*ibrick);
+      ReadAhead(InputCubes[0], *ibrick, p_readAheadDepth);
       funct(*ibrick, *obrick);
       OutputCubes[0]->write(*obrick);
       p_progress->CheckStatus();
@@ -573,6 +639,7 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
 
     for (int i = 0; i < numBricks; i++) {
       InputCubes[0]->read(*ibrick);
+      ReadAhead(InputCubes[0], *ibrick, p_readAheadDepth);
       funct(*ibrick, *obrick);
       OutputCubes[0]->write(*obrick);
       p_progress->CheckStatus();
@@ -619,6 +686,7 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
       // Read the input buffers
       for(unsigned int i = 0; i < InputCubes.size(); i++) {
         InputCubes[i]->read(*ibufs[i]);
+        ReadAhead(InputCubes[i], *imgrs[i], p_readAheadDepth);
       }
 
       // Pass them to the application function
@@ -682,42 +750,87 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
 
 
   /**
-   * This method blocks until the future reports that it is finished. This
-   *   monitors the progress of the future and translates it's progress values
-   *   into Isis progress class calls.
+   * Ask the cube to start reading the data for the brick position that is
+   *   depth positions after the given brick's position. Nothing is done if
+   *   depth is 0 or that position is past the end of the cube.
    *
-   * @param future The future to monitor
+   * @param cube The cube that will be read from
+   * @param brick The brick that was just read
+   * @param depth How many positions ahead to read
    */
-  void ProcessByBrick::BlockingReportProgress(QFuture<void> &future) {
+  void ProcessByBrick::ReadAhead(Cube *cube, const Brick &brick, int depth) {
+    if (depth > 0) {
+      Brick nextBrick(brick);
+      nextBrick += depth;
+
+      if (!nextBrick.end()) {
+        cube->prefetch(nextBrick);
+      }
+    }
+  }
+
+
+  /**
+   * This method blocks until the scheduler's workers are finished. This
+   *   monitors the number of positions the workers have processed and
+   *   translates it into Isis progress class calls.
+   *
+   * @param scheduler The scheduler to monitor
+   */
+  void ProcessByBrick::BlockingReportProgress(BrickScheduler &scheduler) {
     int isisReportedProgress = 0;
-    int lastProgressValue = future.progressValue();
-    // Using a mutex with a timeout isn't as bad of a hack as inheriting QThread
-    //   but there ought to be a better way.
-    // Does having a local mutex make sense?
-    QMutex sleeper;
-    sleeper.lock();
-    while (!future.isFinished()) {
-      sleeper.tryLock(100);
-
-      if (future.progressValue() != lastProgressValue) {
-        lastProgressValue = future.progressValue();
-        // Progress min/max are reporting as 0's currently, so we're
-        //   assuming the progress value is an Isis progress value.
-        int isisProgressValue = lastProgressValue;
-        while (isisReportedProgress < isisProgressValue) {
-          p_progress->CheckStatus();
-          isisReportedProgress++;
-        }
+
+    bool finished = false;
+    while (!finished) {
+      finished = scheduler.waitForFinished(100);
+
+      int isisProgressValue = scheduler.finishedSteps();
+      while (isisReportedProgress < isisProgressValue) {
+        p_progress->CheckStatus();
+        isisReportedProgress++;
       }
     }
+  }
 
-    while (isisReportedProgress < future.progressValue()) {
-      p_progress->CheckStatus();
-      isisReportedProgress++;
+
+  /**
+   * Figure out how many consecutive brick positions a worker thread should
+   *   process together. A work unit is made of whole rows of bricks (every
+   *   sample, or every band when processing bands first) and is tall enough
+   *   to cover a row of cube tiles, so that a worker is the only one reading
+   *   and writing the tiles its unit covers. Band sequential cubes store whole
+   *   bands together, so they get a single row of bricks per unit.
+   *
+   * @param brick A brick used to traverse the cubes
+   * @param cubes The cubes being processed
+   * @return The number of brick positions in a work unit
+   */
+  int ProcessByBrick::WorkUnitSize(const Brick &brick,
+                                   const std::vector<Cube *> &cubes) const {
+    Brick position(brick);
+    position.setpos(0);
+    int firstLine = position.Line();
+
+    int stepsPerBrickRow = 1;
+    while (position.setpos(stepsPerBrickRow) && position.Line() == firstLine) {
+      stepsPerBrickRow++;
     }
 
-    // Need to unlock the mutex before it goes out of scope, otherwise Qt5 issues a warning
-    sleeper.unlock();
+    int tileLines = 1;
+    for (unsigned int i = 0; i < cubes.size(); i++) {
+      const PvlObject &core =
+          cubes[i]->label()->findObject("IsisCube").findObject("Core");
+
+      if (core.hasKeyword("TileLines")) {
+        tileLines = qMax(tileLines, toInt(core["TileLines"][0]));
+      }
+    }
+
+    int brickLines = qMax(1, brick.LineDimension());
+    BigInt brickRowsPerUnit = (tileLines + brickLines - 1) / brickLines;
+
+    return (int)qMin((BigInt)stepsPerBrickRow * brickRowsPerUnit,
+                     (BigInt)INT_MAX);
   }
 
 
@@ -1083,4 +1196,233 @@ void ProcessByBrick::SetOutputRequirements(int outputRequirements) {
     m_currentPosition++;
     return *this;
   }
+
+
+  /**
+   * The work units left for one worker and how much that worker has done.
+   *   Only the worker itself changes stepsDone and seconds; units is shared
+   *   with the workers that steal from it.
+   */
+  class ProcessByBrick::BrickScheduler::WorkerQueue {
+    public:
+      WorkerQueue() : stepsDone(0), seconds(0.0) {
+      }
+
+      //! Protects units
+      QMutex mutex;
+      //! The indices of the work units that haven't been taken yet
+      std::deque<int> units;
+      //! The number of positions this worker processed
+      int stepsDone;
+      //! How long this worker ran for
+      double seconds;
+  };
+
+
+  /**
+   * Split the positions into work units and give each worker a contiguous
+   *   run of them. If there would be too few units for the workers to balance
+   *   their load, the units are made smaller.
+   *
+   * @param numSteps The number of positions to process
+   * @param unitSize The preferred number of positions in each work unit
+   * @param workerCount The number of worker threads that will call
+   *                    runWorker()
+   */
+  ProcessByBrick::BrickScheduler::BrickScheduler(int numSteps, int unitSize,
+                                                 int workerCount) {
+    m_numSteps = numSteps;
+    m_unitSize = qMax(1, unitSize);
+    m_activeWorkers = workerCount;
+
+    BigInt minUnits = 4 * (BigInt)workerCount;
+    while (m_unitSize > 1 &&
+           ((BigInt)m_numSteps + m_unitSize - 1) / m_unitSize < minUnits) {
+      m_unitSize = (m_unitSize + 1) / 2;
+    }
+
+    BigInt numUnits = ((BigInt)m_numSteps + m_unitSize - 1) / m_unitSize;
+    for (int worker = 0; worker < workerCount; worker++) {
+      WorkerQueue *queue = new WorkerQueue;
+
+      int firstUnit = (int)(numUnits * worker / workerCount);
+      int endUnit = (int)(numUnits * (worker + 1) / workerCount);
+      for (int unit = firstUnit; unit < endUnit; unit++) {
+        queue->units.push_back(unit);
+      }
+
+      m_workerQueues.append(queue);
+    }
+  }
+
+
+  /**
+   * Destructor
+   */
+  ProcessByBrick::BrickScheduler::~BrickScheduler() {
+    qDeleteAll(m_workerQueues);
+    m_workerQueues.clear();
+  }
+
+
+  /**
+   * Process work units until there are none left to take. Every worker
+   *   thread runs this exactly once. If processing a position fails, the
+   *   error, of any type, is kept for throwError() and every worker stops.
+   *
+   * @param worker The index of this worker
+   * @param processStep Processes a single position
+   */
+  void ProcessByBrick::BrickScheduler::runWorker(int worker,
+      const std::function<void(int)> &processStep) {
+    WorkerQueue *queue = m_workerQueues[worker];
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // However this worker stops, it has to be counted as finished or the
+    // waiting thread never wakes up
+    struct FinishGuard {
+      BrickScheduler *scheduler;
+      WorkerQueue *queue;
+      QElapsedTimer *timer;
+      ~FinishGuard() {
+        queue->seconds = timer->elapsed() / 1000.0;
+
+        QMutexLocker locker(&scheduler->m_finishMutex);
+        scheduler->m_activeWorkers--;
+        scheduler->m_finishCondition.wakeAll();
+      }
+    } finishGuard = {this, queue, &timer};
+
+    try {
+      int startStep = 0;
+      int endStep = 0;
+
+      while (takeUnit(worker, startStep, endStep)) {
+        for (int step = startStep; step < endStep && !m_cancelled.load(); step++) {
+          processStep(step);
+
+          queue->stepsDone++;
+          m_finishedSteps.ref();
+        }
+      }
+    }
+    catch (IException &) {
+      QMutexLocker locker(&m_finishMutex);
+      if (!m_error) {
+        m_error = std::current_exception();
+      }
+      m_cancelled = 1;
+    }
+    catch (std::exception &e) {
+      QMutexLocker locker(&m_finishMutex);
+      if (!m_error) {
+        m_error = std::make_exception_ptr(
+            IException(IException::Unknown, e.what(), _FILEINFO_));
+      }
+      m_cancelled = 1;
+    }
+    catch (...) {
+      QMutexLocker locker(&m_finishMutex);
+      if (!m_error) {
+        m_error = std::current_exception();
+      }
+      m_cancelled = 1;
+    }
+  }
+
+
+  /**
+   * Wait for every worker to finish.
+   *
+   * @param timeout The longest time to wait, in milliseconds
+   * @return True if every worker is finished
+   */
+  bool ProcessByBrick::BrickScheduler::waitForFinished(unsigned long timeout) {
+    QMutexLocker locker(&m_finishMutex);
+
+    if (m_activeWorkers > 0) {
+      m_finishCondition.wait(&m_finishMutex, timeout);
+    }
+
+    return (m_activeWorkers == 0);
+  }
+
+
+  /**
+   * @return The number of positions that have been processed so far
+   */
+  int ProcessByBrick::BrickScheduler::finishedSteps() const {
+    return m_finishedSteps.load();
+  }
+
+
+  /**
+   * @return The number of positions per second each worker processed
+   */
+  std::vector<double> ProcessByBrick::BrickScheduler::throughput() const {
+    std::vector<double> result;
+
+    foreach (WorkerQueue *queue, m_workerQueues) {
+      result.push_back(
+          (queue->seconds > 0.0) ? queue->stepsDone / queue->seconds : 0.0);
+    }
+
+    return result;
+  }
+
+
+  /**
+   * Throw the error that stopped the workers, if there was one.
+   */
+  void ProcessByBrick::BrickScheduler::throwError() const {
+    if (m_error) {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+
+  /**
+   * Take the next work unit for a worker, stealing one from another worker
+   *   if this worker has none left.
+   *
+   * @param worker The worker that needs work
+   * @param startStep Set to the first position in the unit
+   * @param endStep Set to one past the last position in the unit
+   * @return False if there is no work left or the workers were cancelled
+   */
+  bool ProcessByBrick::BrickScheduler::takeUnit(int worker, int &startStep,
+                                                int &endStep) {
+    int unit = -1;
+
+    for (int i = 0; unit == -1 && i < m_workerQueues.size(); i++) {
+      if (m_cancelled.load()) {
+        return false;
+      }
+
+      WorkerQueue *queue = m_workerQueues[(worker + i) % m_workerQueues.size()];
+      QMutexLocker locker(&queue->mutex);
+
+      if (!queue->units.empty()) {
+        // Our own units come off the front, stolen units come off the back
+        if (i == 0) {
+          unit = queue->units.front();
+          queue->units.pop_front();
+        }
+        else {
+          unit = queue->units.back();
+          queue->units.pop_back();
+        }
+      }
+    }
+
+    if (unit == -1) {
+      return false;
+    }
+
+    startStep = (int)qMin((BigInt)unit * m_unitSize, (BigInt)m_numSteps);
+    endStep = (int)qMin((BigInt)startStep + m_unitSize, (BigInt)m_numSteps);
+    return true;
+  }
 } // end namespace isis
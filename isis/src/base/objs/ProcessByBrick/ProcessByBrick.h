@@ -6,9 +6,15 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <exception>
 #include <functional>
+#include <QAtomicInt>
+#include <QList>
+#include <QMutex>
 #include <QtConcurrentMap>
+#include <QtConcurrentRun>
 #include <QTime>
+#include <QWaitCondition>
 
 #include "Brick.h"
 #include "Buffer.h"
@@ -17,6 +23,8 @@ find files of those names at the top level of this repository. **/
 #include "Progress.h"
 
 namespace Isis {
+  class IException;
+
   /**
    * @brief Process cubes by brick
    *
@@ -127,6 +135,9 @@ namespace Isis {
 
       void SetOutputRequirements(int outputRequirements);
       void SetWrap(bool wrap);
+      void SetReadAheadDepth(int depth);
+      int ReadAheadDepth() const;
+      std::vector<double> ThreadThroughput() const;
       bool Wraps();
 
       using Isis::Process::StartProcess;  // make parents virtual function visable
@@ -169,9 +180,13 @@ namespace Isis {
         bool writeOutput = (!haveInput) || (cube->isReadWrite());
 
         ProcessCubeInPlaceFunctor<Functor> wrapperFunctor(
-            cube, brick, haveInput, writeOutput, functor);
+            cube, brick, haveInput, writeOutput, p_readAheadDepth, functor);
+
+        std::vector<Cube *> cubes;
+        cubes.push_back(cube);
 
-        RunProcess(wrapperFunctor, brick->Bricks(), threaded);
+        RunProcess(wrapperFunctor, brick->Bricks(),
+                   WorkUnitSize(*brick, cubes), threaded);
 
         delete brick;
       }
@@ -205,9 +220,14 @@ namespace Isis {
         int numBricks = PrepProcessCube(&inputCubeData, &outputCubeData);
 
         ProcessCubeFunctor<Functor> wrapperFunctor(InputCubes[0], inputCubeData,
-            OutputCubes[0], outputCubeData, functor);
+            OutputCubes[0], outputCubeData, p_readAheadDepth, functor);
 
-        RunProcess(wrapperFunctor, numBricks, threaded);
+        std::vector<Cube *> cubes;
+        cubes.push_back(InputCubes[0]);
+        cubes.push_back(OutputCubes[0]);
+
+        RunProcess(wrapperFunctor, numBricks,
+                   WorkUnitSize(*inputCubeData, cubes), threaded);
 
         delete inputCubeData;
         delete outputCubeData;
@@ -249,9 +269,15 @@ namespace Isis {
             inputCubeData, outputCubeData);
 
         ProcessCubesFunctor<Functor> wrapperFunctor(InputCubes, inputCubeData,
-              OutputCubes, outputCubeData, Wraps(), functor);
+              OutputCubes, outputCubeData, Wraps(), p_readAheadDepth, functor);
+
+        std::vector<Cube *> cubes(InputCubes);
+        cubes.insert(cubes.end(), OutputCubes.begin(), OutputCubes.end());
+        const Brick &templateBrick = inputCubeData.empty() ?
+            *outputCubeData[0] : *inputCubeData[0];
 
-        RunProcess(wrapperFunctor, numBricks, threaded);
+        RunProcess(wrapperFunctor, numBricks,
+                   WorkUnitSize(templateBrick, cubes), threaded);
 
         for(unsigned int i = 0; i < inputCubeData.size(); i++) {
           delete inputCubeData[i];
@@ -269,27 +295,52 @@ namespace Isis {
        *   or without threading, reporting progress in both cases. This method
        *   is a blocking call.
        *
+       * When threaded, the positions are split into work units of unitSize
+       *   consecutive positions and handed to one worker per global thread by
+       *   a BrickScheduler.
+       *
        * @param wrapperFunctor A functor that does the reading, processing, and
        *            writing required given a ProcessIterator position in the
        *            cube.
        * @param numSteps The end() value for the process iterator.
+       * @param unitSize The number of consecutive positions that a worker
+       *            should process together, see WorkUnitSize().
        * @param threaded Force threading off when set to false; threading may or
        *            may not be used if this is true.
        */
       template <typename Functor>
       void RunProcess(const Functor &wrapperFunctor,
-                      int numSteps, bool threaded) {
+                      int numSteps, int unitSize, bool threaded) {
         ProcessIterator begin(0);
         ProcessIterator end(numSteps);
 
         p_progress->SetMaximumSteps(numSteps);
         p_progress->CheckStatus();
 
+        p_threadThroughput.clear();
+
         int threadCount = QThreadPool::globalInstance()->maxThreadCount();
         if (threaded && threadCount > 1) {
-          QFuture<void> result = QtConcurrent::mapped(begin, end,
-              wrapperFunctor);
-          BlockingReportProgress(result);
+          BrickScheduler scheduler(numSteps, unitSize, threadCount);
+          std::function<void(int)> processStep = [&wrapperFunctor](int step) {
+            wrapperFunctor(step);
+          };
+
+          QList< QFuture<void> > workers;
+          for (int worker = 0; worker < threadCount; worker++) {
+            workers.append(QtConcurrent::run([&scheduler, &processStep, worker]() {
+              scheduler.runWorker(worker, processStep);
+            }));
+          }
+
+          BlockingReportProgress(scheduler);
+
+          for (int worker = 0; worker < workers.size(); worker++) {
+            workers[worker].waitForFinished();
+          }
+
+          p_threadThroughput = scheduler.throughput();
+          scheduler.throwError();
         }
         else {
           while (begin != end) {
@@ -308,7 +359,7 @@ namespace Isis {
        *   ProcessCubeInPlace with the appropriate data.
        *
        * This functor is a helper for the ProcessCubeInPlace() public method.
-       *   This is designed to be passed into QtConcurrent::mapped to operate
+       *   This is designed to be run by RunProcess() to operate
        *   over a cube.
        *
        * @author 2012-02-22 Steven Lambright
@@ -330,6 +381,8 @@ namespace Isis {
            *     before calling the processingFunctor.
            * @param writeOutput True if we should write the resulting brick from
            *     the processingFunctor into the cube
+           * @param readAheadDepth How many positions ahead of the current one
+           *     to prefetch input data for, 0 to disable prefetching
            * @param processingFunctor The functor supplied to
            *     ProcessCubeInPlace() which actually does the work/
            *     calculations.
@@ -337,11 +390,13 @@ namespace Isis {
           ProcessCubeInPlaceFunctor(Cube *cube,
                                     const Brick *templateBrick,
                                     bool readInput, bool writeOutput,
+                                    int readAheadDepth,
                                     const T &processingFunctor) :
               m_cube(cube),
               m_templateBrick(templateBrick),
               m_readInput(readInput),
               m_writeOutput(writeOutput),
+              m_readAheadDepth(readAheadDepth),
               m_processingFunctor(processingFunctor) {
           }
 
@@ -356,6 +411,7 @@ namespace Isis {
               m_templateBrick(other.m_templateBrick),
               m_readInput(other.m_readInput),
               m_writeOutput(other.m_writeOutput),
+              m_readAheadDepth(other.m_readAheadDepth),
               m_processingFunctor(other.m_processingFunctor) {
           }
 
@@ -379,8 +435,10 @@ namespace Isis {
             Brick cubeData(*m_templateBrick);
             cubeData.setpos(brickPosition);
 
-            if (m_readInput)
+            if (m_readInput) {
               m_cube->read(cubeData);
+              ReadAhead(m_cube, cubeData, m_readAheadDepth);
+            }
 
             m_processingFunctor(cubeData);
 
@@ -405,6 +463,7 @@ namespace Isis {
 
             m_readInput = rhs.m_readInput;
             m_writeOutput = rhs.m_writeOutput;
+            m_readAheadDepth = rhs.m_readAheadDepth;
 
             m_processingFunctor = rhs.m_processingFunctor;
 
@@ -420,6 +479,8 @@ namespace Isis {
           bool m_readInput;
           //! Should we write to the output cube after processing
           bool m_writeOutput;
+          //! How many positions ahead to prefetch input data for
+          int m_readAheadDepth;
 
           //! The functor which does the work/arbitrary calculations
           const T &m_processingFunctor;
@@ -432,7 +493,7 @@ namespace Isis {
        *   ProcessCube with the appropriate data.
        *
        * This functor is a helper for the ProcessCube() public method.
-       *   This is designed to be passed into QtConcurrent::mapped to operate
+       *   This is designed to be run by RunProcess() to operate
        *   over a cube.
        *
        * @author 2012-02-22 Steven Lambright
@@ -454,6 +515,8 @@ namespace Isis {
            *     processingFunctor
            * @param outputTemplateBrick A brick initialized for use with the
            *     processingFunctor's output parameter
+           * @param readAheadDepth How many positions ahead of the current one
+           *     to prefetch input data for, 0 to disable prefetching
            * @param processingFunctor The functor supplied to
            *     ProcessCube() which actually does the work/
            *     calculations.
@@ -462,11 +525,13 @@ namespace Isis {
                              const Brick *inputTemplateBrick,
                              Cube *outputCube,
                              const Brick *outputTemplateBrick,
+                             int readAheadDepth,
                              const T &processingFunctor) :
               m_inputCube(inputCube),
               m_inputTemplateBrick(inputTemplateBrick),
               m_outputCube(outputCube),
               m_outputTemplateBrick(outputTemplateBrick),
+              m_readAheadDepth(readAheadDepth),
               m_processingFunctor(processingFunctor) {
           }
 
@@ -481,6 +546,7 @@ namespace Isis {
               m_inputTemplateBrick(other.m_inputTemplateBrick),
               m_outputCube(other.m_outputCube),
               m_outputTemplateBrick(other.m_outputTemplateBrick),
+              m_readAheadDepth(other.m_readAheadDepth),
               m_processingFunctor(other.m_processingFunctor) {
           }
 
@@ -508,6 +574,7 @@ namespace Isis {
             outputCubeData.setpos(brickPosition);
 
             m_inputCube->read(inputCubeData);
+            ReadAhead(m_inputCube, inputCubeData, m_readAheadDepth);
 
             m_processingFunctor(inputCubeData, outputCubeData);
 
@@ -531,6 +598,8 @@ namespace Isis {
             m_outputCube = rhs.m_outputCube;
             m_outputTemplateBrick = rhs.m_outputTemplateBrick;
 
+            m_readAheadDepth = rhs.m_readAheadDepth;
+
             m_processingFunctor = rhs.m_processingFunctor;
 
             return *this;
@@ -547,6 +616,9 @@ namespace Isis {
           //! An example brick for the output parameter to m_processingFunctor
           const Brick *m_outputTemplateBrick;
 
+          //! How many positions ahead to prefetch input data for
+          int m_readAheadDepth;
+
           //! The functor which does the work/arbitrary calculations
           const T &m_processingFunctor;
        };
@@ -559,7 +631,7 @@ namespace Isis {
        *   ProcessCubes with the appropriate data.
        *
        * This functor is a helper for the ProcessCubes() public method.
-       *   This is designed to be passed into QtConcurrent::mapped to operate
+       *   This is designed to be run by RunProcess() to operate
        *   over the pre-set cubes.
        *
        * @author 2012-02-22 Steven Lambright
@@ -585,6 +657,8 @@ namespace Isis {
            *     order as the outputCubes.
            * @param wraps The current setting for the ProcessByBrick::Wrap()
            *     option.
+           * @param readAheadDepth How many positions ahead of the current one
+           *     to prefetch input data for, 0 to disable prefetching
            * @param processingFunctor The functor supplied to
            *     ProcessCubes() which actually does the work/
            *     calculations.
@@ -594,12 +668,14 @@ namespace Isis {
                               std::vector<Cube *> &outputCubes,
                               std::vector<Brick *> &outputTemplateBricks,
                               bool wraps,
+                              int readAheadDepth,
                               const T &processingFunctor) :
               m_inputCubes(inputCubes),
               m_inputTemplateBricks(inputTemplateBricks),
               m_outputCubes(outputCubes),
               m_outputTemplateBricks(outputTemplateBricks),
               m_wraps(wraps),
+              m_readAheadDepth(readAheadDepth),
               m_processingFunctor(processingFunctor) {
           }
 
@@ -615,6 +691,7 @@ namespace Isis {
               m_outputCubes(other.m_outputCubes),
               m_outputTemplateBricks(other.m_outputTemplateBricks),
               m_wraps(other.m_wraps),
+              m_readAheadDepth(other.m_readAheadDepth),
               m_processingFunctor(other.m_processingFunctor) {
           }
 
@@ -654,6 +731,7 @@ namespace Isis {
               }
 
               m_inputCubes[i]->read(*inputBrick);
+              ReadAhead(m_inputCubes[i], *inputBrick, m_readAheadDepth);
             }
 
             for (int i = 0; i < (int)m_outputTemplateBricks.size(); i++) {
@@ -694,6 +772,7 @@ namespace Isis {
             m_outputTemplateBricks = rhs.m_outputTemplateBricks;
 
             m_wraps = rhs.m_wraps;
+            m_readAheadDepth = rhs.m_readAheadDepth;
 
             m_processingFunctor = rhs.m_processingFunctor;
 
@@ -720,12 +799,76 @@ namespace Isis {
           //! Wrap smaller cubes back to the beginning?
           bool m_wraps;
 
+          //! How many positions ahead to prefetch input data for
+          int m_readAheadDepth;
+
           //! The functor which does the work/arbitrary calculations
           const T &m_processingFunctor;
        };
 
 
-      void BlockingReportProgress(QFuture<void> &future);
+      /**
+       * Hands out the brick positions of a threaded RunProcess() to its
+       *   worker threads.
+       *
+       * The positions are split into work units of consecutive positions,
+       *   which are chunk aligned when possible (see WorkUnitSize()), and each
+       *   worker starts with its own contiguous run of units. Workers take
+       *   units from the front of their own run so that they move through the
+       *   cube in order and neighboring workers rarely need the same cube
+       *   chunks. A worker that runs out of units steals from the back of
+       *   another worker's run, which is the work that worker would get to
+       *   last.
+       *
+       * @internal
+       */
+      class BrickScheduler {
+        public:
+          BrickScheduler(int numSteps, int unitSize, int workerCount);
+          ~BrickScheduler();
+
+          void runWorker(int worker,
+                         const std::function<void(int)> &processStep);
+          bool waitForFinished(unsigned long timeout);
+          int finishedSteps() const;
+          std::vector<double> throughput() const;
+          void throwError() const;
+
+        private:
+          //! Disallow copying of this object.
+          BrickScheduler(const BrickScheduler &other);
+          //! Disallow assignments of this object.
+          BrickScheduler &operator=(const BrickScheduler &other);
+
+          bool takeUnit(int worker, int &startStep, int &endStep);
+
+          class WorkerQueue;
+
+          //! The total number of positions to process
+          int m_numSteps;
+          //! The number of positions in each work unit
+          int m_unitSize;
+          //! The units that each worker has left to process
+          QList<WorkerQueue *> m_workerQueues;
+          //! The number of positions that have been processed
+          QAtomicInt m_finishedSteps;
+          //! Set when a worker failed and the rest should stop
+          QAtomicInt m_cancelled;
+          //! Protects m_activeWorkers and m_error
+          QMutex m_finishMutex;
+          //! Signaled whenever a worker finishes
+          QWaitCondition m_finishCondition;
+          //! The number of workers that haven't finished yet
+          int m_activeWorkers;
+          //! The first error a worker ran into, empty if there wasn't one
+          std::exception_ptr m_error;
+      };
+
+
+      void BlockingReportProgress(BrickScheduler &scheduler);
+      static void ReadAhead(Cube *cube, const Brick &brick, int depth);
+      int WorkUnitSize(const Brick &brick,
+                       const std::vector<Cube *> &cubes) const;
       std::vector<int> CalculateMaxDimensions(std::vector<Cube *> cubes) const;
       bool PrepProcessCubeInPlace(Cube **cube, Brick **bricks);
       int PrepProcessCube(Brick **ibrick, Brick **obrick);
@@ -815,6 +958,11 @@ namespace Isis {
                         objects when the Processing Direction is changed from
                         LinesFirst to BandsFirst*/
       bool p_wrapOption;    //!< Indicates whether the brick manager will wrap
+      int p_readAheadDepth; /**< How many brick positions ahead of the current
+                                 one to prefetch input cube data for*/
+      std::vector<double> p_threadThroughput; /**< The positions per second
+                                                   each worker thread processed
+                                                   in the last threaded run*/
       bool p_inputBrickSizeSet;  /**< Indicates whether the brick size has been
                                       set*/
       bool p_outputBrickSizeSet; /**< Indicates whether the brick size has been
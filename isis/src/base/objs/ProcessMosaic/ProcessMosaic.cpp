@@ -6,6 +6,15 @@ find files of those names at the top level of this repository. **/
 /* SPDX-License-Identifier: CC0-1.0 */
 #include "Preference.h"
 
+#include <exception>
+#include <vector>
+
+#include <QFuture>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QWaitCondition>
+#include <QtConcurrentMap>
+
 #include "Application.h"
 #include "IException.h"
 #include "IString.h"
@@ -53,6 +62,9 @@ namespace Isis {
 
     m_enforceMatchDEM = false;
 
+    // Place one line at a time unless threading is asked for
+    m_threaded = false;
+
     // Initialize the data members
     m_iss = -1;
     m_isl = -1;
@@ -381,136 +393,275 @@ namespace Isis {
                                  bandPriorityOutputBandNumber);
     }
     else {
-      // Create portal buffers for the input and output files
-      Portal iPortal(ins, 1, InputCubes[0]->pixelType());
-      Portal oPortal(ins, 1, OutputCubes[0]->pixelType());
-      Portal countPortal(ins, 1, OutputCubes[0]->pixelType());
-      Portal trackingPortal(ins, 1, PixelType::UnsignedInteger);
+      if (m_threaded) {
+        // Every line is placed with all of its bands by one thread, so the lines
+        // can be placed in any order
+        int bandsPlaced = qMin(inb, m_onb - m_osb + 1);
+        PlaceLinesThreaded(inl, bandsPlaced, [&](int line) {
+          Portal iPortal(ins, 1, InputCubes[0]->pixelType());
+          Portal oPortal(ins, 1, OutputCubes[0]->pixelType());
+          Portal countPortal(ins, 1, OutputCubes[0]->pixelType());
+          Portal trackingPortal(ins, 1, PixelType::UnsignedInteger);
+
+          for (int ib = isb, ob = m_osb; ib < (isb + inb) && ob <= m_onb; ib++, ob++) {
+            PlaceLine(iPortal, oPortal, countPortal, trackingPortal,
+                      iss, isl + line, ib, m_osl + line, ob, iIndex,
+                      bandPriorityInputBandNumber, bandPriorityOutputBandNumber);
+          }
+        });
+      }
+      else {
+        // Create portal buffers for the input and output files
+        Portal iPortal(ins, 1, InputCubes[0]->pixelType());
+        Portal oPortal(ins, 1, OutputCubes[0]->pixelType());
+        Portal countPortal(ins, 1, OutputCubes[0]->pixelType());
+        Portal trackingPortal(ins, 1, PixelType::UnsignedInteger);
 
-      for (int ib = isb, ob = m_osb; ib < (isb + inb) && ob <= m_onb; ib++, ob++) {
-        for (int il = isl, ol = m_osl; il < isl + inl; il++, ol++) {
-          // Set the position of the portals in the input and output cubes
-          iPortal.SetPosition(iss, il, ib);
-          InputCubes[0]->read(iPortal);
+        for (int ib = isb, ob = m_osb; ib < (isb + inb) && ob <= m_onb; ib++, ob++) {
+          for (int il = isl, ol = m_osl; il < isl + inl; il++, ol++) {
+            PlaceLine(iPortal, oPortal, countPortal, trackingPortal,
+                      iss, il, ib, ol, ob, iIndex,
+                      bandPriorityInputBandNumber, bandPriorityOutputBandNumber);
+            p_progress->CheckStatus();
+          } // End line loop
+        }   // End band loop
+      }
+    }
+    if (m_trackingCube) {
+      m_trackingCube->close();
+      delete m_trackingCube;
+      m_trackingCube = NULL;
+    }
+  } // End StartProcess
 
-          oPortal.SetPosition(m_oss, ol, ob);
-          OutputCubes[0]->read(oPortal);
 
-          if (m_trackingEnabled) {
-            trackingPortal.SetPosition(m_oss, ol, 1);
-            m_trackingCube->read(trackingPortal);
-          }
-          else if (m_imageOverlay == AverageImageWithMosaic) {
-            countPortal.SetPosition(m_oss, ol, (ob+m_onb));
-            OutputCubes[0]->read(countPortal);
-          }
+  /**
+   * Place one line of one band of the input cube on the mosaic, following the
+   *   image overlay priority, and update the tracking cube or count band for it.
+   *   This only reads and writes the given line of the mosaic (and of the
+   *   tracking cube), so different lines can be placed concurrently.
+   *
+   * @param iPortal Input portal, one line of the input sub-area wide
+   * @param oPortal Mosaic portal, the same size as iPortal
+   * @param countPortal Portal for the count band of average priority
+   * @param trackingPortal Portal for the tracking cube
+   * @param iss The starting sample within the input cube
+   * @param il The input line to place
+   * @param ib The input band to place
+   * @param ol The mosaic line to place it on
+   * @param ob The mosaic band to place it on
+   * @param iIndex The tracking index of the input image
+   * @param bandPriorityInputBandNumber The input band band priority compares
+   * @param bandPriorityOutputBandNumber The mosaic band band priority compares
+   */
+  void ProcessMosaic::PlaceLine(Portal &iPortal, Portal &oPortal, Portal &countPortal,
+                                Portal &trackingPortal, int iss, int il, int ib,
+                                int ol, int ob, int iIndex,
+                                int bandPriorityInputBandNumber,
+                                int bandPriorityOutputBandNumber) {
+    // Set the position of the portals in the input and output cubes
+    iPortal.SetPosition(iss, il, ib);
+    InputCubes[0]->read(iPortal);
+
+    oPortal.SetPosition(m_oss, ol, ob);
+    OutputCubes[0]->read(oPortal);
+
+    if (m_trackingEnabled) {
+      trackingPortal.SetPosition(m_oss, ol, 1);
+      m_trackingCube->read(trackingPortal);
+    }
+    else if (m_imageOverlay == AverageImageWithMosaic) {
+      countPortal.SetPosition(m_oss, ol, (ob+m_onb));
+      OutputCubes[0]->read(countPortal);
+    }
 
-          bool bChanged = false;
-          // Move the input data to the output
-          for (int pixel = 0; pixel < oPortal.size(); pixel++) {
-            // Creating Mosaic, copy the input onto mosaic
-            // regardless of the priority
-            if (m_createOutputMosaic) {
+    // Band priority compares the bands the priority is based on, which don't change
+    // while this line is placed
+    Portal iComparePortal(iPortal.size(), 1, InputCubes[0]->pixelType());
+    Portal oComparePortal(oPortal.size(), 1, OutputCubes[0]->pixelType());
+    if (!m_createOutputMosaic && m_trackingEnabled &&
+        m_imageOverlay == UseBandPlacementCriteria) {
+      iComparePortal.SetPosition(iss, il, bandPriorityInputBandNumber);
+      InputCubes[0]->read(iComparePortal);
+      oComparePortal.SetPosition(m_oss, ol, bandPriorityOutputBandNumber);
+      OutputCubes[0]->read(oComparePortal);
+    }
+
+    bool bChanged = false;
+    // Move the input data to the output
+    for (int pixel = 0; pixel < oPortal.size(); pixel++) {
+      // Creating Mosaic, copy the input onto mosaic
+      // regardless of the priority
+      if (m_createOutputMosaic) {
+        oPortal[pixel] = iPortal[pixel];
+        if (m_trackingEnabled) {
+          trackingPortal[pixel] = iIndex;
+          bChanged = true;
+        }
+        else if (m_imageOverlay == AverageImageWithMosaic) {
+          if (IsValidPixel(iPortal[pixel])) {
+            countPortal[pixel]=1;
+            bChanged = true;
+          }
+        }
+      }
+      // Band Priority
+      else if (m_trackingEnabled && m_imageOverlay == UseBandPlacementCriteria) {
+        int iPixelOrigin = qRound(trackingPortal[pixel]);
+
+        if (iPixelOrigin == iIndex) {
+          if ( ( IsValidPixel(iComparePortal[pixel]) &&
+                 IsValidPixel(oComparePortal[pixel]) ) &&
+               ( (!m_bandPriorityUseMaxValue &&
+                  iComparePortal[pixel] < oComparePortal[pixel]) ||
+                 (m_bandPriorityUseMaxValue &&
+                  iComparePortal[pixel] > oComparePortal[pixel]) ) ) {
+
+            if ( IsValidPixel(iPortal[pixel]) ||
+                 ( m_placeHighSatPixels && IsHighPixel(iPortal[pixel]) ) ||
+                 ( m_placeLowSatPixels  && IsLowPixel (iPortal[pixel]) ) ||
+                 ( m_placeNullPixels    && IsNullPixel(iPortal[pixel]) ) ){
               oPortal[pixel] = iPortal[pixel];
-              if (m_trackingEnabled) {
-                trackingPortal[pixel] = iIndex;
-                bChanged = true;
-              }
-              else if (m_imageOverlay == AverageImageWithMosaic) {
-                if (IsValidPixel(iPortal[pixel])) {
-                  countPortal[pixel]=1;
-                  bChanged = true;
-                }
-              }
-            }
-            // Band Priority
-            else if (m_trackingEnabled && m_imageOverlay == UseBandPlacementCriteria) {
-              int iPixelOrigin = qRound(trackingPortal[pixel]);
-
-              Portal iComparePortal( ins, 1, InputCubes[0]->pixelType() );
-              Portal oComparePortal( ins, 1, OutputCubes[0]->pixelType() );
-              iComparePortal.SetPosition(iss, il, bandPriorityInputBandNumber);
-              InputCubes[0]->read(iComparePortal);
-              oComparePortal.SetPosition(m_oss, ol, bandPriorityOutputBandNumber);
-              OutputCubes[0]->read(oComparePortal);
-
-              if (iPixelOrigin == iIndex) {
-                if ( ( IsValidPixel(iComparePortal[pixel]) &&
-                       IsValidPixel(oComparePortal[pixel]) ) &&
-                     ( (!m_bandPriorityUseMaxValue &&
-                        iComparePortal[pixel] < oComparePortal[pixel]) ||
-                       (m_bandPriorityUseMaxValue &&
-                        iComparePortal[pixel] > oComparePortal[pixel]) ) ) {
-
-                  if ( IsValidPixel(iPortal[pixel]) ||
-                       ( m_placeHighSatPixels && IsHighPixel(iPortal[pixel]) ) ||
-                       ( m_placeLowSatPixels  && IsLowPixel (iPortal[pixel]) ) ||
-                       ( m_placeNullPixels    && IsNullPixel(iPortal[pixel]) ) ){
-                    oPortal[pixel] = iPortal[pixel];
-                    bChanged = true;
-                  }
-                }
-                else { //bad comparison
-                  if ( ( IsValidPixel(iPortal[pixel]) && !IsValidPixel(oPortal[pixel]) ) ||
-                       ( m_placeHighSatPixels && IsHighPixel(iPortal[pixel]) ) ||
-                       ( m_placeLowSatPixels  && IsLowPixel (iPortal[pixel]) ) ||
-                       ( m_placeNullPixels    && IsNullPixel(iPortal[pixel]) ) ) {
-                    oPortal[pixel] = iPortal[pixel];
-                    bChanged = true;
-                  }
-                }
-              }
+              bChanged = true;
             }
-            // OnTop/Input Priority
-            else if (m_imageOverlay == PlaceImagesOnTop) {
-              if (IsNullPixel(oPortal[pixel])  ||
-                 IsValidPixel(iPortal[pixel]) ||
-                 (m_placeHighSatPixels && IsHighPixel(iPortal[pixel])) ||
-                 (m_placeLowSatPixels  && IsLowPixel(iPortal[pixel]))  ||
-                 (m_placeNullPixels    && IsNullPixel(iPortal[pixel]))) {
-                oPortal[pixel] = iPortal[pixel];
-                if (m_trackingEnabled) {
-                  trackingPortal[pixel] = iIndex;
-                  bChanged = true;
-                }
-              }
-            }
-            // AverageImageWithMosaic priority
-            else if (m_imageOverlay == AverageImageWithMosaic) {
-              bChanged |= ProcessAveragePriority(pixel, iPortal, oPortal, countPortal);
-            }
-            // Beneath/Mosaic Priority
-            else if (m_imageOverlay == PlaceImagesBeneath) {
-              if (IsNullPixel(oPortal[pixel])) {
-                oPortal[pixel] = iPortal[pixel];
-                // Set the origin if number of input bands equal to 1
-                // and if the track flag was set
-                if (m_trackingEnabled) {
-                  trackingPortal[pixel] = iIndex;
-                  bChanged = true;
-                }
-              }
-            }
-          } // End sample loop
-          if (bChanged) {
-            if (m_trackingEnabled) {
-              m_trackingCube->write(trackingPortal);
-            }
-            if (m_imageOverlay == AverageImageWithMosaic) {
-              OutputCubes[0]->write(countPortal);
+          }
+          else { //bad comparison
+            if ( ( IsValidPixel(iPortal[pixel]) && !IsValidPixel(oPortal[pixel]) ) ||
+                 ( m_placeHighSatPixels && IsHighPixel(iPortal[pixel]) ) ||
+                 ( m_placeLowSatPixels  && IsLowPixel (iPortal[pixel]) ) ||
+                 ( m_placeNullPixels    && IsNullPixel(iPortal[pixel]) ) ) {
+              oPortal[pixel] = iPortal[pixel];
+              bChanged = true;
             }
           }
-          OutputCubes[0]->write(oPortal);
+        }
+      }
+      // OnTop/Input Priority
+      else if (m_imageOverlay == PlaceImagesOnTop) {
+        if (IsNullPixel(oPortal[pixel])  ||
+           IsValidPixel(iPortal[pixel]) ||
+           (m_placeHighSatPixels && IsHighPixel(iPortal[pixel])) ||
+           (m_placeLowSatPixels  && IsLowPixel(iPortal[pixel]))  ||
+           (m_placeNullPixels    && IsNullPixel(iPortal[pixel]))) {
+          oPortal[pixel] = iPortal[pixel];
+          if (m_trackingEnabled) {
+            trackingPortal[pixel] = iIndex;
+            bChanged = true;
+          }
+        }
+      }
+      // AverageImageWithMosaic priority
+      else if (m_imageOverlay == AverageImageWithMosaic) {
+        bChanged |= ProcessAveragePriority(pixel, iPortal, oPortal, countPortal);
+      }
+      // Beneath/Mosaic Priority
+      else if (m_imageOverlay == PlaceImagesBeneath) {
+        if (IsNullPixel(oPortal[pixel])) {
+          oPortal[pixel] = iPortal[pixel];
+          // Set the origin if number of input bands equal to 1
+          // and if the track flag was set
+          if (m_trackingEnabled) {
+            trackingPortal[pixel] = iIndex;
+            bChanged = true;
+          }
+        }
+      }
+    } // End sample loop
+    if (bChanged) {
+      if (m_trackingEnabled) {
+        m_trackingCube->write(trackingPortal);
+      }
+      if (m_imageOverlay == AverageImageWithMosaic) {
+        OutputCubes[0]->write(countPortal);
+      }
+    }
+    OutputCubes[0]->write(oPortal);
+  }
+
+
+  /**
+   * Place lines of the input cube on the mosaic concurrently, using the global
+   *   thread pool, and report progress from this thread. The first error
+   *   placing a line, of any type, stops the rest of the lines from being
+   *   placed and is rethrown once every worker is done.
+   *
+   * @param lineCount The number of lines to place
+   * @param stepsPerLine The number of progress steps to report for each line
+   * @param placeLine Places a line, given its index from 0 to lineCount - 1.
+   *                  This is called from the worker threads.
+   */
+  void ProcessMosaic::PlaceLinesThreaded(int lineCount, int stepsPerLine,
+                                         const std::function<void(int)> &placeLine) {
+    std::vector<int> lines(lineCount);
+    for (int line = 0; line < lineCount; line++) {
+      lines[line] = line;
+    }
+
+    QMutex finishMutex;
+    QWaitCondition finishCondition;
+    int finishedLines = 0;
+    bool cancelled = false;
+    std::exception_ptr error;
+
+    QFuture<void> future = QtConcurrent::map(lines, [&](const int &line) {
+      {
+        QMutexLocker locker(&finishMutex);
+        if (cancelled) {
+          return;
+        }
+      }
+
+      try {
+        placeLine(line);
+      }
+      catch (...) {
+        QMutexLocker locker(&finishMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        cancelled = true;
+      }
+
+      QMutexLocker locker(&finishMutex);
+      finishedLines++;
+      finishCondition.wakeAll();
+    });
+
+    int reportedSteps = 0;
+    try {
+      QMutexLocker locker(&finishMutex);
+      while (finishedLines < lineCount && !cancelled) {
+        finishCondition.wait(&finishMutex, 100);
+
+        int finishedSteps = finishedLines * stepsPerLine;
+        locker.unlock();
+        while (reportedSteps < finishedSteps) {
           p_progress->CheckStatus();
-        } // End line loop
-      }   // End band loop
+          reportedSteps++;
+        }
+        locker.relock();
+      }
     }
-    if (m_trackingCube) {
-      m_trackingCube->close();
-      delete m_trackingCube;
-      m_trackingCube = NULL;
+    catch (...) {
+      {
+        QMutexLocker locker(&finishMutex);
+        cancelled = true;
+      }
+      future.waitForFinished();
+      throw;
     }
-  } // End StartProcess
+
+    future.waitForFinished();
+
+    if (error) {
+      std::rethrow_exception(error);
+    }
+
+    while (reportedSteps < lineCount * stepsPerLine) {
+      p_progress->CheckStatus();
+      reportedSteps++;
+    }
+  }
 
 
   /**
@@ -820,6 +971,17 @@ namespace Isis {
   }
 
 
+  /**
+   * When true, the lines of each input cube are placed on the mosaic by
+   *   several threads at once. Each line is placed with all of its bands by a
+   *   single thread, so the mosaic (and tracking cube) are exactly the same as
+   *   when the lines are placed one at a time. The default is false.
+   */
+  void ProcessMosaic::SetThreadedFlag(bool threaded) {
+    m_threaded = threaded;
+  }
+
+
   /**
    * @see SetHighSaturationFlag()
    */
@@ -860,6 +1022,14 @@ namespace Isis {
   }
 
 
+  /**
+   * @see SetThreadedFlag()
+   */
+  bool ProcessMosaic::GetThreadedFlag() const {
+    return m_threaded;
+  }
+
+
   /**
    * This is the line where the image was placed into the output mosaic.
    */
@@ -1336,13 +1506,16 @@ namespace Isis {
    */
   void ProcessMosaic::BandComparison(int iss, int isl, int ins, int inl,
       int bandPriorityInputBandNumber, int bandPriorityOutputBandNumber, int index) {
-    //
-    // Create portal buffers for the input and output files
-    Portal cIportal(ins, 1, InputCubes[0]->pixelType());
-    Portal cOportal(ins, 1, OutputCubes[0]->pixelType());
-    Portal trackingPortal(ins, 1, PixelType::UnsignedInteger);
+    // Every line is compared on its own, so the lines can be compared in any order
+    std::function<void(int)> compareLine = [&](int line) {
+      int iIL = isl + line;
+      int iOL = m_osl + line;
+
+      // Create portal buffers for the input and output files
+      Portal cIportal(ins, 1, InputCubes[0]->pixelType());
+      Portal cOportal(ins, 1, OutputCubes[0]->pixelType());
+      Portal trackingPortal(ins, 1, PixelType::UnsignedInteger);
 
-    for (int iIL = isl, iOL = m_osl; iIL < isl + inl; iIL++, iOL++) {
       // Set the position of the portals in the input and output cubes
       cIportal.SetPosition(iss, iIL, bandPriorityInputBandNumber);
       InputCubes[0]->read(cIportal);
@@ -1371,6 +1544,15 @@ namespace Isis {
         }
       }
       m_trackingCube->write(trackingPortal);
+    };
+
+    if (m_threaded) {
+      PlaceLinesThreaded(inl, 0, compareLine);
+    }
+    else {
+      for (int line = 0; line < inl; line++) {
+        compareLine(line);
+      }
     }
   }
 
@@ -1383,19 +1565,20 @@ namespace Isis {
 void ProcessMosaic::BandPriorityWithNoTracking(int iss, int isl, int isb, int ins, int inl,
                                                  int inb, int bandPriorityInputBandNumber,
                                                  int bandPriorityOutputBandNumber) {
-    /*
-     * specified band for comparison
-     * Create portal buffers for the input and output files pointing to the
-     */
-    Portal iComparePortal( ins, 1, InputCubes[0]->pixelType() );
-    Portal oComparePortal( ins, 1, OutputCubes[0]->pixelType() );
-    Portal resultsPortal ( ins, 1, OutputCubes[0]->pixelType() );
-
-    // Create portal buffers for the input and output files
-    Portal iPortal( ins, 1, InputCubes[0]->pixelType() );
-    Portal oPortal( ins, 1, OutputCubes[0]->pixelType() );
-
-    for (int inLine = isl, outLine = m_osl; inLine < isl + inl; inLine++, outLine++) {
+    // Every line is placed with all of its bands at once, so the lines can be placed in any
+    // order
+    std::function<void(int)> placeLine = [&](int line) {
+      int inLine = isl + line;
+      int outLine = m_osl + line;
+
+      /*
+       * specified band for comparison
+       * Create portal buffers for the input and output files pointing to the
+       */
+      Portal iComparePortal( ins, 1, InputCubes[0]->pixelType() );
+      Portal oComparePortal( ins, 1, OutputCubes[0]->pixelType() );
+      Portal resultsPortal ( ins, 1, OutputCubes[0]->pixelType() );
+
 //       Set the position of the portals in the input and output cubes
       iComparePortal.SetPosition(iss, inLine, bandPriorityInputBandNumber);
       InputCubes[0]->read(iComparePortal);
@@ -1403,6 +1586,7 @@ void ProcessMosaic::BandPriorityWithNoTracking(int iss, int isl, int isb, int in
       oComparePortal.SetPosition(m_oss, outLine, bandPriorityOutputBandNumber);
       OutputCubes[0]->read(oComparePortal);
 
+      // Create portal buffers for the input and output files
       Portal iPortal( ins, 1, InputCubes[0]->pixelType() );
       Portal oPortal( ins, 1, OutputCubes[0]->pixelType() );
 
@@ -1456,6 +1640,15 @@ void ProcessMosaic::BandPriorityWithNoTracking(int iss, int isl, int isb, int in
           OutputCubes[0]->write(oPortal);
         }
       }
+    };
+
+    if (m_threaded) {
+      PlaceLinesThreaded(inl, 0, placeLine);
+    }
+    else {
+      for (int line = 0; line < inl; line++) {
+        placeLine(line);
+      }
     }
   }
 
@@ -6,6 +6,8 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <functional>
+
 #include "Process.h"
 
 namespace Isis {
@@ -267,12 +269,14 @@ namespace Isis {
       void SetMatchDEM(bool matchDEM);
       void SetNullFlag(bool placeNullPixels);
       void SetTrackFlag(bool trackingEnabled);
+      void SetThreadedFlag(bool threaded);
 
       bool GetHighSaturationFlag() const;
       ImageOverlay GetImageOverlay() const;
       bool GetLowSaturationFlag() const;
       bool GetNullFlag() const;
       bool GetTrackFlag() const;
+      bool GetThreadedFlag() const;
 
       int GetInputStartLineInMosaic() const;
       int GetInputStartSampleInMosaic() const;
@@ -313,6 +317,16 @@ namespace Isis {
       // Mosaic exists, match the band with the input image
       void MatchBandBinGroup(int origIsb, int &inb);
 
+      // Place one line of one band of the input on the mosaic
+      void PlaceLine(Portal &iPortal, Portal &oPortal, Portal &countPortal,
+                     Portal &trackingPortal, int iss, int il, int ib,
+                     int ol, int ob, int iIndex,
+                     int bandPriorityInputBandNumber, int bandPriorityOutputBandNumber);
+
+      // Place independent lines of the input on the mosaic concurrently
+      void PlaceLinesThreaded(int lineCount, int stepsPerLine,
+                              const std::function<void(int)> &placeLine);
+
       bool ProcessAveragePriority(int piPixel, Portal& pInPortal, Portal& pOutPortal,
                                   Portal& pOrigPortal);
 
@@ -348,6 +362,8 @@ namespace Isis {
 
       bool m_enforceMatchDEM; //!< DEM of the input and mosaic should match
 
+      bool m_threaded; //!< Place the lines of each input with several threads
+
       ImageOverlay m_imageOverlay; //!<
 
       PvlObject m_imagePositions; //!< List of images placed on the mosaic.
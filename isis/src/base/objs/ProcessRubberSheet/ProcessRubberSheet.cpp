@@ -4,15 +4,24 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <exception>
 #include <iostream>
 #include <iomanip>
 
+#include <QFuture>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QVector>
+#include <QWaitCondition>
+#include <QtConcurrentRun>
 
 #include "Affine.h"
 #include "BasisFunction.h"
 #include "BoxcarCachingAlgorithm.h"
 #include "Brick.h"
+#include "IException.h"
+#include "IString.h"
 #include "Interpolator.h"
 #include "LeastSquares.h"
 #include "Portal.h"
@@ -48,6 +57,10 @@ namespace Isis {
     m_patchLines = 5;
     m_patchSampleIncrement = 4;
     m_patchLineIncrement = 4;
+
+    // No transform grid unless it's asked for (StartProcess)
+    m_gridSpacing = 0;
+    m_gridTolerance = 0.5;
   };
 
 
@@ -111,6 +124,49 @@ namespace Isis {
   }
 
 
+  /**
+   * This method makes the tile transform method (StartProcess) compute the
+   * transform on a coarse grid of output pixels instead of its quad tree.
+   * Input positions between the grid nodes are interpolated from the nodes.
+   * The transform is only computed for every output pixel of a grid cell if
+   * the interpolated input position at the center of the cell is off by more
+   * than the tolerance, or if some of the corners of the cell don't transform.
+   * This needs far fewer transforms than the quad tree for smooth transforms,
+   * such as the ones used to map project camera images.
+   *
+   * @param spacing The number of output pixels between grid nodes. The grid
+   *                starts over with every output tile, so this should be less
+   *                than the start tile size. Zero (the default) turns the grid
+   *                off.
+   *
+   * @param tolerance The largest difference, in input pixels, between the
+   *                  interpolated and transformed input position at the center
+   *                  of a grid cell. The default is half a pixel, the same as
+   *                  the quad tree uses.
+   *
+   * @throws IException::Programmer "The transform grid spacing can't be
+   *                                 negative"
+   * @throws IException::Programmer "The transform grid tolerance must be
+   *                                 positive"
+   */
+  void ProcessRubberSheet::setTransformGrid(int spacing, double tolerance) {
+    if (spacing < 0) {
+      string m = "The transform grid spacing [" + IString(spacing) +
+                 "] can't be negative";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+
+    if (tolerance <= 0.0) {
+      string m = "The transform grid tolerance [" + IString(tolerance) +
+                 "] must be positive";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+
+    m_gridSpacing = spacing;
+    m_gridTolerance = tolerance;
+  }
+
+
   /**
    * Applies a Transform and an Interpolator to every pixel in the output cube.
    * The output cube is written using an Tile and the input cube is read using
@@ -179,7 +235,8 @@ namespace Isis {
             SlowGeom(otile, iportal, trans, interp);
           }
           else {
-            QuadTree(otile, iportal, trans, interp, useLastTileMap);
+            QuadTree(otile, iportal, trans, interp, useLastTileMap,
+                     p_lineMap, p_sampMap);
           }
 
           useLastTileMap = true;
@@ -204,7 +261,8 @@ namespace Isis {
           SlowGeom(otile, iportal, trans, interp);
         }
         else {
-          QuadTree(otile, iportal, trans, interp, false);
+          QuadTree(otile, iportal, trans, interp, false,
+                   p_lineMap, p_sampMap);
         }
 
         OutputCubes[0]->write(otile);
@@ -217,6 +275,135 @@ namespace Isis {
   }
 
 
+  /**
+   * Applies a Transform and an Interpolator to every pixel in the output cube
+   * using one thread per Transform. This produces the same output cube as
+   * StartProcess(Transform &, Interpolator &), but the output tiles are
+   * transformed concurrently. Each thread owns one of the Transforms, a copy
+   * of the Interpolator and its own input Portal. The finished tiles are
+   * written to the output cube by the calling thread, in order.
+   *
+   * If a band change function is registered, it is called from the calling
+   * thread and the bands are processed one at a time.
+   *
+   * @param transforms Fully initialized Transform objects, one per thread.
+   *                   They must be able to run concurrently, so they can't
+   *                   share a Camera or any other state that changes when
+   *                   Xform is called. Transforms that evaluate a Camera
+   *                   hold NaifStatus::mutex() while they do.
+   *
+   * @param interp A fully initialized Interpolator object. Each thread uses a
+   *               copy of it.
+   *
+   * @throws IException::Programmer "You must give at least one Transform"
+   */
+  void ProcessRubberSheet::StartProcess(const std::vector<Transform *> &transforms,
+                                        Interpolator &interp) {
+    if (transforms.empty()) {
+      string m = "You must give at least one Transform";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+    else if (transforms.size() == 1) {
+      StartProcess(*transforms[0], interp);
+      return;
+    }
+
+    // Error checks ... there must be one input and one output
+    if (InputCubes.size() != 1) {
+      string m = "You must specify exactly one input cube";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+    else if (OutputCubes.size() != 1) {
+      string m = "You must specify exactly one output cube";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+
+    int workerCount = transforms.size();
+    int bandCount = OutputCubes[0]->bandCount();
+
+    // Every thread gets its own portal, interpolator and sampMap/lineMap
+    std::vector<Portal *> iportals;
+    std::vector<Interpolator> interps(workerCount, interp);
+    std::vector< std::vector< std::vector<double> > > lineMaps(workerCount,
+        std::vector< std::vector<double> >(p_startQuadSize,
+                                           std::vector<double>(p_startQuadSize)));
+    std::vector< std::vector< std::vector<double> > > sampMaps(lineMaps);
+
+    for (int worker = 0; worker < workerCount; worker++) {
+      iportals.push_back(new Portal(interp.Samples(), interp.Lines(),
+                                    InputCubes[0]->pixelType(),
+                                    interp.HotSample(), interp.HotLine()));
+    }
+
+    TileManager otile(*OutputCubes[0], p_startQuadSize, p_startQuadSize);
+    int tilesPerBand = otile.Tiles() / bandCount;
+
+    // Start the progress meter
+    p_progress->SetMaximumSteps(otile.Tiles());
+    p_progress->CheckStatus();
+
+    // Without a band change function every band of a tile is transformed
+    // together, reusing the tile map; otherwise the bands are done one at a
+    // time
+    int bandsPerPass = bandCount;
+    if (p_bandChangeFunct == NULL) {
+      // Every thread reads its own portal positions, so cache enough chunks
+      // for all of them
+      InputCubes[0]->addCachingAlgorithm(
+          new UniqueIOCachingAlgorithm(2 * InputCubes[0]->bandCount() * workerCount));
+      OutputCubes[0]->addCachingAlgorithm(new BoxcarCachingAlgorithm());
+    }
+    else {
+      bandsPerPass = 1;
+    }
+
+    try {
+      for (int firstBand = 1; firstBand <= bandCount; firstBand += bandsPerPass) {
+        if (p_bandChangeFunct != NULL) {
+          p_bandChangeFunct(firstBand);
+        }
+
+        std::function<void(int, int, QList<Buffer *> &)> transformTile =
+            [&](int worker, int unit, QList<Buffer *> &otiles) {
+          for (int band = firstBand; band < firstBand + bandsPerPass; band++) {
+            TileManager *workerTile = new TileManager(*OutputCubes[0],
+                                                      p_startQuadSize,
+                                                      p_startQuadSize);
+            otiles.append(workerTile);
+            workerTile->SetTile(unit + 1, band);
+
+            if (p_startQuadSize <= 2) {
+              SlowGeom(*workerTile, *iportals[worker], *transforms[worker],
+                       interps[worker]);
+            }
+            else {
+              QuadTree(*workerTile, *iportals[worker], *transforms[worker],
+                       interps[worker], band != firstBand,
+                       lineMaps[worker], sampMaps[worker]);
+            }
+          }
+        };
+
+        std::function<void(QList<Buffer *> &)> writeTiles =
+            [this](QList<Buffer *> &otiles) {
+          for (int i = 0; i < otiles.size(); i++) {
+            OutputCubes[0]->write(*otiles[i]);
+          }
+        };
+
+        RunThreaded(workerCount, tilesPerBand, bandsPerPass,
+                    transformTile, writeTiles);
+      }
+    }
+    catch (IException &) {
+      qDeleteAll(iportals);
+      throw;
+    }
+
+    qDeleteAll(iportals);
+  }
+
+
   /**
    * Registers a function to be called when the current output cube band number
    * changes. This includes the first time. If and application does NOT need to
@@ -268,12 +455,17 @@ namespace Isis {
 
   void ProcessRubberSheet::QuadTree(TileManager &otile, Portal &iportal,
                                     Transform &trans, Interpolator &interp,
-                                    bool useLastTileMap) {
+                                    bool useLastTileMap,
+                                    std::vector< std::vector<double> > &lineMap,
+                                    std::vector< std::vector<double> > &sampMap) {
 
     // Initializations
     vector<Quad *> quadTree;
 
-    if (!useLastTileMap) {
+    if (!useLastTileMap && m_gridSpacing > 0) {
+      GridMap(otile, trans, lineMap, sampMap);
+    }
+    else if (!useLastTileMap) {
       // Set up the boundaries of the full tile
       Quad *quad = new Quad;
       quad->sline = otile.Line();
@@ -289,7 +481,7 @@ namespace Isis {
       // Loop and compute the input coordinates filling the maps
       // until the quad tree is empty
       while (quadTree.size() > 0) {
-        ProcessQuad(quadTree, trans, p_lineMap, p_sampMap);
+        ProcessQuad(quadTree, trans, lineMap, sampMap);
       }
     }
 
@@ -297,8 +489,8 @@ namespace Isis {
     int outputBand = otile.Band();
     for (int i = 0, line = 0; line < p_startQuadSize; line++) {
       for (int samp = 0; samp < p_startQuadSize; samp++, i++) {
-        double inputLine = p_lineMap[line][samp];
-        double inputSamp = p_sampMap[line][samp];
+        double inputLine = lineMap[line][samp];
+        double inputSamp = sampMap[line][samp];
         if (inputLine != NULL8) {
           iportal.SetPosition(inputSamp, inputLine, outputBand);
           InputCubes[0]->read(iportal);
@@ -620,6 +812,165 @@ namespace Isis {
   }
 
 
+  /**
+   * Fills the tile maps from a coarse grid of transformed output positions.
+   * The grid nodes are m_gridSpacing output pixels apart, plus the last line
+   * and sample of the tile, and each node is transformed once. A grid cell
+   * whose four corners transform is filled by bilinear interpolation of the
+   * corners, if the interpolated input position at the center of the cell is
+   * within m_gridTolerance input pixels of the transformed one. Otherwise every
+   * pixel of the cell is transformed. A cell with no corners that transform is
+   * filled with nulls, unless any of its edges or center lines transform.
+   *
+   * @param otile The output tile to fill the maps for
+   * @param trans The Transform to use
+   * @param lineMap The input line of every output pixel in the tile
+   * @param sampMap The input sample of every output pixel in the tile
+   */
+  void ProcessRubberSheet::GridMap(TileManager &otile, Transform &trans,
+                                   std::vector< std::vector<double> > &lineMap,
+                                   std::vector< std::vector<double> > &sampMap) {
+    int slineTile = otile.Line();
+    int ssampTile = otile.Sample();
+
+    // Output offsets of the grid nodes from the start of the tile
+    std::vector<int> nodes;
+    for (int offset = 0; offset < p_startQuadSize - 1; offset += m_gridSpacing) {
+      nodes.push_back(offset);
+    }
+    nodes.push_back(p_startQuadSize - 1);
+
+    int nodeCount = nodes.size();
+    std::vector< std::vector<double> > nodeLines(nodeCount, std::vector<double>(nodeCount));
+    std::vector< std::vector<double> > nodeSamps(nodeCount, std::vector<double>(nodeCount));
+    std::vector< std::vector<bool> > nodeGood(nodeCount, std::vector<bool>(nodeCount));
+
+    for (int i = 0; i < nodeCount; i++) {
+      for (int j = 0; j < nodeCount; j++) {
+        nodeGood[i][j] = trans.Xform(nodeSamps[i][j], nodeLines[i][j],
+                                     ssampTile + nodes[j], slineTile + nodes[i]);
+      }
+    }
+
+    for (int i = 0; i < nodeCount - 1; i++) {
+      // Cells own their first line and sample, the last cells own the tile edge
+      int sline = slineTile + nodes[i];
+      int eline = slineTile + nodes[i + 1] - ((i < nodeCount - 2) ? 1 : 0);
+      double cellLines = nodes[i + 1] - nodes[i];
+
+      for (int j = 0; j < nodeCount - 1; j++) {
+        int ssamp = ssampTile + nodes[j];
+        int esamp = ssampTile + nodes[j + 1] - ((j < nodeCount - 2) ? 1 : 0);
+        double cellSamps = nodes[j + 1] - nodes[j];
+
+        int goodCorners = nodeGood[i][j] + nodeGood[i][j + 1] +
+                          nodeGood[i + 1][j] + nodeGood[i + 1][j + 1];
+
+        // If all four corners are bad, walk the edges and center lines of the
+        // cell like ProcessQuad does before deciding it's all null
+        if (goodCorners == 0) {
+          int cellELine = slineTile + nodes[i + 1];
+          int cellESamp = ssampTile + nodes[j + 1];
+          int centerSample = (ssamp + cellESamp) / 2;
+          int centerLine = (sline + cellELine) / 2;
+
+          bool forced = p_forceSamp != Null && p_forceLine != Null &&
+                        p_forceSamp >= ssamp && p_forceSamp <= cellESamp &&
+                        p_forceLine >= sline && p_forceLine <= cellELine;
+
+          if (forced ||
+              TestLine(trans, ssamp, cellESamp, sline, sline, 4) ||
+              TestLine(trans, ssamp, cellESamp, cellELine, cellELine, 4) ||
+              TestLine(trans, ssamp, ssamp, sline, cellELine, 4) ||
+              TestLine(trans, cellESamp, cellESamp, sline, cellELine, 4) ||
+              TestLine(trans, centerSample, centerSample, sline, cellELine, 4) ||
+              TestLine(trans, ssamp, cellESamp, centerLine, centerLine, 4)) {
+            SlowGridCell(trans, sline, eline, ssamp, esamp, slineTile, ssampTile,
+                         lineMap, sampMap);
+          }
+          else {
+            for (int line = sline; line <= eline; line++) {
+              for (int samp = ssamp; samp <= esamp; samp++) {
+                lineMap[line - slineTile][samp - ssampTile] = NULL8;
+              }
+            }
+          }
+          continue;
+        }
+
+        if (goodCorners < 4) {
+          SlowGridCell(trans, sline, eline, ssamp, esamp, slineTile, ssampTile,
+                       lineMap, sampMap);
+          continue;
+        }
+
+        // Test the middle point of the cell to see if the grid is good enough
+        double midLine, midSamp;
+        if (!trans.Xform(midSamp, midLine,
+                         ssampTile + (nodes[j] + nodes[j + 1]) / 2.0,
+                         slineTile + (nodes[i] + nodes[i + 1]) / 2.0)) {
+          SlowGridCell(trans, sline, eline, ssamp, esamp, slineTile, ssampTile,
+                       lineMap, sampMap);
+          continue;
+        }
+
+        double gridMidLine = (nodeLines[i][j] + nodeLines[i][j + 1] +
+                              nodeLines[i + 1][j] + nodeLines[i + 1][j + 1]) / 4.0;
+        double gridMidSamp = (nodeSamps[i][j] + nodeSamps[i][j + 1] +
+                              nodeSamps[i + 1][j] + nodeSamps[i + 1][j + 1]) / 4.0;
+
+        if ((fabs(gridMidSamp - midSamp) > m_gridTolerance) ||
+            (fabs(gridMidLine - midLine) > m_gridTolerance)) {
+          SlowGridCell(trans, sline, eline, ssamp, esamp, slineTile, ssampTile,
+                       lineMap, sampMap);
+          continue;
+        }
+
+        // The grid is suitably accurate, interpolate the cell from its corners
+        for (int line = sline; line <= eline; line++) {
+          double v = (line - sline) / cellLines;
+          double leftLine = nodeLines[i][j] + v * (nodeLines[i + 1][j] - nodeLines[i][j]);
+          double rightLine = nodeLines[i][j + 1] +
+                             v * (nodeLines[i + 1][j + 1] - nodeLines[i][j + 1]);
+          double leftSamp = nodeSamps[i][j] + v * (nodeSamps[i + 1][j] - nodeSamps[i][j]);
+          double rightSamp = nodeSamps[i][j + 1] +
+                             v * (nodeSamps[i + 1][j + 1] - nodeSamps[i][j + 1]);
+
+          std::vector<double> &lineVect = lineMap[line - slineTile];
+          std::vector<double> &sampleVect = sampMap[line - slineTile];
+          for (int samp = ssamp; samp <= esamp; samp++) {
+            double u = (samp - ssamp) / cellSamps;
+            lineVect[samp - ssampTile] = leftLine + u * (rightLine - leftLine);
+            sampleVect[samp - ssampTile] = leftSamp + u * (rightSamp - leftSamp);
+          }
+        }
+      }
+    }
+  }
+
+
+  // Transform every output pixel of a grid cell
+  void ProcessRubberSheet::SlowGridCell(Transform &trans, int sline, int eline,
+                                        int ssamp, int esamp,
+                                        int slineTile, int ssampTile,
+                                        std::vector< std::vector<double> > &lineMap,
+                                        std::vector< std::vector<double> > &sampMap) {
+    double iline, isamp;
+
+    for (int oline = sline; oline <= eline; oline++) {
+      int lineIndex = oline - slineTile;
+      for (int osamp = ssamp; osamp <= esamp; osamp++) {
+        int sampIndex = osamp - ssampTile;
+        lineMap[lineIndex][sampIndex] = NULL8;
+        if (trans.Xform(isamp, iline, (double) osamp, (double) oline)) {
+          lineMap[lineIndex][sampIndex] = iline;
+          sampMap[lineIndex][sampIndex] = isamp;
+        }
+      }
+    }
+  }
+
+
   // Break input quad into four pieces
   void ProcessRubberSheet::SplitQuad(std::vector<Quad *> &quadTree) {
 
@@ -845,21 +1196,133 @@ namespace Isis {
         for (int samp = m_patchStartSample;
               samp <= InputCubes[0]->sampleCount();
               samp += m_patchSampleIncrement, p_progress->CheckStatus()) {
+          QList<Buffer *> obricks;
           transformPatch((double)samp, (double)(samp + m_patchSamples - 1),
                          (double)line, (double)(line + m_patchLines - 1),
-                         iportal, trans, interp);
+                         iportal, trans, interp, obricks);
+          writePatches(obricks);
         }
       }
     }
   }
 
 
+  /**
+   * Applies a Transform and an Interpolator to small patches using one thread
+   * per Transform. This produces the same output cube as
+   * processPatchTransform(Transform &, Interpolator &), but rows of input
+   * patches are transformed concurrently. Each thread owns one of the
+   * Transforms, a copy of the Interpolator and its own input Portal. The
+   * output patches are written to the output cube by the calling thread, in
+   * the same order the single threaded method writes them, because
+   * overlapping patches keep the valid DNs already in the output cube.
+   *
+   * If a band change function is registered, it is called from the calling
+   * thread before each band is processed.
+   *
+   * @param transforms Fully initialized Transform objects, one per thread.
+   *                   They must be able to run concurrently, so they can't
+   *                   share a Camera or any other state that changes when
+   *                   Xform is called. Transforms that evaluate a Camera
+   *                   hold NaifStatus::mutex() while they do.
+   *
+   * @param interp A fully initialized Interpolator object. Each thread uses a
+   *               copy of it.
+   *
+   * @throws IException::Programmer "You must give at least one Transform"
+   */
+  void ProcessRubberSheet::processPatchTransform(
+      const std::vector<Transform *> &transforms, Interpolator &interp) {
+    if (transforms.empty()) {
+      string m = "You must give at least one Transform";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+    else if (transforms.size() == 1) {
+      processPatchTransform(*transforms[0], interp);
+      return;
+    }
+
+    // Error checks ... there must be one input and one output
+    if (InputCubes.size() != 1) {
+      string m = "You must specify exactly one input cube";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+    else if (OutputCubes.size() != 1) {
+      string m = "You must specify exactly one output cube";
+      throw IException(IException::Programmer, m, _FILEINFO_);
+    }
+
+    int workerCount = transforms.size();
+
+    // Every thread gets its own portal and interpolator
+    std::vector<Portal *> iportals;
+    std::vector<Interpolator> interps(workerCount, interp);
+    for (int worker = 0; worker < workerCount; worker++) {
+      iportals.push_back(new Portal(interp.Samples(), interp.Lines(),
+                                    InputCubes[0]->pixelType(),
+                                    interp.HotSample(), interp.HotLine()));
+    }
+
+    // Setup the progress meter
+    int patchRows = 0;
+    for (int line = m_patchStartLine; line <= InputCubes[0]->lineCount();
+          line += m_patchLineIncrement) {
+      patchRows++;
+    }
+
+    int patchesPerRow = 0;
+    for (int samp = m_patchStartSample; samp <= InputCubes[0]->sampleCount();
+          samp += m_patchSampleIncrement) {
+      patchesPerRow++;
+    }
+
+    p_progress->SetMaximumSteps(InputCubes[0]->bandCount() * patchRows * patchesPerRow);
+    p_progress->CheckStatus();
+
+    try {
+      for (int band = 1; band <= InputCubes[0]->bandCount(); band++) {
+        if (p_bandChangeFunct != NULL) p_bandChangeFunct(band);
+
+        std::function<void(int, int, QList<Buffer *> &)> transformPatchRow =
+            [&](int worker, int unit, QList<Buffer *> &obricks) {
+          Portal &iportal = *iportals[worker];
+          iportal.SetPosition(1, 1, band);
+
+          int line = m_patchStartLine + unit * m_patchLineIncrement;
+          for (int samp = m_patchStartSample;
+                samp <= InputCubes[0]->sampleCount();
+                samp += m_patchSampleIncrement) {
+            transformPatch((double)samp, (double)(samp + m_patchSamples - 1),
+                           (double)line, (double)(line + m_patchLines - 1),
+                           iportal, *transforms[worker], interps[worker], obricks);
+          }
+        };
+
+        std::function<void(QList<Buffer *> &)> writePatchRow =
+            [this](QList<Buffer *> &obricks) {
+          writePatches(obricks);
+        };
+
+        RunThreaded(workerCount, patchRows, patchesPerRow,
+                    transformPatchRow, writePatchRow);
+      }
+    }
+    catch (IException &) {
+      qDeleteAll(iportals);
+      throw;
+    }
+
+    qDeleteAll(iportals);
+  }
+
+
   // Private method to process a small patch of the input cube
   void ProcessRubberSheet::transformPatch(double ssamp, double esamp,
                                           double sline, double eline,
                                           Portal &iportal,
                                           Transform &trans,
-                                          Interpolator &interp) {
+                                          Interpolator &interp,
+                                          QList<Buffer *> &obricks) {
     // Let's make sure our patch is contained in the input file
     // TODO:  Think about the image edges should I be adding 0.5
     if (esamp > InputCubes[0]->sampleCount()) {
@@ -919,7 +1382,7 @@ namespace Isis {
 
     // If at least one of the 4 input tile corners did NOT transform, split it
     if (isamps.size() < 4) {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, obricks);
       return;
     }
 
@@ -962,11 +1425,11 @@ namespace Isis {
      */
 
     if (osampMax - osampMin + 1.0 > OutputCubes[0]->sampleCount() * 0.50) {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, obricks);
       return;
     }
     if (olineMax - olineMin + 1.0 > OutputCubes[0]->lineCount() * 0.50) {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, obricks);
       return;
     }
 
@@ -992,18 +1455,18 @@ namespace Isis {
       ilineLSQ.Solve(LeastSquares::QRD);
     }
     catch (IException &e) {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, obricks);
       return;
     }
 
     // If the fit at any corner isn't good enough break it down
     for (int i=0; i<isamps.size(); i++) {
       if (fabs(isampLSQ.Residual(i)) > 0.5) {
-        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, obricks);
         return;
       }
       if (fabs(ilineLSQ.Residual(i)) > 0.5) {
-        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, obricks);
         return;
       }
     }
@@ -1026,12 +1489,12 @@ namespace Isis {
       double err = (csamp - isamp) * (csamp - isamp) +
                    (cline - iline) * (cline - iline);
       if (err > 0.25) {
-        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+        splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, obricks);
         return;
       }
     }
     else {
-      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp);
+      splitPatch(ssamp, esamp, sline, eline, iportal, trans, interp, obricks);
       return;
     }
 #endif
@@ -1047,11 +1510,10 @@ namespace Isis {
     // Now we can do our typical backwards geom. Loop over the output cube
     // coordinates and compute input cube coordinates for the corners of the current
     // buffer. The buffer is the same size as the current patch size.
-    Brick oBrick(*OutputCubes[0], osampMax-osampMin+1, olineMax-olineMin+1, 1);
-    oBrick.SetBasePosition(osampMin, olineMin, iportal.Band());
+    Brick *oBrick = new Brick(*OutputCubes[0], osampMax-osampMin+1, olineMax-olineMin+1, 1);
+    oBrick->SetBasePosition(osampMin, olineMin, iportal.Band());
 
     int brickIndex = 0;
-    bool foundNull = false;
     for (int oline = olineMin; oline <= olineMax; oline++) {
       double isamp = A * osampMin + B * oline + C;
       double iline = D * osampMin + E * oline + F;
@@ -1062,37 +1524,61 @@ namespace Isis {
         // Now read the data around the input coordinate and interpolate a DN
         iportal.SetPosition(isamp, iline, iportal.Band());
         InputCubes[0]->read(iportal);
-        double dn = interp.Interpolate(isamp, iline, iportal.DoubleBuffer());
-        oBrick[brickIndex] = dn;
-        if (dn == Null) foundNull = true;
+        (*oBrick)[brickIndex] = interp.Interpolate(isamp, iline, iportal.DoubleBuffer());
         brickIndex++;
       }
     }
 
-    // If there are any special pixel Null values in this output brick, we may be
-    // up against an edge of the input image where the interpolaters get Nulls from
-    // outside the image. Since the patches have some overlap due to finding the
-    // rectangular area (bounding box, min/max line/samp) of the four points input points
-    // projected into the output space, this causes valid DNs
-    // from a previously processed patch to be replaced with Null DNs from this patch.
-    // NOTE: A different method of accomplishing this fixing of Nulls was tested. We read
-    // the buffer from the output and tested each pixel values before overwriting it
-    // This resulted in a slighly slower run for the test. A concern was found in the
-    // asynchronous write of buffers to the cube, where a race condition may have generated
-    // different dns, not bad, but making testing more difficult.
-    if (foundNull) {
-      Brick readBrick(*OutputCubes[0], osampMax-osampMin+1, olineMax-olineMin+1, 1);
-      readBrick.SetBasePosition(osampMin, olineMin, iportal.Band());
-      OutputCubes[0]->read(readBrick);
-      for (brickIndex = 0; brickIndex<(osampMax-osampMin+1)*(olineMax-olineMin+1); brickIndex++) {
-        if (readBrick[brickIndex] != Null) {
-          oBrick[brickIndex] = readBrick[brickIndex];
+    // The filled buffer is written to the cube by writePatches
+    obricks.append(oBrick);
+  }
+
+
+  /**
+   * Write the output bricks of transformed patches to the output cube, in
+   * order, and delete them.
+   *
+   * If there are any special pixel Null values in an output brick, we may be
+   * up against an edge of the input image where the interpolaters get Nulls from
+   * outside the image. Since the patches have some overlap due to finding the
+   * rectangular area (bounding box, min/max line/samp) of the four points input points
+   * projected into the output space, this causes valid DNs
+   * from a previously processed patch to be replaced with Null DNs from this patch.
+   * NOTE: A different method of accomplishing this fixing of Nulls was tested. We read
+   * the buffer from the output and tested each pixel values before overwriting it
+   * This resulted in a slighly slower run for the test. A concern was found in the
+   * asynchronous write of buffers to the cube, where a race condition may have generated
+   * different dns, not bad, but making testing more difficult.
+   *
+   * @param obricks The output bricks from transformPatch
+   */
+  void ProcessRubberSheet::writePatches(QList<Buffer *> &obricks) {
+    for (int i = 0; i < obricks.size(); i++) {
+      Buffer &oBrick = *obricks[i];
+
+      bool foundNull = false;
+      for (int brickIndex = 0; brickIndex < oBrick.size() && !foundNull; brickIndex++) {
+        if (oBrick[brickIndex] == Null) foundNull = true;
+      }
+
+      if (foundNull) {
+        Brick readBrick(*OutputCubes[0], oBrick.SampleDimension(),
+                        oBrick.LineDimension(), 1);
+        readBrick.SetBasePosition(oBrick.Sample(), oBrick.Line(), oBrick.Band());
+        OutputCubes[0]->read(readBrick);
+        for (int brickIndex = 0; brickIndex < oBrick.size(); brickIndex++) {
+          if (readBrick[brickIndex] != Null) {
+            oBrick[brickIndex] = readBrick[brickIndex];
+          }
         }
       }
+
+      // Write filled buffer to cube
+      OutputCubes[0]->write(oBrick);
     }
 
-    // Write filled buffer to cube
-    OutputCubes[0]->write(oBrick);
+    qDeleteAll(obricks);
+    obricks.clear();
   }
 
 
@@ -1100,7 +1586,8 @@ namespace Isis {
   // process
   void ProcessRubberSheet::splitPatch(double ssamp, double esamp,
                                        double sline, double eline, Portal &iportal,
-                                       Transform &trans, Interpolator &interp) {
+                                       Transform &trans, Interpolator &interp,
+                                       QList<Buffer *> &obricks) {
 
     // Is the input patch too small to even worry about transforming?
     if ((esamp - ssamp < 0.1) && (eline - sline < 0.1)) return;
@@ -1111,19 +1598,233 @@ namespace Isis {
 
     transformPatch(ssamp, midSamp,
                    sline, midLine,
-                   iportal, trans, interp);
+                   iportal, trans, interp, obricks);
     transformPatch(midSamp, esamp,
                    sline, midLine,
-                   iportal, trans, interp);
+                   iportal, trans, interp, obricks);
     transformPatch(ssamp, midSamp,
                    midLine, eline,
-                   iportal, trans, interp);
+                   iportal, trans, interp, obricks);
     transformPatch(midSamp, esamp,
                    midLine, eline,
-                   iportal, trans, interp);
+                   iportal, trans, interp, obricks);
 
     return;
   }
 
 
+  /**
+   * Keeps the pieces of work that the threads of RunThreaded() transformed
+   * until the calling thread writes them, in order. Threads stop taking new
+   * pieces of work when they get too far ahead of the writes, so the output
+   * waiting to be written stays small.
+   */
+  class ProcessRubberSheet::OrderedOutput {
+    public:
+      /**
+       * @param unitCount The number of pieces of work
+       * @param maxPendingUnits The most pieces of work that can be taken, but
+       *                        not written yet
+       */
+      OrderedOutput(int unitCount, int maxPendingUnits) {
+        m_unitCount = unitCount;
+        m_maxPendingUnits = maxPendingUnits;
+        m_nextUnit = 0;
+        m_nextWrite = 0;
+        m_cancelled = false;
+      }
+
+
+      ~OrderedOutput() {
+        foreach (const QList<Buffer *> &buffers, m_finishedUnits) {
+          qDeleteAll(buffers);
+        }
+      }
+
+
+      /**
+       * Process pieces of work until there are none left to take. If
+       *   processing one fails, the error, of any type, is kept for
+       *   throwError() and every thread stops.
+       *
+       * @param worker The index of this thread
+       * @param processUnit Processes one piece of work into output buffers
+       */
+      void runWorker(int worker,
+          const std::function<void(int, int, QList<Buffer *> &)> &processUnit) {
+        while (true) {
+          int unit = 0;
+
+          {
+            QMutexLocker locker(&m_mutex);
+            while (!m_cancelled && m_nextUnit < m_unitCount &&
+                   m_nextUnit >= m_nextWrite + m_maxPendingUnits) {
+              m_writtenCondition.wait(&m_mutex);
+            }
+
+            if (m_cancelled || m_nextUnit >= m_unitCount) {
+              return;
+            }
+
+            unit = m_nextUnit++;
+          }
+
+          QList<Buffer *> buffers;
+          try {
+            processUnit(worker, unit, buffers);
+          }
+          catch (IException &) {
+            qDeleteAll(buffers);
+            cancel(std::current_exception());
+            return;
+          }
+          catch (std::exception &e) {
+            qDeleteAll(buffers);
+            cancel(std::make_exception_ptr(
+                IException(IException::Unknown, e.what(), _FILEINFO_)));
+            return;
+          }
+          catch (...) {
+            qDeleteAll(buffers);
+            cancel(std::current_exception());
+            return;
+          }
+
+          QMutexLocker locker(&m_mutex);
+          m_finishedUnits.insert(unit, buffers);
+          m_finishedCondition.wakeAll();
+        }
+      }
+
+
+      /**
+       * Wait for the next piece of work, in order, to be finished.
+       *
+       * @param buffers Filled with the output buffers of the piece of work.
+       *                The caller owns them.
+       * @return False if there is nothing left to write, or the work was
+       *         cancelled
+       */
+      bool nextUnit(QList<Buffer *> &buffers) {
+        QMutexLocker locker(&m_mutex);
+        while (!m_cancelled && m_nextWrite < m_unitCount &&
+               !m_finishedUnits.contains(m_nextWrite)) {
+          m_finishedCondition.wait(&m_mutex);
+        }
+
+        if (m_cancelled || m_nextWrite >= m_unitCount) {
+          return false;
+        }
+
+        buffers = m_finishedUnits.take(m_nextWrite);
+        m_nextWrite++;
+        m_writtenCondition.wakeAll();
+        return true;
+      }
+
+
+      /**
+       * Stop every thread from taking more work.
+       *
+       * @param error The reason the work stopped, or empty
+       */
+      void cancel(std::exception_ptr error = std::exception_ptr()) {
+        QMutexLocker locker(&m_mutex);
+        if (!m_error) {
+          m_error = error;
+        }
+
+        m_cancelled = true;
+        m_finishedCondition.wakeAll();
+        m_writtenCondition.wakeAll();
+      }
+
+
+      /**
+       * Rethrow the first error a thread ran into, if there was one.
+       */
+      void throwError() const {
+        if (m_error) {
+          std::rethrow_exception(m_error);
+        }
+      }
+
+    private:
+      int m_unitCount;       //!< The number of pieces of work
+      int m_maxPendingUnits; //!< The most taken but unwritten pieces of work
+      int m_nextUnit;        //!< The next piece of work to take
+      int m_nextWrite;       //!< The next piece of work to write
+      bool m_cancelled;      //!< True if the threads need to stop
+      std::exception_ptr m_error; //!< The first error a thread ran into
+
+      //! The output buffers of finished pieces of work, by piece of work
+      QMap<int, QList<Buffer *> > m_finishedUnits;
+
+      //! Protects everything above
+      QMutex m_mutex;
+      //! Signalled when a piece of work is finished
+      QWaitCondition m_finishedCondition;
+      //! Signalled when a piece of work is written
+      QWaitCondition m_writtenCondition;
+  };
+
+
+  /**
+   * Transform pieces of work concurrently and write them in order. One
+   * thread from the global thread pool is started per worker. The calling
+   * thread writes the output of every piece of work, in order, and reports
+   * progress.
+   *
+   * @param workerCount The number of threads to transform with
+   * @param unitCount The number of pieces of work
+   * @param stepsPerUnit The number of progress steps in a piece of work
+   * @param processUnit Transforms a piece of work (worker index, piece of
+   *                    work index) into new output buffers. This is called
+   *                    from the worker threads.
+   * @param writeUnit Writes the output buffers of a piece of work to the
+   *                  output cube. This is called from the calling thread.
+   */
+  void ProcessRubberSheet::RunThreaded(int workerCount, int unitCount, int stepsPerUnit,
+      const std::function<void(int, int, QList<Buffer *> &)> &processUnit,
+      const std::function<void(QList<Buffer *> &)> &writeUnit) {
+    OrderedOutput output(unitCount, 4 * workerCount);
+
+    QList< QFuture<void> > workers;
+    for (int worker = 0; worker < workerCount; worker++) {
+      workers.append(QtConcurrent::run([&output, &processUnit, worker]() {
+        output.runWorker(worker, processUnit);
+      }));
+    }
+
+    QList<Buffer *> buffers;
+    try {
+      while (output.nextUnit(buffers)) {
+        writeUnit(buffers);
+        qDeleteAll(buffers);
+        buffers.clear();
+
+        for (int step = 0; step < stepsPerUnit; step++) {
+          p_progress->CheckStatus();
+        }
+      }
+    }
+    catch (...) {
+      qDeleteAll(buffers);
+      output.cancel();
+
+      for (int worker = 0; worker < workers.size(); worker++) {
+        workers[worker].waitForFinished();
+      }
+
+      throw;
+    }
+
+    for (int worker = 0; worker < workers.size(); worker++) {
+      workers[worker].waitForFinished();
+    }
+
+    output.throwError();
+  }
+
+
 } // end namespace isis
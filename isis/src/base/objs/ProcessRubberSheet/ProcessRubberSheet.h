@@ -6,6 +6,11 @@ For more details about the LICENSE terms and the AUTHORS, you will
 find files of those names at the top level of this repository. **/
 
 /* SPDX-License-Identifier: CC0-1.0 */
+#include <functional>
+#include <vector>
+
+#include <QList>
+
 #include "Process.h"
 #include "Buffer.h"
 #include "Transform.h"
@@ -29,6 +34,14 @@ namespace Isis {
    * an Interpolator object. This class allows only one input cube and one
    * output cube.
    *
+   * Both processing methods can also be given one Transform per thread. The
+   * work is then split into independent pieces (output tiles, or rows of
+   * input patches) that the threads process concurrently, each with its own
+   * Transform, Interpolator and Portal. Transforms that wrap a Camera or a
+   * Projection must not share it with another Transform in the list. The
+   * calling thread writes the finished pieces in the same order as the single
+   * threaded methods, so the output cube is identical.
+   *
    * @ingroup HighLevelCubeIO
    *
    * @author 2002-10-22 Stuart Sides
@@ -112,9 +125,15 @@ namespace Isis {
       using Isis::Process::StartProcess;
       // Output driven processing method for one input and output cube
       virtual void StartProcess(Transform &trans, Interpolator &interp);
+      // Threaded output driven processing, one Transform per thread
+      virtual void StartProcess(const std::vector<Transform *> &transforms,
+                                Interpolator &interp);
 
       // Input driven processing method for one input and output cube
       virtual void processPatchTransform(Transform &trans, Interpolator &interp);
+      // Threaded input driven processing, one Transform per thread
+      virtual void processPatchTransform(
+          const std::vector<Transform *> &transforms, Interpolator &interp);
 
       // Register a function to be called when the band number changes
       virtual void BandChange(void (*funct)(const int band));
@@ -141,8 +160,11 @@ namespace Isis {
                                 int samples, int lines,
                                 int sampleIncrement, int lineIncrement);
 
+      virtual void setTransformGrid(int spacing, double tolerance = 0.5);
+
 
     private:
+      class OrderedOutput;
 
       /**
        * @author ????-??-?? Unknown
@@ -175,20 +197,38 @@ namespace Isis {
                     Transform &trans, Interpolator &interp);
       void QuadTree(TileManager &otile, Portal &iportal,
                     Transform &trans, Interpolator &interp,
-                    bool useLastTileMap);
+                    bool useLastTileMap,
+                    std::vector< std::vector<double> > &lineMap,
+                    std::vector< std::vector<double> > &sampMap);
 
       bool TestLine(Transform &trans, int ssamp, int esamp, int sline,
                     int eline, int increment);
 
+      void GridMap(TileManager &otile, Transform &trans,
+                   std::vector< std::vector<double> > &lineMap,
+                   std::vector< std::vector<double> > &sampMap);
+      void SlowGridCell(Transform &trans, int sline, int eline,
+                        int ssamp, int esamp, int slineTile, int ssampTile,
+                        std::vector< std::vector<double> > &lineMap,
+                        std::vector< std::vector<double> > &sampMap);
+
       void (*p_bandChangeFunct)(const int band);
 
       void transformPatch (double startingSample, double endingSample,
                            double startingLine, double endingLine,
-                           Portal &iportal, Transform &trans, Interpolator &interp);
+                           Portal &iportal, Transform &trans, Interpolator &interp,
+                           QList<Buffer *> &obricks);
 
       void splitPatch (double startingSample, double endingSample,
                        double startingLine, double endingLine,
-                       Portal &iportal, Transform &trans, Interpolator &interp);
+                       Portal &iportal, Transform &trans, Interpolator &interp,
+                       QList<Buffer *> &obricks);
+
+      void writePatches(QList<Buffer *> &obricks);
+
+      void RunThreaded(int workerCount, int unitCount, int stepsPerUnit,
+          const std::function<void(int, int, QList<Buffer *> &)> &processUnit,
+          const std::function<void(QList<Buffer *> &)> &writeUnit);
 #if 0
       void transformPatch (double startingSample, double endingSample,
                            double startingLine, double endingLine);
@@ -213,6 +253,9 @@ namespace Isis {
       int m_patchSampleIncrement;
       int m_patchLineIncrement;
 
+      int m_gridSpacing;      //!< Output pixels between transform grid nodes, 0 for no grid
+      double m_gridTolerance; //!< Largest grid error in input pixels
+
 #if 0
       Portal *m_iportal;
       Brick *m_obrick;
@@ -33,6 +33,8 @@ using json = nlohmann::json;
 #include "NaifStatus.h"
 #include "ShapeModel.h"
 #include "SpacecraftPosition.h"
+#include "SpiceCacheStore.h"
+#include "Table.h"
 #include "Target.h"
 #include "Blob.h"
 
@@ -679,6 +681,20 @@ namespace Isis {
     iTime avgTime((startTime.Et() + endTime.Et()) / 2.0);
     computeSolarLongitude(avgTime);
 
+    // Batch runs often evaluate the same kernels over the same times, so use
+    // the tables from an earlier evaluation if the cache store has them.
+    // Everything below skips what they load.
+    QString storeDirectory = SpiceCacheStore::preferredDirectory();
+    QString storeKey;
+    bool fromStore = false;
+    if (!storeDirectory.isEmpty() && m_usingNaif && !m_usingAle &&
+        !m_bodyRotation->IsCached() && !m_sunPosition->IsCached() &&
+        m_instrumentRotation->GetSource() == SpiceRotation::Spice &&
+        m_instrumentPosition->GetSource() == SpicePosition::Spice) {
+      storeKey = cacheStoreKey(startTime, endTime, cacheSize, tol);
+      fromStore = loadCacheStore(storeDirectory, storeKey);
+    }
+
     // Cache everything
     if (!m_bodyRotation->IsCached()) {
       int bodyRotationCacheSize = cacheSize;
@@ -714,6 +730,10 @@ namespace Isis {
           sunPositionCacheSize);
     }
 
+    if (!storeKey.isEmpty() && !fromStore) {
+      saveCacheStore(storeDirectory, storeKey);
+    }
+
     // Save the time and cache size
     *m_startTime = startTime;
     *m_endTime = endTime;
@@ -733,6 +753,149 @@ namespace Isis {
   }
 
 
+  /**
+   * Makes the SpiceCacheStore key of the tables createCache evaluates. It
+   * covers the loaded kernels and everything else that changes the tables.
+   *
+   * @param startTime Starting ephemeris time to cache
+   * @param endTime Ending ephemeris time to cache
+   * @param cacheSize Size of the cache
+   * @param tol Tolerance
+   *
+   * @return @b QString The store key
+   */
+  QString Spice::cacheStoreKey(iTime startTime, iTime endTime, int cacheSize,
+                               double tol) const {
+    QStringList kernels;
+    for (int i = 0; i < m_kernels->size(); i++) {
+      kernels.append(m_kernels->at(i));
+    }
+
+    QStringList parameters;
+    parameters << "Version 1"
+               << QString::number(*m_spkCode) << QString::number(*m_spkBodyCode)
+               << QString::number(*m_ckCode) << QString::number(*m_ikCode)
+               << QString::number(*m_bodyFrameCode) << QString::number(naifBodyCode())
+               << QString::number(startTime.Et(), 'g', 17)
+               << QString::number(endTime.Et(), 'g', 17)
+               << QString::number(*m_startTimePadding, 'g', 17)
+               << QString::number(*m_endTimePadding, 'g', 17)
+               << QString::number(cacheSize) << QString::number(tol, 'g', 17)
+               << QString::number(m_instrumentRotation->Frame())
+               << QString::number(m_bodyRotation->Frame())
+               << m_instrumentPosition->GetAberrationCorrection();
+
+    return SpiceCacheStore::key(kernels, parameters);
+  }
+
+
+  /**
+   * Loads the instrument pointing and position, body rotation and sun position
+   * caches from a SpiceCacheStore entry.
+   *
+   * @param directory The store directory
+   * @param key The entry's key
+   *
+   * @return @b bool False if the store doesn't have the entry or the entry
+   *                can't be loaded, in which case no cache has been changed
+   */
+  bool Spice::loadCacheStore(const QString &directory, const QString &key) {
+    QList<Table> tables = SpiceCacheStore(directory).read(key);
+    if (tables.size() != 4) {
+      return false;
+    }
+
+    // Load every table into scratch objects first, so that a bad entry is a
+    // miss instead of leaving some of the caches loaded
+    try {
+      QStringList names;
+      foreach (Table table, tables) {
+        if (table.Name() == "InstrumentPointing" || table.Name() == "BodyRotation") {
+          SpiceRotation(0).LoadCache(table);
+        }
+        else if (table.Name() == "InstrumentPosition" || table.Name() == "SunPosition") {
+          SpicePosition(0, 0).LoadCache(table);
+        }
+        else {
+          return false;
+        }
+        names.append(table.Name());
+      }
+
+      if (names.removeDuplicates() > 0) {
+        return false;
+      }
+    }
+    catch (IException &) {
+      return false;
+    }
+
+    foreach (Table table, tables) {
+      if (table.Name() == "InstrumentPointing") {
+        m_instrumentRotation->LoadCache(table);
+      }
+      else if (table.Name() == "InstrumentPosition") {
+        m_instrumentPosition->LoadCache(table);
+      }
+      else if (table.Name() == "BodyRotation") {
+        m_bodyRotation->LoadCache(table);
+      }
+      else if (table.Name() == "SunPosition") {
+        m_sunPosition->LoadCache(table);
+      }
+    }
+
+    return true;
+  }
+
+
+  /**
+   * Saves the caches createCache evaluated to a SpiceCacheStore entry, under
+   * the same names spiceinit gives them. Failing to save only costs later
+   * runs the time to evaluate them again, so it isn't an error.
+   *
+   * @param directory The store directory
+   * @param key The entry's key
+   */
+  void Spice::saveCacheStore(const QString &directory, const QString &key) {
+    try {
+      QList<Table> tables;
+      tables << m_bodyRotation->Cache("BodyRotation")
+             << m_instrumentRotation->Cache("InstrumentPointing")
+             << m_instrumentPosition->Cache("InstrumentPosition")
+             << m_sunPosition->Cache("SunPosition");
+
+      SpiceCacheStore(directory).write(key, tables);
+    }
+    catch (IException &) {
+    }
+  }
+
+
+  /**
+   * Choose how the instrument and sun positions and the instrument and body
+   * rotations find their cached values around a time.
+   *
+   * @param indexed Use the constant time indexed lookup instead of searching
+   *                the cache times
+   *
+   * @see SpicePosition::SetCacheLookup
+   * @see SpiceRotation::SetCacheLookup
+   */
+  void Spice::setIndexedCacheLookup(bool indexed) {
+    SpicePosition::CacheLookup positionLookup =
+        indexed ? SpicePosition::IndexedLookup : SpicePosition::SearchLookup;
+    SpiceRotation::CacheLookup rotationLookup =
+        indexed ? SpiceRotation::IndexedLookup : SpiceRotation::SearchLookup;
+
+    // CSM cameras don't have SPICE caches
+    if (m_instrumentPosition) m_instrumentPosition->SetCacheLookup(positionLookup);
+    if (m_sunPosition) m_sunPosition->SetCacheLookup(positionLookup);
+    if (m_instrumentRotation) m_instrumentRotation->SetCacheLookup(rotationLookup);
+    if (m_bodyRotation) m_bodyRotation->SetCacheLookup(rotationLookup);
+  }
+
+
   /**
    * Accessor method for the cache start time.
    * @return @b iTime Start time for the image.
@@ -307,6 +307,7 @@ namespace Isis {
                                const int size, double tol);
       virtual iTime cacheStartTime() const;
       virtual iTime cacheEndTime() const;
+      void setIndexedCacheLookup(bool indexed);
 
       virtual void subSpacecraftPoint(double &lat, double &lon);
       virtual void subSolarPoint(double &lat, double &lon);
@@ -393,6 +394,11 @@ namespace Isis {
 
       void load(PvlKeyword &key, bool notab);
 
+      QString cacheStoreKey(iTime startTime, iTime endTime, int cacheSize,
+                            double tol) const;
+      bool loadCacheStore(const QString &directory, const QString &key);
+      void saveCacheStore(const QString &directory, const QString &key);
+
       QVector<QString> * m_kernels; //!< Vector containing kernels filenames
 
       // cache stuff
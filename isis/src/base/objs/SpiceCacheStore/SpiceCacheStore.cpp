@@ -0,0 +1,245 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "SpiceCacheStore.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTemporaryDir>
+
+#include "FileName.h"
+#include "IException.h"
+#include "Preference.h"
+#include "PvlGroup.h"
+#include "Table.h"
+
+using namespace std;
+
+namespace Isis {
+  //! The most entries kept in memory
+  static const int maxMemoryEntries = 64;
+  //! Serializes access to the entries in memory
+  static QMutex memoryMutex;
+  //! The tables of the entries read or written by this process
+  static QHash<QString, QList<Table> > memoryEntries;
+  //! The keys of the entries in memory, oldest first
+  static QStringList memoryKeys;
+
+
+  /**
+   * Keeps an entry's tables in memory, dropping the oldest entry if there
+   * are too many.
+   *
+   * @param key The entry's key
+   * @param tables The entry's tables
+   */
+  static void remember(const QString &key, const QList<Table> &tables) {
+    QMutexLocker locker(&memoryMutex);
+    if (memoryEntries.contains(key)) {
+      return;
+    }
+
+    if (memoryKeys.size() >= maxMemoryEntries) {
+      memoryEntries.remove(memoryKeys.takeFirst());
+    }
+    memoryEntries.insert(key, tables);
+    memoryKeys.append(key);
+  }
+
+
+  /**
+   * Opens a store.
+   *
+   * @param directory The directory that holds the entries. It is created
+   *                  when the first entry is written.
+   */
+  SpiceCacheStore::SpiceCacheStore(const QString &directory) {
+    m_directory = FileName(directory).expanded();
+  }
+
+
+  //! Closes the store
+  SpiceCacheStore::~SpiceCacheStore() {
+  }
+
+
+  /**
+   * @return @b QString The store directory from the SpiceCacheDirectory
+   *                    keyword in the Performance preferences, or an empty
+   *                    string if the store is turned off
+   */
+  QString SpiceCacheStore::preferredDirectory() {
+    PvlGroup &performancePrefs =
+        Preference::Preferences().findGroup("Performance");
+    if (!performancePrefs.hasKeyword("SpiceCacheDirectory")) {
+      return "";
+    }
+
+    QString directory = performancePrefs["SpiceCacheDirectory"][0];
+    if (directory.isEmpty() || directory.toUpper() == "NONE") {
+      return "";
+    }
+
+    return FileName(directory).expanded();
+  }
+
+
+  /**
+   * Makes the key of an entry. Kernel files are identified by their path,
+   * size and modification time, so updating a kernel makes new entries.
+   *
+   * @param kernels The kernel files the tables are evaluated from
+   * @param parameters Everything else the tables depend on, such as NAIF
+   *                   codes, times and cache sizes
+   *
+   * @return @b QString The key, a hexadecimal SHA-1 hash
+   */
+  QString SpiceCacheStore::key(const QStringList &kernels, const QStringList &parameters) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    foreach (QString kernel, kernels) {
+      QFileInfo info(FileName(kernel).expanded());
+      hash.addData(info.absoluteFilePath().toUtf8());
+      hash.addData(QByteArray::number(info.size()));
+      hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+      hash.addData("\n");
+    }
+
+    foreach (QString parameter, parameters) {
+      hash.addData(parameter.toUtf8());
+      hash.addData("\n");
+    }
+
+    return QString(hash.result().toHex());
+  }
+
+
+  //! Forgets the entries kept in memory
+  void SpiceCacheStore::clearMemory() {
+    QMutexLocker locker(&memoryMutex);
+    memoryEntries.clear();
+    memoryKeys.clear();
+  }
+
+
+  /**
+   * @return @b QString The directory that holds the entries
+   */
+  QString SpiceCacheStore::directory() const {
+    return m_directory;
+  }
+
+
+  /**
+   * @param key The entry's key
+   *
+   * @return @b bool True if the entry is in memory or in the store directory
+   */
+  bool SpiceCacheStore::contains(const QString &key) const {
+    {
+      QMutexLocker locker(&memoryMutex);
+      if (memoryEntries.contains(key)) {
+        return true;
+      }
+    }
+
+    return QFileInfo(entryPath(key)).isDir();
+  }
+
+
+  /**
+   * Reads the tables of an entry.
+   *
+   * @param key The entry's key
+   *
+   * @return @b QList<Table> The entry's tables in name order, or an empty
+   *                         list if the store doesn't have the entry
+   */
+  QList<Table> SpiceCacheStore::read(const QString &key) const {
+    {
+      QMutexLocker locker(&memoryMutex);
+      if (memoryEntries.contains(key)) {
+        return memoryEntries.value(key);
+      }
+    }
+
+    QList<Table> tables;
+    QDir entry(entryPath(key));
+    if (!entry.exists()) {
+      return tables;
+    }
+
+    try {
+      QStringList files = entry.entryList(QStringList("*.tbl"), QDir::Files, QDir::Name);
+      foreach (QString file, files) {
+        tables.append(Table(QFileInfo(file).completeBaseName(), entry.filePath(file)));
+      }
+    }
+    catch (IException &) {
+      // Treat an entry that can't be read as missing, it is made again
+      tables.clear();
+      return tables;
+    }
+
+    remember(key, tables);
+    return tables;
+  }
+
+
+  /**
+   * Adds an entry to the store. If another process adds the same entry
+   * first, its entry is kept.
+   *
+   * @param key The entry's key
+   * @param tables The tables to save, each with a different name
+   *
+   * @throws IException::Io "Unable to create the SPICE cache directory"
+   */
+  void SpiceCacheStore::write(const QString &key, const QList<Table> &tables) {
+    remember(key, tables);
+
+    if (QFileInfo(entryPath(key)).isDir()) {
+      return;
+    }
+
+    if (!QDir().mkpath(m_directory)) {
+      QString msg = "Unable to create the SPICE cache directory [" + m_directory + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    QTemporaryDir temporaryEntry(m_directory + "/" + key + "-XXXXXX");
+    if (!temporaryEntry.isValid()) {
+      QString msg = "Unable to create a SPICE cache entry in [" + m_directory + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    foreach (Table table, tables) {
+      table.Write(temporaryEntry.path() + "/" + table.Name() + ".tbl");
+    }
+
+    // Renaming the directory is atomic, so readers see all of the tables or
+    // none of them
+    if (QDir().rename(temporaryEntry.path(), entryPath(key))) {
+      temporaryEntry.setAutoRemove(false);
+    }
+  }
+
+
+  /**
+   * @param key An entry's key
+   *
+   * @return @b QString The entry's directory
+   */
+  QString SpiceCacheStore::entryPath(const QString &key) const {
+    return m_directory + "/" + key;
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef SpiceCacheStore_h
+#define SpiceCacheStore_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace Isis {
+  class Table;
+
+  /**
+   * @brief Shares evaluated SPICE tables between cubes and processes
+   *
+   * Spice::createCache evaluates the kernels into the same InstrumentPointing,
+   * InstrumentPosition, BodyRotation and SunPosition tables that spiceinit
+   * attaches to cubes. When many cubes are processed with the same kernels
+   * and times, as in batch pipelines, this store saves those tables under a
+   * key made from the kernel files and the cache parameters, so later
+   * cameras load them instead of reading the SPK and CK files again.
+   *
+   * Each entry is a directory of table files named by its key. Entries are
+   * written to a temporary directory and renamed into place, so processes
+   * sharing the store never see a partial entry. The tables read in this
+   * process are also kept in memory.
+   *
+   * The store is turned on by the SpiceCacheDirectory keyword in the
+   * Performance preferences.
+   *
+   * @ingroup SpiceInstrumentsAndCameras
+   */
+  class SpiceCacheStore {
+    public:
+      SpiceCacheStore(const QString &directory);
+      ~SpiceCacheStore();
+
+      static QString preferredDirectory();
+      static QString key(const QStringList &kernels, const QStringList &parameters);
+      static void clearMemory();
+
+      QString directory() const;
+
+      bool contains(const QString &key) const;
+      QList<Table> read(const QString &key) const;
+      void write(const QString &key, const QList<Table> &tables);
+
+    private:
+      QString entryPath(const QString &key) const;
+
+      QString m_directory; //!< The directory that holds the entries
+  };
+}
+
+#endif
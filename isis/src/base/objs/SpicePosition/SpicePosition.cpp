@@ -112,6 +112,8 @@ namespace Isis {
     m_swapObserverTarget = swapObserverTarget;
     m_lt = 0.0;
     m_state = NULL;
+    m_timeTableSize = 0;
+    m_cacheLookup = SearchLookup;
 
     // Determine observer/target ordering
     if ( m_swapObserverTarget ) {
@@ -149,6 +151,8 @@ namespace Isis {
    */
   void SpicePosition::SetTimeBias(double timeBias) {
     p_timeBias = timeBias;
+    m_timeTable.clear();
+    m_timeIndex.clear();
   }
 
 /**
@@ -193,6 +197,8 @@ namespace Isis {
 
     if (validAbcorr.indexOf(abcorr) >= 0) {
       p_aberrationCorrection = abcorr;
+      m_timeTable.clear();
+      m_timeIndex.clear();
     }
     else {
       QString msg = "Invalid abberation correction [" + correction + "]";
@@ -256,6 +262,19 @@ namespace Isis {
 
     p_et = et;
 
+    // Times that were evaluated before come from the time table
+    if (m_timeTableSize > 0) {
+      QHash<double, TimeTableEntry>::const_iterator entry = m_timeTable.constFind(et);
+      if (entry != m_timeTable.constEnd()) {
+        for (int i = 0; i < 3; i++) {
+          p_coordinate[i] = entry->coordinate[i];
+          p_velocity[i] = entry->velocity[i];
+        }
+        m_lt = entry->lightTime;
+        return p_coordinate;
+      }
+    }
+
     // Read from the cache
     if(p_source == Memcache) {
       SetEphemerisTimeMemcache();
@@ -275,11 +294,60 @@ namespace Isis {
 
     NaifStatus::CheckErrors();
 
+    if (m_timeTable.size() < m_timeTableSize) {
+      TimeTableEntry &entry = m_timeTable[et];
+      for (int i = 0; i < 3; i++) {
+        entry.coordinate[i] = p_coordinate[i];
+        entry.velocity[i] = p_velocity[i];
+      }
+      entry.lightTime = m_lt;
+    }
+
     // Return the coordinate
     return p_coordinate;
   }
 
 
+  /**
+   * Keep the positions of up to size ephemeris times, so that evaluating one
+   *   of those times again doesn't interpolate the cache or read the kernels.
+   *   Times are added to the table as they are evaluated, until it is full.
+   *   This pays off when the same times are evaluated many times, like the
+   *   exposure times of the lines of a line scan image. The table is emptied
+   *   whenever the cache or the polynomials change.
+   *
+   * @param size The maximum number of times in the table, 0 to turn it off
+   */
+  void SpicePosition::SetTimeTableSize(int size) {
+    m_timeTableSize = std::max(size, 0);
+    m_timeTable.clear();
+  }
+
+
+  /**
+   * Choose how the Memcache and HermiteCache sources find the cached
+   *   positions around an ephemeris time. IndexedLookup finds them with a
+   *   uniform time index and interpolates them directly, which takes the same
+   *   few dozen operations no matter how big the cache is. The choice is saved
+   *   with the cache by Cache() and restored by LoadCache(Table &).
+   *
+   * @param lookup SearchLookup or IndexedLookup
+   */
+  void SpicePosition::SetCacheLookup(CacheLookup lookup) {
+    m_cacheLookup = lookup;
+    m_timeIndex.clear();
+    m_timeTable.clear();
+  }
+
+
+  /**
+   * @return @b SpicePosition::CacheLookup How the cache is searched
+   */
+  SpicePosition::CacheLookup SpicePosition::GetCacheLookup() const {
+    return m_cacheLookup;
+  }
+
+
   /** Cache J2000 position over a time range.
    *
    * This method will load an internal cache with coordinates over a time
@@ -335,6 +403,8 @@ namespace Isis {
 
     m_state = new ale::States(p_cacheTime, stateCache);
     p_source = Memcache;
+    m_timeTable.clear();
+    m_timeIndex.clear();
   }
 
 
@@ -401,6 +471,8 @@ namespace Isis {
     m_state = new ale::States(p_cacheTime, stateCache);
 
     p_source = Memcache;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     SetEphemerisTime(p_cacheTime[0]);
   }
 
@@ -447,6 +519,11 @@ namespace Isis {
 
 
     // set source type by table's label keyword
+    m_timeTable.clear();
+    m_timeIndex.clear();
+    if (table.Label().hasKeyword("CacheLookup")) {
+      m_cacheLookup = table.Label()["CacheLookup"][0] == "Indexed" ? IndexedLookup : SearchLookup;
+    }
     if(!table.Label().hasKeyword("CacheType")) {
       p_source = Memcache;
     }
@@ -670,6 +747,9 @@ namespace Isis {
     }
 
     table.Label() += PvlKeyword("CacheType", tabletype);
+    if (m_cacheLookup == IndexedLookup) {
+      table.Label() += PvlKeyword("CacheLookup", "Indexed");
+    }
 
     // Write original time coverage
     if(p_fullCacheStartTime != 0) {
@@ -740,6 +820,8 @@ namespace Isis {
 
     // Clear existing positions from thecache
     p_cacheTime.clear();
+    m_timeTable.clear();
+    m_timeIndex.clear();
 
     // Load the time cache first
     LoadTimeCache();
@@ -774,6 +856,8 @@ namespace Isis {
     // Set source to cache and reset current et
     p_source = Memcache;
     p_et = -DBL_MAX;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     SetEphemerisTime(et);
 
     NaifStatus::CheckErrors();
@@ -915,6 +999,8 @@ namespace Isis {
     p_source = HermiteCache;
     double et = p_et;
     p_et = -DBL_MAX;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     SetEphemerisTime(et);
 
     return Cache(tableName);
@@ -1083,6 +1169,8 @@ namespace Isis {
     // Update the current position
     double et = p_et;
     p_et = -DBL_MAX;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     SetEphemerisTime(et);
 
     return;
@@ -1148,6 +1236,8 @@ namespace Isis {
     p_overrideBaseTime = baseTime;
     p_overrideTimeScale = timeScale;
     p_override = BaseAndScale;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     return;
   }
 
@@ -1292,6 +1382,12 @@ namespace Isis {
    *            method)
    */
   void SpicePosition::SetEphemerisTimeMemcache() {
+    if (m_cacheLookup == IndexedLookup &&
+        (!m_timeIndex.isEmpty() || m_state->getTimes().size() > 1)) {
+      SetEphemerisTimeIndexed(false);
+      return;
+    }
+
     ale::State state;
     if (p_cacheTime.size() == 1) {
       state = m_state->getStates().front();
@@ -1322,7 +1418,10 @@ namespace Isis {
    *   @history 2009-08-03 Jeannie Walldren - Original version
    */
   void SpicePosition::SetEphemerisTimeHermiteCache() {
-    if (p_hasVelocity) {
+    if (p_hasVelocity && m_cacheLookup == IndexedLookup) {
+      SetEphemerisTimeIndexed(true);
+    }
+    else if (p_hasVelocity) {
       ale::State state = m_state->getState(p_et, ale::SPLINE);
 
       p_coordinate[0] = state.position.x;
@@ -1341,6 +1440,69 @@ namespace Isis {
 
 
 
+  /**
+   * Interpolates the cache with the IndexedLookup, linearly like the Memcache
+   * source or with a cubic Hermite spline through the positions and
+   * velocities like the HermiteCache source. The index and a flat copy of the
+   * cached states are made the first time they are needed.
+   *
+   * @param hermite Interpolate with the Hermite spline
+   */
+  void SpicePosition::SetEphemerisTimeIndexed(bool hermite) {
+    if (m_timeIndex.isEmpty()) {
+      m_timeIndex.build(m_state->getTimes());
+
+      std::vector<ale::State> states = m_state->getStates();
+      m_indexStates.resize(6 * states.size());
+      for (size_t i = 0; i < states.size(); i++) {
+        double *state = &m_indexStates[6 * i];
+        state[0] = states[i].position.x;
+        state[1] = states[i].position.y;
+        state[2] = states[i].position.z;
+        state[3] = states[i].velocity.x;
+        state[4] = states[i].velocity.y;
+        state[5] = states[i].velocity.z;
+      }
+    }
+
+    int i = m_timeIndex.interval(p_et);
+    double t0 = m_timeIndex.times()[i];
+    double h = m_timeIndex.times()[i + 1] - t0;
+    double s = (p_et - t0) / h;
+    const double *state0 = &m_indexStates[6 * i];
+    const double *state1 = state0 + 6;
+
+    if (!hermite) {
+      for (int k = 0; k < 3; k++) {
+        p_coordinate[k] = state0[k] + s * (state1[k] - state0[k]);
+        if (p_hasVelocity) {
+          p_velocity[k] = state0[k + 3] + s * (state1[k + 3] - state0[k + 3]);
+        }
+      }
+      return;
+    }
+
+    // Cubic Hermite basis functions and their derivatives
+    double s2 = s * s;
+    double s3 = s2 * s;
+    double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+    double h10 = s3 - 2.0 * s2 + s;
+    double h01 = 3.0 * s2 - 2.0 * s3;
+    double h11 = s3 - s2;
+    double d00 = (6.0 * s2 - 6.0 * s) / h;
+    double d10 = 3.0 * s2 - 4.0 * s + 1.0;
+    double d01 = -d00;
+    double d11 = 3.0 * s2 - 2.0 * s;
+
+    for (int k = 0; k < 3; k++) {
+      p_coordinate[k] = h00 * state0[k] + h10 * h * state0[k + 3] +
+                        h01 * state1[k] + h11 * h * state1[k + 3];
+      p_velocity[k] = d00 * state0[k] + d10 * state0[k + 3] +
+                      d01 * state1[k] + d11 * state1[k + 3];
+    }
+  }
+
+
   /**
    * This is a protected method that is called by
    * SetEphemerisTime() when Source type is PolyFunction.  It
@@ -1475,6 +1637,8 @@ namespace Isis {
     m_state = tempStates;
     p_cacheTime = m_state->getTimes();
     p_source = HermiteCache;
+    m_timeTable.clear();
+    m_timeIndex.clear();
   }
 
 
@@ -1488,6 +1652,8 @@ namespace Isis {
     }
 
     p_cacheTime.clear();
+    m_timeTable.clear();
+    m_timeIndex.clear();
   }
 
 
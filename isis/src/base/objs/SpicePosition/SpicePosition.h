@@ -9,10 +9,13 @@ find files of those names at the top level of this repository. **/
 #include <string>
 #include <vector>
 
+#include <QHash>
+
 #include <SpiceUsr.h>
 #include <SpiceZfc.h>
 #include <SpiceZmc.h>
 
+#include "CacheTimeIndex.h"
 #include "Table.h"
 #include "PolynomialUnivariate.h"
 
@@ -197,7 +200,18 @@ namespace Isis {
       virtual QString GetAberrationCorrection() const;
       double GetLightTime() const;
 
+      /**
+       * This enum indicates how the Memcache and HermiteCache sources find
+       * the cached positions around a time.
+       */
+      enum CacheLookup { SearchLookup, //!< Search the cache times
+                         IndexedLookup //!< Use a uniform time index, see CacheTimeIndex
+                       };
+
       const std::vector<double> &SetEphemerisTime(double et);
+      void SetTimeTableSize(int size);
+      void SetCacheLookup(CacheLookup lookup);
+      CacheLookup GetCacheLookup() const;
       enum PartialType {WRT_X, WRT_Y, WRT_Z};
 
       //! Return the current ephemeris time
@@ -291,6 +305,7 @@ namespace Isis {
     protected:
       void SetEphemerisTimeMemcache();
       void SetEphemerisTimeHermiteCache();
+      void SetEphemerisTimeIndexed(bool hermite);
       virtual void SetEphemerisTimeSpice();
       void SetEphemerisTimePolyFunction();
       void SetEphemerisTimePolyFunctionOverHermiteConstant();
@@ -351,6 +366,20 @@ namespace Isis {
       double m_lt;                 ///!<  Light time correction
 
       ale::States *m_state; ///!< State: stores times, positions, velocities;
+
+      //! The position at one ephemeris time in the time table
+      struct TimeTableEntry {
+        double coordinate[3]; //!< J2000 position
+        double velocity[3];   //!< J2000 velocity
+        double lightTime;     //!< Light time correction
+      };
+
+      QHash<double, TimeTableEntry> m_timeTable; //!< Positions of the times evaluated so far
+      int m_timeTableSize;                        //!< Maximum entries in m_timeTable, 0 if off
+
+      CacheLookup m_cacheLookup;         //!< How the cache is searched
+      CacheTimeIndex m_timeIndex;        //!< Index of the cache times for IndexedLookup
+      std::vector<double> m_indexStates; //!< Cached positions and velocities, 6 per time
   };
 };
 
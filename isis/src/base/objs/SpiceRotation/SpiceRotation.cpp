@@ -77,6 +77,8 @@ namespace Isis {
     m_frameType = UNKNOWN;
     m_tOrientationAvailable = false;
     m_orientation = NULL;
+    m_timeTableSize = 0;
+    m_cacheLookup = SearchLookup;
   }
 
 
@@ -117,6 +119,8 @@ namespace Isis {
     m_frameType = DYN;
     m_tOrientationAvailable = false;
     m_orientation = NULL;
+    m_timeTableSize = 0;
+    m_cacheLookup = SearchLookup;
 
     // Determine the axis for the velocity vector
     QString key = "INS" + toString(frameCode) + "_TRANSX";
@@ -184,6 +188,10 @@ namespace Isis {
     p_hasAngularVelocity = rotToCopy.p_hasAngularVelocity;
     m_frameType = rotToCopy.m_frameType;
 
+    m_timeTable = rotToCopy.m_timeTable;
+    m_timeTableSize = rotToCopy.m_timeTableSize;
+    m_cacheLookup = rotToCopy.m_cacheLookup;
+
     if (rotToCopy.m_orientation) {
       m_orientation = new ale::Orientations;
       *m_orientation = *rotToCopy.m_orientation; 
@@ -263,6 +271,16 @@ namespace Isis {
     if (p_et == et) return;
     p_et = et;
 
+    // Times that were evaluated before come from the time table
+    if (m_timeTableSize > 0) {
+      QHash<double, TimeTableEntry>::const_iterator entry = m_timeTable.constFind(et);
+      if (entry != m_timeTable.constEnd()) {
+        p_CJ.assign(entry->CJ, entry->CJ + 9);
+        p_av.assign(entry->av, entry->av + 3);
+        return;
+      }
+    }
+
     // Read from the cache
     if (p_source == Memcache) {
       setEphemerisTimeMemcache();
@@ -293,11 +311,55 @@ namespace Isis {
       setEphemerisTimeNadir();
     }
 
+    if (m_timeTable.size() < m_timeTableSize && p_CJ.size() == 9 && p_av.size() == 3) {
+      TimeTableEntry &entry = m_timeTable[et];
+      std::copy(p_CJ.begin(), p_CJ.end(), entry.CJ);
+      std::copy(p_av.begin(), p_av.end(), entry.av);
+    }
+
     // Set the quaternion for this rotation
 //    p_quaternion.Set ( p_CJ );
   }
 
 
+  /**
+   * Keep the rotations of up to size ephemeris times, so that evaluating one
+   *   of those times again doesn't interpolate the cache or read the kernels.
+   *   The table is filled as times are evaluated and emptied whenever the
+   *   cache, the polynomials or the source change.
+   *
+   * @param size The maximum number of times in the table, 0 to turn it off
+   */
+  void SpiceRotation::SetTimeTableSize(int size) {
+    m_timeTableSize = std::max(size, 0);
+    m_timeTable.clear();
+  }
+
+
+  /**
+   * Choose how the Memcache source finds the cached rotations around an
+   *   ephemeris time. IndexedLookup finds them with a uniform time index and
+   *   interpolates them directly, which takes the same few dozen operations no
+   *   matter how big the cache is. The choice is saved with the cache by
+   *   Cache() and restored by LoadCache(Table &).
+   *
+   * @param lookup SearchLookup or IndexedLookup
+   */
+  void SpiceRotation::SetCacheLookup(CacheLookup lookup) {
+    m_cacheLookup = lookup;
+    m_timeIndex.clear();
+    m_timeTable.clear();
+  }
+
+
+  /**
+   * @return @b SpiceRotation::CacheLookup How the cache is searched
+   */
+  SpiceRotation::CacheLookup SpiceRotation::GetCacheLookup() const {
+    return m_cacheLookup;
+  }
+
+
   /**
    * Accessor method to get current ephemeris time.
    *
@@ -416,6 +478,8 @@ namespace Isis {
     }
 
     p_source = Memcache;
+    m_timeTable.clear();
+    m_timeIndex.clear();
 
     // Downsize already loaded caches (both time and quats)
     if (p_minimizeCache == Yes  &&  cacheSize > 5) {
@@ -509,6 +573,8 @@ namespace Isis {
 
 
     p_source = Memcache;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     SetEphemerisTime(p_cacheTime[0]);
   }
 
@@ -580,6 +646,10 @@ namespace Isis {
       ident_c((SpiceDouble( *)[3]) &p_TC[0]);
     }
 
+    if (table.Label().hasKeyword("CacheLookup")) {
+      m_cacheLookup = table.Label()["CacheLookup"][0] == "Indexed" ? IndexedLookup : SearchLookup;
+    }
+
     // Load the full cache time information from the label if available
     if (table.Label().hasKeyword("CkTableStartTime")) {
       p_fullCacheStartTime = toDouble(table.Label().findKeyword("CkTableStartTime")[0]);
@@ -641,6 +711,8 @@ namespace Isis {
                                               ale::Rotation(1,0,0,0), p_constantFrames, p_timeFrames);
       }
       p_source = Memcache;
+      m_timeTable.clear();
+      m_timeIndex.clear();
     }
 
     // list table of quaternion, angular velocity vector, and time
@@ -681,6 +753,8 @@ namespace Isis {
                                               ale::Rotation(1,0,0,0), p_constantFrames, p_timeFrames);
       }
       p_source = Memcache;
+      m_timeTable.clear();
+      m_timeIndex.clear();
     }
 
     // coefficient table for angle1, angle2, and angle3
@@ -707,6 +781,8 @@ namespace Isis {
       SetOverrideBaseTime(baseTime, timeScale);
       SetPolynomial(coeffAng1, coeffAng2, coeffAng3);
       p_source = PolyFunction;
+      m_timeTable.clear();
+      m_timeIndex.clear();
       if (degree > 0)  p_hasAngularVelocity = true;
       if (degree == 0  && m_orientation->getAngularVelocities().size() > 0) {
         p_hasAngularVelocity = true;
@@ -732,6 +808,8 @@ namespace Isis {
     // Save current et
     double et = p_et;
     p_et = -DBL_MAX;
+    m_timeTable.clear();
+    m_timeIndex.clear();
 
     std::vector<ale::Rotation> rotationCache;
     std::vector<ale::Vec3d> avCache;
@@ -801,6 +879,8 @@ namespace Isis {
     // Make sure source is Memcache now
     p_source = Memcache;
     p_et = -DBL_MAX;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     SetEphemerisTime(et);
   }
 
@@ -1209,6 +1289,10 @@ namespace Isis {
       table.Label()["CkTableOriginalSize"].addValue(toString(p_fullCacheSize));
     }
 
+    if (m_cacheLookup == IndexedLookup) {
+      table.Label() += PvlKeyword("CacheLookup", "Indexed");
+    }
+
  // Begin section added 06-20-2015 DAC
     table.Label() += PvlKeyword("FrameTypeCode");
     table.Label()["FrameTypeCode"].addValue(toString(m_frameType));
@@ -1343,6 +1427,8 @@ namespace Isis {
 
     // Reset to get the new values
     p_et = -DBL_MAX;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     SetEphemerisTime(p_et);
   }
 
@@ -1911,6 +1997,8 @@ namespace Isis {
     // Update the current rotation
     double et = p_et;
     p_et = -DBL_MAX;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     SetEphemerisTime(et);
 
     NaifStatus::CheckErrors();
@@ -1992,6 +2080,8 @@ namespace Isis {
     p_degreeApplied = true;
     p_hasAngularVelocity = true;
     p_source = PckPolyFunction;
+    m_timeTable.clear();
+    m_timeIndex.clear();
    return;
   }
 
@@ -2401,6 +2491,8 @@ namespace Isis {
    */
   void SpiceRotation::SetSource(Source source) {
     p_source = source;
+    m_timeTable.clear();
+    m_timeIndex.clear();
     return;
   }
 
@@ -3267,6 +3359,9 @@ namespace Isis {
         p_av[2] = av.z;
       }
     }
+    else if (m_cacheLookup == IndexedLookup) {
+      setEphemerisTimeIndexed();
+    }
     // Otherwise determine the interval to interpolate
     else {
       p_CJ = m_orientation->interpolateTimeDep(p_et).toRotationMatrix();
@@ -3282,6 +3377,81 @@ namespace Isis {
   }
 
 
+  /**
+   * When setting the ephemeris time, interpolates the rotation cache with the
+   * IndexedLookup. The rotations are spherically interpolated between the
+   * quaternions of the two cached rotations around the time, and the angular
+   * velocities linearly. The index and the quaternions are made the first
+   * time they are needed.
+   *
+   * @see SpiceRotation::SetCacheLookup
+   */
+  void SpiceRotation::setEphemerisTimeIndexed() {
+    if (m_timeIndex.isEmpty()) {
+      m_timeIndex.build(p_cacheTime);
+
+      std::vector<ale::Rotation> rotations = m_orientation->getRotations();
+      m_indexQuaternions.resize(4 * rotations.size());
+      for (size_t i = 0; i < rotations.size(); i++) {
+        std::vector<double> matrix = rotations[i].toRotationMatrix();
+        m2q_c((SpiceDouble( *)[3]) &matrix[0], &m_indexQuaternions[4 * i]);
+      }
+
+      m_indexAv.clear();
+      if (p_hasAngularVelocity) {
+        std::vector<ale::Vec3d> avs = m_orientation->getAngularVelocities();
+        for (size_t i = 0; i < avs.size(); i++) {
+          m_indexAv.push_back(avs[i].x);
+          m_indexAv.push_back(avs[i].y);
+          m_indexAv.push_back(avs[i].z);
+        }
+      }
+    }
+
+    int i = m_timeIndex.interval(p_et);
+    double t0 = m_timeIndex.times()[i];
+    double s = (p_et - t0) / (m_timeIndex.times()[i + 1] - t0);
+    const double *q0 = &m_indexQuaternions[4 * i];
+    const double *q1 = q0 + 4;
+
+    // Take the shorter way around, and fall back to linear interpolation
+    // when the rotations are too close for the sine to be accurate
+    double cosAngle = q0[0] * q1[0] + q0[1] * q1[1] + q0[2] * q1[2] + q0[3] * q1[3];
+    double sign = cosAngle < 0.0 ? -1.0 : 1.0;
+    cosAngle = fabs(cosAngle);
+
+    double scale0 = 1.0 - s;
+    double scale1 = s;
+    if (cosAngle < 1.0 - 1.0e-12) {
+      double angle = acos(cosAngle);
+      double sinAngle = sin(angle);
+      scale0 = sin((1.0 - s) * angle) / sinAngle;
+      scale1 = sin(s * angle) / sinAngle;
+    }
+    scale1 *= sign;
+
+    SpiceDouble q[4];
+    for (int k = 0; k < 4; k++) {
+      q[k] = scale0 * q0[k] + scale1 * q1[k];
+    }
+    SpiceDouble norm = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    for (int k = 0; k < 4; k++) {
+      q[k] /= norm;
+    }
+
+    p_CJ.resize(9);
+    q2m_c(q, (SpiceDouble( *)[3]) &p_CJ[0]);
+
+    if (p_hasAngularVelocity && !m_indexAv.empty()) {
+      const double *av0 = &m_indexAv[3 * i];
+      const double *av1 = av0 + 3;
+      for (int k = 0; k < 3; k++) {
+        p_av[k] = av0[k] + s * (av1[k] - av0[k]);
+      }
+    }
+  }
+
+
   /**
    * When setting the ephemeris time, uses spacecraft nadir source to update the rotation state
    *
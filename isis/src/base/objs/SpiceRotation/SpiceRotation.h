@@ -9,10 +9,13 @@ find files of those names at the top level of this repository. **/
 #include <string>
 #include <vector>
 
+#include <QHash>
+
 #include <nlohmann/json.hpp>
 #include <ale/Orientations.h>
 
 #include "Angle.h"
+#include "CacheTimeIndex.h"
 #include "Table.h"
 #include "PolynomialUnivariate.h"
 #include "Quaternion.h"
@@ -284,6 +287,19 @@ namespace Isis {
 
       void SetEphemerisTime(double et);
       double EphemerisTime() const;
+      void SetTimeTableSize(int size);
+
+      /**
+       * This enumeration indicates how the Memcache source finds the cached
+       * rotations around a time.
+       */
+      enum CacheLookup {
+        SearchLookup, //!< Search the cache times
+        IndexedLookup //!< Use a uniform time index, see CacheTimeIndex
+      };
+
+      void SetCacheLookup(CacheLookup lookup);
+      CacheLookup GetCacheLookup() const;
 
       std::vector<double> GetCenterAngles();
 
@@ -417,6 +433,7 @@ namespace Isis {
     protected:
       void SetFullCacheParameters(double startTime, double endTime, int cacheSize);
       void setEphemerisTimeMemcache();
+      void setEphemerisTimeIndexed();
       void setEphemerisTimeNadir();
       void setEphemerisTimeSpice();
       void setEphemerisTimePolyFunction();
@@ -478,6 +495,20 @@ namespace Isis {
       std::vector<double> p_av;           //!< Angular velocity for rotation at time p_et
       bool p_hasAngularVelocity;          /**< Flag indicating whether the rotation
                                                includes angular velocity*/
+
+      //! The rotation at one ephemeris time in the time table
+      struct TimeTableEntry {
+        double CJ[9]; //!< Rotation matrix from J2000 to first constant rotation
+        double av[3]; //!< Angular velocity
+      };
+
+      QHash<double, TimeTableEntry> m_timeTable; //!< Rotations of the times evaluated so far
+      int m_timeTableSize;                        //!< Maximum entries in m_timeTable, 0 if off
+
+      CacheLookup m_cacheLookup;              //!< How the cache is searched
+      CacheTimeIndex m_timeIndex;             //!< Index of the cache times for IndexedLookup
+      std::vector<double> m_indexQuaternions; //!< Cached rotations as SPICE quaternions, 4 per time
+      std::vector<double> m_indexAv;          //!< Cached angular velocities, 3 per time
       std::vector<double> StateTJ();      /**< State matrix (6x6) for rotating state
                                                vectors from J2000 to target frame*/
       // The remaining items are only used for PCK frame types.  In this case the
@@ -242,6 +242,15 @@ namespace Isis {
     // Don't create the inverse correlation matrix file
     settings->setCreateInverseMatrix(false);
 
+    settings->setThreadedNormalEquations(ui.GetBoolean("THREADED"));
+
+    settings->setErrorPropagationMethod(
+        BundleSettings::stringToErrorPropagationMethod(ui.GetString("ERRORMETHOD")));
+
+    settings->setSolveMethod(BundleSettings::stringToSolveMethod(ui.GetString("SOLVEMETHOD")),
+                             ui.GetDouble("CGTOLERANCE"),
+                             ui.GetInteger("CGMAXITS"));
+
     settings->setOutlierRejection(ui.GetBoolean("OUTLIER_REJECTION"),
                                  ui.GetDouble("REJECTION_MULTIPLIER"));
 
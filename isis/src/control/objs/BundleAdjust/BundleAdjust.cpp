@@ -9,15 +9,23 @@ find files of those names at the top level of this repository. **/
 #include "BundleAdjust.h"
 
 // std lib
+#include <algorithm>
+#include <exception>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 // qt lib
 #include <QCoreApplication>
 #include <QDebug>
 #include <QFile>
+#include <QFuture>
+#include <QHash>
 #include <QMutex>
+#include <QMutexLocker>
+#include <QThreadPool>
+#include <QtConcurrentRun>
 
 // boost lib
 #include <boost/lexical_cast.hpp>
@@ -47,6 +55,7 @@ find files of those names at the top level of this repository. **/
 #include "Latitude.h"
 #include "Longitude.h"
 #include "MaximumLikelihoodWFunctions.h"
+#include "NaifStatus.h"
 #include "SpecialPixel.h"
 #include "StatCumProbDistDynCalc.h"
 #include "SurfacePoint.h"
@@ -369,7 +378,6 @@ namespace Isis {
    */
   void BundleAdjust::init(Progress *progress) {
     emit(statusUpdate("Initialization"));
-    m_previousNumberImagePartials = 0;
 
     // initialize
     //
@@ -400,7 +408,6 @@ namespace Isis {
     // m_cholmodCommon, m_sparseNormals are not initialized
     m_L = NULL;
     m_cholmodNormal = NULL;
-    m_cholmodTriplet = NULL;
 
     // should we initialize objects m_xResiduals, m_yResiduals, m_xyResiduals
 
@@ -582,8 +589,6 @@ namespace Isis {
       return false;
     }
 
-    m_cholmodTriplet = NULL;
-
     cholmod_start(&m_cholmodCommon);
 
     // set user-defined cholmod error handler
@@ -644,14 +649,13 @@ namespace Isis {
   /**
    * @brief Free CHOLMOD library variables.
    *
-   * Frees m_cholmodTriplet, m_cholmodNormal, and m_L.
+   * Frees m_cholmodNormal and m_L.
    * Calls cholmod_finish when complete.
    *
    * @return @b bool If the CHOLMOD library successfully cleaned up.
    */
   bool BundleAdjust::freeCHOLMODLibraryVariables() {
 
-    cholmod_free_triplet(&m_cholmodTriplet, &m_cholmodCommon);
     cholmod_free_sparse(&m_cholmodNormal, &m_cholmodCommon);
     cholmod_free_factor(&m_L, &m_cholmodCommon);
 
@@ -703,6 +707,13 @@ namespace Isis {
     emit(statusBarUpdate("Solving"));
     try {
 
+      if (m_bundleSettings->errorPropagation() &&
+          m_bundleSettings->solveMethod() == BundleSettings::ConjugateGradient) {
+        QString msg = "Error propagation needs the Cholesky factorization of the normal "
+                      "equations, so it can not be used with the conjugate gradient solve method.";
+        throw IException(IException::User, msg, _FILEINFO_);
+      }
+
       // throw error if a frame camera is included AND
       // if m_bundleSettings->solveInstrumentPositionOverHermiteSpline()
       // is set to true (can only use for line scan or radar)
@@ -939,9 +950,9 @@ namespace Isis {
         // TODO: is this necessary ???
         // probably all ready initialized to 101 nodes in bundle settings constructor...
 
-        // if we're using CHOLMOD and still going, release cholmod_factor
-        // (if we don't, memory leaks will occur), otherwise we need it for error propagation
-        if (!m_bundleResults.converged() || !m_bundleSettings->errorPropagation()) {
+        // the cholmod_factor is refactored in place next iteration and used by error
+        // propagation, so only release it once it isn't needed
+        if (m_bundleResults.converged() && !m_bundleSettings->errorPropagation()) {
           cholmod_free_factor(&m_L, &m_cholmodCommon);
         }
 
@@ -1017,12 +1028,15 @@ namespace Isis {
    * Form the least-squares normal equations matrix via cholmod.
    * Each BundleControlPoint will stores its Q matrix and NIC vector once finished.
    * The covariance matrix for each point will be stored in its adjusted surface point.
+   * If the settings ask for threaded normal equations, formNormalEquationsThreaded
+   * forms them instead.
    *
    * @return @b bool
    *
    * @see BundleAdjust::formMeasureNormals
    * @see BundleAdjust::formPointNormals
    * @see BundleAdjust::formWeightedNormals
+   * @see BundleAdjust::formNormalEquationsThreaded
    */
   bool BundleAdjust::formNormalEquations() {
     emit(statusBarUpdate("Forming Normal Equations"));
@@ -1031,6 +1045,11 @@ namespace Isis {
     m_bundleResults.setNumberObservations(0);// ???
     m_bundleResults.resetNumberConstrainedPointParameters();//???
 
+    int workerCount = QThreadPool::globalInstance()->maxThreadCount();
+    if (m_bundleSettings->threadedNormalEquations() && workerCount > 1) {
+      return formNormalEquationsThreaded(workerCount);
+    }
+
     // Initialize auxilary matrices and vectors.
     static LinearAlgebra::Matrix coeffTarget;
     static LinearAlgebra::Matrix coeffImage;
@@ -1134,6 +1153,381 @@ namespace Isis {
 }
 
 
+  /**
+   * Form the normal equations with several threads. The points are taken a
+   * chunk at a time:
+   *
+   * 1. The partials of the chunk's measures are computed. Every camera is given
+   *    to one thread, since a camera keeps the state of the last point it was set to.
+   *    The cameras call NAIF, so each partial is computed under NaifStatus::mutex().
+   * 2. The observations are added to the bundle results in order.
+   * 3. The Q matrix and NIC vector of each point are formed, with the points
+   *    divided between the threads.
+   * 4. The point and measure normals are accumulated into the normal equations.
+   *    Every block column is owned by one thread, which accumulates into it in
+   *    point order.
+   *
+   * Every sum is made in the same order as it is by a single thread, so the normal
+   * equations are the same.
+   *
+   * @param workerCount The number of threads to use
+   *
+   * @return @b bool
+   *
+   * @see BundleAdjust::formNormalEquations
+   */
+  bool BundleAdjust::formNormalEquationsThreaded(int workerCount) {
+    bool status = false;
+
+    int numTargetBodyParameters = 0;
+    if (m_bundleSettings->solveTargetBody()) {
+      numTargetBodyParameters = m_bundleSettings->numberTargetBodyParameters();
+    }
+
+    // The threads write to different elements of n1, so it can't be compressed here
+    LinearAlgebra::Vector n1(m_rank);
+    n1.clear();
+
+    m_RHS.resize(m_rank);
+    m_RHS.clear();
+
+    int numGood3DPoints = 0;
+    int num3DPoints = m_bundleControlPoints.size();
+    int chunkSize = 1024 * workerCount;
+
+    QVector<MeasurePartials> partials;
+    QVector<PointNormals> pointNormals(std::min(chunkSize, num3DPoints));
+    QVector<int> firstPartials(pointNormals.size() + 1);
+    QVector<int> numConstrained(workerCount, 0);
+
+    outputBundleStatus("\n\n");
+
+    for (int chunkStart = 0; chunkStart < num3DPoints; chunkStart += chunkSize) {
+      int chunkEnd = std::min(num3DPoints, chunkStart + chunkSize);
+      emit(pointUpdate(chunkEnd));
+
+      // List the measures, giving each camera to the thread with the fewest measures so far
+      QHash<Camera *, int> cameraWorkers;
+      QVector< QVector<int> > workerPartials(workerCount);
+      int numPartials = 0;
+      for (int i = chunkStart; i < chunkEnd; i++) {
+        BundleControlPointQsp point = m_bundleControlPoints.at(i);
+        firstPartials[i - chunkStart] = numPartials;
+
+        if (point->isRejected()) {
+          continue;
+        }
+
+        numGood3DPoints++;
+
+        for (int j = 0; j < point->size(); j++) {
+          BundleMeasureQsp measure = point->at(j);
+          if (measure->isRejected()) {
+            continue;
+          }
+
+          if (numPartials == partials.size()) {
+            partials.resize(numPartials + 1);
+          }
+          partials[numPartials].point = point.data();
+          partials[numPartials].measure = measure.data();
+
+          int worker = cameraWorkers.value(measure->camera(), -1);
+          if (worker < 0) {
+            worker = 0;
+            for (int w = 1; w < workerCount; w++) {
+              if (workerPartials[w].size() < workerPartials[worker].size()) {
+                worker = w;
+              }
+            }
+            cameraWorkers.insert(measure->camera(), worker);
+          }
+          workerPartials[worker].append(numPartials);
+
+          numPartials++;
+        }
+      }
+      firstPartials[chunkEnd - chunkStart] = numPartials;
+
+      MeasurePartials *partialsData = partials.data();
+      PointNormals *pointNormalsData = pointNormals.data();
+
+      // Each camera is only evaluated by one thread, but the cameras all call NAIF
+      // routines, which are not thread safe, so the partials are computed one at a
+      // time. The other threads set up their matrices meanwhile.
+      runWorkers(workerCount, [this, &workerPartials, partialsData, numTargetBodyParameters]
+                              (int worker) {
+        const QVector<int> &indices = workerPartials[worker];
+        for (int i = 0; i < indices.size(); i++) {
+          MeasurePartials &measurePartials = partialsData[indices[i]];
+          if ((int)measurePartials.coeffTarget.size2() != numTargetBodyParameters) {
+            measurePartials.coeffTarget.resize(2, numTargetBodyParameters);
+          }
+          if (measurePartials.coeffPoint3D.size2() != 3) {
+            measurePartials.coeffPoint3D.resize(2, 3);
+            measurePartials.coeffRHS.resize(2);
+          }
+
+          QMutexLocker locker(NaifStatus::mutex());
+          computePartials(measurePartials.coeffTarget, measurePartials.coeffImage,
+                          measurePartials.coeffPoint3D, measurePartials.coeffRHS,
+                          *measurePartials.measure, *measurePartials.point, &measurePartials);
+        }
+      });
+
+      for (int i = 0; i < numPartials; i++) {
+        m_bundleResults.setNumberObservations(m_bundleResults.numberObservations() + 2);
+        m_bundleResults.addResidualsProbabilityDistributionObservation(partialsData[i].residualX);
+        m_bundleResults.addResidualsProbabilityDistributionObservation(partialsData[i].residualY);
+        if (!IsSpecial(partialsData[i].residualR2ZScore)) {
+          m_bundleResults.addProbabilityDistributionObservation(partialsData[i].residualR2ZScore);
+        }
+        status = true;
+      }
+
+      runWorkers(workerCount, [this, &firstPartials, &numConstrained, partialsData,
+                               pointNormalsData, chunkStart, chunkEnd, workerCount]
+                              (int worker) {
+        int chunkPoints = chunkEnd - chunkStart;
+        boost::numeric::ublas::symmetric_matrix<double, upper> N22(3);
+
+        for (int i = chunkPoints * worker / workerCount;
+             i < chunkPoints * (worker + 1) / workerCount; i++) {
+          BundleControlPointQsp point = m_bundleControlPoints.at(chunkStart + i);
+          if (point->isRejected()) {
+            continue;
+          }
+
+          PointNormals &normals = pointNormalsData[i];
+          N22.clear();
+          normals.N12.wipe();
+          normals.n2.resize(3);
+          normals.n2.clear();
+
+          for (int j = firstPartials[i]; j < firstPartials[i + 1]; j++) {
+            formMeasurePointNormals(N22, normals.N12, normals.n2, partialsData[j]);
+          }
+
+          numConstrained[worker] += formPointQMatrix(N22, normals.N12, normals.n2, *point);
+        }
+      });
+
+      runWorkers(workerCount, [this, &firstPartials, &n1, partialsData, pointNormalsData,
+                               chunkStart, chunkEnd, workerCount](int worker) {
+        for (int i = 0; i < chunkEnd - chunkStart; i++) {
+          BundleControlPointQsp point = m_bundleControlPoints.at(chunkStart + i);
+          if (point->isRejected()) {
+            continue;
+          }
+
+          for (int j = firstPartials[i]; j < firstPartials[i + 1]; j++) {
+            accumulateMeasureNormals(partialsData[j], n1, worker, workerCount);
+          }
+
+          accumulatePointNormals(pointNormalsData[i], point->cholmodQMatrix(),
+                                 worker, workerCount);
+        }
+      });
+    }
+
+    for (int worker = 0; worker < workerCount; worker++) {
+      m_bundleResults.incrementNumberConstrainedPointParameters(numConstrained[worker]);
+    }
+
+    // finally, form the reduced normal equations
+    boost::numeric::ublas::compressed_vector<double> compressedN1(n1);
+    formWeightedNormals(compressedN1, m_RHS);
+
+    // update number of unknown parameters
+    m_bundleResults.setNumberUnknownParameters(m_rank + 3 * numGood3DPoints);
+
+    return status;
+  }
+
+
+  /**
+   * Form the parts of a measure's auxilary normal equation matrices that belong
+   * to its control point: N22, N12 and n2. These are the same as from
+   * formMeasureNormals.
+   *
+   * @param N22 The normal equation matrix for the point on the body.
+   * @param N12 The normal equation matrix for the camera and the target body.
+   * @param n2 The right hand side vector for the point on the body.
+   * @param partials The measure's partials from computePartials.
+   *
+   * @see BundleAdjust::formNormalEquationsThreaded
+   */
+  void BundleAdjust::formMeasurePointNormals(symmetric_matrix<double, upper> &N22,
+                                             SparseBlockColumnMatrix &N12,
+                                             vector<double> &n2,
+                                             const MeasurePartials &partials) {
+    int blockIndex = partials.measure->observationIndex();
+
+    if (m_bundleSettings->solveTargetBody()) {
+      blockIndex++;
+
+      int numTargetPartials = partials.coeffTarget.size2();
+      N12.insertMatrixBlock(0, numTargetPartials, 3);
+      *N12[0] += prod(trans(partials.coeffTarget), partials.coeffPoint3D);
+    }
+
+    N12.insertMatrixBlock(blockIndex, partials.coeffImage.size2(), 3);
+    *N12[blockIndex] += prod(trans(partials.coeffImage), partials.coeffPoint3D);
+
+    N22 += prod(trans(partials.coeffPoint3D), partials.coeffPoint3D);
+    n2 += prod(trans(partials.coeffPoint3D), partials.coeffRHS);
+  }
+
+
+  /**
+   * Accumulate a measure's normals, N11 and n1, into the block columns that a thread owns.
+   * These are the same as from formMeasureNormals.
+   *
+   * @param partials The measure's partials from computePartials.
+   * @param n1 The right hand side vector for the camera and the target body.
+   * @param worker The thread, which owns every workerCount block column starting at this one.
+   * @param workerCount The number of threads.
+   *
+   * @see BundleAdjust::formNormalEquationsThreaded
+   */
+  void BundleAdjust::accumulateMeasureNormals(const MeasurePartials &partials,
+                                              vector<double> &n1,
+                                              int worker,
+                                              int workerCount) {
+    int blockIndex = partials.measure->observationIndex();
+    int numImagePartials = partials.coeffImage.size2();
+
+    if (m_bundleSettings->solveTargetBody()) {
+      blockIndex++;
+
+      int numTargetPartials = partials.coeffTarget.size2();
+      if (worker == 0) {
+        SparseBlockColumnMatrix *targetColumn = m_sparseNormals.at(0);
+        targetColumn->insertMatrixBlock(0, numTargetPartials, numTargetPartials);
+        *(*targetColumn)[0] += prod(trans(partials.coeffTarget), partials.coeffTarget);
+
+        LinearAlgebra::Vector n1Target = prod(trans(partials.coeffTarget), partials.coeffRHS);
+        for (int i = 0; i < numTargetPartials; i++) {
+          n1(i) += n1Target(i);
+        }
+      }
+
+      if (blockIndex % workerCount == worker) {
+        SparseBlockColumnMatrix *imageColumn = m_sparseNormals.at(blockIndex);
+        imageColumn->insertMatrixBlock(0, numTargetPartials, numImagePartials);
+        *(*imageColumn)[0] += prod(trans(partials.coeffTarget), partials.coeffImage);
+      }
+    }
+
+    if (blockIndex % workerCount != worker) {
+      return;
+    }
+
+    SparseBlockColumnMatrix *imageColumn = m_sparseNormals.at(blockIndex);
+    imageColumn->insertMatrixBlock(blockIndex, numImagePartials, numImagePartials);
+    *(*imageColumn)[blockIndex] += prod(trans(partials.coeffImage), partials.coeffImage);
+
+    int t = imageColumn->startColumn();
+    LinearAlgebra::Vector n1Image = prod(trans(partials.coeffImage), partials.coeffRHS);
+    for (int i = 0; i < numImagePartials; i++) {
+      n1(i + t) += n1Image(i);
+    }
+  }
+
+
+  /**
+   * Accumulate a point's -R = -N12 x Q and -nj into the block columns that a thread owns.
+   * These are the same as from formPointNormals.
+   *
+   * @param normals The point's N12 and n2.
+   * @param Q The point's Q matrix.
+   * @param worker The thread, which owns every workerCount block column starting at this one.
+   * @param workerCount The number of threads.
+   *
+   * @see BundleAdjust::formNormalEquationsThreaded
+   */
+  void BundleAdjust::accumulatePointNormals(PointNormals &normals,
+                                            SparseBlockRowMatrix &Q,
+                                            int worker,
+                                            int workerCount) {
+    QMapIterator<int, LinearAlgebra::Matrix*> Qit(Q);
+    while ( Qit.hasNext() ) {
+      Qit.next();
+
+      int columnIndex = Qit.key();
+      if (columnIndex % workerCount != worker) {
+        continue;
+      }
+
+      LinearAlgebra::Matrix *Qblock = Qit.value();
+      SparseBlockColumnMatrix *column = m_sparseNormals.at(columnIndex);
+
+      QMapIterator<int, LinearAlgebra::Matrix*> N12it(normals.N12);
+      while ( N12it.hasNext() ) {
+        N12it.next();
+
+        int rowIndex = N12it.key();
+        if ( rowIndex > columnIndex ) {
+          continue;
+        }
+
+        LinearAlgebra::Matrix *N12block = N12it.value();
+
+        column->insertMatrixBlock(rowIndex, N12block->size1(), Qblock->size2());
+        *(*column)[rowIndex] -= prod(*N12block, *Qblock);
+      }
+
+      LinearAlgebra::Vector blockProduct = prod(trans(*Qblock), normals.n2);
+      int numParams = column->startColumn();
+      for (unsigned i = 0; i < blockProduct.size(); i++) {
+        m_RHS(numParams+i) += -1.0*blockProduct(i);
+      }
+    }
+  }
+
+
+  /**
+   * Runs work on several threads and waits for it to finish. The first thread is
+   * the calling thread, the others come from the global thread pool.
+   *
+   * @param workerCount The number of threads
+   * @param work Does the work of a thread, given its index
+   *
+   * @throws IException The first error from the threads' work, in thread order. Errors
+   *                    of other types are rethrown as they are.
+   */
+  void BundleAdjust::runWorkers(int workerCount, const std::function<void(int)> &work) {
+    QVector<std::exception_ptr> errors(workerCount);
+
+    auto runWorker = [&work, &errors](int worker) {
+      try {
+        work(worker);
+      }
+      catch (...) {
+        errors[worker] = std::current_exception();
+      }
+    };
+
+    QList< QFuture<void> > workers;
+    for (int worker = 1; worker < workerCount; worker++) {
+      workers.append(QtConcurrent::run(runWorker, worker));
+    }
+    runWorker(0);
+
+    // The work uses the caller's state, so every thread has to finish before
+    // an error is passed on
+    for (int i = 0; i < workers.size(); i++) {
+      workers[i].waitForFinished();
+    }
+
+    for (int worker = 0; worker < workerCount; worker++) {
+      if (errors[worker]) {
+        std::rethrow_exception(errors[worker]);
+      }
+    }
+  }
+
+
   /**
    * Form the auxilary normal equation matrices for a measure.
    * N22, N12, n1, and n2 will contain the auxilary matrices when completed.
@@ -1295,44 +1689,80 @@ namespace Isis {
                                       vector<double> &nj,
                                       BundleControlPointQsp &bundleControlPoint) {
 
-    boost::numeric::ublas::bounded_vector<double, 3> &NIC = bundleControlPoint->nicVector();
     SparseBlockRowMatrix &Q = bundleControlPoint->cholmodQMatrix();
 
+    int numConstrained = formPointQMatrix(N22, N12, n2, *bundleControlPoint);
+    m_bundleResults.incrementNumberConstrainedPointParameters(numConstrained);
+
+    // accumulate -R directly into reduced normal equations
+    productAB(N12, Q);
+
+    // accumulate -nj
+    accumProductAlphaAB(-1.0, Q, n2, nj);
+
+    return true;
+  }
+
+
+  /**
+   * Compute the Q matrix and NIC vector for a control point and store them in the
+   * BundleControlPoint, along with the point's covariance. This only changes the point, so
+   * several threads can do this for different points at once.
+   *
+   * @param N22 The normal equation matrix for the point on the body. Inverted when done.
+   * @param N12 The normal equation matrix for the camera and the target body.
+   * @param n2 The right hand side vector for the point on the body.
+   * @param bundleControlPoint The control point that the Q matrix and NIC vector
+   *                           are being formed for.
+   *
+   * @return @b int The number of constrained point parameters.
+   *
+   * @see BundleAdjust::formPointNormals
+   */
+  int BundleAdjust::formPointQMatrix(symmetric_matrix<double, upper>&N22,
+                                     SparseBlockColumnMatrix &N12,
+                                     vector<double> &n2,
+                                     BundleControlPoint &bundleControlPoint) {
+
+    boost::numeric::ublas::bounded_vector<double, 3> &NIC = bundleControlPoint.nicVector();
+    SparseBlockRowMatrix &Q = bundleControlPoint.cholmodQMatrix();
+    int numConstrained = 0;
+
     NIC.clear();
     Q.zeroBlocks();
 
     // weighting of 3D point parameters
     // Make sure weights are in the units corresponding to the bundle coordinate type
     boost::numeric::ublas::bounded_vector<double, 3> &weights
-        = bundleControlPoint->weights();
+        = bundleControlPoint.weights();
     boost::numeric::ublas::bounded_vector<double, 3> &corrections
-        = bundleControlPoint->corrections();
+        = bundleControlPoint.corrections();
 
     if (weights(0) > 0.0) {
       N22(0,0) += weights(0);
       n2(0) += (-weights(0) * corrections(0));
-      m_bundleResults.incrementNumberConstrainedPointParameters(1);
+      numConstrained++;
     }
 
     if (weights(1) > 0.0) {
       N22(1,1) += weights(1);
       n2(1) += (-weights(1) * corrections(1));
-      m_bundleResults.incrementNumberConstrainedPointParameters(1);
+      numConstrained++;
     }
 
     if (weights(2) > 0.0) {
       N22(2,2) += weights(2);
       n2(2) += (-weights(2) * corrections(2));
-      m_bundleResults.incrementNumberConstrainedPointParameters(1);
+      numConstrained++;
     }
 
     // invert N22
     invert3x3(N22);
 
     // save upper triangular covariance matrix for error propagation
-    SurfacePoint SurfacePoint = bundleControlPoint->adjustedSurfacePoint();
+    SurfacePoint SurfacePoint = bundleControlPoint.adjustedSurfacePoint();
     SurfacePoint.SetMatrix(m_bundleSettings->controlPointCoordTypeBundle(), N22);
-    bundleControlPoint->setAdjustedSurfacePoint(SurfacePoint);
+    bundleControlPoint.setAdjustedSurfacePoint(SurfacePoint);
 
     // form Q (this is N22{-1} * N12{T})
     productATransB(N22, N12, Q);
@@ -1340,13 +1770,7 @@ namespace Isis {
     // form product of N22(inverse) and n2; store in NIC
     NIC = prod(N22, n2);
 
-    // accumulate -R directly into reduced normal equations
-    productAB(N12, Q);
-
-    // accumulate -nj
-    accumProductAlphaAB(-1.0, Q, n2, nj);
-
-    return true;
+    return numConstrained;
   }
 
 
@@ -1538,30 +1962,31 @@ namespace Isis {
 
 
   /**
-   * Compute the solution to the normal equations using the CHOLMOD library.
+   * Compute the solution to the normal equations using the CHOLMOD library, or
+   * with conjugate gradients if the settings ask for them.
    *
    * @return @b bool If the solution was successfully computed.
    *
-   * @throws IException::Programmer "CHOLMOD: Failed to load Triplet matrix"
+   * @throws IException::Programmer "CHOLMOD: Failed to load Sparse matrix"
    *
    * @see BundleAdjust::solveCholesky
    */
   bool BundleAdjust::solveSystem() {
 
-    // load cholmod triplet
-    if ( !loadCholmodTriplet() ) {
-      QString msg = "CHOLMOD: Failed to load Triplet matrix";
-      throw IException(IException::Programmer, msg, _FILEINFO_);
+    if (m_bundleSettings->solveMethod() == BundleSettings::ConjugateGradient) {
+      return solveConjugateGradient();
     }
 
-    // convert triplet to sparse matrix
-    m_cholmodNormal = cholmod_triplet_to_sparse(m_cholmodTriplet,
-                                                m_cholmodTriplet->nnz,
-                                                &m_cholmodCommon);
+    // load cholmod sparse matrix
+    if ( !loadCholmodSparse() ) {
+      QString msg = "CHOLMOD: Failed to load Sparse matrix";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
 
-    // analyze matrix
-    // TODO should we analyze just 1st iteration?
-    m_L = cholmod_analyze(m_cholmodNormal, &m_cholmodCommon);
+    // analyze matrix, only when its pattern is new
+    if ( !m_L ) {
+      m_L = cholmod_analyze(m_cholmodNormal, &m_cholmodCommon);
+    }
 
     // create cholmod cholesky factor
     // CHOLMOD will choose LLT or LDLT decomposition based on the characteristics of the matrix.
@@ -1597,52 +2022,189 @@ namespace Isis {
       m_imageSolution[i] = sx[i];
     }
 
-    // free cholmod structures
-    cholmod_free_sparse(&m_cholmodNormal, &m_cholmodCommon);
+    // free cholmod structures, keeping the sparse matrix to refill next iteration
     cholmod_free_dense(&b, &m_cholmodCommon);
     cholmod_free_dense(&x, &m_cholmodCommon);
 
     return true;
   }
 
-
   /**
-   * @brief Load sparse normal equations matrix into CHOLMOD triplet.
+   * Compute the solution to the normal equations with block Jacobi
+   * preconditioned conjugate gradients. The normal equations are never
+   * factored, so there is no fill-in, and the products use the blocks of
+   * m_sparseNormals directly. The number of iterations and the final relative
+   * residual are recorded in the BundleResults. If the maximum number of
+   * iterations is reached before the tolerance, a warning with the final
+   * residual is output and the solution is used as it is.
    *
-   * Blocks from the sparse block normal matrix are loaded into a CHOLMOD triplet.
-   * Before the triplet can be used with CHOLMOD, it must be converted to a
-   * CHOLMOD sparse matrix via cholmod_triplet_to_sparse.
-   *
-   * @return @b bool If the triplet was successfully formed.
+   * @return @b bool If the solution was successfully computed.
    *
    * @see BundleAdjust::solveSystem
    */
-  bool BundleAdjust::loadCholmodTriplet() {
+  bool BundleAdjust::solveConjugateGradient() {
+    int numBlockColumns = m_sparseNormals.size();
 
-    if ( m_iteration == 1 ) {
-      int numElements = m_sparseNormals.numberOfElements();
-      m_cholmodTriplet = cholmod_allocate_triplet(m_rank, m_rank, numElements,
-                                                  -1, CHOLMOD_REAL, &m_cholmodCommon);
+    // the preconditioner is the inverse of each diagonal block
+    std::vector<LinearAlgebra::Matrix> preconditioner(numBlockColumns);
+    for (int columnIndex = 0; columnIndex < numBlockColumns; columnIndex++) {
+      LinearAlgebra::Matrix *diagonalBlock = (*m_sparseNormals[columnIndex])[columnIndex];
+      LinearAlgebra::Matrix symmetricBlock(diagonalBlock->size1(), diagonalBlock->size2());
+      for (unsigned ii = 0; ii < symmetricBlock.size1(); ii++) {
+        for (unsigned jj = ii; jj < symmetricBlock.size2(); jj++) {
+          symmetricBlock(ii, jj) = (*diagonalBlock)(ii, jj);
+          symmetricBlock(jj, ii) = (*diagonalBlock)(ii, jj);
+        }
+      }
+      preconditioner[columnIndex] = LinearAlgebra::inverse(symmetricBlock);
+    }
 
-      if ( !m_cholmodTriplet ) {
-        outputBundleStatus("\nTriplet allocation failure\n");
+    LinearAlgebra::Vector x(m_rank);
+    LinearAlgebra::Vector r(m_RHS);
+    LinearAlgebra::Vector z(m_rank);
+    LinearAlgebra::Vector q(m_rank);
+    x.clear();
+
+    applyBlockPreconditioner(preconditioner, r, z);
+    LinearAlgebra::Vector p(z);
+    double rz = inner_prod(r, z);
+
+    double rhsNorm = norm_2(m_RHS);
+    double relativeResidual = 0.0;
+    int iterations = 0;
+    while (rhsNorm > 0.0 &&
+           iterations < m_bundleSettings->conjugateGradientMaximumIterations()) {
+      iterations++;
+
+      multiplyNormals(p, q);
+      double pq = inner_prod(p, q);
+      if (pq <= 0.0) {
+        QString msg = "Matrix NOT positive-definite: conjugate gradient failure at iteration " +
+                      toString(iterations);
+        error(msg);
+        emit(finished());
         return false;
       }
 
-      m_cholmodTriplet->nnz = 0;
+      double alpha = rz / pq;
+      x += alpha * p;
+      r -= alpha * q;
+
+      relativeResidual = norm_2(r) / rhsNorm;
+      if (relativeResidual <= m_bundleSettings->conjugateGradientTolerance()) {
+        break;
+      }
+
+      applyBlockPreconditioner(preconditioner, r, z);
+      double previousRz = rz;
+      rz = inner_prod(r, z);
+      p = z + (rz / previousRz) * p;
     }
 
-    int *tripletColumns = (int*) m_cholmodTriplet->i;
-    int *tripletRows = (int*) m_cholmodTriplet->j;
-    double *tripletValues = (double*)m_cholmodTriplet->x;
+    m_bundleResults.addSolverConvergence(iterations, relativeResidual);
+    outputBundleStatus(QString("\nConjugate gradients: %1 iterations, relative residual %2\n")
+                       .arg(iterations).arg(relativeResidual));
+
+    // The solution is still used, it is just less accurate than asked for
+    if (relativeResidual > m_bundleSettings->conjugateGradientTolerance()) {
+      outputBundleStatus(QString("\nWarning: conjugate gradients reached the maximum of %1 "
+                                 "iterations with relative residual %2, above the tolerance "
+                                 "of %3\n")
+                         .arg(iterations).arg(relativeResidual)
+                         .arg(m_bundleSettings->conjugateGradientTolerance()));
+    }
 
-    double entryValue;
+    m_imageSolution = x;
+
+    return true;
+  }
+
+
+  /**
+   * Multiplies the sparse block normal equations matrix by a vector. Only the
+   * upper triangle of the matrix is stored, so each off-diagonal block is used
+   * along with its transpose.
+   *
+   * @param x The vector to multiply
+   * @param y Set to the normal equations matrix times x
+   */
+  void BundleAdjust::multiplyNormals(const LinearAlgebra::Vector &x, LinearAlgebra::Vector &y) {
+    y.clear();
+
+    int numBlockColumns = m_sparseNormals.size();
+    for (int columnIndex = 0; columnIndex < numBlockColumns; columnIndex++) {
+      SparseBlockColumnMatrix *normalsColumn = m_sparseNormals[columnIndex];
+      int numLeadingColumns = normalsColumn->startColumn();
+
+      QMapIterator< int, LinearAlgebra::Matrix * > it(*normalsColumn);
+      while ( it.hasNext() ) {
+        it.next();
+
+        int rowIndex = it.key();
+        int numLeadingRows = m_sparseNormals.at(rowIndex)->startColumn();
+        LinearAlgebra::Matrix &normalsBlock = *it.value();
+        int numRows = normalsBlock.size1();
+        int numColumns = normalsBlock.size2();
+
+        if ( rowIndex == columnIndex ) {   // diagonal block (upper-triangular)
+          for (int ii = 0; ii < numRows; ii++) {
+            for (int jj = ii; jj < numColumns; jj++) {
+              y(numLeadingRows + ii) += normalsBlock(ii, jj) * x(numLeadingColumns + jj);
+              if (ii != jj) {
+                y(numLeadingColumns + jj) += normalsBlock(ii, jj) * x(numLeadingRows + ii);
+              }
+            }
+          }
+        }
+        else {                // off-diagonal block (square)
+          noalias(subrange(y, numLeadingRows, numLeadingRows + numRows)) +=
+              prod(normalsBlock, subrange(x, numLeadingColumns, numLeadingColumns + numColumns));
+          noalias(subrange(y, numLeadingColumns, numLeadingColumns + numColumns)) +=
+              prod(trans(normalsBlock), subrange(x, numLeadingRows, numLeadingRows + numRows));
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Applies the block Jacobi preconditioner to a vector.
+   *
+   * @param preconditioner The inverse of each diagonal block of the normals
+   * @param r The vector to precondition
+   * @param z Set to the preconditioned vector
+   */
+  void BundleAdjust::applyBlockPreconditioner(
+                         const std::vector<LinearAlgebra::Matrix> &preconditioner,
+                         const LinearAlgebra::Vector &r, LinearAlgebra::Vector &z) {
+    for (unsigned columnIndex = 0; columnIndex < preconditioner.size(); columnIndex++) {
+      int start = m_sparseNormals.at(columnIndex)->startColumn();
+      int size = preconditioner[columnIndex].size1();
+      noalias(subrange(z, start, start + size)) =
+          prod(preconditioner[columnIndex], subrange(r, start, start + size));
+    }
+  }
 
-    int numEntries = 0;
 
+
+  /**
+   * @brief Load sparse normal equations matrix into a CHOLMOD sparse matrix.
+   *
+   * The upper triangle of the sparse block normal matrix is copied into
+   * m_cholmodNormal, column by column. The pattern of the blocks is kept between
+   * iterations, so m_cholmodNormal and the symbolic factorization in m_L are
+   * only rebuilt on the first iteration or when the pattern changes. Otherwise
+   * the values are refilled in place.
+   *
+   * @return @b bool If the sparse matrix was successfully formed.
+   *
+   * @see BundleAdjust::solveSystem
+   */
+  bool BundleAdjust::loadCholmodSparse() {
     int numBlockcolumns = m_sparseNormals.size();
-    for (int columnIndex = 0; columnIndex < numBlockcolumns; columnIndex++) {
 
+    QList< QList<int> > pattern;
+    for (int columnIndex = 0; columnIndex < numBlockcolumns; columnIndex++) {
       SparseBlockColumnMatrix *normalsColumn = m_sparseNormals[columnIndex];
 
       if ( !normalsColumn ) {
@@ -1652,69 +2214,83 @@ namespace Isis {
         return false;
       }
 
-      int numLeadingColumns = normalsColumn->startColumn();
-
-      QMapIterator< int, LinearAlgebra::Matrix * > it(*normalsColumn);
-
-      while ( it.hasNext() ) {
-        it.next();
+      pattern.append(normalsColumn->keys());
+    }
 
-        int rowIndex = it.key();
+    if ( m_iteration == 1 || !m_cholmodNormal || pattern != m_normalsPattern ) {
+      cholmod_free_sparse(&m_cholmodNormal, &m_cholmodCommon);
+      cholmod_free_factor(&m_L, &m_cholmodCommon);
 
-        // note: as the normal equations matrix is symmetric, the # of leading rows for a block is
-        //       equal to the # of leading columns for a block column at the "rowIndex" position
-        int numLeadingRows = m_sparseNormals.at(rowIndex)->startColumn();
-
-        LinearAlgebra::Matrix *normalsBlock = it.value();
-        if ( !normalsBlock ) {
-          QString status = "\nmatrix block retrieval failure at column ";
-          status.append(columnIndex);
-          status.append(", row ");
-          status.append(rowIndex);
-          outputBundleStatus(status);
-          status = "Total # of block columns: " + QString::number(numBlockcolumns);
-          outputBundleStatus(status);
-          status = "Total # of blocks: " + QString::number(m_sparseNormals.numberOfBlocks());
-          outputBundleStatus(status);
-          return false;
+      int numElements = 0;
+      for (int columnIndex = 0; columnIndex < numBlockcolumns; columnIndex++) {
+        QMapIterator< int, LinearAlgebra::Matrix * > it(*m_sparseNormals[columnIndex]);
+        while ( it.hasNext() ) {
+          it.next();
+          int numColumns = it.value()->size2();
+          int numRows = it.value()->size1();
+          if ( it.key() == columnIndex ) {
+            numElements += numColumns * (numColumns + 1) / 2;
+          }
+          else {
+            numElements += numColumns * numRows;
+          }
         }
+      }
 
-        if ( columnIndex == rowIndex )  {   // diagonal block (upper-triangular)
-          for (unsigned ii = 0; ii < normalsBlock->size1(); ii++) {
-            for (unsigned jj = ii; jj < normalsBlock->size2(); jj++) {
-              entryValue = normalsBlock->at_element(ii,jj);
-              int entryColumnIndex = jj + numLeadingColumns;
-              int entryRowIndex = ii + numLeadingRows;
-
-              if ( m_iteration == 1 ) {
-                tripletColumns[numEntries] = entryColumnIndex;
-                tripletRows[numEntries] = entryRowIndex;
-                m_cholmodTriplet->nnz++;
-              }
-
-              tripletValues[numEntries] = entryValue;
+      m_cholmodNormal = cholmod_allocate_sparse(m_rank, m_rank, numElements, true, true, 1,
+                                                CHOLMOD_REAL, &m_cholmodCommon);
+      if ( !m_cholmodNormal ) {
+        outputBundleStatus("\nSparse matrix allocation failure\n");
+        return false;
+      }
 
-              numEntries++;
+      // the rows of each column are in block order, so they are already sorted
+      int *columnStarts = (int*) m_cholmodNormal->p;
+      int *rows = (int*) m_cholmodNormal->i;
+      int numEntries = 0;
+      for (int columnIndex = 0; columnIndex < numBlockcolumns; columnIndex++) {
+        SparseBlockColumnMatrix *normalsColumn = m_sparseNormals[columnIndex];
+        int numLeadingColumns = normalsColumn->startColumn();
+        int numColumns = normalsColumn->begin().value()->size2();
+
+        for (int jj = 0; jj < numColumns; jj++) {
+          columnStarts[numLeadingColumns + jj] = numEntries;
+
+          QMapIterator< int, LinearAlgebra::Matrix * > it(*normalsColumn);
+          while ( it.hasNext() ) {
+            it.next();
+
+            // note: as the normal equations matrix is symmetric, the # of leading rows for a block
+            //       is equal to the # of leading columns for a block column at the "rowIndex"
+            //       position
+            int numLeadingRows = m_sparseNormals.at(it.key())->startColumn();
+            int numRows = (it.key() == columnIndex) ? jj + 1 : it.value()->size1();
+            for (int ii = 0; ii < numRows; ii++) {
+              rows[numEntries++] = ii + numLeadingRows;
             }
           }
         }
-        else {                // off-diagonal block (square)
-          for (unsigned ii = 0; ii < normalsBlock->size1(); ii++) {
-            for (unsigned jj = 0; jj < normalsBlock->size2(); jj++) {
-              entryValue = normalsBlock->at_element(ii,jj);
-              int entryColumnIndex = jj + numLeadingColumns;
-              int entryRowIndex = ii + numLeadingRows;
-
-              if ( m_iteration ==1 ) {
-                tripletColumns[numEntries] = entryRowIndex;
-                tripletRows[numEntries] = entryColumnIndex;
-                m_cholmodTriplet->nnz++;
-              }
+      }
+      columnStarts[m_rank] = numEntries;
+
+      m_normalsPattern = pattern;
+    }
 
-              tripletValues[numEntries] = entryValue;
+    double *values = (double*) m_cholmodNormal->x;
+    int numEntries = 0;
+    for (int columnIndex = 0; columnIndex < numBlockcolumns; columnIndex++) {
+      SparseBlockColumnMatrix *normalsColumn = m_sparseNormals[columnIndex];
+      int numColumns = normalsColumn->begin().value()->size2();
 
-              numEntries++;
-            }
+      for (int jj = 0; jj < numColumns; jj++) {
+        QMapIterator< int, LinearAlgebra::Matrix * > it(*normalsColumn);
+        while ( it.hasNext() ) {
+          it.next();
+
+          LinearAlgebra::Matrix *normalsBlock = it.value();
+          int numRows = (it.key() == columnIndex) ? jj + 1 : normalsBlock->size1();
+          for (int ii = 0; ii < numRows; ii++) {
+            values[numEntries++] = normalsBlock->at_element(ii, jj);
           }
         }
       }
@@ -1823,6 +2399,10 @@ namespace Isis {
    * @param coeffRHS A vector that will contain weighted x,y residuals.
    * @param measure The measure that partials are being computed for.
    * @param point The point containing measure.
+   * @param residuals If not NULL, the residuals for the probability distributions are stored
+   *                  here for the caller to add to the bundle results, instead of being added
+   *                  now. This lets several threads compute partials for different cameras at
+   *                  once.
    *
    * @return @b bool If the partials were successfully computed.
    *
@@ -1833,7 +2413,8 @@ namespace Isis {
                                      matrix<double> &coeffPoint3D,
                                      vector<double> &coeffRHS,
                                      BundleMeasure &measure,
-                                     BundleControlPoint &point) {
+                                     BundleControlPoint &point,
+                                     MeasurePartials *residuals) {
 
     // These vectors are either body-fixed latitudinal (lat/lon/radius) or rectangular (x/y/z)
     // depending on the value of coordinate type in SurfacePoint
@@ -1856,12 +2437,10 @@ namespace Isis {
 
     int numImagePartials = observation->numberParameters();
 
-    // we're saving the number of image partials in m_previousNumberImagePartials
-    // to compare to the previous computePartials call to avoid unnecessary resizing of the
+    // compare to the previous number of image partials to avoid unnecessary resizing of the
     // coeffImage matrix
-    if (numImagePartials != m_previousNumberImagePartials) {
+    if ((int)coeffImage.size2() != numImagePartials) {
       coeffImage.resize(2,numImagePartials);
-      m_previousNumberImagePartials = numImagePartials;
     }
 
     // clear partial derivative matrices and vectors
@@ -2074,10 +2653,21 @@ namespace Isis {
 
     // residual prob distribution is calculated even if there is no maximum likelihood estimation
     double obsValue = deltaX / measureCamera->PixelPitch();
-    m_bundleResults.addResidualsProbabilityDistributionObservation(obsValue);
+    if (residuals) {
+      residuals->residualX = obsValue;
+    }
+    else {
+      m_bundleResults.addResidualsProbabilityDistributionObservation(obsValue);
+    }
 
     obsValue = deltaY / measureCamera->PixelPitch();
-    m_bundleResults.addResidualsProbabilityDistributionObservation(obsValue);
+    if (residuals) {
+      residuals->residualY = obsValue;
+      residuals->residualR2ZScore = Null;
+    }
+    else {
+      m_bundleResults.addResidualsProbabilityDistributionObservation(obsValue);
+    }
 
     observationSigma = 1.4 * measureCamera->PixelPitch();
     observationWeight = 1.0 / observationSigma;
@@ -2088,7 +2678,12 @@ namespace Isis {
       double residualR2ZScore
                  = sqrt(deltaX * deltaX + deltaY * deltaY) / observationSigma / sqrt(2.0);
       //dynamically build the cumulative probability distribution of the R^2 residual Z Scores
-      m_bundleResults.addProbabilityDistributionObservation(residualR2ZScore);
+      if (residuals) {
+        residuals->residualR2ZScore = residualR2ZScore;
+      }
+      else {
+        m_bundleResults.addProbabilityDistributionObservation(residualR2ZScore);
+      }
       int currentModelIndex = m_bundleResults.maximumLikelihoodModelIndex();
       observationWeight *= m_bundleResults.maximumLikelihoodModelWFunc(currentModelIndex)
                             .sqrtWeightScaler(residualR2ZScore);
@@ -2591,7 +3186,6 @@ namespace Isis {
   bool BundleAdjust::errorPropagation() {
     emit(statusBarUpdate("Error Propagation"));
     // free unneeded memory
-    cholmod_free_triplet(&m_cholmodTriplet, &m_cholmodCommon);
     cholmod_free_sparse(&m_cholmodNormal, &m_cholmodCommon);
 
     LinearAlgebra::Matrix T(3, 3);
@@ -2616,6 +3210,17 @@ namespace Isis {
       pointCovariances[d].clear();
     }
 
+    // The selected inverse only has the blocks that the sigmas need, so the
+    // inverse matrix file still comes from solving for whole block columns
+    BundleSettings::ErrorPropagationMethod method = m_bundleSettings->errorPropagationMethod();
+    if (method == BundleSettings::SelectedInverse && m_bundleSettings->createInverseMatrix()) {
+      method = BundleSettings::BlockSolves;
+    }
+
+    if (method == BundleSettings::SelectedInverse) {
+      selectedInverseCovariances(pointCovariances);
+    }
+
     cholmod_dense *x;        // solution vector
     cholmod_dense *b;        // right-hand side (column vectors of identity)
 
@@ -2643,7 +3248,8 @@ namespace Isis {
     int i, j, k;
     int columnIndex = 0;
     int numColumns = 0;
-    int numBlockColumns = m_sparseNormals.size();
+    // There are no block columns left to solve for after the selected inverse
+    int numBlockColumns = (method == BundleSettings::SelectedInverse) ? 0 : m_sparseNormals.size();
     for (i = 0; i < numBlockColumns; i++) {
 
       // columns in this column block
@@ -2678,33 +3284,65 @@ namespace Isis {
 
       int localCol = 0;
 
-      // solve for inverse for nCols
-      for (j = 0; j < numColumns; j++) {
-        if ( columnIndex > 0 ) {
-          pb[columnIndex - 1] = 0.0;
+      // solve for inverse for nCols with one right-hand side for each column
+      if (method == BundleSettings::BlockSolves) {
+        cholmod_dense *blockB = cholmod_zeros(m_rank, numColumns, CHOLMOD_REAL, &m_cholmodCommon);
+        double *pBlockB = (double*)blockB->x;
+        for (j = 0; j < numColumns; j++) {
+          pBlockB[j * blockB->d + columnIndex + j] = 1.0;
         }
-        pb[columnIndex] = 1.0;
 
-        x = cholmod_solve ( CHOLMOD_A, m_L, b, &m_cholmodCommon );
+        x = cholmod_solve ( CHOLMOD_A, m_L, blockB, &m_cholmodCommon );
         px = (double*)x->x;
-        int rp = 0;
 
-        // store solution in corresponding column of inverse
-        for (k = 0; k < inverseMatrix.size(); k++) {
-          LinearAlgebra::Matrix *matrix = inverseMatrix.value(k);
+        // store solution in the inverse, one column at a time
+        for (j = 0; j < numColumns; j++) {
+          int rp = j * x->d;
+          for (k = 0; k < inverseMatrix.size(); k++) {
+            LinearAlgebra::Matrix *matrix = inverseMatrix.value(k);
 
-          int sz1 = matrix->size1();
+            int sz1 = matrix->size1();
 
-          for (int ii = 0; ii < sz1; ii++) {
-            (*matrix)(ii,localCol) = px[ii + rp];
+            for (int ii = 0; ii < sz1; ii++) {
+              (*matrix)(ii,j) = px[ii + rp];
+            }
+            rp += matrix->size1();
           }
-          rp += matrix->size1();
         }
 
-        columnIndex++;
-        localCol++;
+        columnIndex += numColumns;
 
         cholmod_free_dense(&x,&m_cholmodCommon);
+        cholmod_free_dense(&blockB,&m_cholmodCommon);
+      }
+      else {
+        for (j = 0; j < numColumns; j++) {
+          if ( columnIndex > 0 ) {
+            pb[columnIndex - 1] = 0.0;
+          }
+          pb[columnIndex] = 1.0;
+
+          x = cholmod_solve ( CHOLMOD_A, m_L, b, &m_cholmodCommon );
+          px = (double*)x->x;
+          int rp = 0;
+
+          // store solution in corresponding column of inverse
+          for (k = 0; k < inverseMatrix.size(); k++) {
+            LinearAlgebra::Matrix *matrix = inverseMatrix.value(k);
+
+            int sz1 = matrix->size1();
+
+            for (int ii = 0; ii < sz1; ii++) {
+              (*matrix)(ii,localCol) = px[ii + rp];
+            }
+            rp += matrix->size1();
+          }
+
+          columnIndex++;
+          localCol++;
+
+          cholmod_free_dense(&x,&m_cholmodCommon);
+        }
       }
 
       // save adjusted target body sigmas if solving for target
@@ -2931,6 +3569,252 @@ namespace Isis {
   }
 
 
+  /**
+   * Computes the entries of the inverse of the reduced normals that lie in the
+   * pattern of their Cholesky factor with the Takahashi recurrence. The factor
+   * is converted to a simplicial L*D*L' factor in place.
+   *
+   * A column of the inverse only needs the columns of its ancestors in the
+   * elimination tree, so the columns at each depth of the tree are computed
+   * together with several threads.
+   *
+   * @param inverse Set to the selected entries of the inverse
+   *
+   * @throws IException::Programmer "Unable to convert the Cholesky factor for selected
+   *                                 inversion."
+   */
+  void BundleAdjust::computeSelectedInverse(SelectedInverse &inverse) {
+    if (!cholmod_change_factor(CHOLMOD_REAL, false, false, true, true, m_L, &m_cholmodCommon)) {
+      QString msg = "Unable to convert the Cholesky factor for selected inversion.";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    int n = (int) m_L->n;
+    int *Lp = (int*) m_L->p;
+    int *Li = (int*) m_L->i;
+    int *Lnz = (int*) m_L->nz;
+    int *perm = (int*) m_L->Perm;
+    double *Lx = (double*) m_L->x;
+
+    inverse.columnStarts.assign(n + 1, 0);
+    for (int j = 0; j < n; j++) {
+      inverse.columnStarts[j + 1] = inverse.columnStarts[j] + Lnz[j];
+    }
+    inverse.rows.resize(inverse.columnStarts[n]);
+    inverse.values.assign(inverse.columnStarts[n], 0.0);
+
+    inverse.factorIndices.resize(n);
+    for (int j = 0; j < n; j++) {
+      inverse.factorIndices[perm[j]] = j;
+    }
+
+    // Copy the factor with the rows of each column sorted, so the diagonal is
+    // first and the parent in the elimination tree is second
+    std::vector<double> factor(inverse.columnStarts[n]);
+    std::vector<int> parents(n, -1);
+    std::vector< std::pair<int, double> > column;
+    for (int j = 0; j < n; j++) {
+      column.clear();
+      for (int p = Lp[j]; p < Lp[j] + Lnz[j]; p++) {
+        column.push_back(std::make_pair(Li[p], Lx[p]));
+      }
+      std::sort(column.begin(), column.end());
+
+      int start = inverse.columnStarts[j];
+      for (unsigned p = 0; p < column.size(); p++) {
+        inverse.rows[start + p] = column[p].first;
+        factor[start + p] = column[p].second;
+      }
+      if (column.size() > 1) {
+        parents[j] = column[1].first;
+      }
+    }
+
+    // Parents always come after their children
+    std::vector<int> depths(n, 0);
+    QList< QVector<int> > levels;
+    for (int j = n - 1; j >= 0; j--) {
+      if (parents[j] >= 0) {
+        depths[j] = depths[parents[j]] + 1;
+      }
+      while (levels.size() <= depths[j]) {
+        levels.append(QVector<int>());
+      }
+      levels[depths[j]].append(j);
+    }
+
+    int workerCount = QThreadPool::globalInstance()->maxThreadCount();
+    for (int level = 0; level < levels.size(); level++) {
+      const QVector<int> &columns = levels.at(level);
+      int levelWorkers = qBound(1, columns.size(), workerCount);
+
+      runWorkers(levelWorkers, [&](int worker) {
+        for (int c = worker; c < columns.size(); c += levelWorkers) {
+          int j = columns[c];
+          int start = inverse.columnStarts[j];
+          int end = inverse.columnStarts[j + 1];
+
+          for (int p = start + 1; p < end; p++) {
+            double sum = 0.0;
+            for (int q = start + 1; q < end; q++) {
+              sum += factor[q] * inverse.factorValue(inverse.rows[p], inverse.rows[q]);
+            }
+            inverse.values[p] = -sum;
+          }
+
+          double diagonal = 1.0 / factor[start];
+          for (int p = start + 1; p < end; p++) {
+            diagonal -= factor[p] * inverse.values[p];
+          }
+          inverse.values[start] = diagonal;
+        }
+      });
+    }
+  }
+
+
+  /**
+   * Computes the image sigmas and the image contributions to the point
+   * covariances from the selected inverse of the reduced normals, instead of
+   * solving for every column of the inverse.
+   *
+   * @param pointCovariances The 3x3 covariance of each point from the images
+   *
+   * @throws IException::User "Input data and settings are not sufficiently stable
+   *                           for error propagation."
+   */
+  void BundleAdjust::selectedInverseCovariances(std::vector< symmetric_matrix<double> >
+                                                    &pointCovariances) {
+    outputBundleStatus("\rError Propagation: Selected Inverse");
+
+    SelectedInverse inverse;
+    computeSelectedInverse(inverse);
+
+    // save adjusted target body and image sigmas
+    std::vector<int> blockStarts(m_sparseNormals.size());
+    std::vector<int> blockSizes(m_sparseNormals.size());
+    for (int i = 0; i < m_sparseNormals.size(); i++) {
+      blockStarts[i] = m_sparseNormals.at(i)->startColumn();
+      blockSizes[i] = m_sparseNormals.at(i)->numberOfColumns();
+      int start = blockStarts[i];
+      int numColumns = blockSizes[i];
+
+      vector< double > *adjustedSigmas;
+      if (m_bundleSettings->solveTargetBody() && i == 0) {
+        adjustedSigmas = &m_bundleTargetBody->adjustedSigmas();
+      }
+      else if (m_bundleSettings->solveTargetBody()) {
+        adjustedSigmas = &m_bundleObservations.at(i-1)->adjustedSigmas();
+      }
+      else {
+        adjustedSigmas = &m_bundleObservations.at(i)->adjustedSigmas();
+      }
+
+      for (int z = 0; z < numColumns; z++) {
+        (*adjustedSigmas)[z] = sqrt(inverse.value(start + z, start + z))*m_bundleResults.sigma0();
+      }
+    }
+
+    // sum the contributions of each pair of blocks in Q into the point covariances
+    int numObjectPoints = m_bundleControlPoints.size();
+    int workerCount = qBound(1, numObjectPoints, QThreadPool::globalInstance()->maxThreadCount());
+    runWorkers(workerCount, [&](int worker) {
+      LinearAlgebra::Matrix T(3, 3);
+      for (int pointIndex = worker; pointIndex < numObjectPoints; pointIndex += workerCount) {
+        BundleControlPointQsp point = m_bundleControlPoints.at(pointIndex);
+        if ( point->isRejected() ) {
+          continue;
+        }
+
+        SparseBlockRowMatrix &Q = point->cholmodQMatrix();
+        symmetric_matrix<double> &covariance = pointCovariances[pointIndex];
+
+        QMapIterator< int, LinearAlgebra::Matrix * > firstIt(Q);
+        while ( firstIt.hasNext() ) {
+          firstIt.next();
+          int i = firstIt.key();
+          LinearAlgebra::Matrix *firstQBlock = firstIt.value();
+
+          QMapIterator< int, LinearAlgebra::Matrix * > secondIt(Q);
+          while ( secondIt.hasNext() ) {
+            secondIt.next();
+            int nKey = secondIt.key();
+            if (nKey > i) {
+              break;
+            }
+
+            LinearAlgebra::Matrix *secondQBlock = secondIt.value();
+
+            LinearAlgebra::Matrix inverseBlock(blockSizes[nKey], blockSizes[i]);
+            for (unsigned r = 0; r < inverseBlock.size1(); r++) {
+              for (unsigned c = 0; c < inverseBlock.size2(); c++) {
+                inverseBlock(r, c) = inverse.value(blockStarts[nKey] + r, blockStarts[i] + c);
+              }
+            }
+
+            T = prod(inverseBlock, trans(*firstQBlock));
+            T = prod(*secondQBlock, T);
+
+            if (nKey != i) {
+              T += trans(T);
+            }
+
+            try {
+              covariance += T;
+            }
+            catch (std::exception &e) {
+              QString msg = "Input data and settings are not sufficiently stable "
+                            "for error propagation.";
+              throw IException(IException::User, msg, _FILEINFO_);
+            }
+          }
+        }
+      }
+    });
+  }
+
+
+  /**
+   * Finds an entry of the selected inverse by its row and column in the factor.
+   * The entry must be in the pattern of the factor or its transpose.
+   *
+   * @param row The row in the factor
+   * @param column The column in the factor
+   *
+   * @return @b double The entry of the inverse
+   *
+   * @throws IException::Programmer "The entry is not in the pattern of the Cholesky factor."
+   */
+  double BundleAdjust::SelectedInverse::factorValue(int row, int column) const {
+    if (row < column) {
+      std::swap(row, column);
+    }
+
+    std::vector<int>::const_iterator begin = rows.begin() + columnStarts[column];
+    std::vector<int>::const_iterator end = rows.begin() + columnStarts[column + 1];
+    std::vector<int>::const_iterator found = std::lower_bound(begin, end, row);
+    if (found == end || *found != row) {
+      QString msg = "The entry [" + toString(row) + ", " + toString(column) +
+                    "] is not in the pattern of the Cholesky factor.";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+    return values[found - rows.begin()];
+  }
+
+
+  /**
+   * Finds an entry of the selected inverse by its parameter row and column.
+   *
+   * @param row The parameter row
+   * @param column The parameter column
+   *
+   * @return @b double The entry of the inverse
+   */
+  double BundleAdjust::SelectedInverse::value(int row, int column) const {
+    return factorValue(factorIndices[row], factorIndices[column]);
+  }
+
+
   /**
    * Returns a pointer to the output control network.
    *
@@ -12,6 +12,7 @@ find files of those names at the top level of this repository. **/
 #include <QObject> // parent class
 
 // std lib
+#include <functional>
 #include <vector>
 #include <fstream>
 
@@ -375,17 +376,64 @@ namespace Isis {
       void finished();
 
     private:
+      /**
+       * The partial derivatives and residuals of one measure, kept between the
+       * steps of forming the normal equations with several threads.
+       */
+      struct MeasurePartials {
+        BundleControlPoint *point;          //!< The control point of the measure
+        BundleMeasure *measure;             //!< The measure
+        LinearAlgebra::Matrix coeffTarget;  //!< Target body partial derivatives
+        LinearAlgebra::Matrix coeffImage;   //!< Camera partial derivatives
+        LinearAlgebra::Matrix coeffPoint3D; //!< Point partial derivatives
+        LinearAlgebra::Vector coeffRHS;     //!< Weighted x,y residuals
+        double residualX;                   //!< The x residual in pixels
+        double residualY;                   //!< The y residual in pixels
+        double residualR2ZScore;            /**!< The R^2 residual Z score, or Null without
+                                                  maximum likelihood estimation.*/
+      };
+
+      /**
+       * The auxilary normal equation matrices of one control point, kept between
+       * the steps of forming the normal equations with several threads.
+       */
+      struct PointNormals {
+        SparseBlockColumnMatrix N12;        //!< The normals between the images and the point
+        LinearAlgebra::Vector n2;           //!< The right hand side for the point
+      };
+
+      /**
+       * The entries of the inverse of the reduced normals that lie in the pattern
+       * of their Cholesky factor, which includes every block the sigmas need.
+       */
+      struct SelectedInverse {
+        std::vector<int> columnStarts;  //!< Where each factor column starts in rows
+        std::vector<int> rows;          //!< The sorted factor rows of each column
+        std::vector<double> values;     //!< The inverse at each factor entry
+        std::vector<int> factorIndices; //!< The factor row and column of each parameter
+
+        double factorValue(int row, int column) const;
+        double value(int row, int column) const;
+      };
+
       //TODO Should there be a resetBundle(BundleSettings bundleSettings) method
       //     that allows for rerunning with new settings? JWB
       void init(Progress *progress = 0);
       bool initializeNormalEquationsMatrix();
       bool validateNetwork();
       bool solveSystem();
+      bool solveConjugateGradient();
+      void multiplyNormals(const LinearAlgebra::Vector &x, LinearAlgebra::Vector &y);
+      void applyBlockPreconditioner(const std::vector<LinearAlgebra::Matrix> &preconditioner,
+                                    const LinearAlgebra::Vector &r, LinearAlgebra::Vector &z);
       void iterationSummary();
       BundleSolutionInfo* bundleSolveInformation();
       bool computeBundleStatistics();
       void applyParameterCorrections();
       bool errorPropagation();
+      void computeSelectedInverse(SelectedInverse &inverse);
+      void selectedInverseCovariances(std::vector< boost::numeric::ublas::symmetric_matrix<
+                                          double> > &pointCovariances);
       double computeResiduals();
       bool computeRejectionLimit();
       bool flagOutliers();
@@ -393,12 +441,14 @@ namespace Isis {
       // normal equation matrices methods
 
       bool formNormalEquations();
+      bool formNormalEquationsThreaded(int workerCount);
       bool computePartials(LinearAlgebra::Matrix  &coeffTarget,
                            LinearAlgebra::Matrix  &coeffImage,
                            LinearAlgebra::Matrix  &coeffPoint3D,
                            LinearAlgebra::Vector  &coeffRHS,
                            BundleMeasure          &measure,
-                           BundleControlPoint     &point);
+                           BundleControlPoint     &point,
+                           MeasurePartials        *residuals = NULL);
       bool formMeasureNormals(boost::numeric::ublas::symmetric_matrix<
                                   double, boost::numeric::ublas::upper >         &N22,
                               SparseBlockColumnMatrix                            &N12,
@@ -415,6 +465,24 @@ namespace Isis {
                             LinearAlgebra::Vector                       &n2,
                             LinearAlgebra::Vector                       &nj,
                             BundleControlPointQsp                       &point);
+      int formPointQMatrix(boost::numeric::ublas::symmetric_matrix<
+                               double, boost::numeric::ublas::upper >  &N22,
+                           SparseBlockColumnMatrix                     &N12,
+                           LinearAlgebra::Vector                       &n2,
+                           BundleControlPoint                          &point);
+      void formMeasurePointNormals(boost::numeric::ublas::symmetric_matrix<
+                                       double, boost::numeric::ublas::upper >  &N22,
+                                   SparseBlockColumnMatrix                     &N12,
+                                   LinearAlgebra::Vector                       &n2,
+                                   const MeasurePartials                       &partials);
+      void accumulateMeasureNormals(const MeasurePartials  &partials,
+                                    LinearAlgebra::Vector  &n1,
+                                    int                    worker,
+                                    int                    workerCount);
+      void accumulatePointNormals(PointNormals          &normals,
+                                  SparseBlockRowMatrix  &Q,
+                                  int                   worker,
+                                  int                   workerCount);
       bool formWeightedNormals(boost::numeric::ublas::compressed_vector< double >  &n1,
                                LinearAlgebra::Vector                               &nj);
 
@@ -437,12 +505,14 @@ namespace Isis {
                           SparseBlockRowMatrix                                &Q,
                           LinearAlgebra::Vector                               &v1);
 
+      static void runWorkers(int workerCount, const std::function<void(int)> &work);
+
       // CHOLMOD library methods
 
       bool initializeCHOLMODLibraryVariables();
       bool freeCHOLMODLibraryVariables();
       bool cholmodInverse();
-      bool loadCholmodTriplet();
+      bool loadCholmodSparse();
       bool wrapUp();
 
       // member variables
@@ -498,29 +568,26 @@ namespace Isis {
                                                                    normal equations.*/
       SparseBlockMatrix m_sparseNormals;                     /**!< The sparse block normal
                                                                    equations matrix.  Used to
-                                                                   populate m_cholmodTriplet and
+                                                                   populate m_cholmodNormal and
                                                                    for error propagation.*/
-      cholmod_triplet  *m_cholmodTriplet;                    /**!< The CHOLMOD triplet
-                                                                   representation of the sparse
-                                                                   normal equations matrix.
-                                                                   Created from m_sparseNormals
-                                                                   and then used to create
-                                                                   m_cholmodNormal.*/
+      QList< QList<int> > m_normalsPattern;                  /**!< The row blocks of each block
+                                                                   column of m_sparseNormals
+                                                                   when m_cholmodNormal was
+                                                                   built.*/
       cholmod_sparse *m_cholmodNormal;                       /**!< The CHOLMOD sparse normal
                                                                    equations matrix used by
                                                                    cholmod_factorize to solve the
-                                                                   system. Created from
-                                                                   m_cholmodTriplet.*/
+                                                                   system. Refilled from
+                                                                   m_sparseNormals each
+                                                                   iteration.*/
       cholmod_factor *m_L;                                   /**!< The lower triangular L matrix
                                                                    from Cholesky decomposition.
                                                                    Created from m_cholmodNormal by
-                                                                   cholmod_factorize.*/
+                                                                   cholmod_analyze and refactored
+                                                                   by cholmod_factorize each
+                                                                   iteration.*/
       LinearAlgebra::Vector m_imageSolution;                 /**!< The image parameter solution
                                                                    vector.*/
-
-      int m_previousNumberImagePartials;                     /**!< used in ::computePartials method
-                                                                   to avoid unnecessary resizing
-                                                                   of the coeffImage matrix.*/
   };
 }
 
@@ -110,6 +110,8 @@ namespace Isis {
         m_bundleControlPoints(src.m_bundleControlPoints),
         m_outNet(src.m_outNet),
         m_iterations(src.m_iterations),
+        m_solverIterations(src.m_solverIterations),
+        m_solverResiduals(src.m_solverResiduals),
         m_observations(src.m_observations),
         m_rmsImageSampleResiduals(src.m_rmsImageSampleResiduals),
         m_rmsImageLineResiduals(src.m_rmsImageLineResiduals),
@@ -195,6 +197,8 @@ namespace Isis {
       m_bundleControlPoints = src.m_bundleControlPoints;
       m_outNet = src.m_outNet;
       m_iterations = src.m_iterations;
+      m_solverIterations = src.m_solverIterations;
+      m_solverResiduals = src.m_solverResiduals;
       m_observations = src.m_observations;
       m_rmsImageSampleResiduals = src.m_rmsImageSampleResiduals;
       m_rmsImageLineResiduals = src.m_rmsImageLineResiduals;
@@ -312,6 +316,8 @@ namespace Isis {
     // solve and solve cholesky
     m_degreesOfFreedom = -1;
     m_iterations = 0;
+    m_solverIterations.clear();
+    m_solverResiduals.clear();
     m_sigma0 = 0.0;
     m_elapsedTime = 0.0;
     m_elapsedTimeErrorProp = 0.0;
@@ -854,6 +860,19 @@ namespace Isis {
   }
 
 
+  /**
+   * Records how an iterative solver converged while solving the normal
+   * equations of a BundleAdjust iteration.
+   *
+   * @param iterations The number of solver iterations.
+   * @param residual The final residual norm relative to the right hand side.
+   */
+  void BundleResults::addSolverConvergence(int iterations, double residual) {
+    m_solverIterations.append(iterations);
+    m_solverResiduals.append(residual);
+  }
+
+
   /**
    * Sets the vector of BundleObservations.
    *
@@ -1304,6 +1323,28 @@ namespace Isis {
   }
 
 
+  /**
+   * Returns the number of iterative solver iterations for each BundleAdjust
+   * iteration. This is empty when the normal equations are factored.
+   *
+   * @return @b QList<int> The solver iterations.
+   */
+  QList<int> BundleResults::solverIterations() const {
+    return m_solverIterations;
+  }
+
+
+  /**
+   * Returns the final relative residual norm of the iterative solver for each
+   * BundleAdjust iteration. This is empty when the normal equations are factored.
+   *
+   * @return @b QList<double> The solver residuals.
+   */
+  QList<double> BundleResults::solverResiduals() const {
+    return m_solverResiduals;
+  }
+
+
   /**
    * Returns a reference to the observations used by the BundleAdjust.
    *
@@ -1621,6 +1662,18 @@ namespace Isis {
     stream.writeAttribute("errorProp", toString(elapsedTimeErrorProp()));
     stream.writeEndElement(); // end elapsed time
 
+    if (!m_solverIterations.isEmpty()) {
+      stream.writeStartElement("solverConvergence");
+      stream.writeAttribute("listSize", toString(m_solverIterations.size()));
+      for (int i = 0; i < m_solverIterations.size(); i++) {
+        stream.writeStartElement("solve");
+        stream.writeAttribute("iterations", toString(m_solverIterations[i]));
+        stream.writeAttribute("residual", toString(m_solverResiduals[i]));
+        stream.writeEndElement(); // end solve
+      }
+      stream.writeEndElement(); // end solverConvergence
+    }
+
     stream.writeStartElement("minMaxSigmas");
 
     // Write the labels corresponding to the coordinate type set for reports
@@ -1913,6 +1966,13 @@ namespace Isis {
         }
 
       }
+      else if (qName == "solve") {
+        QString iterations = atts.value("iterations");
+        QString residual = atts.value("residual");
+        if (!iterations.isEmpty() && !residual.isEmpty()) {
+          m_xmlHandlerBundleResults->addSolverConvergence(toInt(iterations), toDouble(residual));
+        }
+      }
 // ???      else if (qName == "minMaxSigmaDistances") {
 // ???        QString units = atts.value("units");
 // ???        if (!QString::compare(units, "meters", Qt::CaseInsensitive)) {
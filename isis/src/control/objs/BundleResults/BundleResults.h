@@ -163,6 +163,7 @@ namespace Isis {
       void setBundleControlPoints(QVector<BundleControlPointQsp> controlPoints);
       void setOutputControlNet(ControlNetQsp outNet);
       void setIterations(int iterations);
+      void addSolverConvergence(int iterations, double residual);
       void setObservations(BundleObservationVector observations);
 
       // Accessors...
@@ -215,6 +216,8 @@ namespace Isis {
       QVector<BundleControlPointQsp> &bundleControlPoints();
       ControlNetQsp outputControlNet() const;
       int iterations() const;
+      QList<int> solverIterations() const;
+      QList<double> solverResiduals() const;
       const BundleObservationVector &observations() const;
 
       int numberMaximumLikelihoodModels() const;
@@ -325,6 +328,12 @@ namespace Isis {
                                                                  BundleAdjust.*/
       int m_iterations;                                     /**< The number of iterations taken
                                                                  by BundleAdjust.*/
+      QList<int> m_solverIterations;                        /**< The number of iterative solver
+                                                                 iterations in each BundleAdjust
+                                                                 iteration.*/
+      QList<double> m_solverResiduals;                      /**< The final relative residual of
+                                                                 the iterative solver in each
+                                                                 BundleAdjust iteration.*/
       BundleObservationVector m_observations;               /**< The vector of BundleObservations
                                                                  from BundleAdjust.*/
 
@@ -55,6 +55,11 @@ namespace Isis {
     m_updateCubeLabel      = false;
     m_errorPropagation     = false;
     m_createInverseMatrix  = false;
+    m_threadedNormalEquations = false;
+    m_errorPropagationMethod = ColumnSolves;
+    m_solveMethod = Cholesky;
+    m_conjugateGradientTolerance = 1.0e-10;
+    m_conjugateGradientMaximumIterations = 1000;
     m_cubeList             =    "";
     m_outlierRejection     = false;
     m_outlierRejectionMultiplier = 3.0;
@@ -129,6 +134,11 @@ namespace Isis {
         m_updateCubeLabel(other.m_updateCubeLabel),
         m_errorPropagation(other.m_errorPropagation),
         m_createInverseMatrix(other.m_createInverseMatrix),
+        m_threadedNormalEquations(other.m_threadedNormalEquations),
+        m_errorPropagationMethod(other.m_errorPropagationMethod),
+        m_solveMethod(other.m_solveMethod),
+        m_conjugateGradientTolerance(other.m_conjugateGradientTolerance),
+        m_conjugateGradientMaximumIterations(other.m_conjugateGradientMaximumIterations),
         m_outlierRejection(other.m_outlierRejection),
         m_outlierRejectionMultiplier(other.m_outlierRejectionMultiplier),
         m_globalPointCoord1AprioriSigma(other.m_globalPointCoord1AprioriSigma),
@@ -175,6 +185,11 @@ namespace Isis {
       m_updateCubeLabel = other.m_updateCubeLabel;
       m_errorPropagation = other.m_errorPropagation;
       m_createInverseMatrix = other.m_createInverseMatrix;
+      m_threadedNormalEquations = other.m_threadedNormalEquations;
+      m_errorPropagationMethod = other.m_errorPropagationMethod;
+      m_solveMethod = other.m_solveMethod;
+      m_conjugateGradientTolerance = other.m_conjugateGradientTolerance;
+      m_conjugateGradientMaximumIterations = other.m_conjugateGradientMaximumIterations;
       m_outlierRejection = other.m_outlierRejection;
       m_outlierRejectionMultiplier = other.m_outlierRejectionMultiplier;
       m_globalPointCoord1AprioriSigma = other.m_globalPointCoord1AprioriSigma;
@@ -393,6 +408,64 @@ namespace Isis {
   }
 
 
+  /**
+   * Indicates if the normal equations will be formed with several threads. The
+   * normal equations are the same either way.
+   *
+   * @return @b bool Returns whether to form the normal equations with several threads.
+   *
+   * @see BundleAdjust::formNormalEquations()
+   */
+  bool BundleSettings::threadedNormalEquations() const {
+    return m_threadedNormalEquations;
+  }
+
+
+  /**
+   * Retrieves how error propagation will compute the covariances of the parameters.
+   *
+   * @return @b ErrorPropagationMethod The enumeration of the error propagation method.
+   *
+   * @see BundleAdjust::errorPropagation()
+   */
+  BundleSettings::ErrorPropagationMethod BundleSettings::errorPropagationMethod() const {
+    return m_errorPropagationMethod;
+  }
+
+
+  /**
+   * Retrieves how the reduced normal equations will be solved.
+   *
+   * @return @b SolveMethod The enumeration of the solve method.
+   *
+   * @see BundleAdjust::solveSystem()
+   */
+  BundleSettings::SolveMethod BundleSettings::solveMethod() const {
+    return m_solveMethod;
+  }
+
+
+  /**
+   * Retrieves the residual norm, relative to the right hand side, where
+   * conjugate gradients stop.
+   *
+   * @return @b double The conjugate gradient tolerance.
+   */
+  double BundleSettings::conjugateGradientTolerance() const {
+    return m_conjugateGradientTolerance;
+  }
+
+
+  /**
+   * Retrieves the most conjugate gradient iterations for each bundle iteration.
+   *
+   * @return @b int The maximum number of conjugate gradient iterations.
+   */
+  int BundleSettings::conjugateGradientMaximumIterations() const {
+    return m_conjugateGradientMaximumIterations;
+  }
+
+
   /**
    * This method is used to determine whether outlier rejection will be
    * performed on this bundle adjustment.
@@ -468,6 +541,160 @@ namespace Isis {
   }
 
 
+  /**
+   * Turn forming the normal equations with several threads on or off. The
+   * threads come from the global thread pool, so the GlobalThreads preference
+   * limits them. The partial derivatives of the cameras are computed with
+   * NAIF routines, which are not thread safe, so they are computed one at a
+   * time. The solution is the same as it is with one thread.
+   *
+   * @param threaded Boolean indicating whether to form the normal equations
+   *                 with several threads.
+   *
+   * @see BundleAdjust::formNormalEquations()
+   */
+  void BundleSettings::setThreadedNormalEquations(bool threaded) {
+    m_threadedNormalEquations = threaded;
+  }
+
+
+  /**
+   * Set how error propagation computes the covariances of the parameters.
+   * SelectedInverse only computes the blocks of the inverse that the sigmas
+   * need, so the inverse correlation matrix file is still created by solving
+   * for whole block columns.
+   *
+   * @param method An enumeration for the error propagation method.
+   *
+   * @see BundleAdjust::errorPropagation()
+   */
+  void BundleSettings::setErrorPropagationMethod(
+                           BundleSettings::ErrorPropagationMethod method) {
+    m_errorPropagationMethod = method;
+  }
+
+
+  /**
+   * Set how the reduced normal equations are solved. Conjugate gradients never
+   * factor the normal equations, so they use much less memory for very large
+   * networks, but error propagation needs the factorization.
+   *
+   * @param method An enumeration for the solve method.
+   * @param conjugateGradientTolerance The residual norm, relative to the right
+   *                                   hand side, where conjugate gradients stop.
+   * @param conjugateGradientMaximumIterations The most conjugate gradient
+   *                                           iterations for each bundle iteration.
+   *
+   * @see BundleAdjust::solveSystem()
+   */
+  void BundleSettings::setSolveMethod(BundleSettings::SolveMethod method,
+                                      double conjugateGradientTolerance,
+                                      int conjugateGradientMaximumIterations) {
+    m_solveMethod = method;
+    m_conjugateGradientTolerance = conjugateGradientTolerance;
+    m_conjugateGradientMaximumIterations = conjugateGradientMaximumIterations;
+  }
+
+
+  /**
+   * Converts the given string value to a BundleSettings::ErrorPropagationMethod
+   * enumeration. Currently accepted inputs are listed below. This method is
+   * case insensitive.
+   * <ul>
+   *   <li>ColumnSolves</li>
+   *   <li>BlockSolves</li>
+   *   <li>SelectedInverse</li>
+   * </ul>
+   *
+   * @param method Error propagation method name to be converted.
+   *
+   * @return @b ErrorPropagationMethod The enumeration corresponding to the given name.
+   *
+   * @throw Isis::Exception::Programmer "Unknown error propagation method."
+   */
+  BundleSettings::ErrorPropagationMethod
+      BundleSettings::stringToErrorPropagationMethod(QString method) {
+    if (method.compare("COLUMNSOLVES", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::ColumnSolves;
+    }
+    else if (method.compare("BLOCKSOLVES", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::BlockSolves;
+    }
+    else if (method.compare("SELECTEDINVERSE", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::SelectedInverse;
+    }
+    else throw IException(IException::Programmer,
+                          "Unknown error propagation method [" + method + "].",
+                          _FILEINFO_);
+  }
+
+
+  /**
+   * Converts the given BundleSettings::ErrorPropagationMethod enumeration to a string.
+   *
+   * @param method The ErrorPropagationMethod enumeration to be converted.
+   *
+   * @return @b QString The name associated with the given error propagation method.
+   *
+   * @throw Isis::Exception::Programmer "Unknown error propagation method enum."
+   */
+  QString BundleSettings::errorPropagationMethodToString(
+              BundleSettings::ErrorPropagationMethod method) {
+    if (method == ColumnSolves)         return "ColumnSolves";
+    else if (method == BlockSolves)     return "BlockSolves";
+    else if (method == SelectedInverse) return "SelectedInverse";
+    else  throw IException(IException::Programmer,
+                           "Unknown error propagation method enum [" + toString(method) + "].",
+                           _FILEINFO_);
+  }
+
+
+  /**
+   * Converts the given string value to a BundleSettings::SolveMethod
+   * enumeration. Currently accepted inputs are listed below. This method is
+   * case insensitive.
+   * <ul>
+   *   <li>Cholesky</li>
+   *   <li>ConjugateGradient</li>
+   * </ul>
+   *
+   * @param method Solve method name to be converted.
+   *
+   * @return @b SolveMethod The enumeration corresponding to the given name.
+   *
+   * @throw Isis::Exception::Programmer "Unknown solve method."
+   */
+  BundleSettings::SolveMethod BundleSettings::stringToSolveMethod(QString method) {
+    if (method.compare("CHOLESKY", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::Cholesky;
+    }
+    else if (method.compare("CONJUGATEGRADIENT", Qt::CaseInsensitive) == 0) {
+      return BundleSettings::ConjugateGradient;
+    }
+    else throw IException(IException::Programmer,
+                          "Unknown solve method [" + method + "].",
+                          _FILEINFO_);
+  }
+
+
+  /**
+   * Converts the given BundleSettings::SolveMethod enumeration to a string.
+   *
+   * @param method The SolveMethod enumeration to be converted.
+   *
+   * @return @b QString The name associated with the given solve method.
+   *
+   * @throw Isis::Exception::Programmer "Unknown solve method enum."
+   */
+  QString BundleSettings::solveMethodToString(BundleSettings::SolveMethod method) {
+    if (method == Cholesky)               return "Cholesky";
+    else if (method == ConjugateGradient) return "ConjugateGradient";
+    else  throw IException(IException::Programmer,
+                           "Unknown solve method enum [" + toString(method) + "].",
+                           _FILEINFO_);
+  }
+
+
   /**
    * Retrieves the outlier rejection multiplier for the bundle adjustment.
    *
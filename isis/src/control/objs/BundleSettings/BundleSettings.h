@@ -151,6 +151,33 @@ namespace Isis {
       //============================ Solve options ==========================//
       //=====================================================================//
 
+      /**
+       * This enum defines how error propagation computes the covariances of
+       * the parameters.
+       */
+      enum ErrorPropagationMethod {
+        ColumnSolves,    /**< Solve for the inverse of the normals one column at a time.*/
+        BlockSolves,     /**< Solve for the inverse of the normals one block column at a
+                              time.*/
+        SelectedInverse  /**< Compute only the blocks of the inverse of the normals that the
+                              image and point sigmas need.*/
+      };
+
+      static ErrorPropagationMethod stringToErrorPropagationMethod(QString method);
+      static QString errorPropagationMethodToString(ErrorPropagationMethod method);
+
+      /**
+       * This enum defines how the reduced normal equations are solved.
+       */
+      enum SolveMethod {
+        Cholesky,          /**< Factor the normal equations with CHOLMOD.*/
+        ConjugateGradient  /**< Solve the normal equations with block Jacobi preconditioned
+                                conjugate gradients, without factoring them.*/
+      };
+
+      static SolveMethod stringToSolveMethod(QString method);
+      static QString solveMethodToString(SolveMethod method);
+
       // mutators
       void setSolveOptions(bool solveObservationMode = false,
                            bool updateCubeLabel = false,
@@ -165,11 +192,21 @@ namespace Isis {
                                double multiplier = 1.0);
       void setObservationSolveOptions(QList<BundleObservationSolveSettings> obsSolveSettingsList);
       void setCreateInverseMatrix(bool createMatrix);
+      void setThreadedNormalEquations(bool threaded);
+      void setErrorPropagationMethod(ErrorPropagationMethod method);
+      void setSolveMethod(SolveMethod method,
+                          double conjugateGradientTolerance = 1.0e-10,
+                          int conjugateGradientMaximumIterations = 1000);
 
       // accessors
       SurfacePoint::CoordinateType controlPointCoordTypeReports() const;
       SurfacePoint::CoordinateType controlPointCoordTypeBundle() const;
       bool createInverseMatrix() const;
+      bool threadedNormalEquations() const;
+      ErrorPropagationMethod errorPropagationMethod() const;
+      SolveMethod solveMethod() const;
+      double conjugateGradientTolerance() const;
+      int conjugateGradientMaximumIterations() const;
       bool solveObservationMode() const;
       bool solveRadius() const;
       bool updateCubeLabel() const;
@@ -350,6 +387,14 @@ namespace Isis {
       bool m_updateCubeLabel; //!< Indicates whether to update cubes.
       bool m_errorPropagation; //!< Indicates whether to perform error propagation.
       bool m_createInverseMatrix; //!< Indicates whether to create the inverse matrix file.
+      bool m_threadedNormalEquations; //!< Indicates whether to form the normals with threads.
+      ErrorPropagationMethod m_errorPropagationMethod; /**< How error propagation computes the
+                                                            parameter covariances.*/
+      SolveMethod m_solveMethod; //!< How the reduced normal equations are solved.
+      double m_conjugateGradientTolerance; /**< The residual norm, relative to the right hand
+                                                side, where conjugate gradients stop.*/
+      int m_conjugateGradientMaximumIterations; /**< The most conjugate gradient iterations for
+                                                     each bundle iteration.*/
       bool m_outlierRejection; /**< Indicates whether to perform automatic
                                     outlier detection/rejection.*/
       double m_outlierRejectionMultiplier; /**< The multiplier value for outlier rejection.
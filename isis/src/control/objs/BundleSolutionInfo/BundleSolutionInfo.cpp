@@ -984,6 +984,19 @@ namespace Isis {
       fpOut << buf;
     }
 
+    QList<int> solverIterations = m_statisticsResults->solverIterations();
+    QList<double> solverResiduals = m_statisticsResults->solverResiduals();
+    for (int i = 0; i < solverIterations.size(); i++) {
+      sprintf(buf, "\n   Solver Iterations (Iter %3d): %6d  Relative Residual: %g",
+                    i + 1, solverIterations[i], solverResiduals[i]);
+      fpOut << buf;
+
+      if (solverResiduals[i] > m_settings->conjugateGradientTolerance()) {
+        sprintf(buf, "(Maximum reached)");
+        fpOut << buf;
+      }
+    }
+
     sprintf(buf, "\n                         Sigma0: %30.20lf\n", m_statisticsResults->sigma0());
     fpOut << buf;
     sprintf(buf, " Error Propagation Elapsed Time: %6.4lf (seconds)\n",
@@ -302,13 +302,15 @@ namespace Isis {
    * @param ptfile Name of file containing a Pvl list of control points
    * @param pvl    Boolean indicating whether to write in pvl format
    *               (Default=false)
+   * @param indexed Boolean indicating whether to write a binary network with
+   *                an index for ControlNetPointReader (Default=false)
    *
    * @history 2010-10-05 Tracie Sucharski - Renamed old WRite method to WritePvl
    *                     and created this new method to determine format to
    *                     be written.
    * @history 2017-12-21 Jesse Mapel - Modified to use new ControlNetVersioner.
    */
-  void ControlNet::Write(const QString &ptfile, bool pvl) {
+  void ControlNet::Write(const QString &ptfile, bool pvl, bool indexed) {
     ControlNetVersioner versionedWriter(this);
 
     if (pvl) {
@@ -331,7 +333,7 @@ namespace Isis {
     }
     else {
       try {
-        versionedWriter.write(FileName(ptfile));
+        versionedWriter.write(FileName(ptfile), indexed);
       }
       catch (IException &e) {
         QString msg = "Failed writing control network to file [" + ptfile + "]";
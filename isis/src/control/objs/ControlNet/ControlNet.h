@@ -287,7 +287,7 @@ namespace Isis {
       QList< ControlPoint * > take();
 
       void ReadControl(const QString &filename, Progress *progress = 0);
-      void Write(const QString &filename, bool pvl = false);
+      void Write(const QString &filename, bool pvl = false, bool indexed = false);
 
       void AddPoint(ControlPoint *point);
       int DeletePoint(ControlPoint *point);
@@ -0,0 +1,449 @@
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include "ControlNetPointReader.h"
+
+#include <QMutexLocker>
+#include <QSharedPointer>
+
+#include "ControlNetFileHeaderV0005.pb.h"
+#include "ControlNetFileIndexV0006.pb.h"
+#include "ControlPointFileEntryV0002.pb.h"
+
+#include "ControlNetVersioner.h"
+#include "ControlPoint.h"
+#include "EndianSwapper.h"
+#include "IException.h"
+#include "IString.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "PvlObject.h"
+
+using namespace std;
+
+namespace Isis {
+  /**
+   * Opens a binary control network and reads its header and index.
+   *
+   * @param netFile The control network file
+   */
+  ControlNetPointReader::ControlNetPointReader(const FileName &netFile) {
+    m_netFile = netFile;
+
+    try {
+      Pvl label(netFile.expanded());
+      if ( !label.hasObject("ProtoBuffer") ) {
+        QString msg = "Only binary control networks can be read point by point";
+        throw IException(IException::User, msg, _FILEINFO_);
+      }
+
+      const PvlObject &protoBuf = label.findObject("ProtoBuffer");
+      const PvlObject &protoCore = protoBuf.findObject("Core");
+      const PvlGroup &netInfo = protoBuf.findGroup("ControlNetworkInfo");
+
+      m_version = netInfo.hasKeyword("Version") ? toInt(netInfo["Version"][0]) : 1;
+      if (m_version != 5 && m_version != 6) {
+        QString msg = "The binary control network version [" + toString(m_version) +
+                      "] can not be read point by point. Only versions 5 and 6 can.";
+        throw IException(IException::User, msg, _FILEINFO_);
+      }
+
+      m_input.open(netFile.expanded().toLatin1().data(), ios::in | ios::binary);
+      if ( !m_input.is_open() ) {
+        QString msg = "Failed to open the control network file";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+
+      readHeader(protoCore);
+      if (m_version == 6) {
+        readIndex(protoCore);
+      }
+      else {
+        buildIndex(protoCore);
+      }
+    }
+    catch (IException &e) {
+      QString msg = "Reading the control network [" + netFile.name() + "] failed";
+      throw IException(e, IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  //! Closes the network file
+  ControlNetPointReader::~ControlNetPointReader() {
+  }
+
+
+  /**
+   * @return @b int The version of the network file
+   */
+  int ControlNetPointReader::version() const {
+    return m_version;
+  }
+
+
+  /**
+   * @return @b QString The network id
+   */
+  QString ControlNetPointReader::netId() const {
+    return m_netId;
+  }
+
+
+  /**
+   * @return @b QString The name of the network's target
+   */
+  QString ControlNetPointReader::targetName() const {
+    return m_targetName;
+  }
+
+
+  /**
+   * @return @b QString When the network was created
+   */
+  QString ControlNetPointReader::creationDate() const {
+    return m_created;
+  }
+
+
+  /**
+   * @return @b QString When the network was last modified
+   */
+  QString ControlNetPointReader::lastModificationDate() const {
+    return m_lastModified;
+  }
+
+
+  /**
+   * @return @b QString The network description
+   */
+  QString ControlNetPointReader::description() const {
+    return m_description;
+  }
+
+
+  /**
+   * @return @b QString The user or program that last modified the network
+   */
+  QString ControlNetPointReader::userName() const {
+    return m_userName;
+  }
+
+
+  /**
+   * @return @b int The number of points in the network
+   */
+  int ControlNetPointReader::numPoints() const {
+    return m_pointIds.size();
+  }
+
+
+  /**
+   * @param index The position of the point in the file, from 0
+   *
+   * @return @b QString The id of the point
+   */
+  QString ControlNetPointReader::pointId(int index) const {
+    if (index < 0 || index >= m_pointIds.size()) {
+      QString msg = "The control point index [" + toString(index) + "] is out of range";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+    return m_pointIds[index];
+  }
+
+
+  /**
+   * @param id A point id
+   *
+   * @return @b int The position of the point in the file, or -1 if the network
+   *                does not have the point
+   */
+  int ControlNetPointReader::pointIndex(const QString &id) const {
+    return m_pointIndices.value(id, -1);
+  }
+
+
+  /**
+   * @return @b QStringList The serial numbers of the measured images, in the
+   *                        order they first appear in the network
+   */
+  QStringList ControlNetPointReader::serialNumbers() const {
+    return m_serialNumbers;
+  }
+
+
+  /**
+   * @param serialNumber An image serial number
+   *
+   * @return @b QVector<int> The positions of the points with a measure in the
+   *                         image, in file order
+   */
+  QVector<int> ControlNetPointReader::pointIndices(const QString &serialNumber) const {
+    return m_serialPoints.value(serialNumber);
+  }
+
+
+  /**
+   * Reads a control point from the file. The caller owns the point.
+   *
+   * @param index The position of the point in the file, from 0
+   *
+   * @return @b ControlPoint* The point
+   */
+  ControlPoint *ControlNetPointReader::readPoint(int index) {
+    if (index < 0 || index >= m_pointOffsets.size()) {
+      QString msg = "The control point index [" + toString(index) + "] is out of range";
+      throw IException(IException::Programmer, msg, _FILEINFO_);
+    }
+
+    QSharedPointer<ControlPointFileEntryV0002> protoPoint(new ControlPointFileEntryV0002);
+    {
+      QMutexLocker locker(&m_inputMutex);
+      string bytes;
+      readPointBytes(m_pointOffsets[index], bytes);
+      if ( !protoPoint->ParseFromString(bytes) ) {
+        QString msg = "Failed to parse the control point [" + m_pointIds[index] +
+                      "] in the control network [" + m_netFile.name() + "]";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+    }
+
+    try {
+      ControlNetVersioner::ControlPointV0005 point(protoPoint);
+      return ControlNetVersioner::createPoint(point);
+    }
+    catch (IException &e) {
+      QString msg = "Failed to convert the control point [" + m_pointIds[index] +
+                    "] into a ControlPoint";
+      throw IException(e, IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Reads a control point from the file. The caller owns the point.
+   *
+   * @param id The id of the point
+   *
+   * @return @b ControlPoint* The point
+   */
+  ControlPoint *ControlNetPointReader::readPoint(const QString &id) {
+    int index = pointIndex(id);
+    if (index < 0) {
+      QString msg = "The control network [" + m_netFile.name() +
+                    "] does not have a control point with id [" + id + "]";
+      throw IException(IException::User, msg, _FILEINFO_);
+    }
+    return readPoint(index);
+  }
+
+
+  /**
+   * Reads every control point with a measure in an image. The caller owns the
+   * points.
+   *
+   * @param serialNumber The serial number of the image
+   *
+   * @return @b QList<ControlPoint*> The points, in file order. This is empty if
+   *                                 the image is not in the network.
+   */
+  QList<ControlPoint *> ControlNetPointReader::readPoints(const QString &serialNumber) {
+    QList<ControlPoint *> points;
+    try {
+      foreach (int index, pointIndices(serialNumber)) {
+        points.append(readPoint(index));
+      }
+    }
+    catch (...) {
+      qDeleteAll(points);
+      throw;
+    }
+    return points;
+  }
+
+
+  /**
+   * Reads the general network information from the protobuf header.
+   *
+   * @param protoCore The Core object of the label
+   */
+  void ControlNetPointReader::readHeader(const PvlObject &protoCore) {
+    string bytes;
+    readBytes(toBigInt(protoCore["HeaderStartByte"][0]),
+              toBigInt(protoCore["HeaderBytes"][0]), bytes);
+
+    ControlNetFileHeaderV0005 protoHeader;
+    if ( !protoHeader.ParseFromString(bytes) ) {
+      QString msg = "Failed to parse the protobuf header";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    m_netId = protoHeader.networkid().c_str();
+    m_targetName = protoHeader.targetname().c_str();
+    m_created = protoHeader.created().c_str();
+    m_lastModified = protoHeader.lastmodified().c_str();
+    m_description = protoHeader.description().c_str();
+    m_userName = protoHeader.username().c_str();
+
+    // Match the target name ControlNetVersioner gives old MRO networks
+    if ( m_targetName.startsWith("MRO/") ) {
+      m_targetName = "Mars";
+    }
+  }
+
+
+  /**
+   * Reads the index that follows the points of a version 6 network.
+   *
+   * @param protoCore The Core object of the label
+   */
+  void ControlNetPointReader::readIndex(const PvlObject &protoCore) {
+    if ( !protoCore.hasKeyword("IndexStartByte") || !protoCore.hasKeyword("IndexBytes") ) {
+      QString msg = "The version 6 control network does not have an index";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    string bytes;
+    readBytes(toBigInt(protoCore["IndexStartByte"][0]),
+              toBigInt(protoCore["IndexBytes"][0]), bytes);
+
+    ControlNetFileIndexV0006 protoIndex;
+    if ( !protoIndex.ParseFromString(bytes) ) {
+      QString msg = "Failed to parse the control network index";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+    bytes.clear();
+
+    int numPoints = protoIndex.points_size();
+    m_pointIds.resize(numPoints);
+    m_pointOffsets.resize(numPoints);
+    m_pointIndices.reserve(numPoints);
+    for (int i = 0; i < numPoints; i++) {
+      const ControlNetFileIndexV0006_PointEntry &pointEntry = protoIndex.points(i);
+      m_pointIds[i] = pointEntry.id().c_str();
+      m_pointOffsets[i] = pointEntry.offset();
+      m_pointIndices.insert(m_pointIds[i], i);
+    }
+
+    if (protoIndex.serialpoints_size() != protoIndex.serialnumbers_size()) {
+      QString msg = "The control network index has [" +
+                    toString(protoIndex.serialnumbers_size()) + "] serial numbers but [" +
+                    toString(protoIndex.serialpoints_size()) + "] point lists";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+
+    for (int i = 0; i < protoIndex.serialnumbers_size(); i++) {
+      QString serialNumber = protoIndex.serialnumbers(i).c_str();
+      const ControlNetFileIndexV0006_SerialEntry &serialEntry = protoIndex.serialpoints(i);
+
+      QVector<int> &points = m_serialPoints[serialNumber];
+      points.reserve(serialEntry.pointindices_size());
+      for (int j = 0; j < serialEntry.pointindices_size(); j++) {
+        int index = serialEntry.pointindices(j);
+        if (index < 0 || index >= numPoints) {
+          QString msg = "The control network index has an invalid point index [" +
+                        toString(index) + "] for serial number [" + serialNumber + "]";
+          throw IException(IException::Io, msg, _FILEINFO_);
+        }
+        points.append(index);
+      }
+      m_serialNumbers.append(serialNumber);
+    }
+  }
+
+
+  /**
+   * Builds the index of a version 5 network by reading through its points.
+   * Each point message is parsed for its id and serial numbers and then
+   * discarded.
+   *
+   * @param protoCore The Core object of the label
+   */
+  void ControlNetPointReader::buildIndex(const PvlObject &protoCore) {
+    BigInt offset = toBigInt(protoCore["PointsStartByte"][0]);
+    BigInt pointsEnd = offset + toBigInt(protoCore["PointsBytes"][0]);
+
+    string bytes;
+    ControlPointFileEntryV0002 protoPoint;
+    while (offset < pointsEnd) {
+      BigInt pointOffset = offset;
+      offset += readPointBytes(pointOffset, bytes);
+
+      if ( !protoPoint.ParseFromString(bytes) ) {
+        QString msg = "Failed to parse the control point at index [" +
+                      toString(m_pointIds.size()) + "]";
+        throw IException(IException::Io, msg, _FILEINFO_);
+      }
+
+      int index = m_pointIds.size();
+      QString id = protoPoint.id().c_str();
+      m_pointIds.append(id);
+      m_pointOffsets.append(pointOffset);
+      m_pointIndices.insert(id, index);
+
+      for (int i = 0; i < protoPoint.measures_size(); i++) {
+        QString serialNumber = protoPoint.measures(i).serialnumber().c_str();
+        QHash<QString, QVector<int> >::iterator points = m_serialPoints.find(serialNumber);
+        if ( points == m_serialPoints.end() ) {
+          points = m_serialPoints.insert(serialNumber, QVector<int>());
+          m_serialNumbers.append(serialNumber);
+        }
+        // A point only measures an image once, so this keeps the lists unique
+        if ( points->isEmpty() || points->last() != index ) {
+          points->append(index);
+        }
+      }
+    }
+  }
+
+
+  /**
+   * Reads a block of the file. The caller must hold the input mutex, or be
+   * the constructor.
+   *
+   * @param offset The file position of the block
+   * @param size The number of bytes in the block
+   * @param bytes Set to the contents of the block
+   */
+  void ControlNetPointReader::readBytes(BigInt offset, BigInt size, string &bytes) {
+    bytes.resize(size);
+    m_input.clear();
+    m_input.seekg(offset, ios::beg);
+    if (size > 0) {
+      m_input.read(&bytes[0], size);
+    }
+
+    if ( !m_input ) {
+      QString msg = "Failed to read [" + toString(size) + "] bytes at byte [" +
+                    toString(offset) + "] of the control network file [" +
+                    m_netFile.name() + "]";
+      throw IException(IException::Io, msg, _FILEINFO_);
+    }
+  }
+
+
+  /**
+   * Reads the message of a point and the size before it. The caller must hold
+   * the input mutex, or be the constructor.
+   *
+   * @param offset The file position of the size before the point message
+   * @param bytes Set to the point message
+   *
+   * @return @b BigInt The number of bytes read, including the size
+   */
+  BigInt ControlNetPointReader::readPointBytes(BigInt offset, string &bytes) {
+    string sizeBytes;
+    readBytes(offset, sizeof(uint32_t), sizeBytes);
+
+    EndianSwapper lsb("LSB");
+    uint32_t size = lsb.Uint32_t(&sizeBytes[0]);
+
+    readBytes(offset + sizeof(uint32_t), size, bytes);
+    return sizeof(uint32_t) + (BigInt) size;
+  }
+}
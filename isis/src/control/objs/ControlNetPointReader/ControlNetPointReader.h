@@ -0,0 +1,98 @@
+#ifndef ControlNetPointReader_h
+#define ControlNetPointReader_h
+/** This is free and unencumbered software released into the public domain.
+The authors of ISIS do not claim copyright on the contents of this file.
+For more details about the LICENSE terms and the AUTHORS, you will
+find files of those names at the top level of this repository. **/
+
+/* SPDX-License-Identifier: CC0-1.0 */
+
+#include <fstream>
+#include <string>
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "Constants.h"
+#include "FileName.h"
+
+namespace Isis {
+  class ControlPoint;
+  class PvlObject;
+
+  /**
+   * @brief Reads control points from a binary control network on demand
+   *
+   * Opening a network with ControlNet creates every control point in it
+   * before any of them can be used, which takes a long time and a lot of
+   * memory for large networks. This class only reads the network's index
+   * when it is created and then reads single points, by position or id, or
+   * all of the points measured in one image, when they are asked for.
+   *
+   * Version 6 binary networks, written with ControlNet::Write or
+   * ControlNetVersioner::write with the indexed flag set, store the index
+   * after their control points. For version 5 binary networks the index is
+   * built by reading through the points once without creating them. Older
+   * and Pvl networks are not supported.
+   *
+   * The points may be read from several threads at once.
+   *
+   * @ingroup ControlNetwork
+   */
+  class ControlNetPointReader {
+    public:
+      ControlNetPointReader(const FileName &netFile);
+      ~ControlNetPointReader();
+
+      int version() const;
+
+      QString netId() const;
+      QString targetName() const;
+      QString creationDate() const;
+      QString lastModificationDate() const;
+      QString description() const;
+      QString userName() const;
+
+      int numPoints() const;
+      QString pointId(int index) const;
+      int pointIndex(const QString &id) const;
+
+      QStringList serialNumbers() const;
+      QVector<int> pointIndices(const QString &serialNumber) const;
+
+      ControlPoint *readPoint(int index);
+      ControlPoint *readPoint(const QString &id);
+      QList<ControlPoint *> readPoints(const QString &serialNumber);
+
+    private:
+      Q_DISABLE_COPY(ControlNetPointReader)
+
+      void readHeader(const PvlObject &protoCore);
+      void readIndex(const PvlObject &protoCore);
+      void buildIndex(const PvlObject &protoCore);
+      void readBytes(BigInt offset, BigInt size, std::string &bytes);
+      BigInt readPointBytes(BigInt offset, std::string &bytes);
+
+      FileName m_netFile;                         //!< The network file
+      std::ifstream m_input;                      //!< The open network file
+      QMutex m_inputMutex;                        //!< Serializes reads of the file
+      int m_version;                              //!< The network file version
+      QString m_netId;                            //!< The network id
+      QString m_targetName;                       //!< The target of the network
+      QString m_created;                          //!< When the network was created
+      QString m_lastModified;                     //!< When the network was last modified
+      QString m_description;                      //!< The network description
+      QString m_userName;                         //!< Who last modified the network
+      QVector<QString> m_pointIds;                //!< The id of each point
+      QVector<BigInt> m_pointOffsets;             //!< The file position of each point
+      QHash<QString, int> m_pointIndices;         //!< The index of each point by id
+      QStringList m_serialNumbers;                //!< The measured images
+      QHash<QString, QVector<int> > m_serialPoints; //!< The points measured in each image
+  };
+}
+
+#endif
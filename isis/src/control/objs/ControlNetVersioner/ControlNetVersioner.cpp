@@ -12,10 +12,12 @@ find files of those names at the top level of this repository. **/
 #include <boost/numeric/ublas/io.hpp>
 
 #include <QDebug>
+#include <QHash>
 #include <QString>
 
 #include "ControlNetFileHeaderV0002.pb.h"
 #include "ControlNetFileHeaderV0005.pb.h"
+#include "ControlNetFileIndexV0006.pb.h"
 #include "ControlNetLogDataProtoV0001.pb.h"
 #include "ControlPointFileEntryV0002.pb.h"
 
@@ -891,6 +893,8 @@ namespace Isis {
         readProtobufV0002(header, netFile, progress);
         break;
       case 5:
+      case 6:
+        // Version 6 only adds an index after the version 5 points
         readProtobufV0005(header, netFile, progress);
         break;
       default:
@@ -1654,9 +1658,11 @@ namespace Isis {
    * This will write a control net file object to disk.
    *
    * @param netFile The output filename that will be written to
+   * @param indexed If true, write a version 6 network with an index of the
+   *                points after them. Otherwise write a version 5 network.
    *
    */
-  void ControlNetVersioner::write(FileName netFile) {
+  void ControlNetVersioner::write(FileName netFile, bool indexed) {
     try {
 
       const int labelBytes = 65536;
@@ -1676,9 +1682,39 @@ namespace Isis {
 
       writeHeader(&output);
 
+      ControlNetFileIndexV0006 protoIndex;
+      QHash<QString, int> serialIndices;
+
       BigInt pointByteTotal = 0;
       while ( !m_points.isEmpty() ) {
-         pointByteTotal += writeFirstPoint(&output);
+        if (indexed) {
+          // The point is deleted once it is written, so index it first
+          ControlPoint *point = m_points.first();
+          int pointIndex = protoIndex.points_size();
+
+          ControlNetFileIndexV0006_PointEntry *pointEntry = protoIndex.add_points();
+          pointEntry->set_id(point->GetId().toLatin1().data());
+          pointEntry->set_offset((BigInt) output.tellp());
+
+          foreach (QString serialNumber, point->getCubeSerialNumbers()) {
+            int serialIndex = serialIndices.value(serialNumber, -1);
+            if (serialIndex < 0) {
+              serialIndex = protoIndex.serialnumbers_size();
+              serialIndices.insert(serialNumber, serialIndex);
+              protoIndex.add_serialnumbers(serialNumber.toLatin1().data());
+              protoIndex.add_serialpoints();
+            }
+            protoIndex.mutable_serialpoints(serialIndex)->add_pointindices(pointIndex);
+          }
+        }
+
+        pointByteTotal += writeFirstPoint(&output);
+      }
+
+      BigInt indexStartByte = (BigInt) output.tellp();
+      if ( indexed && !protoIndex.SerializeToOstream(&output) ) {
+        QString msg = "Failed to write the control network index.";
+        throw IException(IException::Io, msg, _FILEINFO_);
       }
 
       // Insert header at the beginning of the file once writing is done.
@@ -1708,6 +1744,12 @@ namespace Isis {
 
       protoCore.addKeyword(PvlKeyword("PointsBytes",
                            toString(pointByteTotal)));
+
+      if (indexed) {
+        protoCore.addKeyword(PvlKeyword("IndexStartByte", toString(indexStartByte)));
+        protoCore.addKeyword(PvlKeyword("IndexBytes",
+                             toString((BigInt) protoIndex.ByteSize())));
+      }
       protoObj.addObject(protoCore);
 
       PvlGroup netInfo("ControlNetworkInfo");
@@ -1720,7 +1762,7 @@ namespace Isis {
       netInfo += PvlKeyword("Description", protobufHeader.description().c_str());
       netInfo += PvlKeyword("NumberOfPoints", toString(numPoints));
       netInfo += PvlKeyword("NumberOfMeasures", toString(numMeasures));
-      netInfo += PvlKeyword("Version", "5");
+      netInfo += PvlKeyword("Version", indexed ? "6" : "5");
       protoObj.addGroup(netInfo);
 
       p.addObject(protoObj);
@@ -342,6 +342,27 @@ namespace Isis {
    *   <em>ControlNetFileHeaderV0005.proto</em> instead of
    *   <em>ControlNetFileHeaderV0003.proto</em>.
    *
+   * <b>Version 6</b>
+   *
+   *   This version was created so that single control points, or all of the
+   *   control points measured in one image, can be read from large binary
+   *   control network files without reading the whole network. It is only
+   *   written when an index is requested; otherwise networks are still
+   *   written as version 5.
+   *
+   *   Version 6 binary control network files are formatted the same as
+   *   version 5 binary control network files except that an index protobuf
+   *   message follows the control point messages. The index holds the id and
+   *   file position of each control point, and the serial numbers of the
+   *   measured images with the indices of the points measured in each one.
+   *   Its position and size are stored in the IndexStartByte and IndexBytes
+   *   keywords of the Protobuf Core. The structure of the index is defined by
+   *   <em>ControlNetFileIndexV0006.proto</em>. ControlNetVersioner reads
+   *   version 6 files the same way as version 5 files and ignores the index;
+   *   ControlNetPointReader uses it to read points on demand.
+   *
+   *   There are no version 6 Pvl control network files.
+   *
    * @ingroup ControlNetwork
    *
    * @author 2011-04-05 Steven Lambright
@@ -426,10 +447,12 @@ namespace Isis {
       int numPoints() const;
       ControlPoint *takeFirstPoint();
 
-      void write(FileName netFile);
+      void write(FileName netFile, bool indexed=false);
       Pvl toPvl();
 
     private:
+      friend class ControlNetPointReader;
+
       // These three methods are private to ensure proper memory management
       //! Default constructor. Intentially un-implemented.
       ControlNetVersioner();
@@ -502,11 +525,11 @@ namespace Isis {
       void readProtobufV0002(const Pvl &header, const FileName netFile, Progress *progress=NULL);
       void readProtobufV0005(const Pvl &header, const FileName netFile, Progress *progress=NULL);
 
-      ControlPoint *createPoint(ControlPointV0001 &point);
-      ControlPoint *createPoint(ControlPointV0002 &point);
-      ControlPoint *createPoint(ControlPointV0003 &point);
+      static ControlPoint *createPoint(ControlPointV0001 &point);
+      static ControlPoint *createPoint(ControlPointV0002 &point);
+      static ControlPoint *createPoint(ControlPointV0003 &point);
 
-      ControlMeasure *createMeasure(const ControlPointFileEntryV0002_Measure&);
+      static ControlMeasure *createMeasure(const ControlPointFileEntryV0002_Measure&);
 
       void createHeader(const ControlNetHeaderV0001 header);
 
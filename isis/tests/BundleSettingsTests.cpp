@@ -130,6 +130,15 @@ class ConvergenceCriteriaTest : public ::testing::TestWithParam<BundleSettings::
   // Intentionally empty
 };
 
+class ErrorPropagationMethodTest :
+      public ::testing::TestWithParam<BundleSettings::ErrorPropagationMethod> {
+  // Intentionally empty
+};
+
+class SolveMethodTest : public ::testing::TestWithParam<BundleSettings::SolveMethod> {
+  // Intentionally empty
+};
+
 TEST(BundleSettings, DefaultConstructor) {
   BundleSettings testSettings;
 
@@ -637,6 +646,52 @@ INSTANTIATE_TEST_SUITE_P(
       ::testing::Values(BundleSettings::Sigma0, BundleSettings::ParameterCorrections)
 );
 
+TEST_P(ErrorPropagationMethodTest, errorPropagationMethodStrings) {
+  QString methodString = BundleSettings::errorPropagationMethodToString(GetParam());
+  BundleSettings::ErrorPropagationMethod method =
+        BundleSettings::stringToErrorPropagationMethod(methodString);
+  EXPECT_EQ(GetParam(), method);
+}
+
+TEST_P(ErrorPropagationMethodTest, errorPropagationMethod) {
+  BundleSettings testSettings;
+  EXPECT_EQ(BundleSettings::ColumnSolves, testSettings.errorPropagationMethod());
+  testSettings.setErrorPropagationMethod(GetParam());
+  EXPECT_EQ(GetParam(), testSettings.errorPropagationMethod());
+  BundleSettings copySettings(testSettings);
+  EXPECT_EQ(GetParam(), copySettings.errorPropagationMethod());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+      BundleSettings,
+      ErrorPropagationMethodTest,
+      ::testing::Values(BundleSettings::ColumnSolves, BundleSettings::BlockSolves,
+                        BundleSettings::SelectedInverse)
+);
+
+TEST_P(SolveMethodTest, solveMethodStrings) {
+  QString methodString = BundleSettings::solveMethodToString(GetParam());
+  BundleSettings::SolveMethod method = BundleSettings::stringToSolveMethod(methodString);
+  EXPECT_EQ(GetParam(), method);
+}
+
+TEST_P(SolveMethodTest, solveMethod) {
+  BundleSettings testSettings;
+  EXPECT_EQ(BundleSettings::Cholesky, testSettings.solveMethod());
+  testSettings.setSolveMethod(GetParam(), 1.0e-8, 200);
+  EXPECT_EQ(GetParam(), testSettings.solveMethod());
+  EXPECT_EQ(1.0e-8, testSettings.conjugateGradientTolerance());
+  EXPECT_EQ(200, testSettings.conjugateGradientMaximumIterations());
+  BundleSettings copySettings(testSettings);
+  EXPECT_EQ(GetParam(), copySettings.solveMethod());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+      BundleSettings,
+      SolveMethodTest,
+      ::testing::Values(BundleSettings::Cholesky, BundleSettings::ConjugateGradient)
+);
+
 TEST(BundleSettings, maximumLikelihoodHuber) {
   BundleSettings testSettings;
   testSettings.addMaximumLikelihoodEstimatorModel(
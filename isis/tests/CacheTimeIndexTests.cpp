@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <vector>
+
+#include "CacheTimeIndex.h"
+#include "IException.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST(CacheTimeIndex, Interval) {
+  // Unevenly spaced, like a cache reduced to a Hermite spline
+  std::vector<double> times = {10.0, 10.5, 10.6, 10.7, 14.0, 14.1, 20.0};
+
+  CacheTimeIndex index;
+  EXPECT_TRUE(index.isEmpty());
+  index.build(times);
+  EXPECT_FALSE(index.isEmpty());
+  EXPECT_EQ(index.times(), times);
+
+  for (double et = 10.0; et < 20.0; et += 0.05) {
+    int expected = (int)(std::upper_bound(times.begin(), times.end(), et) - times.begin()) - 1;
+    EXPECT_EQ(index.interval(et), expected) << "et = " << et;
+  }
+
+  // Cache times start their interval, except the last
+  EXPECT_EQ(index.interval(10.7), 3);
+  EXPECT_EQ(index.interval(14.0), 4);
+  EXPECT_EQ(index.interval(20.0), 5);
+
+  // Times outside the cache use the end intervals
+  EXPECT_EQ(index.interval(-100.0), 0);
+  EXPECT_EQ(index.interval(100.0), 5);
+
+  index.clear();
+  EXPECT_TRUE(index.isEmpty());
+}
+
+TEST(CacheTimeIndex, Errors) {
+  CacheTimeIndex index;
+  EXPECT_THROW(index.build(std::vector<double>(1, 0.0)), IException);
+  EXPECT_THROW(index.build(std::vector<double>{0.0, 1.0, 1.0}), IException);
+  EXPECT_THROW(index.build(std::vector<double>{0.0, 2.0, 1.0}), IException);
+}
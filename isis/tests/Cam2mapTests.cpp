@@ -1,11 +1,17 @@
 #include <iostream>
 #include <QTemporaryFile>
+#include <QThreadPool>
 
 #include "cam2map.h"
 
+#include "Camera.h"
+#include "CameraFactory.h"
 #include "Cube.h"
 #include "CubeAttribute.h"
 #include "IException.h"
+#include "LineManager.h"
+#include "LineScanCamera.h"
+#include "LineScanCameraGroundMap.h"
 #include "PixelType.h"
 #include "Pvl.h"
 #include "PvlGroup.h"
@@ -13,6 +19,7 @@
 #include "TestUtilities.h"
 #include "FileName.h"
 #include "ProjectionFactory.h"
+#include "TProjection.h"
 #include "Fixtures.h"
 #include "Mocks.h"
 
@@ -80,6 +87,62 @@ TEST_F(DefaultCube, FunctionalTestCam2mapDefault) {
   ASSERT_EQ(cubeMapGroup.findKeyword("Scale"), userGrp.findKeyword("Scale"));
 }
 
+TEST_F(DefaultCube, FunctionalTestCam2mapThreadedMatchesSerial) {
+  std::istringstream labelStrm(R"(
+    Group = Mapping
+      ProjectionName  = Sinusoidal
+      CenterLongitude = 0.0 <degrees>
+
+      TargetName         = MARS
+      EquatorialRadius   = 3396190.0 <meters>
+      PolarRadius        = 3376200.0 <meters>
+
+      LatitudeType       = Planetocentric
+      LongitudeDirection = PositiveEast
+      LongitudeDomain    = 360 <degrees>
+    End_Group
+  )");
+
+  Pvl serialMap;
+  labelStrm >> serialMap;
+  Pvl threadedMap = serialMap;
+
+  QVector<QString> serialArgs = {"to="+tempDir.path()+"/serial.cub"};
+  UserInterface serialUi(APP_XML, serialArgs);
+  Pvl serialLog;
+  cam2map(testCube, serialMap, serialMap.findGroup("Mapping", Pvl::Traverse), serialUi,
+          &serialLog);
+
+  // Make sure there are threads to copy the camera for
+  int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount(4);
+  QVector<QString> threadedArgs = {"to="+tempDir.path()+"/threaded.cub", "threaded=yes"};
+  UserInterface threadedUi(APP_XML, threadedArgs);
+  Pvl threadedLog;
+  cam2map(testCube, threadedMap, threadedMap.findGroup("Mapping", Pvl::Traverse), threadedUi,
+          &threadedLog);
+  QThreadPool::globalInstance()->setMaxThreadCount(threadCount);
+
+  EXPECT_FALSE(threadedLog.hasGroup("Warnings"));
+
+  Cube serialCube(tempDir.path()+"/serial.cub");
+  Cube threadedCube(tempDir.path()+"/threaded.cub");
+  ASSERT_EQ(threadedCube.sampleCount(), serialCube.sampleCount());
+  ASSERT_EQ(threadedCube.lineCount(), serialCube.lineCount());
+
+  LineManager serialLine(serialCube);
+  LineManager threadedLine(threadedCube);
+  for (serialLine.begin(), threadedLine.begin(); !serialLine.end();
+       serialLine++, threadedLine++) {
+    serialCube.read(serialLine);
+    threadedCube.read(threadedLine);
+    for (int i = 0; i < serialLine.size(); i++) {
+      ASSERT_EQ(threadedLine[i], serialLine[i]) << "Line " << serialLine.Line() << ", sample "
+                                                << i + 1;
+    }
+  }
+}
+
 TEST_F(DefaultCube, FunctionalTestCam2mapMismatch) {
   std::istringstream labelStrm(R"(
     Group = Mapping
@@ -218,6 +281,93 @@ TEST_F(LineScannerCube, FunctionalTestCam2mapMapLatlon) {
   ASSERT_EQ(userGrp.findKeyword("UpperLeftCornerY")[0], "59275.496394555");
 }
 
+TEST_F(LineScannerCube, FunctionalTestCam2mapLineScanCachesMatchPlainCamera) {
+  std::istringstream labelStrm(R"(
+    Group = Mapping
+      ProjectionName  = Sinusoidal
+      CenterLongitude = 0.0 <degrees>
+
+      TargetName         = MOON
+      EquatorialRadius   = 1737400.0 <meters>
+      PolarRadius        = 1737400.0 <meters>
+
+      LatitudeType       = Planetocentric
+      LongitudeDirection = PositiveEast
+      LongitudeDomain    = 360 <degrees>
+    End_Group
+  )");
+  Pvl userMap;
+  labelStrm >> userMap;
+  PvlGroup &userGrp = userMap.findGroup("Mapping", Pvl::Traverse);
+
+  QVector<QString> args = {"to="+tempDir.path()+"/level2.cub", "matchmap=no",
+                           "defaultrange=camera", "pixres=camera"};
+  UserInterface ui(APP_XML, args);
+
+  Pvl log;
+
+  cam2map(testCube, userMap, userGrp, ui, &log);
+
+  // cam2map turns its lookup caches on only for the run, so the input camera
+  // is a plain camera again to compare a cached clone against
+  Camera *incam = testCube->camera();
+  Camera *cached = CameraFactory::Clone(*testCube);
+  cached->setIndexedCacheLookup(true);
+  ((LineScanCamera *) cached)->SetLineTimeTable(true);
+  ((LineScanCamera *) cached)->GroundMap()->SetLinePredictor(true);
+
+  Cube ocube(tempDir.path()+"/level2.cub");
+  TProjection *plainMap = (TProjection *) ProjectionFactory::CreateFromCube(ocube);
+  TProjection *cachedMap = (TProjection *) ProjectionFactory::CreateFromCube(ocube);
+
+  cam2mapForward plainForward(testCube->sampleCount(), testCube->lineCount(), incam,
+                              ocube.sampleCount(), ocube.lineCount(), plainMap, false);
+  cam2mapForward cachedForward(testCube->sampleCount(), testCube->lineCount(), cached,
+                               ocube.sampleCount(), ocube.lineCount(), cachedMap, false);
+  cam2mapReverse plainReverse(testCube->sampleCount(), testCube->lineCount(), incam,
+                              ocube.sampleCount(), ocube.lineCount(), plainMap, false, false);
+  cam2mapReverse cachedReverse(testCube->sampleCount(), testCube->lineCount(), cached,
+                               ocube.sampleCount(), ocube.lineCount(), cachedMap, false, false);
+
+  // Forward patches, the default for line scan cameras, only use SetImage
+  int forwardPoints = 0;
+  for (double line = 0.5; line <= testCube->lineCount() + 0.5; line += 0.25) {
+    for (double samp = 0.5; samp <= testCube->sampleCount() + 0.5; samp += 15.5) {
+      double plainSamp, plainLine, cachedSamp, cachedLine;
+      bool plainOk = plainForward.Xform(plainSamp, plainLine, samp, line);
+      bool cachedOk = cachedForward.Xform(cachedSamp, cachedLine, samp, line);
+      ASSERT_EQ(plainOk, cachedOk) << "Input sample " << samp << ", line " << line;
+      if (plainOk) {
+        EXPECT_NEAR(plainSamp, cachedSamp, 1e-4) << "Input sample " << samp << ", line " << line;
+        EXPECT_NEAR(plainLine, cachedLine, 1e-4) << "Input sample " << samp << ", line " << line;
+        forwardPoints++;
+      }
+    }
+  }
+  EXPECT_GT(forwardPoints, 0);
+
+  // Reverse patches also search the line with the predictor, which only
+  // moves the secant start so the result stays within its tolerance
+  int reversePoints = 0;
+  for (int line = 1; line <= ocube.lineCount(); line += 3) {
+    for (int samp = 1; samp <= ocube.sampleCount(); samp += 13) {
+      double plainSamp, plainLine, cachedSamp, cachedLine;
+      bool plainOk = plainReverse.Xform(plainSamp, plainLine, samp, line);
+      bool cachedOk = cachedReverse.Xform(cachedSamp, cachedLine, samp, line);
+      if (plainOk && cachedOk) {
+        EXPECT_NEAR(plainSamp, cachedSamp, 0.05) << "Output sample " << samp << ", line " << line;
+        EXPECT_NEAR(plainLine, cachedLine, 0.05) << "Output sample " << samp << ", line " << line;
+        reversePoints++;
+      }
+    }
+  }
+  EXPECT_GT(reversePoints, 0);
+
+  delete plainMap;
+  delete cachedMap;
+  delete cached;
+}
+
 TEST_F(DefaultCube, ReverseXformUnitTestCam2map) {
   MockCamera camera(*testCube);
   MockTProjection outmap(projLabel);
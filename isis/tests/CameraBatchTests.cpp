@@ -0,0 +1,129 @@
+#include <vector>
+
+#include "Camera.h"
+#include "IException.h"
+#include "SpecialPixel.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST_F(DefaultCube, CameraSetImagesMatchesSetImage) {
+  Camera *cam = testCube->camera();
+
+  std::vector<double> samples;
+  std::vector<double> lines;
+  for (int i = 0; i < 10; i++) {
+    samples.push_back(1.0 + i * 130.0);
+    lines.push_back(1.0 + i * 110.0);
+  }
+  // Off the image, so it isn't valid
+  samples.push_back(-5000.0);
+  lines.push_back(-5000.0);
+
+  Camera::PointBatch points;
+  cam->SetImages(samples, lines, points);
+  ASSERT_EQ(points.size(), (int)samples.size());
+
+  std::vector<double> latitudes;
+  std::vector<double> longitudes;
+  // The index in samples of each point that intersected the target
+  std::vector<int> imageIndices;
+  for (int i = 0; i < points.size(); i++) {
+    bool success = cam->SetImage(samples[i], lines[i]);
+    ASSERT_EQ((bool)points.valid[i], success);
+
+    if (!success) {
+      EXPECT_EQ(points.latitude[i], Null);
+      EXPECT_EQ(points.emissionAngle[i], Null);
+      continue;
+    }
+
+    EXPECT_DOUBLE_EQ(points.sample[i], samples[i]);
+    EXPECT_DOUBLE_EQ(points.line[i], lines[i]);
+    EXPECT_DOUBLE_EQ(points.latitude[i], cam->UniversalLatitude());
+    EXPECT_DOUBLE_EQ(points.longitude[i], cam->UniversalLongitude());
+    EXPECT_DOUBLE_EQ(points.radius[i], cam->LocalRadius().meters());
+    EXPECT_DOUBLE_EQ(points.phaseAngle[i], cam->PhaseAngle());
+    EXPECT_DOUBLE_EQ(points.incidenceAngle[i], cam->IncidenceAngle());
+    EXPECT_DOUBLE_EQ(points.emissionAngle[i], cam->EmissionAngle());
+
+    latitudes.push_back(points.latitude[i]);
+    longitudes.push_back(points.longitude[i]);
+    imageIndices.push_back(i);
+  }
+
+  ASSERT_GT(latitudes.size(), 1u);
+
+  // Round trip back to the image, reusing the batch
+  cam->SetUniversalGrounds(latitudes, longitudes, points);
+  ASSERT_EQ(points.size(), (int)latitudes.size());
+  for (int j = 0; j < points.size(); j++) {
+    int i = imageIndices[j];
+    ASSERT_TRUE(points.valid[j]);
+    EXPECT_NEAR(points.sample[j], samples[i], 0.01);
+    EXPECT_NEAR(points.line[j], lines[i], 0.01);
+
+    ASSERT_TRUE(cam->SetUniversalGround(latitudes[j], longitudes[j]));
+    EXPECT_DOUBLE_EQ(points.sample[j], cam->Sample());
+    EXPECT_DOUBLE_EQ(points.line[j], cam->Line());
+    EXPECT_DOUBLE_EQ(points.latitude[j], cam->UniversalLatitude());
+    EXPECT_DOUBLE_EQ(points.longitude[j], cam->UniversalLongitude());
+    EXPECT_DOUBLE_EQ(points.phaseAngle[j], cam->PhaseAngle());
+    EXPECT_DOUBLE_EQ(points.incidenceAngle[j], cam->IncidenceAngle());
+    EXPECT_DOUBLE_EQ(points.emissionAngle[j], cam->EmissionAngle());
+  }
+}
+
+TEST_F(DefaultCube, CameraSetImagesLeavesCameraAtLastPoint) {
+  Camera *cam = testCube->camera();
+
+  std::vector<double> samples(3, 600.0);
+  std::vector<double> lines(3, 500.0);
+  samples[2] = 250.0;
+  lines[2] = 300.0;
+
+  Camera::PointBatch points;
+  cam->SetImages(samples, lines, points);
+  ASSERT_TRUE(points.valid[2]);
+  EXPECT_DOUBLE_EQ(cam->Sample(), 250.0);
+  EXPECT_DOUBLE_EQ(cam->Line(), 300.0);
+  EXPECT_DOUBLE_EQ(cam->UniversalLatitude(), points.latitude[2]);
+  EXPECT_DOUBLE_EQ(cam->UniversalLongitude(), points.longitude[2]);
+}
+
+TEST_F(DefaultCube, CameraSetImagesProjectedMatchesSetImage) {
+  Camera *cam = projTestCube->camera();
+
+  std::vector<double> samples;
+  std::vector<double> lines;
+  for (int i = 0; i < 5; i++) {
+    samples.push_back(1.0 + i * 10.0);
+    lines.push_back(1.0 + i * 12.0);
+  }
+
+  Camera::PointBatch points;
+  cam->SetImages(samples, lines, points);
+  ASSERT_EQ(points.size(), (int)samples.size());
+  for (int i = 0; i < points.size(); i++) {
+    bool success = cam->SetImage(samples[i], lines[i]);
+    ASSERT_EQ((bool)points.valid[i], success);
+    if (success) {
+      EXPECT_DOUBLE_EQ(points.latitude[i], cam->UniversalLatitude());
+      EXPECT_DOUBLE_EQ(points.longitude[i], cam->UniversalLongitude());
+    }
+  }
+}
+
+TEST_F(DefaultCube, CameraSetImagesSizeMismatch) {
+  Camera *cam = testCube->camera();
+
+  Camera::PointBatch points;
+  EXPECT_THROW(cam->SetImages(std::vector<double>(2, 1.0), std::vector<double>(1, 1.0), points),
+               IException);
+  EXPECT_THROW(cam->SetUniversalGrounds(std::vector<double>(1, 1.0), std::vector<double>(3, 1.0),
+                                        points),
+               IException);
+}
@@ -0,0 +1,69 @@
+#include <vector>
+
+#include <QList>
+
+#include "Camera.h"
+#include "CameraFactory.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST_F(DefaultCube, CameraFactoryCloneIsIndependent) {
+  Camera *cam = testCube->camera();
+  Camera *clone = CameraFactory::Clone(*testCube);
+  ASSERT_NE(clone, cam);
+
+  ASSERT_TRUE(cam->SetImage(600.0, 500.0));
+  ASSERT_TRUE(clone->SetImage(600.0, 500.0));
+  EXPECT_DOUBLE_EQ(clone->UniversalLatitude(), cam->UniversalLatitude());
+  EXPECT_DOUBLE_EQ(clone->UniversalLongitude(), cam->UniversalLongitude());
+
+  // Moving the clone doesn't move the cube's camera
+  double latitude = cam->UniversalLatitude();
+  ASSERT_TRUE(clone->SetImage(100.0, 100.0));
+  EXPECT_DOUBLE_EQ(cam->UniversalLatitude(), latitude);
+  EXPECT_DOUBLE_EQ(cam->Sample(), 600.0);
+
+  delete clone;
+}
+
+TEST_F(DefaultCube, CameraFactoryClonesKeepTheirOwnState) {
+  std::vector<double> samples;
+  std::vector<double> lines;
+  for (int i = 0; i < 200; i++) {
+    samples.push_back(1.0 + (i * 37) % 1000);
+    lines.push_back(1.0 + (i * 53) % 1000);
+  }
+
+  Camera::PointBatch expected;
+  testCube->camera()->SetImages(samples, lines, expected);
+
+  QList<Camera *> clones;
+  for (int i = 0; i < 4; i++) {
+    clones.append(CameraFactory::Clone(*testCube));
+  }
+
+  // Set every clone to a different point before checking any of them
+  for (int j = 0; j < expected.size(); j++) {
+    QList<bool> successes;
+    for (int i = 0; i < clones.size(); i++) {
+      int point = (j + i * 50) % expected.size();
+      successes.append(clones[i]->SetImage(samples[point], lines[point]));
+    }
+
+    for (int i = 0; i < clones.size(); i++) {
+      int point = (j + i * 50) % expected.size();
+      ASSERT_EQ(successes[i], (bool)expected.valid[point]);
+      if (successes[i]) {
+        EXPECT_DOUBLE_EQ(clones[i]->UniversalLatitude(), expected.latitude[point]);
+        EXPECT_DOUBLE_EQ(clones[i]->UniversalLongitude(), expected.longitude[point]);
+        EXPECT_DOUBLE_EQ(clones[i]->EmissionAngle(), expected.emissionAngle[point]);
+      }
+    }
+  }
+
+  qDeleteAll(clones);
+}
@@ -0,0 +1,85 @@
+#include <QScopedPointer>
+#include <QSet>
+#include <QStringList>
+
+#include "ControlMeasure.h"
+#include "ControlNet.h"
+#include "ControlNetPointReader.h"
+#include "ControlPoint.h"
+#include "IException.h"
+#include "Pvl.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST_F(ThreeImageNetwork, ControlNetPointReaderMatchesNetwork) {
+  QString indexedPath = tempDir.path() + "/indexed.net";
+  QString plainPath = tempDir.path() + "/plain.net";
+  network->Write(indexedPath, false, true);
+  network->Write(plainPath);
+
+  Pvl label(indexedPath);
+  PvlObject &core = label.findObject("ProtoBuffer").findObject("Core");
+  EXPECT_TRUE(core.hasKeyword("IndexStartByte"));
+  EXPECT_TRUE(core.hasKeyword("IndexBytes"));
+
+  // Version 6 networks still read as a whole network
+  ControlNet indexedNet(indexedPath);
+  EXPECT_EQ(indexedNet.GetNumPoints(), network->GetNumPoints());
+  EXPECT_EQ(indexedNet.GetNumMeasures(), network->GetNumMeasures());
+
+  QStringList paths;
+  paths << indexedPath << plainPath;
+  for (int version = 6; version >= 5; version--) {
+    ControlNetPointReader reader(paths[6 - version]);
+    EXPECT_EQ(reader.version(), version);
+    EXPECT_EQ(reader.netId(), network->GetNetworkId());
+    EXPECT_EQ(reader.targetName(), network->GetTarget());
+    ASSERT_EQ(reader.numPoints(), network->GetNumPoints());
+
+    for (int i = 0; i < reader.numPoints(); i++) {
+      QString id = reader.pointId(i);
+      EXPECT_EQ(reader.pointIndex(id), i);
+
+      QScopedPointer<ControlPoint> point(reader.readPoint(id));
+      const ControlPoint *netPoint = network->GetPoint(id);
+      EXPECT_EQ(point->GetId(), id);
+      EXPECT_EQ(point->GetType(), netPoint->GetType());
+      ASSERT_EQ(point->GetNumMeasures(), netPoint->GetNumMeasures());
+      for (int j = 0; j < point->GetNumMeasures(); j++) {
+        const ControlMeasure *measure = point->GetMeasure(j);
+        const ControlMeasure *netMeasure = netPoint->GetMeasure(j);
+        EXPECT_EQ(measure->GetCubeSerialNumber(), netMeasure->GetCubeSerialNumber());
+        EXPECT_EQ(measure->GetSample(), netMeasure->GetSample());
+        EXPECT_EQ(measure->GetLine(), netMeasure->GetLine());
+      }
+    }
+
+    EXPECT_EQ(QSet<QString>::fromList(reader.serialNumbers()),
+              QSet<QString>::fromList(network->GetCubeSerials()));
+    foreach (QString serialNumber, reader.serialNumbers()) {
+      QList<ControlPoint *> points = reader.readPoints(serialNumber);
+      EXPECT_EQ(points.size(), network->GetMeasuresInCube(serialNumber).size());
+      foreach (ControlPoint *point, points) {
+        EXPECT_TRUE(point->HasSerialNumber(serialNumber));
+      }
+      qDeleteAll(points);
+    }
+
+    EXPECT_TRUE(reader.pointIndices("NotAnImage").isEmpty());
+    EXPECT_EQ(reader.pointIndex("NotAPoint"), -1);
+    EXPECT_THROW(reader.readPoint("NotAPoint"), IException);
+    EXPECT_THROW(reader.readPoint(reader.numPoints()), IException);
+  }
+}
+
+
+TEST_F(ThreeImageNetwork, ControlNetPointReaderPvlNetwork) {
+  QString pvlPath = tempDir.path() + "/pvl.net";
+  network->Write(pvlPath, true);
+
+  EXPECT_THROW(ControlNetPointReader reader(pvlPath), IException);
+}
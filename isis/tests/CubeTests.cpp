@@ -1,5 +1,9 @@
+#include <QAtomicInt>
+#include <QFileInfo>
 #include <QTemporaryFile>
+#include <QScopedPointer>
 #include <QString>
+#include <QtConcurrentMap>
 #include <iostream>
 
 #include <nlohmann/json.hpp>
@@ -8,6 +12,8 @@ using json = nlohmann::json;
 #include "StringBlob.h"
 #include "Cube.h"
 #include "Camera.h"
+#include "LineManager.h"
+#include "SpecialPixel.h"
 
 #include "Fixtures.h"
 #include "TestUtilities.h"
@@ -239,3 +245,287 @@ TEST_F(SmallCube, TestCubeHasBlob) {
   EXPECT_TRUE(testCube->hasBlob("String", "TestBlob"));
   EXPECT_FALSE(testCube->hasBlob("String", "SomeOtherTestBlob"));
 }
+
+TEST_F(SmallCube, TestCubeMemoryMappedRead) {
+  QString path = testCube->fileName();
+  testCube->close();
+
+  PreferenceGuard memoryMap("Performance", "CubeReadMemoryMap", "ReadOnly");
+
+  testCube->open(path, "r");
+
+  LineManager line(*testCube);
+  double pixelValue = 0.0;
+  for(line.begin(); !line.end(); line++) {
+    testCube->read(line);
+    for(int i = 0; i < line.size(); i++) {
+      EXPECT_DOUBLE_EQ(line[i], pixelValue++);
+    }
+  }
+
+  testCube->close();
+}
+
+TEST_F(SmallCube, TestCubePrefetch) {
+  QString path = testCube->fileName();
+  testCube->close();
+  testCube->open(path, "r");
+
+  LineManager line(*testCube);
+  LineManager nextLine(*testCube);
+  double pixelValue = 0.0;
+  for(line.begin(); !line.end(); line++) {
+    nextLine = line;
+    nextLine += 2;
+    if (!nextLine.end()) {
+      testCube->prefetch(nextLine);
+    }
+
+    testCube->read(line);
+    for(int i = 0; i < line.size(); i++) {
+      EXPECT_DOUBLE_EQ(line[i], pixelValue++);
+    }
+  }
+}
+
+
+TEST_F(SmallCube, TestCubeConcurrentRead) {
+  QString path = testCube->fileName();
+  testCube->close();
+  testCube->open(path, "r");
+
+  QList<int> linePositions;
+  for (int i = 0; i < testCube->lineCount() * testCube->bandCount(); i++) {
+    linePositions.append(i);
+  }
+
+  Cube *cube = testCube;
+  QAtomicInt badPixelCount(0);
+  QtConcurrent::blockingMap(linePositions, [cube, &badPixelCount](int &linePosition) {
+    LineManager line(*cube);
+    line.SetLine(linePosition % cube->lineCount() + 1,
+                 linePosition / cube->lineCount() + 1);
+    cube->read(line);
+
+    for (int i = 0; i < line.size(); i++) {
+      if (line[i] != (double) (linePosition * line.size() + i)) {
+        badPixelCount.ref();
+      }
+    }
+  });
+
+  EXPECT_EQ(badPixelCount.load(), 0);
+}
+
+TEST_F(TempTestingFiles, TestCubeCompressedTile) {
+  Cube cube;
+  cube.setDimensions(300, 200, 2);
+  cube.setFormat(Cube::CompressedTile);
+  cube.setPixelType(Real);
+  cube.create(tempDir.path() + "/compressed.cub");
+
+  // Leave the bottom half of each band NULL so those tiles are never stored
+  LineManager line(cube);
+  for(line.begin(); !line.end(); line++) {
+    for(int i = 0; i < line.size(); i++) {
+      line[i] = (line.Line() > 100) ? Null : (double) (line.Line() + i);
+    }
+    cube.write(line);
+  }
+
+  StringBlob testBlob("Test String", "TestBlob");
+  cube.write(testBlob);
+  cube.close();
+
+  cube.open(tempDir.path() + "/compressed.cub", "r");
+  PvlObject &core = cube.label()->findObject("IsisCube").findObject("Core");
+  EXPECT_EQ(core["Format"][0].toStdString(), "CompressedTile");
+  EXPECT_EQ(core["TileCompression"][0].toStdString(), "Zlib");
+  EXPECT_TRUE(cube.hasBlob("String", "TestBlob"));
+  EXPECT_LT(QFileInfo(cube.fileName()).size(), 300 * 200 * 2 * 4);
+
+  for(line.begin(); !line.end(); line++) {
+    cube.read(line);
+    for(int i = 0; i < line.size(); i++) {
+      if (line.Line() > 100) {
+        EXPECT_EQ(line[i], Null);
+      }
+      else {
+        EXPECT_DOUBLE_EQ(line[i], (double) (line.Line() + i));
+      }
+    }
+  }
+  cube.close();
+
+  // Rewrite the first lines with values that don't compress as well and
+  // fill in a NULL tile, then check everything after reopening again
+  cube.open(tempDir.path() + "/compressed.cub", "rw");
+  for(line.begin(); !line.end(); line++) {
+    if (line.Line() <= 10 || (line.Line() > 150 && line.Band() == 2)) {
+      for(int i = 0; i < line.size(); i++) {
+        line[i] = (double) (line.Line() * 1000 + i * 7 % 13) + 0.5;
+      }
+      cube.write(line);
+    }
+  }
+  cube.close();
+
+  cube.open(tempDir.path() + "/compressed.cub", "r");
+  EXPECT_TRUE(cube.hasBlob("String", "TestBlob"));
+  for(line.begin(); !line.end(); line++) {
+    cube.read(line);
+    for(int i = 0; i < line.size(); i++) {
+      if (line.Line() <= 10 || (line.Line() > 150 && line.Band() == 2)) {
+        EXPECT_DOUBLE_EQ(line[i], (double) (line.Line() * 1000 + i * 7 % 13) + 0.5);
+      }
+      else if (line.Line() > 100) {
+        EXPECT_EQ(line[i], Null);
+      }
+      else {
+        EXPECT_DOUBLE_EQ(line[i], (double) (line.Line() + i));
+      }
+    }
+  }
+}
+
+TEST_F(TempTestingFiles, TestCubeSkipNullTiles) {
+  QScopedPointer<PreferenceGuard> skipNullTiles(
+      new PreferenceGuard("Performance", "CubeSkipNullTiles", "Always"));
+
+  Cube cube;
+  cube.setDimensions(1024, 1024, 1);
+  cube.setFormat(Cube::Tile);
+  cube.setPixelType(Real);
+  cube.create(tempDir.path() + "/sparse.cub");
+
+  // Only the first line has data, every other tile is never written
+  LineManager line(cube);
+  line.SetLine(1);
+  for(int i = 0; i < line.size(); i++) {
+    line[i] = (double) i;
+  }
+  cube.write(line);
+  cube.close();
+
+  skipNullTiles.reset();
+
+  cube.open(tempDir.path() + "/sparse.cub", "r");
+  PvlObject &core = cube.label()->findObject("IsisCube").findObject("Core");
+  ASSERT_TRUE(core.hasKeyword("NullTileRanges"));
+  EXPECT_EQ(QFileInfo(cube.fileName()).size(),
+            (BigInt) core["StartByte"] - 1 + 1024 * 1024 * 4);
+
+  for(line.begin(); !line.end(); line++) {
+    cube.read(line);
+    for(int i = 0; i < line.size(); i++) {
+      if (line.Line() == 1) {
+        EXPECT_DOUBLE_EQ(line[i], (double) i);
+      }
+      else {
+        EXPECT_EQ(line[i], Null);
+      }
+    }
+  }
+  cube.close();
+
+  // Writing into a skipped tile with the preference off puts it on the disk
+  cube.open(tempDir.path() + "/sparse.cub", "rw");
+  line.SetLine(1024);
+  for(int i = 0; i < line.size(); i++) {
+    line[i] = 5.0;
+  }
+  cube.write(line);
+  cube.close();
+
+  cube.open(tempDir.path() + "/sparse.cub", "r");
+  cube.read(line);
+  for(int i = 0; i < line.size(); i++) {
+    EXPECT_DOUBLE_EQ(line[i], 5.0);
+  }
+  line.SetLine(1000);
+  cube.read(line);
+  EXPECT_EQ(line[0], Null);
+}
+
+TEST_F(TempTestingFiles, TestCubeSwappedSpecialPixels) {
+  QList<PixelType> pixelTypes;
+  pixelTypes << UnsignedByte << SignedWord << UnsignedWord << UnsignedInteger << Real;
+
+  QList<double> specials;
+  specials << Null << Lis << Lrs << His << Hrs;
+
+  foreach (PixelType pixelType, pixelTypes) {
+    // Unsigned bytes only have room for NULL and HRS
+    QList<double> expected = specials;
+    if (pixelType == UnsignedByte) {
+      expected.clear();
+      expected << Null << Null << Null << Hrs << Hrs;
+    }
+
+    for (int swapped = 0; swapped < 2; swapped++) {
+      QString name = PixelTypeName(pixelType) + (swapped ? "Swapped" : "Native");
+      QString path = tempDir.path() + "/" + name + ".cub";
+
+      Cube cube;
+      cube.setDimensions(10, 2, 1);
+      cube.setPixelType(pixelType);
+      cube.setByteOrder((IsLsb() == (bool) swapped) ? Msb : Lsb);
+      if (pixelType != Real) {
+        cube.setBaseMultiplier(10.0, 0.5);
+      }
+      cube.create(path);
+
+      LineManager line(cube);
+      line.SetLine(1);
+      for (int i = 0; i < specials.size(); i++) {
+        line[i] = specials[i];
+      }
+      for (int i = specials.size(); i < line.size(); i++) {
+        line[i] = 10.0 + 0.5 * i;
+      }
+      cube.write(line);
+      cube.close();
+
+      cube.open(path, "r");
+      cube.read(line);
+
+      for (int i = 0; i < specials.size(); i++) {
+        EXPECT_EQ(line[i], expected[i]) << name.toStdString() << " special " << i;
+      }
+      for (int i = specials.size(); i < line.size(); i++) {
+        EXPECT_DOUBLE_EQ(line[i], 10.0 + 0.5 * i) << name.toStdString();
+      }
+      cube.close();
+    }
+  }
+}
+
+
+TEST_F(TempTestingFiles, TestCubeUnsignedIntegerNegativeValues) {
+  QString path = tempDir.path() + "/unsignedInteger.cub";
+
+  Cube cube;
+  cube.setDimensions(4, 1, 1);
+  cube.setPixelType(UnsignedInteger);
+  cube.setBaseMultiplier(10.0, 1.0);
+  cube.create(path);
+
+  // Every value that would be below zero in the file saturates low instead
+  // of wrapping around
+  LineManager line(cube);
+  line.SetLine(1);
+  line[0] = -5.0;
+  line[1] = 5.0;
+  line[2] = 9.4;
+  line[3] = 20.0;
+  cube.write(line);
+  cube.close();
+
+  cube.open(path, "r");
+  cube.read(line);
+  EXPECT_EQ(line[0], Lrs);
+  EXPECT_EQ(line[1], Lrs);
+  EXPECT_EQ(line[2], Lrs);
+  EXPECT_DOUBLE_EQ(line[3], 20.0);
+  cube.close();
+}
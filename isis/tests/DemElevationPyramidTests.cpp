@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cfloat>
+
+#include "Brick.h"
+#include "DemElevationPyramid.h"
+#include "IException.h"
+#include "SpecialPixel.h"
+#include "Table.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+namespace {
+  // Band 1 of the SmallCube is (line - 1) * 10 + sample - 1 meters
+  bool bruteForceRange(int startSample, int startLine, int endSample, int endLine,
+                       int nullSample, int nullLine, double &minRadius, double &maxRadius) {
+    minRadius = DBL_MAX;
+    maxRadius = -DBL_MAX;
+    for (int line = std::max(1, startLine); line <= std::min(10, endLine); line++) {
+      for (int sample = std::max(1, startSample); sample <= std::min(10, endSample); sample++) {
+        if (sample == nullSample && line == nullLine) continue;
+        double radius = ((line - 1) * 10 + sample - 1) / 1000.0;
+        minRadius = std::min(minRadius, radius);
+        maxRadius = std::max(maxRadius, radius);
+      }
+    }
+    return minRadius <= maxRadius;
+  }
+}
+
+TEST_F(SmallCube, DemElevationPyramidRange) {
+  Brick nullPixel(1, 1, 1, testCube->pixelType());
+  nullPixel.SetBasePosition(4, 7, 1);
+  nullPixel[0] = Null;
+  testCube->write(nullPixel);
+
+  DemElevationPyramid pyramid(*testCube, 2);
+  EXPECT_EQ(pyramid.blockSize(), 2);
+  // 5x5, 3x3, 2x2 and 1x1 blocks
+  EXPECT_EQ(pyramid.levels(), 4);
+
+  double minRadius, maxRadius;
+  ASSERT_TRUE(pyramid.range(1, 1, 10, 10, minRadius, maxRadius));
+  EXPECT_DOUBLE_EQ(minRadius, 0.0);
+  EXPECT_DOUBLE_EQ(maxRadius, 0.099);
+
+  // The pyramid bounds the radii of any area, from outside
+  for (int startLine = -1; startLine <= 10; startLine += 3) {
+    for (int startSample = 1; startSample <= 10; startSample += 2) {
+      for (int size = 1; size <= 9; size += 4) {
+        int endSample = startSample + size - 1;
+        int endLine = startLine + size;
+        double expectedMin, expectedMax;
+        ASSERT_TRUE(bruteForceRange(startSample, startLine, endSample, endLine, 4, 7,
+                                    expectedMin, expectedMax));
+        ASSERT_TRUE(pyramid.range(startSample, startLine, endSample, endLine,
+                                  minRadius, maxRadius));
+        EXPECT_LE(minRadius, expectedMin);
+        EXPECT_GE(maxRadius, expectedMax);
+      }
+    }
+  }
+
+  // Areas of a single block are exact
+  ASSERT_TRUE(pyramid.range(3, 7, 4, 8, minRadius, maxRadius));
+  EXPECT_DOUBLE_EQ(minRadius, 0.062);
+  EXPECT_DOUBLE_EQ(maxRadius, 0.073);
+
+  EXPECT_FALSE(pyramid.range(11, 1, 20, 10, minRadius, maxRadius));
+  EXPECT_FALSE(pyramid.range(1, -10, 10, 0, minRadius, maxRadius));
+}
+
+TEST_F(SmallCube, DemElevationPyramidTable) {
+  DemElevationPyramid pyramid(*testCube, 3);
+  Table table = pyramid.toTable();
+  EXPECT_EQ(table.Name(), DemElevationPyramid::tableName());
+
+  DemElevationPyramid copy(table);
+  EXPECT_EQ(copy.levels(), pyramid.levels());
+  EXPECT_EQ(copy.blockSize(), 3);
+
+  for (int start = 1; start <= 10; start += 2) {
+    double minRadius, maxRadius, copyMin, copyMax;
+    ASSERT_TRUE(pyramid.range(start, 1, 10, start, minRadius, maxRadius));
+    ASSERT_TRUE(copy.range(start, 1, 10, start, copyMin, copyMax));
+    EXPECT_DOUBLE_EQ(copyMin, minRadius);
+    EXPECT_DOUBLE_EQ(copyMax, maxRadius);
+  }
+
+  table.Label()["BlockSize"] = "2";
+  EXPECT_THROW(DemElevationPyramid badTable(table), IException);
+}
+
+TEST_F(SmallCube, DemElevationPyramidBadBlockSize) {
+  EXPECT_THROW(DemElevationPyramid pyramid(*testCube, 0), IException);
+}
+
+TEST(DemElevationPyramid, DefaultBlockSize) {
+  EXPECT_EQ(DemElevationPyramid::defaultBlockSize(10, 10), 16);
+  EXPECT_EQ(DemElevationPyramid::defaultBlockSize(8192, 8192), 16);
+  EXPECT_EQ(DemElevationPyramid::defaultBlockSize(8193, 8192), 32);
+  // A 128 pixels/degree global DEM
+  EXPECT_EQ(DemElevationPyramid::defaultBlockSize(46080, 23040), 64);
+}
+
+TEST_F(SmallCube, DemElevationPyramidShared) {
+  EXPECT_EQ(DemElevationPyramid::acquire(testCube), (DemElevationPyramid *) NULL);
+
+  DemElevationPyramid pyramid(*testCube, 3);
+  testCube->write(pyramid.toTable());
+
+  DemElevationPyramid *first = DemElevationPyramid::acquire(testCube);
+  ASSERT_NE(first, (DemElevationPyramid *) NULL);
+  DemElevationPyramid *second = DemElevationPyramid::acquire(testCube);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(first->blockSize(), 3);
+
+  DemElevationPyramid::release(first);
+  DemElevationPyramid::release(second);
+}
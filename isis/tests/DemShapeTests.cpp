@@ -0,0 +1,180 @@
+#include <cmath>
+#include <vector>
+
+#include "Angle.h"
+#include "Camera.h"
+#include "Constants.h"
+#include "Cube.h"
+#include "DemElevationPyramid.h"
+#include "DemShape.h"
+#include "IString.h"
+#include "Latitude.h"
+#include "LineManager.h"
+#include "Longitude.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "PvlKeyword.h"
+#include "SurfacePoint.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+namespace {
+  // The radius, in meters, of a global Mars DEM with rolling terrain
+  double terrainRadius(double lat, double lon) {
+    return 3396190.0 + 3000.0 * sin(2.0 * lat * DEG2RAD) * cos(3.0 * lon * DEG2RAD);
+  }
+
+  // Writes a global, one pixel per degree, simple cylindrical DEM
+  QString writeGlobalDem(const QString &path, bool withPyramid) {
+    Cube dem;
+    dem.setDimensions(360, 180, 1);
+    dem.setPixelType(Real);
+    dem.create(path);
+
+    double pixelResolution = 3396190.0 * DEG2RAD;
+    PvlGroup mapping("Mapping");
+    mapping += PvlKeyword("ProjectionName", "SimpleCylindrical");
+    mapping += PvlKeyword("CenterLongitude", "180.0");
+    mapping += PvlKeyword("TargetName", "Mars");
+    mapping += PvlKeyword("EquatorialRadius", "3396190.0", "meters");
+    mapping += PvlKeyword("PolarRadius", "3376200.0", "meters");
+    mapping += PvlKeyword("LatitudeType", "Planetocentric");
+    mapping += PvlKeyword("LongitudeDirection", "PositiveEast");
+    mapping += PvlKeyword("LongitudeDomain", "360");
+    mapping += PvlKeyword("MinimumLatitude", "-90.0");
+    mapping += PvlKeyword("MaximumLatitude", "90.0");
+    mapping += PvlKeyword("MinimumLongitude", "0.0");
+    mapping += PvlKeyword("MaximumLongitude", "360.0");
+    mapping += PvlKeyword("UpperLeftCornerX", toString(-180.0 * pixelResolution), "meters");
+    mapping += PvlKeyword("UpperLeftCornerY", toString(90.0 * pixelResolution), "meters");
+    mapping += PvlKeyword("PixelResolution", toString(pixelResolution), "meters/pixel");
+    mapping += PvlKeyword("Scale", "1.0", "pixels/degree");
+    dem.putGroup(mapping);
+
+    LineManager line(dem);
+    for (line.begin(); !line.end(); line++) {
+      double lat = 90.0 - (line.Line() - 0.5);
+      for (int i = 0; i < line.size(); i++) {
+        line[i] = terrainRadius(lat, i + 0.5);
+      }
+      dem.write(line);
+    }
+
+    if (withPyramid) {
+      DemElevationPyramid pyramid(dem);
+      dem.write(pyramid.toTable());
+    }
+
+    dem.close();
+    return path;
+  }
+
+  std::vector<double> bodyFixed(double lat, double lon, double radius) {
+    std::vector<double> point(3);
+    point[0] = radius * cos(lat * DEG2RAD) * cos(lon * DEG2RAD);
+    point[1] = radius * cos(lat * DEG2RAD) * sin(lon * DEG2RAD);
+    point[2] = radius * sin(lat * DEG2RAD);
+    return point;
+  }
+
+  std::vector<double> lookAt(const std::vector<double> &observer,
+                             const std::vector<double> &target) {
+    std::vector<double> look(3);
+    for (int i = 0; i < 3; i++) {
+      look[i] = target[i] - observer[i];
+    }
+    return look;
+  }
+
+  // Intersects both shapes and checks that they agree to a tenth of a DEM pixel
+  void expectSameIntersection(DemShape &pyramidShape, DemShape &iterativeShape,
+                              const std::vector<double> &observer,
+                              const std::vector<double> &look) {
+    ASSERT_TRUE(iterativeShape.intersectSurface(observer, look));
+    ASSERT_TRUE(pyramidShape.intersectSurface(observer, look));
+
+    SurfacePoint *expected = iterativeShape.surfaceIntersection();
+    SurfacePoint *actual = pyramidShape.surfaceIntersection();
+    double lat = expected->GetLatitude().degrees();
+    double lonDiff = actual->GetLongitude().degrees() - expected->GetLongitude().degrees();
+    lonDiff = remainder(lonDiff, 360.0);
+    EXPECT_NEAR(actual->GetLatitude().degrees(), lat, 0.1);
+    // Longitude degrees shrink toward the poles
+    EXPECT_NEAR(lonDiff * cos(lat * DEG2RAD), 0.0, 0.1);
+    // The height is refined to a hundredth of a DEM pixel, about 600 meters
+    EXPECT_NEAR(actual->GetLocalRadius().meters(),
+                terrainRadius(actual->GetLatitude().degrees(),
+                              actual->GetLongitude().degrees()),
+                600.0);
+  }
+}
+
+class GlobalDem : public DefaultCube {
+  protected:
+    Pvl pyramidLabel;
+    Pvl iterativeLabel;
+
+    void SetUp() override {
+      DefaultCube::SetUp();
+
+      PvlGroup pyramidKernels("Kernels");
+      pyramidKernels += PvlKeyword("ShapeModel",
+          writeGlobalDem(tempDir.path() + "/pyramidDem.cub", true));
+      pyramidLabel.addGroup(pyramidKernels);
+
+      PvlGroup iterativeKernels("Kernels");
+      iterativeKernels += PvlKeyword("ShapeModel",
+          writeGlobalDem(tempDir.path() + "/iterativeDem.cub", false));
+      iterativeLabel.addGroup(iterativeKernels);
+    }
+};
+
+TEST_F(GlobalDem, DemShapePyramidMatchesIterationFromAbove) {
+  Target *target = testCube->camera()->target();
+  DemShape pyramidShape(target, pyramidLabel);
+  DemShape iterativeShape(target, iterativeLabel);
+
+  std::vector<double> observer = bodyFixed(20.0, 40.0, 2.0 * 3396.19);
+  for (int i = -2; i <= 2; i++) {
+    for (int j = -2; j <= 2; j++) {
+      SCOPED_TRACE("Offset " + toString(i).toStdString() + ", " + toString(j).toStdString());
+      std::vector<double> ground = bodyFixed(20.0 + 7.3 * i, 40.0 + 6.1 * j, 3396.19);
+      expectSameIntersection(pyramidShape, iterativeShape, observer, lookAt(observer, ground));
+    }
+  }
+}
+
+TEST_F(GlobalDem, DemShapePyramidMatchesIterationAtTheLimb) {
+  Target *target = testCube->camera()->target();
+  DemShape pyramidShape(target, pyramidLabel);
+  DemShape iterativeShape(target, iterativeLabel);
+
+  // Rays that pass the center of the planet at 90 to 99 percent of its
+  // radius, on every side of the disk
+  std::vector<double> observer = bodyFixed(5.0, 100.0, 5.0 * 3396.19);
+  std::vector<double> up = bodyFixed(85.0, 280.0, 1.0);
+  std::vector<double> side(3);
+  side[0] = observer[1] * up[2] - observer[2] * up[1];
+  side[1] = observer[2] * up[0] - observer[0] * up[2];
+  side[2] = observer[0] * up[1] - observer[1] * up[0];
+  double sideLength = sqrt(side[0] * side[0] + side[1] * side[1] + side[2] * side[2]);
+
+  double fractions[] = {0.9, 0.95, 0.99};
+  for (int angle = 0; angle < 360; angle += 45) {
+    for (int f = 0; f < 3; f++) {
+      SCOPED_TRACE("Angle " + toString(angle).toStdString() + ", fraction " +
+                   toString(fractions[f]).toStdString());
+      double distance = fractions[f] * 3396.19;
+      std::vector<double> edge(3);
+      for (int i = 0; i < 3; i++) {
+        edge[i] = distance * (cos(angle * DEG2RAD) * up[i] +
+                              sin(angle * DEG2RAD) * side[i] / sideLength);
+      }
+      expectSameIntersection(pyramidShape, iterativeShape, observer, lookAt(observer, edge));
+    }
+  }
+}
@@ -0,0 +1,145 @@
+#include "Camera.h"
+#include "Cube.h"
+#include "DemShape.h"
+#include "DemTileCache.h"
+#include "IException.h"
+#include "Latitude.h"
+#include "LineManager.h"
+#include "Longitude.h"
+#include "PixelType.h"
+#include "Portal.h"
+#include "Pvl.h"
+#include "PvlGroup.h"
+#include "SpecialPixel.h"
+
+#include "Fixtures.h"
+#include "TestUtilities.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST_F(SmallCube, DemTileCacheMatchesPortal) {
+  // Room for two 3x3 tiles, so tiles get dropped and read again
+  DemTileCache cache(testCube, 2 * 3 * 3 * sizeof(float), 3);
+  EXPECT_EQ(cache.maximumTiles(), 2);
+
+  Portal portal(2, 2, testCube->pixelType(), 0.0, 0.0);
+  for (int line = 0; line <= 10; line++) {
+    for (int sample = 0; sample <= 10; sample++) {
+      portal.SetPosition(sample, line, 1);
+      testCube->read(portal);
+
+      double values[4];
+      cache.read(sample, line, 2, 2, values);
+      for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(values[i], portal[i]);
+      }
+    }
+  }
+  EXPECT_EQ(cache.tileCount(), 2);
+}
+
+TEST_F(TempTestingFiles, DemTileCacheKeepsRadiusPrecision) {
+  Cube dem;
+  dem.setDimensions(5, 5, 1);
+  dem.setPixelType(Double);
+  dem.create(tempDir.path() + "/dem.cub");
+
+  LineManager line(dem);
+  for (line.begin(); !line.end(); line++) {
+    for (int i = 0; i < line.size(); i++) {
+      line[i] = 3396190.0 + 0.001 * (line.Line() * 5 + i);
+    }
+    if (line.Line() == 3) {
+      line[2] = Null;
+    }
+    dem.write(line);
+  }
+
+  DemTileCache cache(&dem, 1024 * 1024);
+  double values[25];
+  cache.read(1, 1, 5, 5, values);
+  for (int l = 0; l < 5; l++) {
+    for (int s = 0; s < 5; s++) {
+      if (l == 2 && s == 2) {
+        EXPECT_EQ(values[l * 5 + s], Null);
+      }
+      else {
+        EXPECT_NEAR(values[l * 5 + s], 3396190.0 + 0.001 * ((l + 1) * 5 + s), 1e-6);
+      }
+    }
+  }
+}
+
+TEST_F(TempTestingFiles, DemTileCacheMatchesPortalForEachPixelType) {
+  PixelType pixelTypes[] = {UnsignedByte, SignedWord, UnsignedWord, SignedInteger, Real, Double};
+  for (int type = 0; type < 6; type++) {
+    SCOPED_TRACE(PixelTypeName(pixelTypes[type]).toStdString());
+
+    Cube dem;
+    dem.setDimensions(7, 6, 1);
+    dem.setPixelType(pixelTypes[type]);
+    if (pixelTypes[type] != Real && pixelTypes[type] != Double) {
+      dem.setBaseMultiplier(3396000.0, 0.25);
+    }
+    dem.create(tempDir.path() + "/dem" + QString::number(type) + ".cub");
+
+    // Radii in meters, like a DEM of the planetary radius
+    LineManager line(dem);
+    for (line.begin(); !line.end(); line++) {
+      for (int i = 0; i < line.size(); i++) {
+        line[i] = 3396000.0 + 0.25 * ((line.Line() - 1) * 7 + i + 1);
+      }
+      if (line.Line() == 4) {
+        line[5] = Null;
+      }
+      dem.write(line);
+    }
+
+    // Room for two 4x4 tiles of any pixel type, so tiles get dropped and read again
+    DemTileCache cache(&dem, 2 * 4 * 4 * sizeof(double), 4);
+    Portal portal(1, 1, dem.pixelType());
+    for (int l = 1; l <= 6; l++) {
+      for (int s = 1; s <= 7; s++) {
+        portal.SetPosition(s, l, 1);
+        dem.read(portal);
+
+        double value;
+        cache.read(s, l, 1, 1, &value);
+        EXPECT_EQ(value, portal[0]) << "sample " << s << " line " << l;
+      }
+    }
+  }
+}
+
+TEST_F(DemCube, DemTileCacheLeavesDemShapeRadiiUnchanged) {
+  Pvl label;
+  PvlGroup kernels("Kernels");
+  kernels += PvlKeyword("ShapeModel", demCube->fileName());
+  label.addGroup(kernels);
+
+  Target *target = testCube->camera()->target();
+  DemShape uncached(target, label);
+
+  PreferenceGuard cacheSize("Performance", "DemCacheSize", "16");
+  DemShape cached(target, label);
+
+  // Between the pixel centers of the DEM, so the radii are interpolated
+  for (int i = 0; i <= 20; i++) {
+    for (int j = 0; j <= 20; j++) {
+      Latitude lat(11.12 + i * 0.0371, Angle::Degrees);
+      Longitude lon(78.12 + j * 0.0373, Angle::Degrees);
+      Distance expected = uncached.localRadius(lat, lon);
+      Distance actual = cached.localRadius(lat, lon);
+      ASSERT_EQ(actual.isValid(), expected.isValid());
+      if (expected.isValid()) {
+        EXPECT_EQ(actual.meters(), expected.meters());
+      }
+    }
+  }
+}
+
+TEST(DemTileCache, TileSizeError) {
+  EXPECT_THROW(DemTileCache(NULL, 1024, 0), IException);
+}
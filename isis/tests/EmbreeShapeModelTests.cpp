@@ -0,0 +1,98 @@
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+#include <QVector>
+
+#include "EmbreeShapeModel.h"
+#include "EmbreeTargetManager.h"
+#include "EmbreeTargetShape.h"
+#include "LinearAlgebra.h"
+#include "SurfacePoint.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+namespace {
+  // Writes an octahedron with vertices one kilometer out on each axis
+  QString writeOctahedron(const QString &path) {
+    std::ofstream obj(path.toStdString().c_str());
+    obj << "v 1 0 0\nv 0 1 0\nv -1 0 0\nv 0 -1 0\nv 0 0 1\nv 0 0 -1\n";
+    obj << "f 1 2 5\nf 2 3 5\nf 3 4 5\nf 4 1 5\n";
+    obj << "f 2 1 6\nf 3 2 6\nf 4 3 6\nf 1 4 6\n";
+    return path;
+  }
+}
+
+TEST_F(TempTestingFiles, EmbreeShapeModelIntersectSurfacesMatchesSingleRays) {
+  QString shapeFile = writeOctahedron(tempDir.path() + "/octahedron.obj");
+  EmbreeTargetManager *manager = EmbreeTargetManager::getInstance();
+  EmbreeShapeModel model(0, shapeFile, manager);
+  EmbreeTargetShape *shape = manager->create(shapeFile);
+
+  // A block of look directions that fills several packets, the last one
+  // partly, including rays that miss the target
+  std::vector<double> observer(3);
+  observer[0] = 10.0;
+  observer[1] = 0.3;
+  observer[2] = -0.2;
+  std::vector< std::vector<double> > lookDirections;
+  for (int i = -3; i <= 3; i++) {
+    for (int j = -2; j <= 2; j++) {
+      std::vector<double> look(3);
+      look[0] = -1.0;
+      look[1] = 0.03 * i - 0.03;
+      look[2] = 0.04 * j + 0.02;
+      lookDirections.push_back(look);
+    }
+  }
+
+  QVector<SurfacePoint> points;
+  int intersections = model.intersectSurfaces(observer, lookDirections, points);
+  ASSERT_EQ(points.size(), (int)lookDirections.size());
+
+  int expectedIntersections = 0;
+  bool missed = false;
+  for (size_t i = 0; i < lookDirections.size(); i++) {
+    RTCMultiHitRay ray(observer, lookDirections[i]);
+    shape->intersectRay(ray);
+
+    bool hit = model.intersectSurface(observer, lookDirections[i]);
+    ASSERT_EQ(hit, ray.lastHit >= 0);
+    ASSERT_EQ(points[i].Valid(), hit);
+    if (!hit) {
+      missed = true;
+      continue;
+    }
+    expectedIntersections++;
+
+    // The single ray hit closest to the observer
+    double closest = DBL_MAX;
+    LinearAlgebra::Vector expected;
+    for (int hitIndex = 0; hitIndex <= ray.lastHit; hitIndex++) {
+      RayHitInformation info = shape->getHitInformation(ray, hitIndex);
+      double dx = info.intersection(0) - observer[0];
+      double dy = info.intersection(1) - observer[1];
+      double dz = info.intersection(2) - observer[2];
+      double distance = sqrt(dx * dx + dy * dy + dz * dz);
+      if (distance < closest) {
+        closest = distance;
+        expected = info.intersection;
+      }
+    }
+
+    EXPECT_NEAR(points[i].GetX().kilometers(), expected(0), 1e-9);
+    EXPECT_NEAR(points[i].GetY().kilometers(), expected(1), 1e-9);
+    EXPECT_NEAR(points[i].GetZ().kilometers(), expected(2), 1e-9);
+  }
+
+  EXPECT_EQ(intersections, expectedIntersections);
+  EXPECT_GT(expectedIntersections, 0);
+  EXPECT_TRUE(missed);
+
+  manager->free(shapeFile);
+}
@@ -0,0 +1,104 @@
+#include <vector>
+
+#include <pcl/conversions.h>
+
+#include "EmbreeTargetShape.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+namespace {
+  // An octahedron with vertices one kilometer out on each axis
+  pcl::PolygonMesh::Ptr octahedron() {
+    pcl::PointCloud<pcl::PointXYZ> cloud;
+    cloud.push_back(pcl::PointXYZ( 1,  0,  0));
+    cloud.push_back(pcl::PointXYZ( 0,  1,  0));
+    cloud.push_back(pcl::PointXYZ(-1,  0,  0));
+    cloud.push_back(pcl::PointXYZ( 0, -1,  0));
+    cloud.push_back(pcl::PointXYZ( 0,  0,  1));
+    cloud.push_back(pcl::PointXYZ( 0,  0, -1));
+
+    pcl::PolygonMesh::Ptr mesh(new pcl::PolygonMesh);
+    pcl::toPCLPointCloud2(cloud, mesh->cloud);
+
+    int faces[8][3] = {{0, 1, 4}, {1, 2, 4}, {2, 3, 4}, {3, 0, 4},
+                       {1, 0, 5}, {2, 1, 5}, {3, 2, 5}, {0, 3, 5}};
+    for (int i = 0; i < 8; i++) {
+      pcl::Vertices face;
+      face.vertices.push_back(faces[i][0]);
+      face.vertices.push_back(faces[i][1]);
+      face.vertices.push_back(faces[i][2]);
+      mesh->polygons.push_back(face);
+    }
+    return mesh;
+  }
+}
+
+TEST(EmbreeTargetShape, IntersectRaysMatchesIntersectRay) {
+  EmbreeTargetShape shape(octahedron(), "octahedron");
+
+  // A 3x3 block of look directions, off the vertex, plus a ray that misses,
+  // so the last packet is partly empty
+  std::vector<double> origin(3);
+  origin[0] = 10.0;
+  origin[1] = 0.0;
+  origin[2] = 0.0;
+  std::vector<RTCMultiHitRay> rays;
+  for (int i = -1; i <= 1; i++) {
+    for (int j = -1; j <= 1; j++) {
+      std::vector<double> direction(3);
+      direction[0] = -1.0;
+      direction[1] = 0.02 * i + 0.005;
+      direction[2] = 0.02 * j + 0.005;
+      rays.push_back(RTCMultiHitRay(origin, direction));
+    }
+  }
+  std::vector<double> away(3);
+  away[0] = 1.0;
+  away[1] = 0.0;
+  away[2] = 0.0;
+  rays.push_back(RTCMultiHitRay(origin, away));
+
+  std::vector<RTCMultiHitRay> packetRays(rays);
+  shape.intersectRays(packetRays);
+
+  for (size_t i = 0; i < rays.size(); i++) {
+    shape.intersectRay(rays[i]);
+    ASSERT_EQ(packetRays[i].lastHit, rays[i].lastHit);
+    for (int hit = 0; hit <= rays[i].lastHit; hit++) {
+      EXPECT_EQ(packetRays[i].hitPrimIDs[hit], rays[i].hitPrimIDs[hit]);
+      EXPECT_NEAR(packetRays[i].hitUs[hit], rays[i].hitUs[hit], 1e-5);
+      EXPECT_NEAR(packetRays[i].hitVs[hit], rays[i].hitVs[hit], 1e-5);
+    }
+  }
+  EXPECT_EQ(rays[0].lastHit, 1);
+  EXPECT_EQ(rays.back().lastHit, -1);
+}
+
+TEST(EmbreeTargetShape, AreOccludedMatchesIsOccluded) {
+  EmbreeTargetShape shape(octahedron(), "octahedron");
+
+  std::vector<double> origin(3);
+  origin[0] = 10.0;
+  origin[1] = 0.0;
+  origin[2] = 0.0;
+  std::vector<RTCOcclusionRay> rays;
+  for (int i = 0; i < 6; i++) {
+    std::vector<double> direction(3);
+    direction[0] = -1.0;
+    direction[1] = 0.1 * i;
+    direction[2] = 0.0;
+    rays.push_back(RTCOcclusionRay(origin, direction));
+  }
+
+  std::vector<RTCOcclusionRay> packetRays(rays);
+  std::vector<bool> occluded = shape.areOccluded(packetRays);
+
+  ASSERT_EQ(occluded.size(), rays.size());
+  for (size_t i = 0; i < rays.size(); i++) {
+    EXPECT_EQ(occluded[i], shape.isOccluded(rays[i]));
+  }
+  EXPECT_TRUE(occluded[0]);
+  EXPECT_FALSE(occluded[5]);
+}
@@ -145,6 +145,7 @@ TEST_F(DefaultCube, FunctionalTestFootprintinitPrecision) {
   ASSERT_TRUE(log.hasGroup("Results"));
   ASSERT_EQ(100, log.findGroup("Results").findKeyword("LINC")[0].toInt());
   ASSERT_EQ(100, log.findGroup("Results").findKeyword("SINC")[0].toInt());
+  EXPECT_GT(log.findGroup("Results").findKeyword("CameraEvaluations")[0].toLongLong(), 0);
 
   ImagePolygon poly;
   testCube->read(poly);
@@ -161,3 +162,25 @@ TEST_F(DefaultCube, FunctionalTestFootprintinitPrecision) {
     EXPECT_NEAR(lats[i], coordArray.getAt(i).y, 1e-6);
   }
 }
+
+TEST_F(DefaultCube, FunctionalTestFootprintinitThreaded) {
+  QVector<QString> serialArgs = {};
+  UserInterface serialUi(APP_XML, serialArgs);
+  Pvl serialLog;
+  footprintinit(testCube, serialUi, &serialLog);
+  EXPECT_FALSE(serialLog.hasGroup("Results"));
+
+  QVector<QString> footprintArgs = {"threaded=yes"};
+  UserInterface footprintUi(APP_XML, footprintArgs);
+  Pvl log;
+  footprintinit(testCube, footprintUi, &log);
+  ASSERT_TRUE(testCube->label()->hasObject("Polygon"));
+
+  ASSERT_TRUE(log.hasGroup("Results"));
+  EXPECT_FALSE(log.findGroup("Results").hasKeyword("SINC"));
+  EXPECT_GT(log.findGroup("Results").findKeyword("CameraEvaluations")[0].toLongLong(), 0);
+
+  ImagePolygon poly;
+  testCube->read(poly);
+  ASSERT_EQ(49, poly.numVertices());
+}
@@ -81,6 +81,13 @@ TEST(Demprep, DemprepDefault){
   // Assertion for maximum radius
   ASSERT_DOUBLE_EQ(double(shapeModel[0][1]), 1745.313);
 
+  ASSERT_TRUE(cube.hasTable("ShapeModelPyramid"));
+  Table pyramid("ShapeModelPyramid");
+  cube.read(pyramid);
+  // The coarsest block covers the whole DEM
+  ASSERT_DOUBLE_EQ(double(pyramid[pyramid.Records() - 1][0]), 1728.805);
+  ASSERT_DOUBLE_EQ(double(pyramid[pyramid.Records() - 1][1]), 1745.313);
+
 
   std::unique_ptr<Histogram> hist (cube.histogram());
 
@@ -1188,3 +1188,92 @@ End)");
 
 }
 
+
+TEST_F(ApolloNetwork, FunctionalTestJigsawThreadedNormals) {
+  QStringList outputs;
+  outputs << "bundleout_points.csv" << "bundleout_images.csv";
+
+  QStringList prefixes;
+  prefixes << tempDir.path() + "/serial_" << tempDir.path() + "/threaded_";
+
+  for (int threaded = 0; threaded < 2; threaded++) {
+    QVector<QString> args = {"fromlist="+cubeListFile, "cnet="+controlNetPath,
+                             "onet="+prefixes[threaded]+"out.net",
+                             "radius=yes", "errorpropagation=yes", "spsolve=position",
+                             "spacecraft_position_sigma=1000.0", "camsolve=angles", "twist=yes",
+                             "camera_angles_sigma=2.", "model1=huber", "max_model1_c_quantile=0.6",
+                             "update=no", "bundleout_txt=no", "output_csv=on", "imagescsv=on",
+                             "file_prefix="+prefixes[threaded],
+                             QString("threaded=") + (threaded ? "yes" : "no")};
+
+    UserInterface ui(APP_XML, args);
+    jigsaw(ui);
+  }
+
+  foreach (QString output, outputs) {
+    QFile serialFile(prefixes[0] + output);
+    QFile threadedFile(prefixes[1] + output);
+    ASSERT_TRUE(serialFile.open(QIODevice::ReadOnly | QIODevice::Text));
+    ASSERT_TRUE(threadedFile.open(QIODevice::ReadOnly | QIODevice::Text));
+    EXPECT_PRED_FORMAT2(AssertQStringsEqual, QString(serialFile.readAll()),
+                        QString(threadedFile.readAll()));
+  }
+}
+
+
+TEST_F(ApolloNetwork, FunctionalTestJigsawErrorPropagationMethods) {
+  QStringList outputs;
+  outputs << "bundleout_points.csv" << "bundleout_images.csv";
+
+  QStringList methods;
+  methods << "columnsolves" << "blocksolves" << "selectedinverse";
+
+  foreach (QString method, methods) {
+    QString prefix = tempDir.path() + "/" + method + "_";
+    QVector<QString> args = {"fromlist="+cubeListFile, "cnet="+controlNetPath,
+                             "onet="+prefix+"out.net",
+                             "radius=yes", "errorpropagation=yes", "spsolve=position",
+                             "spacecraft_position_sigma=1000.0", "camsolve=angles", "twist=yes",
+                             "camera_angles_sigma=2.", "update=no", "bundleout_txt=no",
+                             "output_csv=on", "imagescsv=on", "file_prefix="+prefix,
+                             "errormethod="+method};
+
+    UserInterface ui(APP_XML, args);
+    jigsaw(ui);
+  }
+
+  foreach (QString output, outputs) {
+    for (int m = 1; m < methods.size(); m++) {
+      compareCsvFiles(tempDir.path() + "/columnsolves_" + output,
+                      tempDir.path() + "/" + methods[m] + "_" + output, 1e-5);
+    }
+  }
+}
+
+
+TEST_F(ApolloNetwork, FunctionalTestJigsawConjugateGradient) {
+  QStringList outputs;
+  outputs << "bundleout_points.csv" << "bundleout_images.csv";
+
+  QStringList methods;
+  methods << "cholesky" << "conjugategradient";
+
+  foreach (QString method, methods) {
+    QString prefix = tempDir.path() + "/" + method + "_";
+    QVector<QString> args = {"fromlist="+cubeListFile, "cnet="+controlNetPath,
+                             "onet="+prefix+"out.net",
+                             "radius=yes", "spsolve=position",
+                             "spacecraft_position_sigma=1000.0", "camsolve=angles", "twist=yes",
+                             "camera_angles_sigma=2.", "update=no", "bundleout_txt=no",
+                             "output_csv=on", "imagescsv=on", "file_prefix="+prefix,
+                             "solvemethod="+method, "cgtolerance=1.0e-14", "cgmaxits=10000"};
+
+    UserInterface ui(APP_XML, args);
+    jigsaw(ui);
+  }
+
+  foreach (QString output, outputs) {
+    compareCsvFiles(tempDir.path() + "/cholesky_" + output,
+                    tempDir.path() + "/conjugategradient_" + output, 1e-5);
+  }
+}
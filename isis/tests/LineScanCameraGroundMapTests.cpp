@@ -0,0 +1,48 @@
+#include <vector>
+
+#include "LineScanCamera.h"
+#include "LineScanCameraGroundMap.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST_F(LineScannerCube, LineScanCameraGroundMapLinePredictor) {
+  LineScanCamera *cam = (LineScanCamera *) testCube->camera();
+  LineScanCameraGroundMap *groundMap = cam->GroundMap();
+
+  std::vector<double> lats;
+  std::vector<double> lons;
+  for (int line = 3; line <= cam->ParentLines(); line += 97) {
+    for (int sample = 3; sample <= cam->ParentSamples(); sample += 211) {
+      if (cam->SetImage(sample, line)) {
+        lats.push_back(cam->UniversalLatitude());
+        lons.push_back(cam->UniversalLongitude());
+      }
+    }
+  }
+  ASSERT_FALSE(lats.empty());
+
+  std::vector<double> samples;
+  std::vector<double> lines;
+  groundMap->ResetIterationCounts();
+  for (size_t i = 0; i < lats.size(); i++) {
+    ASSERT_TRUE(cam->SetUniversalGround(lats[i], lons[i]));
+    samples.push_back(cam->Sample());
+    lines.push_back(cam->Line());
+  }
+  EXPECT_EQ(groundMap->FindFocalPlaneCalls(), (BigInt)lats.size());
+  double searchIterations = groundMap->AverageIterations();
+
+  groundMap->SetLinePredictor(true);
+  groundMap->ResetIterationCounts();
+  for (size_t i = 0; i < lats.size(); i++) {
+    ASSERT_TRUE(cam->SetUniversalGround(lats[i], lons[i]));
+    EXPECT_NEAR(cam->Sample(), samples[i], 0.05);
+    EXPECT_NEAR(cam->Line(), lines[i], 0.05);
+  }
+  EXPECT_LT(groundMap->AverageIterations(), searchIterations);
+  groundMap->SetLinePredictor(false);
+}
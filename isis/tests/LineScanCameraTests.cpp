@@ -0,0 +1,41 @@
+#include "LineScanCamera.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST_F(LineScannerCube, LineScanCameraLineTimeTable) {
+  LineScanCamera *cam = (LineScanCamera *) testCube->camera();
+  ASSERT_EQ(cam->GetCameraType(), Camera::LineScan);
+
+  std::vector<double> samples;
+  std::vector<double> lines;
+  for (int line = 1; line <= cam->ParentLines(); line += 97) {
+    for (int sample = 1; sample <= cam->ParentSamples(); sample += 211) {
+      samples.push_back(sample);
+      lines.push_back(line);
+    }
+  }
+
+  Camera::PointBatch expected;
+  cam->SetImages(samples, lines, expected);
+
+  // The second pass over the same lines comes from the table
+  cam->SetLineTimeTable(true);
+  for (int pass = 0; pass < 2; pass++) {
+    Camera::PointBatch points;
+    cam->SetImages(samples, lines, points);
+
+    ASSERT_EQ(points.size(), expected.size());
+    for (int i = 0; i < points.size(); i++) {
+      EXPECT_EQ(points.valid[i], expected.valid[i]);
+      EXPECT_EQ(points.latitude[i], expected.latitude[i]);
+      EXPECT_EQ(points.longitude[i], expected.longitude[i]);
+      EXPECT_EQ(points.phaseAngle[i], expected.phaseAngle[i]);
+      EXPECT_EQ(points.incidenceAngle[i], expected.incidenceAngle[i]);
+    }
+  }
+  cam->SetLineTimeTable(false);
+}
@@ -0,0 +1,71 @@
+#include <QAtomicInt>
+#include <QThreadPool>
+
+#include "Buffer.h"
+#include "Cube.h"
+#include "IException.h"
+#include "LineManager.h"
+#include "ProcessByBrick.h"
+#include "SpecialPixel.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST_F(SmallCube, ProcessByBrickThreadedInPlace) {
+  QString path = testCube->fileName();
+  testCube->close();
+  testCube->open(path, "rw");
+
+  ProcessByBrick process;
+  process.SetInputCube(testCube);
+  process.SetBrickSize(3, 3, 1);
+
+  QAtomicInt processedBricks(0);
+  auto doubleValues = [&processedBricks](Buffer &brick) {
+    for (int i = 0; i < brick.size(); i++) {
+      if (!IsSpecial(brick[i])) {
+        brick[i] *= 2.0;
+      }
+    }
+    processedBricks.ref();
+  };
+
+  process.ProcessCubeInPlace(doubleValues, true);
+  process.EndProcess();
+
+  EXPECT_EQ(processedBricks.load(), 4 * 4 * 10);
+
+  int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  if (threadCount > 1) {
+    EXPECT_EQ(process.ThreadThroughput().size(), (size_t) threadCount);
+  }
+
+  testCube->close();
+  testCube->open(path, "r");
+
+  LineManager line(*testCube);
+  double pixelValue = 0.0;
+  for(line.begin(); !line.end(); line++) {
+    testCube->read(line);
+    for(int i = 0; i < line.size(); i++) {
+      EXPECT_DOUBLE_EQ(line[i], 2.0 * pixelValue++);
+    }
+  }
+}
+
+TEST_F(SmallCube, ProcessByBrickThreadedError) {
+  ProcessByBrick process;
+  process.SetInputCube(testCube);
+  process.SetBrickSize(10, 1, 1);
+
+  auto failOnBand5 = [](Buffer &brick) {
+    if (brick.Band() == 5) {
+      throw IException(IException::Unknown, "Failed on band 5", _FILEINFO_);
+    }
+  };
+
+  EXPECT_THROW(process.ProcessCubeInPlace(failOnBand5, true), IException);
+}
@@ -0,0 +1,185 @@
+#include <QList>
+#include <QStringList>
+
+#include "Cube.h"
+#include "CubeAttribute.h"
+#include "LineManager.h"
+#include "ProcessMosaic.h"
+#include "SpecialPixel.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+TEST_F(SmallCube, ProcessMosaicThreadedMatchesSerial) {
+  QString inputPath = testCube->fileName();
+  testCube->close();
+
+  QList<ProcessMosaic::ImageOverlay> overlays;
+  overlays << ProcessMosaic::PlaceImagesOnTop
+           << ProcessMosaic::PlaceImagesBeneath
+           << ProcessMosaic::UseBandPlacementCriteria;
+
+  foreach (ProcessMosaic::ImageOverlay overlay, overlays) {
+    Cube serialMosaic;
+    serialMosaic.setDimensions(15, 15, 10);
+    serialMosaic.create(tempDir.path() + "/serial.cub");
+
+    Cube threadedMosaic;
+    threadedMosaic.setDimensions(15, 15, 10);
+    threadedMosaic.create(tempDir.path() + "/threaded.cub");
+
+    // The second placement overlaps the first, so it depends on it
+    for (int placement = 0; placement < 2; placement++) {
+      for (int threaded = 0; threaded < 2; threaded++) {
+        ProcessMosaic process;
+        process.SetThreadedFlag(threaded);
+        process.SetBandBinMatch(false);
+        process.SetImageOverlay(overlay);
+        process.SetBandNumber(3);
+        process.SetBandUseMaxValue(placement == 1);
+
+        CubeAttributeInput att;
+        process.SetInputCube(inputPath, att);
+        process.AddOutputCube(threaded ? &threadedMosaic : &serialMosaic, false);
+        process.StartProcess(1 + 4 * placement, 1 + 3 * placement, 1);
+        process.EndProcess();
+      }
+    }
+
+    LineManager serialLine(serialMosaic);
+    LineManager threadedLine(threadedMosaic);
+    for (serialLine.begin(), threadedLine.begin(); !serialLine.end();
+         serialLine++, threadedLine++) {
+      serialMosaic.read(serialLine);
+      threadedMosaic.read(threadedLine);
+      for (int i = 0; i < serialLine.size(); i++) {
+        EXPECT_EQ(threadedLine[i], serialLine[i]);
+      }
+    }
+  }
+}
+
+
+/**
+ * Writes a second input for the mosaic tests that overlaps the SmallCube
+ * input with different values and some NULL pixels.
+ */
+static QString createSecondInput(QString path) {
+  Cube input;
+  input.setDimensions(10, 10, 10);
+  input.create(path);
+
+  LineManager line(input);
+  for (line.begin(); !line.end(); line++) {
+    for (int i = 0; i < line.size(); i++) {
+      line[i] = ((line.Line() + i) % 4 == 0) ? Null :
+                (double) (1000 - 10 * line.Line() - i + 3 * line.Band());
+    }
+    input.write(line);
+  }
+  input.close();
+
+  return path;
+}
+
+
+/**
+ * Compares two cubes DN by DN.
+ */
+static void expectCubesEqual(Cube &expected, Cube &actual) {
+  ASSERT_EQ(actual.bandCount(), expected.bandCount());
+
+  LineManager expectedLine(expected);
+  LineManager actualLine(actual);
+  for (expectedLine.begin(), actualLine.begin(); !expectedLine.end();
+       expectedLine++, actualLine++) {
+    expected.read(expectedLine);
+    actual.read(actualLine);
+    for (int i = 0; i < expectedLine.size(); i++) {
+      EXPECT_EQ(actualLine[i], expectedLine[i]);
+    }
+  }
+}
+
+
+TEST_F(SmallCube, ProcessMosaicThreadedTrackingMatchesSerial) {
+  QString inputPath = testCube->fileName();
+  testCube->close();
+  QString secondPath = createSecondInput(tempDir.path() + "/second.cub");
+
+  // The first image creates the mosaic and its tracking cube, the second is
+  // placed by comparing band 3 with tracking
+  for (int threaded = 0; threaded < 2; threaded++) {
+    QString mosaicPath = tempDir.path() + (threaded ? "/threaded.cub" : "/serial.cub");
+    Cube mosaic;
+    mosaic.setDimensions(15, 15, 10);
+    mosaic.create(mosaicPath);
+
+    QStringList inputs;
+    inputs << inputPath << secondPath;
+    for (int placement = 0; placement < 2; placement++) {
+      ProcessMosaic process;
+      process.SetThreadedFlag(threaded);
+      process.SetBandBinMatch(false);
+      process.SetImageOverlay(ProcessMosaic::UseBandPlacementCriteria);
+      process.SetBandNumber(3);
+      process.SetBandUseMaxValue(true);
+      process.SetTrackFlag(true);
+      process.SetCreateFlag(placement == 0);
+
+      CubeAttributeInput att;
+      process.SetInputCube(inputs[placement], att);
+      process.AddOutputCube(&mosaic, false);
+      process.StartProcess(1 + 4 * placement, 1 + 3 * placement, 1);
+      process.EndProcess();
+    }
+    mosaic.close();
+  }
+
+  QStringList suffixes;
+  suffixes << ".cub" << "_tracking.cub";
+  foreach (QString suffix, suffixes) {
+    Cube serial(tempDir.path() + "/serial" + suffix);
+    Cube threaded(tempDir.path() + "/threaded" + suffix);
+    expectCubesEqual(serial, threaded);
+  }
+}
+
+
+TEST_F(SmallCube, ProcessMosaicThreadedAverageMatchesSerial) {
+  QString inputPath = testCube->fileName();
+  testCube->close();
+  QString secondPath = createSecondInput(tempDir.path() + "/second.cub");
+
+  // The mosaic holds a count band for each of its ten bands
+  for (int threaded = 0; threaded < 2; threaded++) {
+    QString mosaicPath = tempDir.path() + (threaded ? "/threaded.cub" : "/serial.cub");
+    Cube mosaic;
+    mosaic.setDimensions(15, 15, 20);
+    mosaic.create(mosaicPath);
+
+    QStringList inputs;
+    inputs << inputPath << secondPath;
+    for (int placement = 0; placement < 2; placement++) {
+      ProcessMosaic process;
+      process.SetThreadedFlag(threaded);
+      process.SetBandBinMatch(false);
+      process.SetImageOverlay(ProcessMosaic::AverageImageWithMosaic);
+      process.SetCreateFlag(placement == 0);
+
+      CubeAttributeInput att;
+      process.SetInputCube(inputs[placement], att);
+      process.AddOutputCube(&mosaic, false);
+      process.StartProcess(1 + 4 * placement, 1 + 3 * placement, 1);
+      process.EndProcess();
+    }
+    mosaic.close();
+  }
+
+  Cube serial(tempDir.path() + "/serial.cub");
+  Cube threaded(tempDir.path() + "/threaded.cub");
+  expectCubesEqual(serial, threaded);
+}
@@ -0,0 +1,160 @@
+#include <vector>
+
+#include "Cube.h"
+#include "CubeAttribute.h"
+#include "IException.h"
+#include "Interpolator.h"
+#include "LineManager.h"
+#include "ProcessRubberSheet.h"
+#include "SpecialPixel.h"
+#include "Transform.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+namespace {
+  // Mirrors the cube left to right, which is its own inverse. Output lines
+  // after validLines don't transform.
+  class FlipTransform : public Transform {
+    public:
+      FlipTransform(int samples, int lines, int validLines = -1)
+          : m_samples(samples), m_lines(lines),
+            m_validLines(validLines < 0 ? lines : validLines) {
+      }
+
+      int OutputSamples() const {
+        return m_samples;
+      }
+
+      int OutputLines() const {
+        return m_lines;
+      }
+
+      bool Xform(double &inSample, double &inLine,
+                 const double outSample, const double outLine) {
+        if (outLine > m_validLines) {
+          return false;
+        }
+
+        inSample = m_samples + 1 - outSample;
+        inLine = outLine;
+        return true;
+      }
+
+    private:
+      int m_samples;
+      int m_lines;
+      int m_validLines;
+  };
+}
+
+TEST_F(SmallCube, ProcessRubberSheetThreadedStartProcess) {
+  QString path = testCube->fileName();
+  testCube->close();
+  testCube->open(path, "r");
+
+  ProcessRubberSheet process(8, 4);
+  process.SetInputCube(testCube);
+  Cube *outputCube = process.SetOutputCube(tempDir.path() + "/flipped.cub",
+                                           CubeAttributeOutput(), 10, 10, 10);
+
+  FlipTransform flip1(10, 10), flip2(10, 10), flip3(10, 10);
+  std::vector<Transform *> transforms;
+  transforms.push_back(&flip1);
+  transforms.push_back(&flip2);
+  transforms.push_back(&flip3);
+
+  Interpolator interp(Interpolator::NearestNeighborType);
+  process.StartProcess(transforms, interp);
+
+  LineManager line(*outputCube);
+  for (line.begin(); !line.end(); line++) {
+    outputCube->read(line);
+    double lineStart = (line.Band() - 1) * 100 + (line.Line() - 1) * 10;
+    for (int i = 0; i < line.size(); i++) {
+      EXPECT_DOUBLE_EQ(line[i], lineStart + 9 - i);
+    }
+  }
+
+  process.EndProcess();
+}
+
+TEST_F(SmallCube, ProcessRubberSheetTransformGrid) {
+  QString path = testCube->fileName();
+  testCube->close();
+  testCube->open(path, "r");
+
+  ProcessRubberSheet process(8, 4);
+  process.setTransformGrid(3);
+  process.SetInputCube(testCube);
+  Cube *outputCube = process.SetOutputCube(tempDir.path() + "/flipped.cub",
+                                           CubeAttributeOutput(), 10, 10, 10);
+
+  FlipTransform flip(10, 10, 6);
+  Interpolator interp(Interpolator::NearestNeighborType);
+  process.StartProcess(flip, interp);
+
+  LineManager line(*outputCube);
+  for (line.begin(); !line.end(); line++) {
+    outputCube->read(line);
+    double lineStart = (line.Band() - 1) * 100 + (line.Line() - 1) * 10;
+    for (int i = 0; i < line.size(); i++) {
+      if (line.Line() > 6) {
+        EXPECT_EQ(line[i], Null);
+      }
+      else {
+        EXPECT_DOUBLE_EQ(line[i], lineStart + 9 - i);
+      }
+    }
+  }
+
+  process.EndProcess();
+}
+
+TEST(ProcessRubberSheet, TransformGridErrors) {
+  ProcessRubberSheet process;
+  EXPECT_THROW(process.setTransformGrid(-1), IException);
+  EXPECT_THROW(process.setTransformGrid(16, 0.0), IException);
+}
+
+TEST_F(SmallCube, ProcessRubberSheetThreadedPatchTransform) {
+  QString path = testCube->fileName();
+  testCube->close();
+  testCube->open(path, "r");
+
+  Interpolator interp(Interpolator::BiLinearType);
+
+  ProcessRubberSheet serialProcess;
+  serialProcess.SetInputCube(testCube);
+  Cube *serialCube = serialProcess.SetOutputCube(tempDir.path() + "/serial.cub",
+                                                 CubeAttributeOutput(), 10, 10, 10);
+  FlipTransform serialFlip(10, 10);
+  serialProcess.processPatchTransform(serialFlip, interp);
+
+  ProcessRubberSheet threadedProcess;
+  threadedProcess.SetInputCube(testCube);
+  Cube *threadedCube = threadedProcess.SetOutputCube(tempDir.path() + "/threaded.cub",
+                                                     CubeAttributeOutput(), 10, 10, 10);
+  FlipTransform flip1(10, 10), flip2(10, 10);
+  std::vector<Transform *> transforms;
+  transforms.push_back(&flip1);
+  transforms.push_back(&flip2);
+  threadedProcess.processPatchTransform(transforms, interp);
+
+  LineManager serialLine(*serialCube);
+  LineManager threadedLine(*threadedCube);
+  for (serialLine.begin(), threadedLine.begin(); !serialLine.end();
+       serialLine++, threadedLine++) {
+    serialCube->read(serialLine);
+    threadedCube->read(threadedLine);
+    for (int i = 0; i < serialLine.size(); i++) {
+      EXPECT_EQ(threadedLine[i], serialLine[i]);
+    }
+  }
+
+  serialProcess.EndProcess();
+  threadedProcess.EndProcess();
+}
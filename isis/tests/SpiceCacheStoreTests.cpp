@@ -0,0 +1,229 @@
+#include <sstream>
+
+#include <QDir>
+#include <QFile>
+
+#include "spiceinit.h"
+
+#include "Camera.h"
+#include "Cube.h"
+#include "FileName.h"
+#include "Pvl.h"
+#include "SpiceCacheStore.h"
+#include "Table.h"
+#include "TableField.h"
+#include "TableRecord.h"
+#include "TestUtilities.h"
+#include "UserInterface.h"
+
+#include "Fixtures.h"
+
+#include "gmock/gmock.h"
+
+using namespace Isis;
+
+namespace {
+  Table makeTable(const QString &name, double value) {
+    TableField et("ET", TableField::Double);
+    TableRecord record;
+    record += et;
+
+    Table table(name, record);
+    record[0] = value;
+    table += record;
+    record[0] = value + 1.0;
+    table += record;
+    return table;
+  }
+
+  // A Clementine UVVIS frame, which spiceinit evaluates from kernels
+  void makeUvvisCube(Cube &cube, const QString &path) {
+    std::istringstream labelStrm(R"(
+      Object = IsisCube
+        Object = Core
+          StartByte   = 65537
+          Format      = Tile
+          TileSamples = 384
+          TileLines   = 288
+
+          Group = Dimensions
+            Samples = 384
+            Lines   = 288
+            Bands   = 1
+          End_Group
+
+          Group = Pixels
+            Type       = UnsignedByte
+            ByteOrder  = Lsb
+            Base       = 0.0
+            Multiplier = 1.0
+          End_Group
+        End_Object
+
+        Group = Instrument
+          SpacecraftName           = "CLEMENTINE 1"
+          InstrumentId             = UVVIS
+          TargetName               = MOON
+          StartTime                = 1994-03-05T08:21:22.626
+          OrbitNumber              = 063
+          FocalPlaneTemperature    = 273.633 <K>
+          ExposureDuration         = 20.3904 <ms>
+          OffsetModeID             = 6
+          GainModeID               = 1
+          CryocoolerDuration       = N/A
+          EncodingCompressionRatio = 3.55
+          EncodingFormat           = CLEM-JPEG-1
+        End_Group
+
+        Group = Archive
+          ProductID    = LUB5120P.063
+          MissionPhase = "LUNAR MAPPING"
+        End_Group
+
+        Group = BandBin
+          FilterName = B
+          Center     = 0.75 <micrometers>
+          Width      = 0.01 <micrometers>
+        End_Group
+
+        Group = Kernels
+          NaifFrameCode = -40022
+        End_Group
+      End_Object
+    End
+    )");
+
+    Pvl label;
+    labelStrm >> label;
+    cube.fromLabel(path, label, "rw");
+
+    QVector<QString> args(0);
+    UserInterface options(FileName("$ISISROOT/bin/xml/spiceinit.xml").expanded(), args);
+    spiceinit(&cube, options);
+  }
+
+  void expectTablesEqual(Table &expected, Table &actual) {
+    ASSERT_EQ(actual.Records(), expected.Records()) << expected.Name().toStdString();
+    for (int i = 0; i < expected.Records(); i++) {
+      ASSERT_EQ(actual[i].Fields(), expected[i].Fields()) << expected.Name().toStdString();
+      for (int j = 0; j < expected[i].Fields(); j++) {
+        EXPECT_EQ(double(actual[i][j]), double(expected[i][j]))
+            << expected.Name().toStdString() << " record " << i << " field " << j;
+      }
+    }
+  }
+
+  void expectSameSpice(Cube &expected, Cube &actual) {
+    QStringList names;
+    names << "InstrumentPointing" << "InstrumentPosition" << "BodyRotation" << "SunPosition";
+    foreach (QString name, names) {
+      Table expectedTable(name);
+      expected.read(expectedTable);
+      Table actualTable(name);
+      actual.read(actualTable);
+      expectTablesEqual(expectedTable, actualTable);
+    }
+
+    Camera *expectedCamera = expected.camera();
+    Camera *actualCamera = actual.camera();
+    for (double line = 1.0; line <= 288.0; line += 71.75) {
+      for (double sample = 1.0; sample <= 384.0; sample += 95.75) {
+        ASSERT_TRUE(expectedCamera->SetImage(sample, line));
+        ASSERT_TRUE(actualCamera->SetImage(sample, line));
+        EXPECT_EQ(actualCamera->UniversalLatitude(), expectedCamera->UniversalLatitude());
+        EXPECT_EQ(actualCamera->UniversalLongitude(), expectedCamera->UniversalLongitude());
+      }
+    }
+  }
+}
+
+TEST_F(TempTestingFiles, SpiceCacheStoreKey) {
+  QString kernelPath = tempDir.path() + "/kernel.bsp";
+  QFile kernel(kernelPath);
+  ASSERT_TRUE(kernel.open(QIODevice::WriteOnly));
+  kernel.write("kernel");
+  kernel.close();
+
+  QStringList kernels(kernelPath);
+  QStringList parameters;
+  parameters << "-82000" << "100.0";
+
+  QString key = SpiceCacheStore::key(kernels, parameters);
+  EXPECT_EQ(key.size(), 40);
+  EXPECT_EQ(SpiceCacheStore::key(kernels, parameters), key);
+  EXPECT_NE(SpiceCacheStore::key(kernels, QStringList() << "-82000" << "101.0"), key);
+  EXPECT_NE(SpiceCacheStore::key(QStringList(), parameters), key);
+
+  // Changing a kernel changes the key
+  ASSERT_TRUE(kernel.open(QIODevice::Append));
+  kernel.write(" updated");
+  kernel.close();
+  EXPECT_NE(SpiceCacheStore::key(kernels, parameters), key);
+}
+
+TEST_F(TempTestingFiles, SpiceCacheStoreReadWrite) {
+  SpiceCacheStore::clearMemory();
+
+  SpiceCacheStore store(tempDir.path() + "/store");
+  QString key = SpiceCacheStore::key(QStringList(), QStringList("parameters"));
+  EXPECT_FALSE(store.contains(key));
+  EXPECT_TRUE(store.read(key).isEmpty());
+
+  QList<Table> tables;
+  tables << makeTable("SunPosition", 10.0) << makeTable("BodyRotation", 20.0);
+  store.write(key, tables);
+  EXPECT_TRUE(store.contains(key));
+  EXPECT_TRUE(QDir(tempDir.path() + "/store/" + key).exists());
+
+  // Read the entry back from the disk, like another process would
+  SpiceCacheStore::clearMemory();
+  QList<Table> readTables = SpiceCacheStore(tempDir.path() + "/store").read(key);
+  ASSERT_EQ(readTables.size(), 2);
+  EXPECT_EQ(readTables[0].Name(), "BodyRotation");
+  EXPECT_EQ(readTables[1].Name(), "SunPosition");
+  ASSERT_EQ(readTables[1].Records(), 2);
+  EXPECT_DOUBLE_EQ(double(readTables[1][0][0]), 10.0);
+  EXPECT_DOUBLE_EQ(double(readTables[1][1][0]), 11.0);
+
+  // Later reads come from memory
+  QDir(tempDir.path() + "/store/" + key).removeRecursively();
+  EXPECT_EQ(store.read(key).size(), 2);
+
+  SpiceCacheStore::clearMemory();
+  EXPECT_FALSE(store.contains(key));
+}
+
+TEST_F(TempTestingFiles, SpiceCacheStoreSpiceinit) {
+  QString storePath = tempDir.path() + "/store";
+  PreferenceGuard guard("Performance", "SpiceCacheDirectory", storePath);
+  SpiceCacheStore::clearMemory();
+
+  // The first run evaluates the kernels and saves the tables in the store
+  Cube fromKernels;
+  makeUvvisCube(fromKernels, tempDir.path() + "/fromKernels.cub");
+  QStringList keys = QDir(storePath).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+  ASSERT_EQ(keys.size(), 1);
+
+  // The second run loads them from the store on disk
+  SpiceCacheStore::clearMemory();
+  Cube fromStore;
+  makeUvvisCube(fromStore, tempDir.path() + "/fromStore.cub");
+  expectSameSpice(fromKernels, fromStore);
+
+  // An entry that can't be loaded is a miss, so the kernels are evaluated again
+  SpiceCacheStore store(storePath);
+  QList<Table> badTables = store.read(keys[0]);
+  ASSERT_EQ(badTables.size(), 4);
+  for (int i = 0; i < badTables.size(); i++) {
+    if (badTables[i].Name() == "InstrumentPosition") {
+      badTables[i] = makeTable("InstrumentPosition", 0.0);
+    }
+  }
+  store.write(keys[0], badTables);
+
+  Cube afterBadEntry;
+  makeUvvisCube(afterBadEntry, tempDir.path() + "/afterBadEntry.cub");
+  expectSameSpice(fromKernels, afterBadEntry);
+
+  SpiceCacheStore::clearMemory();
+}
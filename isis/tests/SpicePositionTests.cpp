@@ -0,0 +1,76 @@
+#include <cmath>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "SpicePosition.h"
+#include "Table.h"
+
+#include "TestUtilities.h"
+
+#include "gmock/gmock.h"
+
+using json = nlohmann::json;
+using namespace Isis;
+
+namespace {
+  // A circular orbit sampled every 10 seconds
+  json circularOrbit(int size) {
+    json isd;
+    isd["spk_table_start_time"] = 0.0;
+    isd["spk_table_end_time"] = 10.0 * (size - 1);
+    isd["spk_table_original_size"] = size;
+
+    std::vector<double> times;
+    std::vector<std::vector<double>> positions, velocities;
+    for (int i = 0; i < size; i++) {
+      double et = 10.0 * i;
+      double angle = 0.001 * et;
+      times.push_back(et);
+      positions.push_back({2000.0 * cos(angle), 2000.0 * sin(angle), 100.0});
+      velocities.push_back({-2.0 * sin(angle), 2.0 * cos(angle), 0.0});
+    }
+    isd["ephemeris_times"] = times;
+    isd["positions"] = positions;
+    isd["velocities"] = velocities;
+    return isd;
+  }
+}
+
+TEST(SpicePosition, IndexedLookup) {
+  json isd = circularOrbit(50);
+
+  SpicePosition searchPos(-94, 499);
+  searchPos.LoadCache(isd);
+  SpicePosition indexedPos(-94, 499);
+  indexedPos.LoadCache(isd);
+  EXPECT_EQ(indexedPos.GetCacheLookup(), SpicePosition::SearchLookup);
+  indexedPos.SetCacheLookup(SpicePosition::IndexedLookup);
+
+  for (double et = -5.0; et <= 500.0; et += 3.7) {
+    searchPos.SetEphemerisTime(et);
+    indexedPos.SetEphemerisTime(et);
+    EXPECT_PRED_FORMAT3(AssertVectorsNear, indexedPos.Coordinate(), searchPos.Coordinate(), 1e-9);
+    EXPECT_PRED_FORMAT3(AssertVectorsNear, indexedPos.Velocity(), searchPos.Velocity(), 1e-12);
+  }
+
+  // The Hermite spline
+  searchPos.Memcache2HermiteCache(0.01);
+  indexedPos.Memcache2HermiteCache(0.01);
+  ASSERT_EQ(indexedPos.GetSource(), SpicePosition::HermiteCache);
+
+  for (double et = 0.0; et <= 490.0; et += 3.7) {
+    searchPos.SetEphemerisTime(et);
+    indexedPos.SetEphemerisTime(et);
+    EXPECT_PRED_FORMAT3(AssertVectorsNear, indexedPos.Coordinate(), searchPos.Coordinate(), 1e-9);
+    EXPECT_PRED_FORMAT3(AssertVectorsNear, indexedPos.Velocity(), searchPos.Velocity(), 1e-9);
+  }
+
+  // The lookup is saved with the cache
+  Table posTable = indexedPos.Cache("TestCache");
+  EXPECT_EQ(posTable.Label()["CacheLookup"][0], "Indexed");
+
+  SpicePosition newPos(-94, 499);
+  newPos.LoadCache(posTable);
+  EXPECT_EQ(newPos.GetCacheLookup(), SpicePosition::IndexedLookup);
+}
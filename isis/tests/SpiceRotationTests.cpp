@@ -463,6 +463,38 @@ TEST_F(SpiceRotationIsd, Cache) {
 }
 
 
+TEST_F(SpiceRotationIsd, IndexedLookup) {
+  SpiceRotation searchRot(-94031);
+  searchRot.LoadCache(isdAv);
+
+  SpiceRotation indexedRot(-94031);
+  indexedRot.LoadCache(isdAv);
+  EXPECT_EQ(indexedRot.GetCacheLookup(), SpiceRotation::SearchLookup);
+  indexedRot.SetCacheLookup(SpiceRotation::IndexedLookup);
+
+  // Include times outside of the cache, which are extrapolated
+  for (double et = -0.5; et <= 3.5; et += 0.125) {
+    searchRot.SetEphemerisTime(et);
+    indexedRot.SetEphemerisTime(et);
+    EXPECT_PRED_FORMAT3(AssertVectorsNear, indexedRot.Matrix(), searchRot.Matrix(),
+                        testTolerance);
+    EXPECT_PRED_FORMAT3(AssertVectorsNear, indexedRot.AngularVelocity(),
+                        searchRot.AngularVelocity(), testTolerance);
+  }
+
+  // The lookup is saved with the cache
+  Table rotTable = indexedRot.Cache("TestCache");
+  EXPECT_EQ(rotTable.Label()["CacheLookup"][0], "Indexed");
+
+  SpiceRotation newRot(-94031);
+  newRot.LoadCache(rotTable);
+  EXPECT_EQ(newRot.GetCacheLookup(), SpiceRotation::IndexedLookup);
+  newRot.SetEphemerisTime(1.5);
+  searchRot.SetEphemerisTime(1.5);
+  EXPECT_PRED_FORMAT3(AssertVectorsNear, newRot.Matrix(), searchRot.Matrix(), testTolerance);
+}
+
+
 TEST_F(SpiceRotationIsd, LineCache) {
   SpiceRotation polyRot(-94031);
   polyRot.LoadCache(isd);
@@ -1,5 +1,10 @@
 #include "TestUtilities.h"
 
+#include <QFile>
+#include <QStringList>
+
+#include "Preference.h"
+
 namespace Isis {
 
   /**
@@ -184,6 +189,40 @@ namespace Isis {
   };
 
 
+  // Compares two CSV files field by field. Numbers must agree to a tolerance
+  // relative to the first file's value, or absolute below 1, and every other
+  // field must match exactly.
+  void compareCsvFiles(QString path1, QString path2, double relativeTolerance) {
+    QFile file1(path1);
+    QFile file2(path2);
+    ASSERT_TRUE(file1.open(QIODevice::ReadOnly | QIODevice::Text)) << path1.toStdString();
+    ASSERT_TRUE(file2.open(QIODevice::ReadOnly | QIODevice::Text)) << path2.toStdString();
+    QStringList lines1 = QString(file1.readAll()).split("\n");
+    QStringList lines2 = QString(file2.readAll()).split("\n");
+    ASSERT_EQ(lines2.size(), lines1.size()) << path2.toStdString();
+
+    for (int i = 0; i < lines1.size(); i++) {
+      QStringList fields1 = lines1[i].split(",");
+      QStringList fields2 = lines2[i].split(",");
+      ASSERT_EQ(fields2.size(), fields1.size()) << path2.toStdString() << " line " << i + 1;
+
+      for (int j = 0; j < fields1.size(); j++) {
+        bool isNumber1, isNumber2;
+        double value1 = fields1[j].toDouble(&isNumber1);
+        double value2 = fields2[j].toDouble(&isNumber2);
+        if (isNumber1 && isNumber2) {
+          EXPECT_NEAR(value2, value1, relativeTolerance * qMax(1.0, qAbs(value1)))
+              << path2.toStdString() << " line " << i + 1 << " field " << j + 1;
+        }
+        else {
+          EXPECT_PRED_FORMAT2(AssertQStringsEqual, fields2[j], fields1[j])
+              << path2.toStdString() << " line " << i + 1 << " field " << j + 1;
+        }
+      }
+    }
+  }
+
+
   // Matches a CSM Image Coord for gMock
   ::testing::Matcher<const csm::ImageCoord&> MatchImageCoord(const csm::ImageCoord &expected) {
     return ::testing::AllOf(
@@ -201,4 +240,34 @@ namespace Isis {
         ::testing::Field(&csm::EcefCoord::z, ::testing::DoubleNear(expected.z, 0.0001))
     );
   }
+
+
+  /**
+   * Replaces a preference until the guard is destroyed.
+   *
+   * @param group The preference group
+   * @param keyword The name of the preference
+   * @param value The value to use
+   */
+  PreferenceGuard::PreferenceGuard(QString group, QString keyword, QString value) :
+      m_group(group), m_keyword(keyword) {
+    PvlGroup &prefs = Preference::Preferences().findGroup(m_group);
+    m_hadKeyword = prefs.hasKeyword(m_keyword);
+    if (m_hadKeyword) {
+      m_original = prefs[m_keyword];
+    }
+    prefs.addKeyword(PvlKeyword(m_keyword, value), PvlContainer::Replace);
+  }
+
+
+  //! Puts back the original preference
+  PreferenceGuard::~PreferenceGuard() {
+    PvlGroup &prefs = Preference::Preferences().findGroup(m_group);
+    if (m_hadKeyword) {
+      prefs.addKeyword(m_original, PvlContainer::Replace);
+    }
+    else if (prefs.hasKeyword(m_keyword)) {
+      prefs.deleteKeyword(m_keyword);
+    }
+  }
 }
@@ -56,9 +56,27 @@ namespace Isis {
   void compareCsvLine(CSVReader::CSVAxis csvLine, QString headerStr, int initialIndex=0);
   void compareCsvLine(CSVReader::CSVAxis csvLine, CSVReader::CSVAxis csvLine2, int initialIndex=0,
                       double tolerance = 0.000001);
+  void compareCsvFiles(QString path1, QString path2, double relativeTolerance = 1e-5);
 
   ::testing::Matcher<const csm::ImageCoord&> MatchImageCoord(const csm::ImageCoord &expected);
   ::testing::Matcher<const csm::EcefCoord&> MatchEcefCoord(const csm::EcefCoord &expected);
+
+  /**
+   * Sets a preference for the life of a test and puts back the original value,
+   * or removes the keyword if there was none, when it goes out of scope. This
+   * keeps a failed assertion from leaking the setting into later tests.
+   */
+  class PreferenceGuard {
+    public:
+      PreferenceGuard(QString group, QString keyword, QString value);
+      ~PreferenceGuard();
+
+    private:
+      QString m_group;          //!< The preference group
+      QString m_keyword;        //!< The name of the preference
+      bool m_hadKeyword;        //!< If the preference was set before the guard
+      PvlKeyword m_original;    //!< The original preference
+  };
 }
 
 #endif
@@ -1,3 +1,5 @@
+#include <QThreadPool>
+
 #include "ImagePolygon.h"
 #include "LineManager.h"
 #include "PolygonTools.h"
@@ -68,6 +70,33 @@ TEST_F(DefaultCube, UnitTestImagePolygonSubPoly) {
   EXPECT_NEAR(10.126704, centroid->getY(), 1e-6);
 }
 
+TEST_F(DefaultCube, UnitTestImagePolygonThreaded) {
+  ImagePolygon serialPoly;
+  serialPoly.Create(*testCube, 100, 100);
+
+  // Make sure there are threads to copy the camera for
+  int threadCount = QThreadPool::globalInstance()->maxThreadCount();
+  QThreadPool::globalInstance()->setMaxThreadCount(4);
+  ImagePolygon threadedPoly;
+  threadedPoly.SetThreadedFlag(true);
+  threadedPoly.Create(*testCube, 100, 100);
+  QThreadPool::globalInstance()->setMaxThreadCount(threadCount);
+
+  EXPECT_EQ(serialPoly.cameraCount(), 1);
+  ASSERT_GT(threadedPoly.cameraCount(), 1);
+  EXPECT_GT(serialPoly.cameraEvaluations(), 0);
+  EXPECT_GT(threadedPoly.cameraEvaluations(), 0);
+  ASSERT_EQ(serialPoly.numVertices(), threadedPoly.numVertices());
+
+  geos::geom::CoordinateArraySequence serialCoords(*(serialPoly.Polys()->getCoordinates()));
+  geos::geom::CoordinateArraySequence threadedCoords(*(threadedPoly.Polys()->getCoordinates()));
+  ASSERT_EQ(serialCoords.getSize(), threadedCoords.getSize());
+  for (size_t i = 0; i < serialCoords.getSize(); i++) {
+    EXPECT_EQ(serialCoords.getAt(i).x, threadedCoords.getAt(i).x);
+    EXPECT_EQ(serialCoords.getAt(i).y, threadedCoords.getAt(i).y);
+  }
+}
+
 TEST_F(TempTestingFiles, UnitTestImagePolygonCross) {
   FileName isdFile("$ISISROOT/../isis/tests/data/footprintinit/cross.isd");
   FileName labelFile("$ISISROOT/../isis/tests/data/footprintinit/cross.pvl");